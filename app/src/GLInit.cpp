@@ -67,6 +67,9 @@ namespace TrenchBroom {
     static Func3<void, GLenum, GLenum, GLfloat>& _glTexParameterf = glTexParameterf;
     static Func3<void, GLenum, GLenum, GLint>& _glTexParameteri = glTexParameteri;
     static Func9<void, GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*>& _glTexImage2D = glTexImage2D;
+    static Func10<void, GLenum, GLint, GLint, GLsizei, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*>& _glTexImage3D = glTexImage3D;
+    static Func11<void, GLenum, GLint, GLint, GLint, GLint, GLsizei, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*>& _glTexSubImage3D = glTexSubImage3D;
+    static Func8<void, GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei, const GLvoid*>& _glCompressedTexImage2D = glCompressedTexImage2D;
     static Func1<void, GLenum>& _glActiveTexture = glActiveTexture;
     
     static Func2<void, GLsizei, GLuint*>& _glGenBuffers = glGenBuffers;
@@ -94,6 +97,8 @@ namespace TrenchBroom {
     static Func4<void, GLenum, GLsizei, GLenum, const GLvoid*>& _glDrawElements = glDrawElements;
     static Func6<void, GLenum, GLuint, GLuint, GLsizei, GLenum, const GLvoid*>& _glDrawRangeElements = glDrawRangeElements;
     static Func5<void, GLenum, const GLsizei*, GLenum, const GLvoid**, GLsizei>& _glMultiDrawElements = glMultiDrawElements;
+    static Func4<void, GLenum, GLint, GLsizei, GLsizei>& _glDrawArraysInstanced = glDrawArraysInstanced;
+    static Func2<void, GLuint, GLuint>& _glVertexAttribDivisor = glVertexAttribDivisor;
 
     static Func1<GLuint, GLenum>& _glCreateShader = glCreateShader;
     static Func1<void, GLuint>& _glDeleteShader = glDeleteShader;
@@ -148,6 +153,7 @@ namespace TrenchBroom {
     static Func4<void, GLint, GLsizei, GLboolean, const GLfloat*>& _glUniformMatrix4x3fv = glUniformMatrix4x3fv;
     
     static Func2<GLint, GLuint, const GLchar*>& _glGetUniformLocation = glGetUniformLocation;
+    static Func2<GLint, GLuint, const GLchar*>& _glGetAttribLocation = glGetAttribLocation;
     
 #ifdef __APPLE__
     static Func2<void, GLenum, GLint>& _glFinishObjectAPPLE = glFinishObjectAPPLE;
@@ -199,6 +205,9 @@ namespace TrenchBroom {
         _glTexParameterf.bindFunc(&::glTexParameterf);
         _glTexParameteri.bindFunc(&::glTexParameteri);
         _glTexImage2D.bindFunc(&::glTexImage2D);
+        _glTexImage3D.bindFunc(glTexImage3D);
+        _glTexSubImage3D.bindFunc(glTexSubImage3D);
+        _glCompressedTexImage2D.bindFunc(glCompressedTexImage2D);
         _glActiveTexture.bindFunc(glActiveTexture);
         
         _glGenBuffers.bindFunc(glGenBuffers);
@@ -226,6 +235,8 @@ namespace TrenchBroom {
         _glDrawElements.bindFunc(&::glDrawElements);
         _glDrawRangeElements.bindFunc(glDrawRangeElements);
         _glMultiDrawElements.bindFunc(glMultiDrawElements);
+        _glDrawArraysInstanced.bindFunc(glDrawArraysInstancedARB);
+        _glVertexAttribDivisor.bindFunc(glVertexAttribDivisorARB);
         
         _glCreateShader.bindFunc(glCreateShader);
         _glDeleteShader.bindFunc(glDeleteShader);
@@ -280,6 +291,7 @@ namespace TrenchBroom {
         _glUniformMatrix4x3fv.bindFunc(glUniformMatrix4x3fv);
         
         _glGetUniformLocation.bindFunc(glGetUniformLocation);
+        _glGetAttribLocation.bindFunc(glGetAttribLocation);
         
 #ifdef __APPLE__
         _glFinishObjectAPPLE.bindFunc(glFinishObjectAPPLE);
@@ -0,0 +1,61 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "ByteBuffer.h"
+#include "Color.h"
+#include "Assets/Palette.h"
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static constexpr size_t NumTextures = 1'000;
+        static constexpr size_t TextureSize = 128;
+
+        TEST(PaletteBenchmark, benchIndexedToRgb) {
+            unsigned char* data = new unsigned char[768];
+            for (size_t i = 0; i < 768; ++i)
+                data[i] = static_cast<unsigned char>((i * 37) % 256);
+            const Palette palette(768, data);
+
+            // indexed images tend to have runs of equal indices, like the textures in a WAD file
+            std::vector<unsigned char> indices(TextureSize * TextureSize);
+            for (size_t i = 0; i < indices.size(); ++i)
+                indices[i] = static_cast<unsigned char>((i / 5 * 13) % 256);
+
+            Buffer<unsigned char> rgbImage(3 * indices.size());
+            Color averageColor;
+            timeLambda([&]() {
+                for (size_t i = 0; i < NumTextures; ++i) {
+                    // convert the complete mip chain, but only compute the average color of the first level
+                    palette.indexedToRgb(indices.data(), indices.size(), rgbImage, averageColor);
+                    for (size_t level = 1; level < 4; ++level) {
+                        const size_t size = indices.size() >> (2 * level);
+                        palette.indexedToRgb(indices.data(), size, rgbImage);
+                    }
+                }
+            }, "convert " + std::to_string(NumTextures) + " indexed " + std::to_string(TextureSize) + "x" + std::to_string(TextureSize) + " textures");
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "StringUtils.h"
+#include "IO/StandardMapParser.h"
+#include "IO/SimpleParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/World.h"
+
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumBrushes = 64'000;
+
+        /**
+         * Creates a map with a worldspawn entity containing the given number of brushes. The brushes are boxes with
+         * decimal plane points, which is typical for maps that have been edited with vertex tools.
+         */
+        static String makeMap(const size_t brushCount) {
+            StringStream str;
+            str << "// Game: Quake\n"
+                << "// Format: Standard\n"
+                << "{\n"
+                << "\"classname\" \"worldspawn\"\n"
+                << "\"wad\" \"/quake/id1/gfx/base.wad\"\n";
+
+            for (size_t i = 0; i < brushCount; ++i) {
+                const double x = static_cast<double>(i % 256) * 64.0;
+                const double y = static_cast<double>((i / 256) % 256) * 64.0;
+                const double z = static_cast<double>(i / 65536) * 64.0 + 0.125;
+
+                str << "{\n"
+                    << "( " << x << " " << y << " " << z << " ) ( " << x << " " << y + 1.0 << " " << z << " ) ( " << x << " " << y << " " << z + 1.0 << " ) city2_1 0 0 0 1 1\n"
+                    << "( " << x << " " << y << " " << z << " ) ( " << x << " " << y << " " << z + 1.0 << " ) ( " << x + 1.0 << " " << y << " " << z << " ) city2_1 0 0 0 1 1\n"
+                    << "( " << x << " " << y << " " << z << " ) ( " << x + 1.0 << " " << y << " " << z << " ) ( " << x << " " << y + 1.0 << " " << z << " ) city2_1 0 0 0 1 1\n"
+                    << "( " << x + 32.5 << " " << y + 32.5 << " " << z + 16.25 << " ) ( " << x + 32.5 << " " << y + 33.5 << " " << z + 16.25 << " ) ( " << x + 33.5 << " " << y + 32.5 << " " << z + 16.25 << " ) city2_1 -16 8 0 1 1\n"
+                    << "( " << x + 32.5 << " " << y + 32.5 << " " << z + 16.25 << " ) ( " << x + 33.5 << " " << y + 32.5 << " " << z + 16.25 << " ) ( " << x + 32.5 << " " << y + 32.5 << " " << z + 17.25 << " ) city2_1 -16 8 0 1 1\n"
+                    << "( " << x + 32.5 << " " << y + 32.5 << " " << z + 16.25 << " ) ( " << x + 32.5 << " " << y + 32.5 << " " << z + 17.25 << " ) ( " << x + 32.5 << " " << y + 33.5 << " " << z + 16.25 << " ) city2_1 -16 8 0 1 1\n"
+                    << "}\n";
+            }
+
+            str << "}\n";
+            return str.str();
+        }
+
+        TEST(MapParserBenchmark, benchTokenizer) {
+            const String map = makeMap(NumBrushes);
+
+            size_t tokenCount = 0;
+            double sum = 0.0;
+            timeLambda([&]() {
+                QuakeMapTokenizer tokenizer(map);
+                auto token = tokenizer.nextToken();
+                while (!token.hasType(QuakeMapToken::Eof)) {
+                    if (token.hasType(QuakeMapToken::Integer | QuakeMapToken::Decimal))
+                        sum += token.toFloat<double>();
+                    ++tokenCount;
+                    token = tokenizer.nextToken();
+                }
+            }, "tokenize " + std::to_string(map.size() / 1024) + " KiB map");
+
+            ASSERT_LT(0u, tokenCount);
+            ASSERT_LT(0.0, sum);
+        }
+
+        TEST(MapParserBenchmark, benchWorldReader) {
+            const String map = makeMap(NumBrushes);
+            const BBox3 worldBounds(16384.0);
+
+            Model::World* world = nullptr;
+            timeLambda([&]() {
+                SimpleParserStatus status(nullptr);
+                WorldReader reader(map, nullptr);
+                world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            }, "read map with " + std::to_string(NumBrushes) + " brushes");
+
+            ASSERT_TRUE(world != nullptr);
+            delete world;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "IO/NodeWriter.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/Layer.h"
+#include "Model/World.h"
+
+#include <cstdio>
+#include <string>
+
+namespace TrenchBroom {
+    namespace IO {
+        static constexpr size_t NumWriterBrushes = 64'000;
+
+        TEST(NodeWriterBenchmark, benchWriteMap) {
+            const BBox3 worldBounds(16384.0);
+            Model::World world(Model::MapFormat::Valve, nullptr, worldBounds);
+            
+            Model::BrushBuilder builder(&world, worldBounds);
+            for (size_t i = 0; i < NumWriterBrushes; ++i) {
+                const double x = static_cast<double>(i % 256) * 64.0;
+                const double y = static_cast<double>((i / 256) % 256) * 64.0;
+                const double z = static_cast<double>(i / 65536) * 64.0;
+                
+                Model::Brush* brush = builder.createCuboid(BBox3(Vec3(x, y, z), Vec3(x + 32.0, y + 32.0, z + 16.0)), "city2_1");
+                brush->faces().front()->setXOffset(static_cast<float>(i % 64));
+                brush->faces().front()->setRotation(0.1f * static_cast<float>(i % 7));
+                world.defaultLayer()->addChild(brush);
+            }
+            
+            FILE* file = std::tmpfile();
+            ASSERT_TRUE(file != nullptr);
+            
+            timeLambda([&]() {
+                NodeWriter writer(&world, file);
+                writer.writeMap();
+            }, "write map with " + std::to_string(NumWriterBrushes) + " brushes");
+            
+            ASSERT_LT(0, std::ftell(file));
+            std::fclose(file);
+        }
+    }
+}
@@ -0,0 +1,107 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "BenchmarkUtils.h"
+#include "VecMath.h"
+#include "Model/AABBTree.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/Layer.h"
+#include "Model/World.h"
+
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        static constexpr size_t NumDraggedBrushes = 10'000;
+        static constexpr size_t NumDragSteps = 32;
+
+        static BBox3 draggedBrushBounds(const size_t i) {
+            const double x = static_cast<double>(i % 100) * 64.0 - 3200.0;
+            const double y = static_cast<double>(i / 100) * 64.0 - 3200.0;
+            return BBox3(Vec3(x, y, 0.0), Vec3(x + 32.0, y + 32.0, 32.0));
+        }
+
+        TEST(LayerBenchmark, benchDragBrushes) {
+            const BBox3 worldBounds(16384.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+
+            BrushBuilder builder(&world, worldBounds);
+            BrushList brushes;
+            for (size_t i = 0; i < NumDraggedBrushes; ++i) {
+                Brush* brush = builder.createCuboid(draggedBrushBounds(i), "texture");
+                world.defaultLayer()->addChild(brush);
+                brushes.push_back(brush);
+            }
+
+            // every step moves the brushes by one grid unit, like a mouse drag does
+            const Mat4x4 translation = translationMatrix(Vec3(16.0, 8.0, 0.0));
+            timeLambda([&]() {
+                for (size_t step = 0; step < NumDragSteps; ++step) {
+                    for (Brush* brush : brushes)
+                        brush->transform(translation, false, worldBounds);
+                }
+            }, "drag " + std::to_string(NumDraggedBrushes) + " brushes " + std::to_string(NumDragSteps) + " steps");
+        }
+
+        TEST(LayerBenchmark, benchUpdateIndex) {
+            typedef std::vector<BBox3> BoundsList;
+            BoundsList bounds;
+            for (size_t i = 0; i < NumDraggedBrushes; ++i)
+                bounds.push_back(draggedBrushBounds(i));
+
+            const Vec3 delta(16.0, 8.0, 0.0);
+
+            // same leaf margin as in Layer
+            AABBTree<FloatType, size_t> tree(static_cast<FloatType>(16.0));
+            for (size_t i = 0; i < NumDraggedBrushes; ++i)
+                tree.addObject(bounds[i], i);
+
+            BoundsList treeBounds = bounds;
+            timeLambda([&]() {
+                for (size_t step = 0; step < NumDragSteps; ++step) {
+                    for (size_t i = 0; i < NumDraggedBrushes; ++i) {
+                        treeBounds[i].translate(delta);
+                        tree.updateObject(treeBounds[i], i);
+                    }
+                }
+            }, "update " + std::to_string(NumDraggedBrushes) + " objects in tree " + std::to_string(NumDragSteps) + " times");
+
+            // for comparison, remove and reinsert every object from the root like the octree used to do
+            AABBTree<FloatType, size_t> reinsertTree(static_cast<FloatType>(16.0));
+            for (size_t i = 0; i < NumDraggedBrushes; ++i)
+                reinsertTree.addObject(bounds[i], i);
+
+            BoundsList reinsertBounds = bounds;
+            timeLambda([&]() {
+                for (size_t step = 0; step < NumDragSteps; ++step) {
+                    for (size_t i = 0; i < NumDraggedBrushes; ++i) {
+                        reinsertBounds[i].translate(delta);
+                        reinsertTree.removeObject(i);
+                        reinsertTree.addObject(reinsertBounds[i], i);
+                    }
+                }
+            }, "reinsert " + std::to_string(NumDraggedBrushes) + " objects in tree " + std::to_string(NumDragSteps) + " times");
+        }
+    }
+}
@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 
+#include "BenchmarkUtils.h"
 #include "CollectionUtils.h"
 #include "Assets/Texture.h"
 #include "Model/Brush.h"
@@ -28,7 +29,6 @@
 #include "Renderer/BrushRenderer.h"
 
 #include <vector>
-#include <chrono>
 #include <string>
 #include <iostream>
 #include <tuple>
@@ -79,23 +79,6 @@ namespace TrenchBroom {
             return {result, textures};
         }
 
-#ifdef __GNUC__
-#define TB_NOINLINE __attribute__((noinline))
-#else
-#define TB_NOINLINE
-#endif
-
-        // the noinline is so you can see the timeLambda when profiling
-        template<class L>
-        TB_NOINLINE static void timeLambda(L&& lambda, const std::string& message) {
-            const auto start = std::chrono::high_resolution_clock::now();
-            lambda();
-            const auto end = std::chrono::high_resolution_clock::now();
-
-            printf("Time elapsed for '%s': %fms\n", message.c_str(),
-                   std::chrono::duration<double>(end - start).count() * 1000.0);
-        }
-
         TEST(BrushRendererBenchmark, benchBrushRenderer) {
             auto brushesTextures = makeBrushes();
             std::vector<Model::Brush*> brushes = brushesTextures.first;
@@ -20,15 +20,113 @@
 #ifndef TrenchBroom_Allocator_h
 #define TrenchBroom_Allocator_h
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <iostream>
 #include <limits>
-#include <stack>
+#include <mutex>
 #include <vector>
 
 // Undefine this to prevent false positives when looking for memory leaks.
 #define TB_ENABLE_ALLOCATOR 1
 
+/**
+ * A scoped arena for objects that are managed by an Allocator. While an arena is alive, all such objects that are
+ * created on the same thread are placed into large contiguous blocks owned by the arena, and deleting them does not
+ * return their memory to the allocator pools. Instead, the memory is released all at once when the arena is
+ * destroyed.
+ *
+ * This is meant for operations that build temporary geometry which is discarded as a whole, e.g. testing whether a
+ * set of vertices can be moved. Objects created while the arena is alive must not outlive it. Objects that were
+ * created before the arena may still be deleted while it is alive.
+ *
+ * Arenas may be nested, in which case new objects are placed into the innermost arena.
+ */
+class AllocatorArena {
+private:
+    static const size_t BlockSize = 64 * 1024;
+
+    std::vector<unsigned char*> m_blocks;
+    unsigned char* m_current;
+    size_t m_remaining;
+    AllocatorArena* m_previous;
+
+    static AllocatorArena*& activeArena() {
+        static thread_local AllocatorArena* arena = nullptr;
+        return arena;
+    }
+public:
+    AllocatorArena() :
+    m_current(nullptr),
+    m_remaining(0),
+    m_previous(activeArena()) {
+        activeArena() = this;
+    }
+
+    ~AllocatorArena() {
+        assert(activeArena() == this);
+        activeArena() = m_previous;
+        for (unsigned char* block : m_blocks)
+            delete[] block;
+    }
+
+    AllocatorArena(const AllocatorArena& other) = delete;
+    AllocatorArena& operator=(const AllocatorArena& other) = delete;
+
+    /**
+     * Returns the innermost arena that is alive on the calling thread, or null if there is none.
+     */
+    static AllocatorArena* active() {
+        return activeArena();
+    }
+
+    /**
+     * Indicates whether the given memory was allocated by any arena that is alive on the calling thread.
+     */
+    static bool owns(const void* p) {
+        for (const AllocatorArena* arena = activeArena(); arena != nullptr; arena = arena->m_previous) {
+            if (arena->contains(p))
+                return true;
+        }
+        return false;
+    }
+
+    void* allocate(const size_t size, const size_t alignment) {
+        assert(size <= BlockSize);
+
+        size_t padding = reinterpret_cast<size_t>(m_current) % alignment;
+        if (padding > 0)
+            padding = alignment - padding;
+
+        if (m_current == nullptr || padding + size > m_remaining) {
+            // new[] returns memory that is suitably aligned for any fundamental type
+            m_current = new unsigned char[BlockSize];
+            m_remaining = BlockSize;
+            m_blocks.push_back(m_current);
+            padding = 0;
+        }
+
+        void* result = m_current + padding;
+        m_current += padding + size;
+        m_remaining -= padding + size;
+        return result;
+    }
+
+    bool contains(const void* p) const {
+        const unsigned char* address = reinterpret_cast<const unsigned char*>(p);
+        for (const unsigned char* block : m_blocks) {
+            if (address >= block && address < block + BlockSize)
+                return true;
+        }
+        return false;
+    }
+
+    size_t blockCount() const {
+        return m_blocks.size();
+    }
+};
+
 template <class T, size_t PoolSize = 64, size_t BlocksPerChunk = 256>
 class Allocator {
 private:
@@ -90,10 +188,43 @@ private:
     };
     
     typedef std::vector<Chunk*> ChunkList;
-    typedef std::stack<T*> Pool;
-    
+
+    /**
+     * Caches free blocks for the calling thread so that the shared chunk lists only need to be locked when the cache
+     * runs empty or overflows. The cached blocks are returned to the chunks when the thread exits.
+     */
+    class Pool {
+    private:
+        std::vector<T*> m_blocks;
+    public:
+        ~Pool() {
+            std::lock_guard<std::mutex> lock(mutex());
+            for (T* t : m_blocks)
+                releaseBlock(t);
+        }
+
+        bool empty() const {
+            return m_blocks.empty();
+        }
+
+        size_t size() const {
+            return m_blocks.size();
+        }
+
+        void push(T* t) {
+            m_blocks.push_back(t);
+        }
+
+        T* pop() {
+            assert(!empty());
+            T* t = m_blocks.back();
+            m_blocks.pop_back();
+            return t;
+        }
+    };
+
     static Pool& pool() {
-        static Pool p;
+        static thread_local Pool p;
         return p;
     }
     
@@ -107,21 +238,24 @@ private:
         return chunks;
     }
     
-    static ChunkList emptyChunks() {
+    static ChunkList& emptyChunks() {
         static ChunkList chunks;
         return chunks;
     }
-public:
-#ifdef TB_ENABLE_ALLOCATOR
-    void* operator new(size_t size) {
-        assert(size == sizeof(T));
-        
-        if (!pool().empty()) {
-            T* t = pool().top();
-            pool().pop();
-            return t;
-        }
-        
+
+    // guards the chunk lists, since objects may be created and destroyed on worker threads
+    static std::mutex& mutex() {
+        static std::mutex m;
+        return m;
+    }
+
+    // the number of blocks that are moved between a thread's pool and the chunks at once
+    static size_t batchSize() {
+        return std::max(PoolSize / 2, static_cast<size_t>(1));
+    }
+
+    // must be called while the mutex is locked
+    static T* allocateBlock() {
         Chunk* chunk = nullptr;
         if (mixedChunks().empty()) {
             if (!emptyChunks().empty()) {
@@ -145,15 +279,9 @@ public:
         }
         return block;
     }
-    
-    void operator delete(void* block) {
-        T* t = reinterpret_cast<T*>(block);
-        
-        if (PoolSize > 0 && pool().size() < PoolSize) {
-            pool().push(t);
-            return;
-        }
-        
+
+    // must be called while the mutex is locked
+    static void releaseBlock(T* t) {
         typename ChunkList::reverse_iterator fullIt, fullEnd, mixedIt, mixedEnd;
         fullIt = fullChunks().rbegin();
         fullEnd = fullChunks().rend();
@@ -185,6 +313,7 @@ public:
         if (chunk->full()) {
             fullChunks().erase((fullIt + 1).base());
             mixedChunks().push_back(chunk);
+            mixedIt = mixedChunks().rbegin();
         }
         
         chunk->deallocate(t);
@@ -197,6 +326,37 @@ public:
                     delete chunk;
         }
     }
+public:
+#ifdef TB_ENABLE_ALLOCATOR
+    void* operator new(size_t size) {
+        assert(size == sizeof(T));
+
+        AllocatorArena* arena = AllocatorArena::active();
+        if (arena != nullptr)
+            return arena->allocate(sizeof(T), alignof(T));
+
+        Pool& p = pool();
+        if (p.empty()) {
+            std::lock_guard<std::mutex> lock(mutex());
+            for (size_t i = 0; i < batchSize(); ++i)
+                p.push(allocateBlock());
+        }
+        return p.pop();
+    }
+    
+    void operator delete(void* block) {
+        // memory that belongs to an arena is released when the arena is destroyed
+        if (AllocatorArena::owns(block))
+            return;
+
+        Pool& p = pool();
+        p.push(reinterpret_cast<T*>(block));
+        if (p.size() > PoolSize) {
+            std::lock_guard<std::mutex> lock(mutex());
+            while (p.size() > PoolSize / 2)
+                releaseBlock(p.pop());
+        }
+    }
 #endif
 };
 
@@ -24,7 +24,7 @@
 #include "Assets/TextureCollection.h"
 #include "Renderer/TexturedIndexRangeMap.h"
 #include "Renderer/TexturedIndexRangeMapBuilder.h"
-#include "Renderer/TexturedIndexRangeRenderer.h"
+#include "Renderer/EntityModelMesh.h"
 
 #include <cassert>
 
@@ -79,7 +79,7 @@ namespace TrenchBroom {
             m_subModels.push_back(SubModel(faces, bounds));
         }
 
-        Renderer::TexturedIndexRangeRenderer* Bsp29Model::doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const {
+        Renderer::EntityModelMesh* Bsp29Model::doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const {
             const SubModel& model = m_subModels.front();
 
             size_t vertexCount = 0;
@@ -95,9 +95,8 @@ namespace TrenchBroom {
             for (const Face& face : model.faces)
                 builder.addPolygon(face.texture(), face.vertices());
 
-            const Renderer::VertexArray vertexArray = Renderer::VertexArray::swap(builder.vertices());
             const Renderer::TexturedIndexRangeMap& indexArray = builder.indices();
-            return new Renderer::TexturedIndexRangeRenderer(vertexArray, indexArray);
+            return new Renderer::EntityModelMesh(builder.vertices(), indexArray);
         }
 
         BBox3f Bsp29Model::doGetBounds(const size_t skinIndex, const size_t frameIndex) const {
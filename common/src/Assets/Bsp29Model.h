@@ -66,7 +66,7 @@ namespace TrenchBroom {
             
             void addModel(const FaceList& faces, const BBox3f& bounds);
         private:
-            Renderer::TexturedIndexRangeRenderer* doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const override;
+            Renderer::EntityModelMesh* doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const override;
             BBox3f doGetBounds(const size_t skinIndex, const size_t frameIndex) const override;
             BBox3f doGetTransformedBounds(const size_t skinIndex, const size_t frameIndex, const Mat4x4f& transformation) const override;
             void doPrepare(int minFilter, int magFilter) override;
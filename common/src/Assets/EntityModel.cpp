@@ -26,7 +26,7 @@ namespace TrenchBroom {
 
         EntityModel::~EntityModel() {}
         
-        Renderer::TexturedIndexRangeRenderer * EntityModel::buildRenderer(const size_t skinIndex, const size_t frameIndex) const {
+        Renderer::EntityModelMesh* EntityModel::buildRenderer(const size_t skinIndex, const size_t frameIndex) const {
             return doBuildRenderer(skinIndex, frameIndex);
         }
 
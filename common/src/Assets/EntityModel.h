@@ -24,7 +24,7 @@
 
 namespace TrenchBroom {
     namespace Renderer {
-        class TexturedIndexRangeRenderer;
+        class EntityModelMesh;
     }
     
     namespace Assets {
@@ -35,7 +35,7 @@ namespace TrenchBroom {
             EntityModel();
             virtual ~EntityModel();
             
-            Renderer::TexturedIndexRangeRenderer* buildRenderer(const size_t skinIndex, const size_t frameIndex) const;
+            Renderer::EntityModelMesh* buildRenderer(const size_t skinIndex, const size_t frameIndex) const;
             BBox3f bounds(const size_t skinIndex, const size_t frameIndex) const;
             BBox3f transformedBounds(const size_t skinIndex, const size_t frameIndex, const Mat4x4f& transformation) const;
             
@@ -43,7 +43,7 @@ namespace TrenchBroom {
             void prepare(int minFilter, int magFilter);
             void setTextureMode(int minFilter, int magFilter);
         private:
-            virtual Renderer::TexturedIndexRangeRenderer* doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const = 0;
+            virtual Renderer::EntityModelMesh* doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const = 0;
             virtual BBox3f doGetBounds(const size_t skinIndex, const size_t frameIndex) const = 0;
             virtual BBox3f doGetTransformedBounds(const size_t skinIndex, const size_t frameIndex, const Mat4x4f& transformation) const = 0;
             virtual void doPrepare(int minFilter, int magFilter) = 0;
@@ -22,10 +22,14 @@
 #include "CollectionUtils.h"
 #include "Exceptions.h"
 #include "Logger.h"
+#include "ParallelUtils.h"
 #include "Assets/EntityModel.h"
 #include "IO/EntityModelLoader.h"
 #include "Model/Entity.h"
-#include "Renderer/TexturedIndexRangeRenderer.h"
+#include "Renderer/EntityModelMesh.h"
+
+#include <algorithm>
+#include <chrono>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -34,13 +38,17 @@ namespace TrenchBroom {
         m_loader(nullptr),
         m_minFilter(minFilter),
         m_magFilter(magFilter),
-        m_resetTextureMode(false) {}
+        m_resetTextureMode(false),
+        m_collectedModels(false),
+        m_cancelLoading(false) {}
         
         EntityModelManager::~EntityModelManager() {
             clear();
         }
         
         void EntityModelManager::clear() {
+            cancelLoading();
+            
             MapUtils::clearAndDelete(m_renderers);
             MapUtils::clearAndDelete(m_models);
             m_rendererMismatches.clear();
@@ -63,10 +71,61 @@ namespace TrenchBroom {
             m_loader = loader;
         }
 
+        void EntityModelManager::loadModels(const IO::Path::List& paths) {
+            if (m_loader == nullptr)
+                return;
+            
+            IO::Path::List newPaths;
+            for (const IO::Path& path : paths) {
+                if (!path.isEmpty() &&
+                    m_models.count(path) == 0 &&
+                    m_modelMismatches.count(path) == 0 &&
+                    m_pendingModels.insert(path).second)
+                    newPaths.push_back(path);
+            }
+            
+            if (newPaths.empty())
+                return;
+
+            // drop the tasks that have finished
+            m_loadTasks.erase(std::remove_if(std::begin(m_loadTasks), std::end(m_loadTasks), [](const std::future<void>& task) {
+                return task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            }), std::end(m_loadTasks));
+            
+            const IO::EntityModelLoader* loader = m_loader;
+            m_loadTasks.push_back(std::async(std::launch::async, [this, loader, newPaths]() {
+                ParallelUtils::parallelFor(newPaths.size(), [&](const size_t i) {
+                    LoadedModel loadedModel = { newPaths[i], nullptr, "" };
+                    if (!m_cancelLoading) {
+                        try {
+                            loadedModel.model = loader->loadEntityModel(newPaths[i]);
+                        } catch (const std::exception& e) {
+                            loadedModel.error = e.what();
+                        }
+                    }
+                    
+                    std::lock_guard<std::mutex> lock(m_loadedModelsMutex);
+                    m_loadedModels.push_back(loadedModel);
+                    m_loadedModelsCondition.notify_all();
+                });
+            }));
+        }
+        
+        bool EntityModelManager::collectLoadedModels() {
+            doCollectLoadedModels();
+            
+            const bool result = m_collectedModels;
+            m_collectedModels = false;
+            return result;
+        }
+
         EntityModel* EntityModelManager::model(const IO::Path& path) const {
             if (path.isEmpty())
                 return nullptr;
             
+            if (m_pendingModels.count(path) > 0)
+                waitForModel(path);
+            
             ModelCache::const_iterator it = m_models.find(path);
             if (it != std::end(m_models))
                 return it->second;
@@ -98,7 +157,11 @@ namespace TrenchBroom {
             }
         }
         
-        Renderer::TexturedIndexRangeRenderer* EntityModelManager::renderer(const Assets::ModelSpecification& spec) const {
+        Renderer::EntityModelMesh* EntityModelManager::renderer(const Assets::ModelSpecification& spec) const {
+            // the entity is rendered without its model until the model has been loaded
+            if (m_pendingModels.count(spec.path) > 0)
+                return nullptr;
+            
             EntityModel* entityModel = safeGetModel(spec.path);
 
             if (entityModel == nullptr)
@@ -111,7 +174,7 @@ namespace TrenchBroom {
             if (m_rendererMismatches.count(spec) > 0)
                 return nullptr;
             
-            Renderer::TexturedIndexRangeRenderer* renderer = entityModel->buildRenderer(spec.skinIndex, spec.frameIndex);
+            Renderer::EntityModelMesh* renderer = entityModel->buildRenderer(spec.skinIndex, spec.frameIndex);
             if (renderer == nullptr) {
                 m_rendererMismatches.insert(spec);
                 
@@ -140,12 +203,66 @@ namespace TrenchBroom {
             return m_loader->loadEntityModel(path);
         }
 
+        void EntityModelManager::waitForModel(const IO::Path& path) const {
+            while (true) {
+                doCollectLoadedModels();
+                if (m_pendingModels.count(path) == 0)
+                    return;
+                
+                std::unique_lock<std::mutex> lock(m_loadedModelsMutex);
+                m_loadedModelsCondition.wait(lock, [this]() { return !m_loadedModels.empty(); });
+            }
+        }
+
+        void EntityModelManager::doCollectLoadedModels() const {
+            LoadedModelList loadedModels;
+            {
+                std::lock_guard<std::mutex> lock(m_loadedModelsMutex);
+                loadedModels.swap(m_loadedModels);
+            }
+            
+            for (const LoadedModel& loadedModel : loadedModels) {
+                m_pendingModels.erase(loadedModel.path);
+                if (loadedModel.model != nullptr) {
+                    m_models[loadedModel.path] = loadedModel.model;
+                    m_unpreparedModels.push_back(loadedModel.model);
+                    
+                    if (m_logger != nullptr)
+                        m_logger->debug("Loaded entity model %s", loadedModel.path.asString().c_str());
+                } else {
+                    m_modelMismatches.insert(loadedModel.path);
+                    
+                    if (m_logger != nullptr)
+                        m_logger->debug("Failed to load entity model %s: %s", loadedModel.path.asString().c_str(), loadedModel.error.c_str());
+                }
+                m_collectedModels = true;
+            }
+        }
+
+        void EntityModelManager::cancelLoading() {
+            m_cancelLoading = true;
+            for (std::future<void>& task : m_loadTasks)
+                task.wait();
+            m_loadTasks.clear();
+            m_cancelLoading = false;
+            
+            for (const LoadedModel& loadedModel : m_loadedModels)
+                delete loadedModel.model;
+            m_loadedModels.clear();
+            m_pendingModels.clear();
+            m_collectedModels = false;
+        }
+
         void EntityModelManager::prepare(Renderer::Vbo& vbo) {
             resetTextureMode();
             prepareModels();
             prepareRenderers(vbo);
         }
 
+        Renderer::EntityModelVertexArray& EntityModelManager::vertexArray() {
+            return m_vertexArray;
+        }
+
         void EntityModelManager::resetTextureMode() {
             if (m_resetTextureMode) {
                 for (const auto& entry : m_models) {
@@ -163,9 +280,10 @@ namespace TrenchBroom {
         }
         
         void EntityModelManager::prepareRenderers(Renderer::Vbo& vbo) {
-            for (Renderer::TexturedIndexRangeRenderer* renderer : m_unpreparedRenderers)
-                renderer->prepare(vbo);
+            for (Renderer::EntityModelMesh* renderer : m_unpreparedRenderers)
+                renderer->prepare(m_vertexArray);
             m_unpreparedRenderers.clear();
+            m_vertexArray.prepare(vbo);
         }
     }
 }
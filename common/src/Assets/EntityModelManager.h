@@ -20,11 +20,17 @@
 #ifndef TrenchBroom_EntityModelManager
 #define TrenchBroom_EntityModelManager
 
+#include "StringUtils.h"
 #include "Assets/ModelDefinition.h"
 #include "IO/Path.h"
 #include "Model/ModelTypes.h"
+#include "Renderer/EntityModelVertexArray.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <future>
 #include <map>
+#include <mutex>
 #include <set>
 #include <vector>
 
@@ -36,7 +42,7 @@ namespace TrenchBroom {
     }
     
     namespace Renderer {
-        class TexturedIndexRangeRenderer;
+        class EntityModelMesh;
         class Vbo;
     }
     
@@ -47,11 +53,19 @@ namespace TrenchBroom {
         private:
             typedef std::map<IO::Path, EntityModel*> ModelCache;
             typedef std::set<IO::Path> ModelMismatches;
+            typedef std::set<IO::Path> PendingModels;
             typedef std::vector<EntityModel*> ModelList;
             
-            typedef std::map<Assets::ModelSpecification, Renderer::TexturedIndexRangeRenderer*> RendererCache;
+            typedef std::map<Assets::ModelSpecification, Renderer::EntityModelMesh*> RendererCache;
             typedef std::set<Assets::ModelSpecification> RendererMismatches;
-            typedef std::vector<Renderer::TexturedIndexRangeRenderer*> RendererList;
+            typedef std::vector<Renderer::EntityModelMesh*> RendererList;
+
+            struct LoadedModel {
+                IO::Path path;
+                EntityModel* model;
+                String error;
+            };
+            typedef std::vector<LoadedModel> LoadedModelList;
             
             Logger* m_logger;
             const IO::EntityModelLoader* m_loader;
@@ -67,6 +81,20 @@ namespace TrenchBroom {
 
             mutable ModelList m_unpreparedModels;
             mutable RendererList m_unpreparedRenderers;
+
+            // holds the vertices of all renderers
+            Renderer::EntityModelVertexArray m_vertexArray;
+
+            // models that are being loaded in the background and have not been collected yet
+            mutable PendingModels m_pendingModels;
+            mutable bool m_collectedModels;
+            std::vector<std::future<void>> m_loadTasks;
+            std::atomic<bool> m_cancelLoading;
+
+            // guards the models that the background tasks have loaded
+            mutable std::mutex m_loadedModelsMutex;
+            mutable std::condition_variable m_loadedModelsCondition;
+            mutable LoadedModelList m_loadedModels;
         public:
             EntityModelManager(Logger* logger, int minFilter, int magFilter);
             ~EntityModelManager();
@@ -75,17 +103,49 @@ namespace TrenchBroom {
 
             void setTextureMode(int minFilter, int magFilter);
             void setLoader(const IO::EntityModelLoader* loader);
-            
+
+            /**
+             * Starts loading the models with the given paths in the background. Paths of models that are already
+             * loaded, are being loaded or failed to load are skipped.
+             */
+            void loadModels(const IO::Path::List& paths);
+
+            /**
+             * Takes over the models that have been loaded in the background. Must be called on the main thread.
+             *
+             * @return true if any models were taken over since the last call, including models that were taken over
+             * because they were requested directly
+             */
+            bool collectLoadedModels();
+
+            /**
+             * Returns the model with the given path, loading it if necessary. Waits for the model if it is being loaded
+             * in the background.
+             */
             EntityModel* model(const IO::Path& path) const;
             EntityModel* safeGetModel(const IO::Path& path) const;
-            Renderer::TexturedIndexRangeRenderer* renderer(const Assets::ModelSpecification& spec) const;
+            
+            /**
+             * Returns the renderer for the given model specification. Returns null without waiting if the model is
+             * still being loaded in the background.
+             */
+            Renderer::EntityModelMesh* renderer(const Assets::ModelSpecification& spec) const;
             
             bool hasModel(const Model::Entity* entity) const;
             bool hasModel(const Assets::ModelSpecification& spec) const;
         private:
             EntityModel* loadModel(const IO::Path& path) const;
+            void waitForModel(const IO::Path& path) const;
+            void doCollectLoadedModels() const;
+            void cancelLoading();
         public:
             void prepare(Renderer::Vbo& vbo);
+            
+            /**
+             * Returns the vertex array that holds the vertices of all prepared renderers. It must be set up before
+             * any of the renderers can be rendered.
+             */
+            Renderer::EntityModelVertexArray& vertexArray();
         private:
             void resetTextureMode();
             void prepareModels();
@@ -18,13 +18,11 @@
  */
 
 #include "Md2Model.h"
-#include "CollectionUtils.h"
 #include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
-#include "Renderer/VertexArray.h"
 #include "Renderer/IndexRangeMap.h"
 #include "Renderer/TexturedIndexRangeMap.h"
-#include "Renderer/TexturedIndexRangeRenderer.h"
+#include "Renderer/EntityModelMesh.h"
 
 #include <cassert>
 #include <algorithm>
@@ -60,49 +58,47 @@ namespace TrenchBroom {
             return m_bounds;
         }
 
-        Md2Model::Md2Model(const String& name, const TextureList& skins, const FrameList& frames) :
+        Md2Model::Md2Model(const String& name, const TextureList& skins, const size_t frameCount, const FrameDecoder& decoder) :
         m_name(name),
         m_skins(new TextureCollection(IO::Path(name), skins)),
-        m_frames(frames) {}
+        m_frameCount(frameCount),
+        m_decoder(decoder),
+        m_frames(FrameCacheSize) {}
         
         Md2Model::~Md2Model() {
-            VectorUtils::clearAndDelete(m_frames);
             delete m_skins;
             m_skins = nullptr;
         }
 
-        Renderer::TexturedIndexRangeRenderer* Md2Model::doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const {
+        Md2Model::FrameCache::ValuePtr Md2Model::frame(const size_t frameIndex) const {
+            ensure(frameIndex < m_frameCount, "frame index out of range");
+            return m_frames.get(frameIndex, m_decoder);
+        }
+
+        Renderer::EntityModelMesh* Md2Model::doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const {
             const TextureList& textures = m_skins->textures();
             
             ensure(skinIndex < textures.size(), "skin index out of range");
-            ensure(frameIndex < m_frames.size(), "frame index out of range");
 
             const Assets::Texture* skin = textures[skinIndex];
-            const Frame* frame = m_frames[frameIndex];
+            const FrameCache::ValuePtr frame = this->frame(frameIndex);
             
-            const VertexList& vertices = frame->vertices();
+            // the frame may be dropped from the cache before the mesh is prepared
+            VertexList vertices = frame->vertices();
             const Renderer::IndexRangeMap& indices = frame->indices();
             
-            const Renderer::VertexArray vertexArray = Renderer::VertexArray::ref(vertices);
             const Renderer::TexturedIndexRangeMap texturedIndices(skin, indices);
-            
-            return new Renderer::TexturedIndexRangeRenderer(vertexArray, texturedIndices);
+            return new Renderer::EntityModelMesh(vertices, texturedIndices);
         }
         
         BBox3f Md2Model::doGetBounds(const size_t skinIndex, const size_t frameIndex) const {
             ensure(skinIndex < m_skins->textures().size(), "skin index out of range");
-            ensure(frameIndex < m_frames.size(), "frame index out of range");
-            
-            const Frame* frame = m_frames[frameIndex];
-            return frame->bounds();
+            return frame(frameIndex)->bounds();
         }
         
         BBox3f Md2Model::doGetTransformedBounds(const size_t skinIndex, const size_t frameIndex, const Mat4x4f& transformation) const {
             ensure(skinIndex < m_skins->textures().size(), "skin index out of range");
-            ensure(frameIndex < m_frames.size(), "frame index out of range");
-            
-            const Frame* frame = m_frames[frameIndex];
-            return frame->transformedBounds(transformation);
+            return frame(frameIndex)->transformedBounds(transformation);
         }
 
         void Md2Model::doPrepare(const int minFilter, const int magFilter) {
@@ -22,12 +22,13 @@
 
 #include "Assets/AssetTypes.h"
 #include "Assets/EntityModel.h"
+#include "LruCache.h"
 #include "StringUtils.h"
 #include "VecMath.h"
 #include "Renderer/VertexSpec.h"
 #include "Renderer/IndexRangeMap.h"
 
-#include <vector>
+#include <functional>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -35,7 +36,7 @@ namespace TrenchBroom {
         
         class Md2Model : public EntityModel {
         public:
-            typedef Renderer::VertexSpecs::P3NT2 VertexSpec;
+            typedef Renderer::VertexSpecs::P3T2 VertexSpec;
             typedef VertexSpec::Vertex Vertex;
             typedef Vertex::List VertexList;
             
@@ -53,16 +54,30 @@ namespace TrenchBroom {
                 const BBox3f& bounds() const;
             };
 
-            typedef std::vector<Frame*> FrameList;
+            /**
+             * Decodes the frame with the given index from the model file.
+             */
+            typedef std::function<Frame*(size_t)> FrameDecoder;
         private:
+            typedef LruCache<size_t, Frame> FrameCache;
+            static const size_t FrameCacheSize = 4;
+            
             String m_name;
             TextureCollection* m_skins;
-            FrameList m_frames;
+            size_t m_frameCount;
+            FrameDecoder m_decoder;
+            mutable FrameCache m_frames;
         public:
-            Md2Model(const String& name, const TextureList& skins, const FrameList& frames);
+            /**
+             * Creates a model whose frames are decoded when they are first used. Only the frames that were used
+             * most recently are kept in memory.
+             */
+            Md2Model(const String& name, const TextureList& skins, size_t frameCount, const FrameDecoder& decoder);
             ~Md2Model() override;
         private:
-            Renderer::TexturedIndexRangeRenderer* doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const override;
+            FrameCache::ValuePtr frame(size_t frameIndex) const;
+
+            Renderer::EntityModelMesh* doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const override;
             BBox3f doGetBounds(const size_t skinIndex, const size_t frameIndex) const override;
             BBox3f doGetTransformedBounds(const size_t skinIndex, const size_t frameIndex, const Mat4x4f& transformation) const override;
             void doPrepare(int minFilter, int magFilter) override;
@@ -24,7 +24,7 @@
 #include "Assets/Texture.h"
 #include "Renderer/TexturedIndexRangeMap.h"
 #include "Renderer/TexturedIndexRangeMapBuilder.h"
-#include "Renderer/TexturedIndexRangeRenderer.h"
+#include "Renderer/EntityModelMesh.h"
 
 #include <cassert>
 
@@ -53,17 +53,11 @@ namespace TrenchBroom {
             return m_textures.textures().front();
         }
 
-        MdlBaseFrame::~MdlBaseFrame() {}
-
         MdlFrame::MdlFrame(const String& name, const VertexList& triangles, const BBox3f& bounds) :
         m_name(name),
         m_triangles(triangles),
         m_bounds(bounds) {}
         
-        const MdlFrame* MdlFrame::firstFrame() const {
-            return this;
-        }
-
         const MdlFrame::VertexList& MdlFrame::triangles() const {
             return m_triangles;
         }
@@ -91,67 +85,60 @@ namespace TrenchBroom {
             return bounds;
         }
 
-        MdlFrameGroup::~MdlFrameGroup() {
-            VectorUtils::clearAndDelete(m_frames);
-        }
-        
-        const MdlFrame* MdlFrameGroup::firstFrame() const {
-            if (m_frames.empty())
-                return nullptr;
-            return m_frames[0]->firstFrame();
-        }
-        
-        void MdlFrameGroup::addFrame(MdlFrame* frame, const float time) {
-            m_frames.push_back(frame);
-            m_times.push_back(time);
-        }
-
         MdlModel::MdlModel(const String& name) :
-        m_name(name) {}
+        m_name(name),
+        m_frameCount(0),
+        m_frames(FrameCacheSize) {}
 
         MdlModel::~MdlModel() {
             VectorUtils::clearAndDelete(m_skins);
-            VectorUtils::clearAndDelete(m_frames);
         }
 
         void MdlModel::addSkin(MdlSkin* skin) {
             m_skins.push_back(skin);
         }
 
-        void MdlModel::addFrame(MdlBaseFrame* frame) {
-            m_frames.push_back(frame);
+        void MdlModel::setFrames(const size_t frameCount, const FrameDecoder& decoder) {
+            m_frameCount = frameCount;
+            m_decoder = decoder;
+            m_frames.clear();
+        }
+
+        MdlModel::FrameCache::ValuePtr MdlModel::frame(const size_t frameIndex) const {
+            if (frameIndex >= m_frameCount)
+                return FrameCache::ValuePtr();
+            return m_frames.get(frameIndex, m_decoder);
         }
 
-        Renderer::TexturedIndexRangeRenderer* MdlModel::doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const {
+        Renderer::EntityModelMesh* MdlModel::doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const {
             if (skinIndex >= m_skins.size())
                 return nullptr;
-            if (frameIndex >= m_frames.size())
+            
+            const FrameCache::ValuePtr frame = this->frame(frameIndex);
+            if (frame == nullptr)
                 return nullptr;
             
             const MdlSkin* skin = m_skins[skinIndex];
-            const MdlFrame* frame = m_frames[frameIndex]->firstFrame();
-
             const Assets::Texture* texture = skin->firstPicture();
-            const MdlFrame::VertexList& vertices = frame->triangles();
+            // the frame may be dropped from the cache before the mesh is prepared
+            MdlFrame::VertexList vertices = frame->triangles();
             const size_t vertexCount = vertices.size();
             
-            const Renderer::VertexArray vertexArray = Renderer::VertexArray::ref(vertices);
             const Renderer::TexturedIndexRangeMap indexArray(texture, GL_TRIANGLES, 0, vertexCount);
-            
-            return new Renderer::TexturedIndexRangeRenderer(vertexArray, indexArray);
+            return new Renderer::EntityModelMesh(vertices, indexArray);
         }
 
         BBox3f MdlModel::doGetBounds(const size_t skinIndex, const size_t frameIndex) const {
-            if (frameIndex >= m_frames.size())
+            const FrameCache::ValuePtr frame = this->frame(frameIndex);
+            if (frame == nullptr)
                 return BBox3f(-8.0f, 8.0f);
-            const MdlFrame* frame = m_frames[frameIndex]->firstFrame();
             return frame->bounds();
         }
 
         BBox3f MdlModel::doGetTransformedBounds(const size_t skinIndex, const size_t frameIndex, const Mat4x4f& transformation) const {
-            if (frameIndex >= m_frames.size())
+            const FrameCache::ValuePtr frame = this->frame(frameIndex);
+            if (frame == nullptr)
                 return BBox3f(-8.0f, 8.0f);
-            const MdlFrame* frame = m_frames[frameIndex]->firstFrame();
             return frame->transformedBounds(transformation);
         }
 
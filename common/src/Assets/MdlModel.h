@@ -20,6 +20,7 @@
 #ifndef TrenchBroom_MdlModel
 #define TrenchBroom_MdlModel
 
+#include "LruCache.h"
 #include "VecMath.h"
 #include "StringUtils.h"
 #include "Assets/AssetTypes.h"
@@ -29,6 +30,7 @@
 #include "Renderer/Vertex.h"
 #include "Renderer/IndexRangeMap.h"
 
+#include <functional>
 #include <vector>
 
 namespace TrenchBroom {
@@ -48,15 +50,7 @@ namespace TrenchBroom {
             const Texture* firstPicture() const;
         };
 
-        class MdlFrame;
-        
-        class MdlBaseFrame {
-        public:
-            virtual ~MdlBaseFrame();
-            virtual const MdlFrame* firstFrame() const = 0;
-        };
-        
-        class MdlFrame : public MdlBaseFrame {
+        class MdlFrame {
         public:
             typedef Renderer::VertexSpecs::P3T2::Vertex Vertex;
             typedef Vertex::List VertexList;
@@ -66,40 +60,43 @@ namespace TrenchBroom {
             BBox3f m_bounds;
         public:
             MdlFrame(const String& name, const VertexList& triangles, const BBox3f& bounds);
-            const MdlFrame* firstFrame() const override;
             const VertexList& triangles() const;
             BBox3f bounds() const;
             BBox3f transformedBounds(const Mat4x4f& transformation) const;
         };
         
-        class MdlFrameGroup : public MdlBaseFrame {
-        private:
-            typedef std::vector<MdlFrame*> SingleFrameList;
-            
-            MdlTimeList m_times;
-            SingleFrameList m_frames;
-        public:
-            ~MdlFrameGroup() override;
-            const MdlFrame* firstFrame() const override;
-            void addFrame(MdlFrame* frame, const float time);
-        };
-        
         class MdlModel : public EntityModel {
+        public:
+            /**
+             * Decodes the frame with the given index from the model file. For frame groups, only the first frame of
+             * the group is decoded. Returns null if the frame group is empty.
+             */
+            typedef std::function<MdlFrame*(size_t)> FrameDecoder;
         private:
             typedef std::vector<MdlSkin*> MdlSkinList;
-            typedef std::vector<MdlBaseFrame*> MdlFrameList;
+            typedef LruCache<size_t, MdlFrame> FrameCache;
+            static const size_t FrameCacheSize = 4;
             
             String m_name;
             MdlSkinList m_skins;
-            MdlFrameList m_frames;
+            size_t m_frameCount;
+            FrameDecoder m_decoder;
+            mutable FrameCache m_frames;
         public:
             explicit MdlModel(const String& name);
             ~MdlModel() override;
             
             void addSkin(MdlSkin* skin);
-            void addFrame(MdlBaseFrame* frame);
+
+            /**
+             * Sets the number of frames and the decoder that decodes them when they are first used. Only the frames
+             * that were used most recently are kept in memory.
+             */
+            void setFrames(size_t frameCount, const FrameDecoder& decoder);
         private:
-            Renderer::TexturedIndexRangeRenderer* doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const override;
+            FrameCache::ValuePtr frame(size_t frameIndex) const;
+
+            Renderer::EntityModelMesh* doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const override;
             BBox3f doGetBounds(const size_t skinIndex, const size_t frameIndex) const override;
             BBox3f doGetTransformedBounds(const size_t skinIndex, const size_t frameIndex, const Mat4x4f& transformation) const override;
             void doPrepare(int minFilter, int magFilter) override;
@@ -28,18 +28,104 @@
 #include <cstring>
 #include <fstream>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TB_PALETTE_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace TrenchBroom {
     namespace Assets {
+        // the channel sums are accumulated in 16 bit lanes, each of which receives two colors per four pixels
+        static const size_t AccumulatorBlockSize = 4 * (0xFFFF / (2 * 0xFF));
+        
         Palette::Data::Data(const size_t size, unsigned char* data) :
         m_size(size),
         m_data(data) {
             ensure(m_size > 0, "size is 0");
             ensure(m_data != nullptr, "data is null");
+            
+            // colors missing from short palettes are black
+            std::fill(std::begin(m_colors), std::end(m_colors), 0);
+            for (size_t i = 0; i < 256 && 3 * i + 2 < m_size; ++i) {
+                for (size_t j = 0; j < 3; ++j)
+                    m_colors[4 * i + j] = m_data[3 * i + j];
+            }
         }
         
         Palette::Data::~Data() {
             delete [] m_data;
         }
+        
+        static Color averageOfChannelSums(const uint64_t channelSums[3], const size_t pixelCount) {
+            Color result(0.0f, 0.0f, 0.0f, 1.0f);
+            if (pixelCount > 0) {
+                for (size_t i = 0; i < 3; ++i)
+                    result[i] = static_cast<float>(static_cast<double>(channelSums[i]) / pixelCount / 0xFF);
+            }
+            return result;
+        }
+
+        void Palette::Data::indexedToRgb(const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbImage, Color* averageColor) const {
+            uint64_t channelSums[3];
+            convert<true>(indexedImage, pixelCount, rgbImage, channelSums);
+            if (averageColor != nullptr)
+                *averageColor = averageOfChannelSums(channelSums, pixelCount);
+        }
+        
+        Color Palette::Data::averageColor(const unsigned char* indexedImage, const size_t pixelCount) const {
+            uint64_t channelSums[3];
+            convert<false>(indexedImage, pixelCount, nullptr, channelSums);
+            return averageOfChannelSums(channelSums, pixelCount);
+        }
+        
+        template <bool StoreColors>
+        void Palette::Data::convert(const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbImage, uint64_t channelSums[3]) const {
+            channelSums[0] = channelSums[1] = channelSums[2] = 0;
+            if (pixelCount == 0)
+                return;
+            
+            // Every pixel is written as four bytes, the last of which is overwritten by the next pixel. The last
+            // pixel must not write past the end of the image, so it is always converted by the scalar loop below.
+            const size_t last = pixelCount - 1;
+            size_t i = 0;
+            
+#ifdef TB_PALETTE_SSE2
+            const __m128i zero = _mm_setzero_si128();
+            while (i + 4 <= last) {
+                const size_t blockEnd = std::min(i + AccumulatorBlockSize, last);
+                
+                // holds the sums of two interleaved colors: r g b x r g b x
+                __m128i sums = zero;
+                for (; i + 4 <= blockEnd; i += 4) {
+                    uint32_t colors[4];
+                    for (size_t j = 0; j < 4; ++j)
+                        std::memcpy(&colors[j], m_colors + 4 * indexedImage[i + j], 4);
+                    if (StoreColors) {
+                        for (size_t j = 0; j < 4; ++j)
+                            std::memcpy(rgbImage + 3 * (i + j), &colors[j], 4);
+                    }
+                    
+                    const __m128i packed = _mm_set_epi32(static_cast<int>(colors[3]), static_cast<int>(colors[2]),
+                                                         static_cast<int>(colors[1]), static_cast<int>(colors[0]));
+                    sums = _mm_add_epi16(sums, _mm_unpacklo_epi8(packed, zero));
+                    sums = _mm_add_epi16(sums, _mm_unpackhi_epi8(packed, zero));
+                }
+                
+                uint16_t blockSums[8];
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(blockSums), sums);
+                for (size_t j = 0; j < 3; ++j)
+                    channelSums[j] += static_cast<uint64_t>(blockSums[j]) + static_cast<uint64_t>(blockSums[j + 4]);
+            }
+#endif
+            
+            for (; i < pixelCount; ++i) {
+                const unsigned char* color = m_colors + 4 * indexedImage[i];
+                if (StoreColors)
+                    std::memcpy(rgbImage + 3 * i, color, i < last ? 4 : 3);
+                for (size_t j = 0; j < 3; ++j)
+                    channelSums[j] += color[j];
+            }
+        }
 
         Palette::Palette(const size_t size, unsigned char* data) :
         m_data(new Data(size, data)) {}
@@ -26,6 +26,12 @@
 
 #include <cassert>
 
+#ifdef _MSC_VER
+#include <cstdint>
+#elif defined __GNUC__
+#include <stdint.h>
+#endif
+
 namespace TrenchBroom {
     namespace IO {
         class FileSystem;
@@ -39,33 +45,21 @@ namespace TrenchBroom {
             private:
                 size_t m_size;
                 unsigned char* m_data;
+                
+                /**
+                 * The 256 palette colors padded to four bytes each, so that every color can be copied with a single
+                 * 32 bit load and store.
+                 */
+                unsigned char m_colors[256 * 4];
             public:
                 Data(const size_t size, unsigned char* data);
                 ~Data();
 
-                template <typename IndexT, typename ColorT>
-                void indexedToRgb(const Buffer<IndexT>& indexedImage, const size_t pixelCount, Buffer<ColorT>& rgbImage, Color& averageColor) const {
-                    indexedToRgb(&indexedImage[0], pixelCount, rgbImage, averageColor);
-                }
-                
-                template <typename IndexT, typename ColorT>
-                void indexedToRgb(const IndexT* indexedImage, const size_t pixelCount, Buffer<ColorT>& rgbImage, Color& averageColor) const {
-                    double avg[3];
-                    avg[0] = avg[1] = avg[2] = 0.0;
-                    for (size_t i = 0; i < pixelCount; ++i) {
-                        const size_t index = static_cast<size_t>(static_cast<unsigned char>(indexedImage[i]));
-                        assert(index < m_size);
-                        for (size_t j = 0; j < 3; ++j) {
-                            const unsigned char c = m_data[index * 3 + j];
-                            rgbImage[i * 3 + j] = c;
-                            avg[j] += static_cast<double>(c);
-                        }
-                    }
-                    
-                    for (size_t i = 0; i < 3; ++i)
-                        averageColor[i] = static_cast<float>(avg[i] / pixelCount / 0xFF);
-                    averageColor[3] = 1.0f;
-                }
+                void indexedToRgb(const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbImage, Color* averageColor) const;
+                Color averageColor(const unsigned char* indexedImage, const size_t pixelCount) const;
+            private:
+                template <bool StoreColors>
+                void convert(const unsigned char* indexedImage, const size_t pixelCount, unsigned char* rgbImage, uint64_t channelSums[3]) const;
             };
             
             typedef std::shared_ptr<Data> DataPtr;
@@ -77,14 +71,38 @@ namespace TrenchBroom {
             static Palette loadLmp(IO::MappedFile::Ptr file);
             static Palette loadPcx(IO::MappedFile::Ptr file);
             
+            /**
+             * Converts the given indexed image to RGB and computes its average color in the same pass.
+             */
             template <typename IndexT, typename ColorT>
             void indexedToRgb(const Buffer<IndexT>& indexedImage, const size_t pixelCount, Buffer<ColorT>& rgbImage, Color& averageColor) const {
-                m_data->indexedToRgb(indexedImage, pixelCount, rgbImage, averageColor);
+                indexedToRgb(indexedImage.ptr(), pixelCount, rgbImage, averageColor);
             }
             
             template <typename IndexT, typename ColorT>
             void indexedToRgb(const IndexT* indexedImage, const size_t pixelCount, Buffer<ColorT>& rgbImage, Color& averageColor) const {
-                m_data->indexedToRgb(indexedImage, pixelCount, rgbImage, averageColor);
+                static_assert(sizeof(IndexT) == 1 && sizeof(ColorT) == 1, "indices and color components must be bytes");
+                assert(rgbImage.size() >= 3 * pixelCount);
+                m_data->indexedToRgb(reinterpret_cast<const unsigned char*>(indexedImage), pixelCount, reinterpret_cast<unsigned char*>(rgbImage.ptr()), &averageColor);
+            }
+            
+            /**
+             * Converts the given indexed image to RGB without computing its average color.
+             */
+            template <typename IndexT, typename ColorT>
+            void indexedToRgb(const IndexT* indexedImage, const size_t pixelCount, Buffer<ColorT>& rgbImage) const {
+                static_assert(sizeof(IndexT) == 1 && sizeof(ColorT) == 1, "indices and color components must be bytes");
+                assert(rgbImage.size() >= 3 * pixelCount);
+                m_data->indexedToRgb(reinterpret_cast<const unsigned char*>(indexedImage), pixelCount, reinterpret_cast<unsigned char*>(rgbImage.ptr()), nullptr);
+            }
+            
+            /**
+             * Returns the average color of the given indexed image without converting it.
+             */
+            template <typename IndexT>
+            Color averageColor(const IndexT* indexedImage, const size_t pixelCount) const {
+                static_assert(sizeof(IndexT) == 1, "indices must be bytes");
+                return m_data->averageColor(reinterpret_cast<const unsigned char*>(indexedImage), pixelCount);
             }
         };
     }
@@ -20,8 +20,10 @@
 #include "Texture.h"
 #include "Assets/ImageUtils.h"
 #include "Assets/TextureCollection.h"
+#include "Assets/TextureCompression.h"
 
 #include <cassert>
+#include <cstring>
 
 namespace TrenchBroom {
     namespace Assets {
@@ -33,6 +35,17 @@ namespace TrenchBroom {
                 buffers[i] = Assets::TextureBuffer(size);
             }
         }
+        
+        size_t mipBufferSize(const size_t width, const size_t height, const GLenum format, const size_t level) {
+            // mip sizes are halved without clamping to match Texture::upload
+            const size_t mipWidth = width >> level;
+            const size_t mipHeight = height >> level;
+            if (isCompressed(format))
+                return compressedImageSize(mipWidth, mipHeight, format);
+            
+            const size_t bytesPerPixel = format == GL_RGBA || format == GL_BGRA ? 4 : 3;
+            return mipWidth * mipHeight * bytesPerPixel;
+        }
 
         Texture::Texture(const String& name, const size_t width, const size_t height, const Color& averageColor, const TextureBuffer& buffer, const GLenum format) :
         m_collection(nullptr),
@@ -43,7 +56,10 @@ namespace TrenchBroom {
         m_usageCount(0),
         m_overridden(false),
         m_format(format),
-        m_textureId(0) {
+        m_minFilter(GL_NEAREST_MIPMAP_NEAREST),
+        m_magFilter(GL_NEAREST),
+        m_textureId(0),
+        m_lastActivation(0) {
             assert(m_width > 0);
             assert(m_height > 0);
             assert(buffer.size() >= m_width * m_height * 3);
@@ -59,8 +75,11 @@ namespace TrenchBroom {
         m_usageCount(0),
         m_overridden(false),
         m_format(format),
+        m_minFilter(GL_NEAREST_MIPMAP_NEAREST),
+        m_magFilter(GL_NEAREST),
         m_textureId(0),
-        m_buffers(buffers) {
+        m_buffers(buffers),
+        m_lastActivation(0) {
             assert(m_width > 0);
             assert(m_height > 0);
             for (size_t i = 0; i < m_buffers.size(); ++i) {
@@ -68,6 +87,25 @@ namespace TrenchBroom {
             }
         }
         
+        Texture::Texture(const String& name, const size_t width, const size_t height, const Color& averageColor, const TextureDecoder& decoder, const GLenum format) :
+        m_collection(nullptr),
+        m_name(name),
+        m_width(width),
+        m_height(height),
+        m_averageColor(averageColor),
+        m_usageCount(0),
+        m_overridden(false),
+        m_format(format),
+        m_minFilter(GL_NEAREST_MIPMAP_NEAREST),
+        m_magFilter(GL_NEAREST),
+        m_decoder(decoder),
+        m_textureId(0),
+        m_lastActivation(0) {
+            assert(m_width > 0);
+            assert(m_height > 0);
+            assert(m_decoder);
+        }
+        
         Texture::Texture(const String& name, const size_t width, const size_t height, const GLenum format) :
         m_collection(nullptr),
         m_name(name),
@@ -77,10 +115,14 @@ namespace TrenchBroom {
         m_usageCount(0),
         m_overridden(false),
         m_format(format),
-        m_textureId(0) {}
+        m_minFilter(GL_NEAREST_MIPMAP_NEAREST),
+        m_magFilter(GL_NEAREST),
+        m_textureId(0),
+        m_lastActivation(0) {}
 
         Texture::~Texture() {
-            if (m_collection == nullptr && m_textureId != 0)
+            // lazy textures create their own texture objects, the others are owned by their collection, if any
+            if ((m_collection == nullptr || lazy()) && m_textureId != 0)
                 glAssert(glDeleteTextures(1, &m_textureId));
             m_textureId = 0;
         }
@@ -101,6 +143,27 @@ namespace TrenchBroom {
             return m_averageColor;
         }
         
+        GLenum Texture::format() const {
+            return m_format;
+        }
+
+        int Texture::minFilter() const {
+            return m_minFilter;
+        }
+
+        int Texture::magFilter() const {
+            return m_magFilter;
+        }
+        
+        const TextureBuffer::List& Texture::buffers() const {
+            return m_buffers;
+        }
+        
+        TextureBuffer::List Texture::decode() const {
+            assert(lazy());
+            return m_decoder();
+        }
+        
         size_t Texture::usageCount() const {
             return m_usageCount;
         }
@@ -126,6 +189,10 @@ namespace TrenchBroom {
             m_overridden = overridden;
         }
         
+        bool Texture::lazy() const {
+            return static_cast<bool>(m_decoder);
+        }
+        
         bool Texture::isPrepared() const {
             return m_textureId != 0;
         }
@@ -134,6 +201,95 @@ namespace TrenchBroom {
             assert(textureId > 0);
             assert(!m_buffers.empty());
             
+            m_minFilter = minFilter;
+            m_magFilter = magFilter;
+            upload(textureId);
+            m_textureId = textureId;
+        }
+        
+        void Texture::setMode(const int minFilter, const int magFilter) {
+            m_minFilter = minFilter;
+            m_magFilter = magFilter;
+            
+            // a lazy texture that has not been uploaded yet will use the new mode when it is uploaded
+            if (isPrepared()) {
+                activate();
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
+                glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
+                deactivate();
+            }
+        }
+        
+        void Texture::compress() {
+            if (!isCompressible(m_format) || isPrepared())
+                return;
+            
+            // encoding is far too slow to repeat whenever the texture is uploaded, so a lazy texture is decoded once
+            // and keeps the compressed buffers instead of its decoder
+            if (lazy()) {
+                m_buffers = decode();
+                m_decoder = TextureDecoder();
+            }
+            if (m_buffers.empty())
+                return;
+            
+            m_buffers = compressMips(m_buffers, m_width, m_height, m_format);
+            m_format = compressedFormat(m_format);
+        }
+        
+        void Texture::evict() {
+            if (lazy() && isPrepared()) {
+                glAssert(glDeleteTextures(1, &m_textureId));
+                m_textureId = 0;
+            }
+        }
+
+        static size_t activationCount = 0;
+
+        size_t Texture::lastActivation() const {
+            return m_lastActivation;
+        }
+
+        void Texture::activate() const {
+            if (!isPrepared() && lazy()) {
+                m_buffers = decode();
+                
+                GLuint textureId;
+                glAssert(glGenTextures(1, &textureId));
+                upload(textureId);
+                m_textureId = textureId;
+                
+                if (m_collection != nullptr)
+                    m_collection->textureWasUploaded();
+            }
+            
+            m_lastActivation = ++activationCount;
+            assert(isPrepared());
+            glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
+        }
+        
+        void Texture::deactivate() const {
+            glAssert(glBindTexture(GL_TEXTURE_2D, 0));
+        }
+        
+        static bool compressedTexturesSupported() {
+            static const bool supported = []() {
+                const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+                return extensions != nullptr && std::strstr(extensions, "GL_EXT_texture_compression_s3tc") != nullptr;
+            }();
+            return supported;
+        }
+
+        void Texture::upload(const GLuint textureId) const {
+            assert(!m_buffers.empty());
+            
+            // fall back to uncompressed images if the GL implementation cannot handle compressed ones
+            GLenum format = m_format;
+            if (isCompressed(m_format) && !compressedTexturesSupported()) {
+                m_buffers = decompressMips(m_buffers, m_width, m_height, m_format);
+                format = GL_RGBA;
+            }
+            
             glAssert(glPixelStorei(GL_UNPACK_SWAP_BYTES, false));
             glAssert(glPixelStorei(GL_UNPACK_LSB_FIRST, false));
             glAssert(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
@@ -143,8 +299,8 @@ namespace TrenchBroom {
             
             glAssert(glBindTexture(GL_TEXTURE_2D, textureId));
             glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_buffers.size() - 1)));
-            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
-            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_minFilter));
+            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, m_magFilter));
             glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT));
             glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT));
             
@@ -160,32 +316,22 @@ namespace TrenchBroom {
             size_t mipHeight = m_height; //potHeight;
             for (size_t j = 0; j < m_buffers.size(); ++j) {
                 const GLvoid* data = reinterpret_cast<const GLvoid*>(m_buffers[j].ptr());
-                glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
-                                      static_cast<GLsizei>(mipWidth),
-                                      static_cast<GLsizei>(mipHeight),
-                                      0, m_format, GL_UNSIGNED_BYTE, data));
+                if (isCompressed(format)) {
+                    glAssert(glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), format,
+                                                    static_cast<GLsizei>(mipWidth),
+                                                    static_cast<GLsizei>(mipHeight),
+                                                    0, static_cast<GLsizei>(m_buffers[j].size()), data));
+                } else {
+                    glAssert(glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(j), GL_RGBA,
+                                          static_cast<GLsizei>(mipWidth),
+                                          static_cast<GLsizei>(mipHeight),
+                                          0, format, GL_UNSIGNED_BYTE, data));
+                }
                 mipWidth  /= 2;
                 mipHeight /= 2;
             }
             
             m_buffers.clear();
-            m_textureId = textureId;
-        }
-        
-        void Texture::setMode(const int minFilter, const int magFilter) {
-            activate();
-            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter));
-            glAssert(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter));
-            deactivate();
-        }
-
-        void Texture::activate() const {
-            assert(isPrepared());
-            glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
-        }
-        
-        void Texture::deactivate() const {
-            glAssert(glBindTexture(GL_TEXTURE_2D, 0));
         }
 
         void Texture::setCollection(TextureCollection* collection) {
@@ -26,6 +26,7 @@
 #include "Renderer/GL.h"
 
 #include <cassert>
+#include <functional>
 #include <vector>
 
 namespace TrenchBroom {
@@ -35,6 +36,16 @@ namespace TrenchBroom {
         typedef Buffer<unsigned char> TextureBuffer;
         void setMipBufferSize(TextureBuffer::List& buffers, const size_t width, const size_t height);
         
+        /**
+         * Returns the number of bytes of the given mip level of a texture with the given size and pixel format.
+         */
+        size_t mipBufferSize(size_t width, size_t height, GLenum format, size_t level);
+        
+        /**
+         * Decodes the mip buffers of a texture whose image data is only read when the texture is first used.
+         */
+        typedef std::function<TextureBuffer::List()> TextureDecoder;
+        
         class Texture {
         private:
             TextureCollection* m_collection;
@@ -48,12 +59,21 @@ namespace TrenchBroom {
             bool m_overridden;
 
             GLenum m_format;
+            int m_minFilter;
+            int m_magFilter;
 
+            TextureDecoder m_decoder;
             mutable GLuint m_textureId;
             mutable TextureBuffer::List m_buffers;
+            mutable size_t m_lastActivation;
         public:
             Texture(const String& name, const size_t width, const size_t height, const Color& averageColor, const TextureBuffer& buffer, GLenum format = GL_RGB);
             Texture(const String& name, const size_t width, const size_t height, const Color& averageColor, const TextureBuffer::List& buffers, GLenum format = GL_RGB);
+            
+            /**
+             * Creates a texture that is decoded by the given decoder and uploaded when it is first activated.
+             */
+            Texture(const String& name, const size_t width, const size_t height, const Color& averageColor, const TextureDecoder& decoder, GLenum format = GL_RGB);
             Texture(const String& name, const size_t width, const size_t height, GLenum format = GL_RGB);
             ~Texture();
 
@@ -62,6 +82,19 @@ namespace TrenchBroom {
             size_t width() const;
             size_t height() const;
             const Color& averageColor() const;
+            GLenum format() const;
+            int minFilter() const;
+            int magFilter() const;
+            
+            /**
+             * Returns the mip buffers of this texture. The buffers are only available until the texture is uploaded.
+             */
+            const TextureBuffer::List& buffers() const;
+            
+            /**
+             * Decodes the mip buffers of a lazy texture without uploading it.
+             */
+            TextureBuffer::List decode() const;
 
             size_t usageCount() const;
             void incUsageCount();
@@ -69,13 +102,35 @@ namespace TrenchBroom {
             bool overridden() const;
             void setOverridden(const bool overridden);
 
+            bool lazy() const;
             bool isPrepared() const;
             void prepare(GLuint textureId, int minFilter, int magFilter);
             void setMode(int minFilter, int magFilter);
 
+            /**
+             * Compresses the mip buffers of this texture to reduce the memory that it occupies until and after it is
+             * uploaded. A lazy texture is decoded and compressed right away and is no longer lazy afterwards, so its
+             * collection can store the compressed buffers in the texture cache. Has no effect if the texture has
+             * already been uploaded or if its format cannot be compressed.
+             */
+            void compress();
+            
+            /**
+             * Releases the texture object of a lazy texture. The texture is decoded and uploaded again when it is
+             * activated the next time.
+             */
+            void evict();
+
+            /**
+             * Returns a stamp that increases with every activation of any texture, so that the textures which have
+             * been activated least recently can be evicted first.
+             */
+            size_t lastActivation() const;
+
             void activate() const;
             void deactivate() const;
         private:
+            void upload(GLuint textureId) const;
             void setCollection(TextureCollection* collection);
             friend class TextureCollection;
         };
@@ -26,23 +26,31 @@ namespace TrenchBroom {
     namespace Assets {
         TextureCollection::TextureCollection() :
         m_loaded(false),
-        m_usageCount(0) {}
+        m_usageCount(0),
+        m_prepared(false),
+        m_hasNewUploads(false) {}
         
         TextureCollection::TextureCollection(const TextureList& textures) :
         m_loaded(false),
-        m_usageCount(0) {
+        m_usageCount(0),
+        m_prepared(false),
+        m_hasNewUploads(false) {
             addTextures(textures);
         }
 
         TextureCollection::TextureCollection(const IO::Path& path) :
         m_loaded(false),
         m_path(path),
-        m_usageCount(0) {}
+        m_usageCount(0),
+        m_prepared(false),
+        m_hasNewUploads(false) {}
 
         TextureCollection::TextureCollection(const IO::Path& path, const TextureList& textures) :
         m_loaded(true),
         m_path(path),
-        m_usageCount(0) {
+        m_usageCount(0),
+        m_prepared(false),
+        m_hasNewUploads(false) {
             addTextures(textures);
         }
 
@@ -90,21 +98,34 @@ namespace TrenchBroom {
         }
 
         bool TextureCollection::prepared() const {
-            return !m_textureIds.empty();
+            return m_prepared;
         }
 
         void TextureCollection::prepare(const int minFilter, const int magFilter) {
             assert(!prepared());
             
-            const size_t textureCount = m_textures.size();
-            m_textureIds.resize(textureCount);
-            glAssert(glGenTextures(static_cast<GLsizei>(textureCount),
-                                   static_cast<GLuint*>(&m_textureIds.front())));
-
-            for (size_t i = 0; i < textureCount; ++i) {
-                Texture* texture = m_textures[i];
-                texture->prepare(m_textureIds[i], minFilter, magFilter);
+            // lazy textures create their texture objects when they are first activated
+            TextureList eagerTextures;
+            for (Texture* texture : m_textures) {
+                if (texture->lazy())
+                    texture->setMode(minFilter, magFilter);
+                else
+                    eagerTextures.push_back(texture);
+            }
+            
+            const size_t textureCount = eagerTextures.size();
+            if (textureCount > 0) {
+                m_textureIds.resize(textureCount);
+                glAssert(glGenTextures(static_cast<GLsizei>(textureCount),
+                                       static_cast<GLuint*>(&m_textureIds.front())));
+                
+                for (size_t i = 0; i < textureCount; ++i) {
+                    Texture* texture = eagerTextures[i];
+                    texture->prepare(m_textureIds[i], minFilter, magFilter);
+                }
             }
+            
+            m_prepared = true;
         }
 
         void TextureCollection::setTextureMode(const int minFilter, const int magFilter) {
@@ -114,6 +135,19 @@ namespace TrenchBroom {
             }
         }
 
+        bool TextureCollection::takeNewUploads() {
+            const bool result = m_hasNewUploads;
+            m_hasNewUploads = false;
+            return result;
+        }
+
+        void TextureCollection::collectUnusedTextures(TextureList& result) const {
+            for (Texture* texture : m_textures) {
+                if (texture->lazy() && texture->isPrepared() && texture->usageCount() == 0)
+                    result.push_back(texture);
+            }
+        }
+
         void TextureCollection::incUsageCount() {
             ++m_usageCount;
             usageCountDidChange();
@@ -124,5 +158,9 @@ namespace TrenchBroom {
             --m_usageCount;
             usageCountDidChange();
         }
+        
+        void TextureCollection::textureWasUploaded() {
+            m_hasNewUploads = true;
+        }
     }
 }
@@ -41,6 +41,8 @@ namespace TrenchBroom {
             size_t m_usageCount;
             
             TextureIdList m_textureIds;
+            bool m_prepared;
+            bool m_hasNewUploads;
             
             friend class Texture;
         public:
@@ -65,9 +67,20 @@ namespace TrenchBroom {
             bool prepared() const;
             void prepare(int minFilter, int magFilter);
             void setTextureMode(int minFilter, int magFilter);
+            
+            /**
+             * Returns whether any lazy texture of this collection has been uploaded since the last call.
+             */
+            bool takeNewUploads();
+            
+            /**
+             * Adds the lazy textures of this collection that are uploaded but not used by any face to the given list.
+             */
+            void collectUnusedTextures(TextureList& result) const;
         private:
             void incUsageCount();
             void decUsageCount();
+            void textureWasUploaded();
         };
     }
 }
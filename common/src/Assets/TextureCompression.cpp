@@ -0,0 +1,368 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TextureCompression.h"
+
+#include "Ensure.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+namespace TrenchBroom {
+    namespace Assets {
+        // The pixels of a 4x4 block in row major order, each with red, green, blue and alpha components.
+        typedef int Block[16][4];
+
+        static size_t channelCount(const GLenum format) {
+            switch (format) {
+                case GL_RGB:
+                case GL_BGR:
+                    return 3;
+                case GL_RGBA:
+                case GL_BGRA:
+                    return 4;
+                default:
+                    return 0;
+            }
+        }
+
+        static size_t blockSize(const GLenum compressedFormat) {
+            assert(isCompressed(compressedFormat));
+            return compressedFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ? 8 : 16;
+        }
+
+        static void readBlock(const unsigned char* image, const size_t width, const size_t height, const size_t blockX, const size_t blockY, const GLenum format, Block& block) {
+            const size_t channels = channelCount(format);
+            const bool bgr = format == GL_BGR || format == GL_BGRA;
+
+            // pixels outside of the image repeat the last row or column
+            for (size_t y = 0; y < 4; ++y) {
+                const size_t imageY = std::min(4 * blockY + y, height - 1);
+                for (size_t x = 0; x < 4; ++x) {
+                    const size_t imageX = std::min(4 * blockX + x, width - 1);
+                    const unsigned char* pixel = image + (imageY * width + imageX) * channels;
+                    int* dest = block[4 * y + x];
+                    dest[0] = pixel[bgr ? 2 : 0];
+                    dest[1] = pixel[1];
+                    dest[2] = pixel[bgr ? 0 : 2];
+                    dest[3] = channels == 4 ? pixel[3] : 255;
+                }
+            }
+        }
+
+        static void writeBlock(const Block& block, const size_t width, const size_t height, const size_t blockX, const size_t blockY, unsigned char* image) {
+            for (size_t y = 0; y < 4 && 4 * blockY + y < height; ++y) {
+                for (size_t x = 0; x < 4 && 4 * blockX + x < width; ++x) {
+                    unsigned char* pixel = image + ((4 * blockY + y) * width + 4 * blockX + x) * 4;
+                    for (size_t i = 0; i < 4; ++i)
+                        pixel[i] = static_cast<unsigned char>(block[4 * y + x][i]);
+                }
+            }
+        }
+
+        static uint16_t toRgb565(const int color[3]) {
+            const int r = (color[0] * 31 + 127) / 255;
+            const int g = (color[1] * 63 + 127) / 255;
+            const int b = (color[2] * 31 + 127) / 255;
+            return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+        }
+
+        static void fromRgb565(const uint16_t value, int color[3]) {
+            const int r = (value >> 11) & 31;
+            const int g = (value >> 5) & 63;
+            const int b = value & 31;
+            color[0] = (r << 3) | (r >> 2);
+            color[1] = (g << 2) | (g >> 4);
+            color[2] = (b << 3) | (b >> 2);
+        }
+
+        static void colorPalette(const uint16_t color0, const uint16_t color1, int palette[4][3]) {
+            fromRgb565(color0, palette[0]);
+            fromRgb565(color1, palette[1]);
+            for (size_t i = 0; i < 3; ++i) {
+                palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+                palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+            }
+        }
+
+        static void alphaPalette(const int alpha0, const int alpha1, int palette[8]) {
+            palette[0] = alpha0;
+            palette[1] = alpha1;
+            if (alpha0 > alpha1) {
+                for (int i = 1; i < 7; ++i)
+                    palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+            } else {
+                for (int i = 1; i < 5; ++i)
+                    palette[i + 1] = ((5 - i) * alpha0 + i * alpha1) / 5;
+                palette[6] = 0;
+                palette[7] = 255;
+            }
+        }
+
+        static void writeUInt16(const uint16_t value, unsigned char* dest) {
+            dest[0] = static_cast<unsigned char>(value & 0xFF);
+            dest[1] = static_cast<unsigned char>(value >> 8);
+        }
+
+        static uint16_t readUInt16(const unsigned char* src) {
+            return static_cast<uint16_t>(src[0] | (src[1] << 8));
+        }
+
+        /**
+         * Encodes the colors of the given block using the inset bounding box of the colors as the end points. The
+         * diagonal of the bounding box is chosen according to the correlation of the channels with the channel that
+         * varies the most.
+         */
+        static void encodeColorBlock(const Block& block, unsigned char* dest) {
+            int minColor[3] = { 255, 255, 255 };
+            int maxColor[3] = { 0, 0, 0 };
+            int sum[3] = { 0, 0, 0 };
+            for (size_t i = 0; i < 16; ++i) {
+                for (size_t j = 0; j < 3; ++j) {
+                    minColor[j] = std::min(minColor[j], block[i][j]);
+                    maxColor[j] = std::max(maxColor[j], block[i][j]);
+                    sum[j] += block[i][j];
+                }
+            }
+
+            size_t reference = 0;
+            for (size_t j = 1; j < 3; ++j) {
+                if (maxColor[j] - minColor[j] > maxColor[reference] - minColor[reference])
+                    reference = j;
+            }
+
+            for (size_t j = 0; j < 3; ++j) {
+                if (j == reference)
+                    continue;
+                int covariance = 0;
+                for (size_t i = 0; i < 16; ++i)
+                    covariance += (16 * block[i][j] - sum[j]) * (16 * block[i][reference] - sum[reference]);
+                if (covariance < 0)
+                    std::swap(minColor[j], maxColor[j]);
+            }
+
+            for (size_t j = 0; j < 3; ++j) {
+                const int inset = (maxColor[j] - minColor[j]) / 16;
+                minColor[j] += inset;
+                maxColor[j] -= inset;
+            }
+
+            uint16_t color0 = toRgb565(maxColor);
+            uint16_t color1 = toRgb565(minColor);
+            if (color0 < color1)
+                std::swap(color0, color1);
+
+            writeUInt16(color0, dest);
+            writeUInt16(color1, dest + 2);
+
+            uint32_t indices = 0;
+            if (color0 != color1) {
+                int palette[4][3];
+                colorPalette(color0, color1, palette);
+
+                for (size_t i = 0; i < 16; ++i) {
+                    uint32_t bestIndex = 0;
+                    int bestDistance = std::numeric_limits<int>::max();
+                    for (uint32_t k = 0; k < 4; ++k) {
+                        int distance = 0;
+                        for (size_t j = 0; j < 3; ++j) {
+                            const int delta = block[i][j] - palette[k][j];
+                            distance += delta * delta;
+                        }
+                        if (distance < bestDistance) {
+                            bestDistance = distance;
+                            bestIndex = k;
+                        }
+                    }
+                    indices |= bestIndex << (2 * i);
+                }
+            }
+
+            for (size_t i = 0; i < 4; ++i)
+                dest[4 + i] = static_cast<unsigned char>((indices >> (8 * i)) & 0xFF);
+        }
+
+        static void encodeAlphaBlock(const Block& block, unsigned char* dest) {
+            int alpha0 = 0;
+            int alpha1 = 255;
+            for (size_t i = 0; i < 16; ++i) {
+                alpha0 = std::max(alpha0, block[i][3]);
+                alpha1 = std::min(alpha1, block[i][3]);
+            }
+
+            dest[0] = static_cast<unsigned char>(alpha0);
+            dest[1] = static_cast<unsigned char>(alpha1);
+
+            uint64_t indices = 0;
+            if (alpha0 != alpha1) {
+                int palette[8];
+                alphaPalette(alpha0, alpha1, palette);
+
+                for (size_t i = 0; i < 16; ++i) {
+                    uint64_t bestIndex = 0;
+                    int bestDistance = std::numeric_limits<int>::max();
+                    for (uint64_t k = 0; k < 8; ++k) {
+                        const int distance = std::abs(block[i][3] - palette[k]);
+                        if (distance < bestDistance) {
+                            bestDistance = distance;
+                            bestIndex = k;
+                        }
+                    }
+                    indices |= bestIndex << (3 * i);
+                }
+            }
+
+            for (size_t i = 0; i < 6; ++i)
+                dest[2 + i] = static_cast<unsigned char>((indices >> (8 * i)) & 0xFF);
+        }
+
+        static void decodeColorBlock(const unsigned char* src, const bool dxt1, Block& block) {
+            const uint16_t color0 = readUInt16(src);
+            const uint16_t color1 = readUInt16(src + 2);
+
+            int palette[4][3];
+            colorPalette(color0, color1, palette);
+
+            // DXT1 blocks whose first color is not greater than the second use three colors and transparent black
+            bool transparent = false;
+            if (dxt1 && color0 <= color1) {
+                for (size_t i = 0; i < 3; ++i) {
+                    palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+                    palette[3][i] = 0;
+                }
+                transparent = true;
+            }
+
+            for (size_t i = 0; i < 16; ++i) {
+                const size_t index = (src[4 + i / 4] >> (2 * (i % 4))) & 3;
+                for (size_t j = 0; j < 3; ++j)
+                    block[i][j] = palette[index][j];
+                block[i][3] = transparent && index == 3 ? 0 : 255;
+            }
+        }
+
+        static void decodeAlphaBlock(const unsigned char* src, Block& block) {
+            int palette[8];
+            alphaPalette(src[0], src[1], palette);
+
+            uint64_t indices = 0;
+            for (size_t i = 0; i < 6; ++i)
+                indices |= static_cast<uint64_t>(src[2 + i]) << (8 * i);
+
+            for (size_t i = 0; i < 16; ++i)
+                block[i][3] = palette[(indices >> (3 * i)) & 7];
+        }
+
+        bool isCompressible(const GLenum format) {
+            return channelCount(format) > 0;
+        }
+
+        bool isCompressed(const GLenum format) {
+            return format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || format == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        }
+
+        GLenum compressedFormat(const GLenum format) {
+            assert(isCompressible(format));
+            return channelCount(format) == 4 ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        }
+
+        size_t compressedImageSize(const size_t width, const size_t height, const GLenum compressedFormat) {
+            return ((width + 3) / 4) * ((height + 3) / 4) * blockSize(compressedFormat);
+        }
+
+        TextureBuffer::List compressMips(const TextureBuffer::List& buffers, const size_t width, const size_t height, const GLenum format) {
+            const GLenum targetFormat = compressedFormat(format);
+            const bool alpha = targetFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+
+            TextureBuffer::List result;
+            result.reserve(buffers.size());
+
+            for (size_t level = 0; level < buffers.size(); ++level) {
+                // mip sizes are halved without clamping to match Texture::upload
+                const size_t mipWidth = width >> level;
+                const size_t mipHeight = height >> level;
+
+                result.push_back(TextureBuffer(compressedImageSize(mipWidth, mipHeight, targetFormat)));
+                if (mipWidth == 0 || mipHeight == 0)
+                    continue;
+
+                const TextureBuffer& source = buffers[level];
+                ensure(source.size() >= mipWidth * mipHeight * channelCount(format), "mip buffer is too small");
+
+                unsigned char* dest = result.back().ptr();
+                Block block;
+                for (size_t blockY = 0; blockY < (mipHeight + 3) / 4; ++blockY) {
+                    for (size_t blockX = 0; blockX < (mipWidth + 3) / 4; ++blockX) {
+                        readBlock(source.ptr(), mipWidth, mipHeight, blockX, blockY, format, block);
+                        if (alpha) {
+                            encodeAlphaBlock(block, dest);
+                            dest += 8;
+                        }
+                        encodeColorBlock(block, dest);
+                        dest += 8;
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        TextureBuffer::List decompressMips(const TextureBuffer::List& buffers, const size_t width, const size_t height, const GLenum compressedFormat) {
+            const bool alpha = compressedFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+
+            TextureBuffer::List result;
+            result.reserve(buffers.size());
+
+            for (size_t level = 0; level < buffers.size(); ++level) {
+                const size_t mipWidth = width >> level;
+                const size_t mipHeight = height >> level;
+
+                result.push_back(TextureBuffer(mipWidth * mipHeight * 4));
+                if (mipWidth == 0 || mipHeight == 0)
+                    continue;
+
+                const TextureBuffer& source = buffers[level];
+                ensure(source.size() >= compressedImageSize(mipWidth, mipHeight, compressedFormat), "mip buffer is too small");
+
+                const unsigned char* src = source.ptr();
+                unsigned char* dest = result.back().ptr();
+                Block block;
+                for (size_t blockY = 0; blockY < (mipHeight + 3) / 4; ++blockY) {
+                    for (size_t blockX = 0; blockX < (mipWidth + 3) / 4; ++blockX) {
+                        if (alpha) {
+                            decodeColorBlock(src + 8, false, block);
+                            decodeAlphaBlock(src, block);
+                            src += 16;
+                        } else {
+                            decodeColorBlock(src, true, block);
+                            src += 8;
+                        }
+                        writeBlock(block, mipWidth, mipHeight, blockX, blockY, dest);
+                    }
+                }
+            }
+
+            return result;
+        }
+    }
+}
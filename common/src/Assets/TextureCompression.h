@@ -0,0 +1,62 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_TextureCompression
+#define TrenchBroom_TextureCompression
+
+#include "Assets/Texture.h"
+
+namespace TrenchBroom {
+    namespace Assets {
+        /**
+         * Indicates whether textures with the given pixel format can be compressed. Only 8 bit RGB(A) and BGR(A)
+         * textures can be compressed.
+         */
+        bool isCompressible(GLenum format);
+
+        /**
+         * Indicates whether the given format is one of the S3TC formats that textures are compressed to.
+         */
+        bool isCompressed(GLenum format);
+
+        /**
+         * Returns the format that textures with the given pixel format are compressed to: DXT1 for textures without
+         * an alpha channel and DXT5 otherwise.
+         */
+        GLenum compressedFormat(GLenum format);
+
+        /**
+         * Returns the number of bytes of a compressed image with the given size and format.
+         */
+        size_t compressedImageSize(size_t width, size_t height, GLenum compressedFormat);
+
+        /**
+         * Compresses the given mip buffers of a texture with the given size and pixel format.
+         */
+        TextureBuffer::List compressMips(const TextureBuffer::List& buffers, size_t width, size_t height, GLenum format);
+
+        /**
+         * Decompresses the given compressed mip buffers into RGBA images.
+         */
+        TextureBuffer::List decompressMips(const TextureBuffer::List& buffers, size_t width, size_t height, GLenum compressedFormat);
+    }
+}
+
+#endif /* defined(TrenchBroom_TextureCompression) */
@@ -27,6 +27,7 @@
 #include "IO/TextureLoader.h"
 
 #include <algorithm>
+#include <cassert>
 #include <iterator>
 
 namespace TrenchBroom {
@@ -48,34 +49,38 @@ namespace TrenchBroom {
             }
         };
         
+        class CompareByActivation {
+        public:
+            bool operator() (const Texture* left, const Texture* right) const {
+                return left->lastActivation() > right->lastActivation();
+            }
+        };
+        
         TextureManager::TextureManager(Logger* logger, int minFilter, int magFilter) :
         m_logger(logger),
+        m_cancelLoading(false),
         m_minFilter(minFilter),
         m_magFilter(magFilter),
-        m_resetTextureMode(false) {}
+        m_resetTextureMode(false),
+        m_compressTextures(false) {}
         
         TextureManager::~TextureManager() {
             clear();
         }
         
-        void TextureManager::setTextureCollections(const IO::Path::List& paths, IO::TextureLoader& loader) {
+        void TextureManager::setTextureCollections(const IO::Path::List& paths, std::shared_ptr<IO::TextureLoader> loader) {
             TextureCollectionMap collections = collectionMap();
             m_collections.clear();
             clear();
             
+            PendingCollectionList pendingCollections;
             for (const IO::Path& path : paths) {
                 const auto it = collections.find(path);
                 if (it == std::end(collections) || !it->second->loaded()) {
-                    try {
-                        Assets::TextureCollection* collection = loader.loadTextureCollection(path);
-                        m_logger->info("Loaded texture collection '" + path.asString() + "'");
-                        addTextureCollection(collection);
-                        collection->usageCountDidChange.addObserver(usageCountDidChange);
-                    } catch (const Exception& e) {
-                        addTextureCollection(new Assets::TextureCollection(path));
-                        if (it == std::end(collections))
-                            m_logger->error("Could not load texture collection '" + path.asString() + "': " + e.what());
-                    }
+                    // errors are only reported for collections that were not set before
+                    Assets::TextureCollection* placeholder = new Assets::TextureCollection(path);
+                    pendingCollections.push_back({ path, placeholder, it == std::end(collections) });
+                    addTextureCollection(placeholder);
                 } else {
                     addTextureCollection(it->second);
                 }
@@ -85,6 +90,79 @@ namespace TrenchBroom {
             
             updateTextures();
             VectorUtils::append(m_toRemove, collections);
+
+            if (!pendingCollections.empty())
+                loadCollections(pendingCollections, loader);
+        }
+
+        bool TextureManager::collectLoadedCollections() {
+            LoadedCollectionList loadedCollections;
+            {
+                std::lock_guard<std::mutex> lock(m_loadedCollectionsMutex);
+                loadedCollections.swap(m_loadedCollections);
+            }
+
+            for (const LoadedCollection& loadedCollection : loadedCollections) {
+                const PendingCollection& pending = loadedCollection.pending;
+                if (loadedCollection.collection != nullptr) {
+                    const auto it = std::find(std::begin(m_collections), std::end(m_collections), pending.placeholder);
+                    assert(it != std::end(m_collections));
+
+                    // the placeholder may still be referenced by the renderers until the next call to commitChanges
+                    m_toRemove.push_back(*it);
+                    *it = loadedCollection.collection;
+                    if (loadedCollection.collection->loaded())
+                        m_toPrepare.push_back(loadedCollection.collection);
+                    loadedCollection.collection->usageCountDidChange.addObserver(usageCountDidChange);
+                    
+                    m_logger->info("Loaded texture collection '" + pending.path.asString() + "'");
+                } else if (pending.reportError) {
+                    // the empty placeholder remains in place of the collection
+                    m_logger->error("Could not load texture collection '" + pending.path.asString() + "': " + loadedCollection.error);
+                }
+            }
+
+            if (loadedCollections.empty())
+                return false;
+
+            updateTextures();
+            return true;
+        }
+
+        void TextureManager::finishLoading() {
+            if (m_loadTask.valid())
+                m_loadTask.wait();
+        }
+
+        void TextureManager::loadCollections(const PendingCollectionList& pendingCollections, std::shared_ptr<IO::TextureLoader> loader) {
+            // the collections are loaded one after another since each of them decodes its textures in parallel
+            m_loadTask = std::async(std::launch::async, [this, pendingCollections, loader]() {
+                for (const PendingCollection& pending : pendingCollections) {
+                    if (m_cancelLoading)
+                        return;
+                    
+                    LoadedCollection loadedCollection = { pending, nullptr, "" };
+                    try {
+                        loadedCollection.collection = loader->loadTextureCollection(pending.path);
+                    } catch (const std::exception& e) {
+                        loadedCollection.error = e.what();
+                    }
+                    
+                    std::lock_guard<std::mutex> lock(m_loadedCollectionsMutex);
+                    m_loadedCollections.push_back(loadedCollection);
+                }
+            });
+        }
+
+        void TextureManager::cancelLoading() {
+            m_cancelLoading = true;
+            finishLoading();
+            m_loadTask = std::future<void>();
+            m_cancelLoading = false;
+
+            for (const LoadedCollection& loadedCollection : m_loadedCollections)
+                delete loadedCollection.collection;
+            m_loadedCollections.clear();
         }
 
         TextureManager::TextureCollectionMap TextureManager::collectionMap() const {
@@ -104,6 +182,8 @@ namespace TrenchBroom {
         }
 
         void TextureManager::clear() {
+            cancelLoading();
+
             VectorUtils::clearAndDelete(m_collections);
             VectorUtils::clearAndDelete(m_toRemove);
             
@@ -120,9 +200,18 @@ namespace TrenchBroom {
             m_resetTextureMode = true;
         }
 
+        bool TextureManager::compressTextures() const {
+            return m_compressTextures;
+        }
+        
+        void TextureManager::setCompressTextures(const bool compressTextures) {
+            m_compressTextures = compressTextures;
+        }
+
         void TextureManager::commitChanges() {
             resetTextureMode();
             prepare();
+            evictUnusedTextures();
             VectorUtils::clearAndDelete(m_toRemove);
         }
         
@@ -163,6 +252,25 @@ namespace TrenchBroom {
             m_toPrepare.clear();
         }
         
+        void TextureManager::evictUnusedTextures() {
+            // the number of unused textures only grows significantly when textures are uploaded
+            bool hasNewUploads = false;
+            for (TextureCollection* collection : m_collections)
+                hasNewUploads |= collection->takeNewUploads();
+            if (!hasNewUploads)
+                return;
+            
+            TextureList unusedTextures;
+            for (const TextureCollection* collection : m_collections)
+                collection->collectUnusedTextures(unusedTextures);
+            if (unusedTextures.size() <= MaxUnusedTextures)
+                return;
+            
+            const auto lastKept = std::begin(unusedTextures) + static_cast<std::ptrdiff_t>(MaxUnusedTextures);
+            std::nth_element(std::begin(unusedTextures), lastKept, std::end(unusedTextures), CompareByActivation());
+            std::for_each(lastKept, std::end(unusedTextures), [](Texture* texture) { texture->evict(); });
+        }
+        
         void TextureManager::updateTextures() {
             m_texturesByName.clear();
             m_textures.clear();
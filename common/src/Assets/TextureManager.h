@@ -21,11 +21,16 @@
 #define TrenchBroom_TextureManager
 
 #include "Notifier.h"
+#include "StringUtils.h"
 #include "Assets/AssetTypes.h"
 #include "IO/Path.h"
 #include "Model/ModelTypes.h"
 
+#include <atomic>
+#include <future>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace TrenchBroom {
@@ -41,10 +46,38 @@ namespace TrenchBroom {
             typedef std::map<IO::Path, TextureCollection*> TextureCollectionMap;
             typedef std::pair<IO::Path, TextureCollection*> TextureCollectionMapEntry;
             typedef std::map<String, Texture*> TextureMap;
+
+            /**
+             * The number of uploaded lazy textures that are kept even though no face uses them, e.g. because they
+             * were shown in the texture browser. The least recently activated ones beyond that are evicted.
+             */
+            static const size_t MaxUnusedTextures = 256;
+
+            struct PendingCollection {
+                IO::Path path;
+                TextureCollection* placeholder;
+                bool reportError;
+            };
+            typedef std::vector<PendingCollection> PendingCollectionList;
+
+            struct LoadedCollection {
+                PendingCollection pending;
+                TextureCollection* collection;
+                String error;
+            };
+            typedef std::vector<LoadedCollection> LoadedCollectionList;
             
             Logger* m_logger;
             
             TextureCollectionList m_collections;
+
+            // loads the collections that are represented by empty placeholders
+            std::future<void> m_loadTask;
+            std::atomic<bool> m_cancelLoading;
+
+            // guards the collections that the background task has loaded
+            std::mutex m_loadedCollectionsMutex;
+            LoadedCollectionList m_loadedCollections;
             
             TextureCollectionList m_toPrepare;
             TextureCollectionList m_toRemove;
@@ -55,20 +88,50 @@ namespace TrenchBroom {
             int m_minFilter;
             int m_magFilter;
             bool m_resetTextureMode;
+            bool m_compressTextures;
         public:
             Notifier0 usageCountDidChange;
         public:
             TextureManager(Logger* logger, int minFilter, int magFilter);
             ~TextureManager();
 
-            void setTextureCollections(const IO::Path::List& paths, IO::TextureLoader& loader);
+            /**
+             * Sets the texture collections with the given paths. Collections that are already loaded are kept, the
+             * others are loaded by the given loader on a background task. Until a collection has been loaded, it is
+             * represented by an empty placeholder collection, so faces that use its textures are rendered without a
+             * texture.
+             */
+            void setTextureCollections(const IO::Path::List& paths, std::shared_ptr<IO::TextureLoader> loader);
+
+            /**
+             * Replaces the placeholders of the collections that have been loaded in the background. Must be called on
+             * the main thread.
+             *
+             * @return true if any placeholder was replaced or any collection failed to load
+             */
+            bool collectLoadedCollections();
+
+            /**
+             * Waits until the background task has loaded all pending collections. The loaded collections must still
+             * be collected.
+             */
+            void finishLoading();
         private:
             TextureCollectionMap collectionMap() const;
             void addTextureCollection(Assets::TextureCollection* collection);
+            void loadCollections(const PendingCollectionList& pendingCollections, std::shared_ptr<IO::TextureLoader> loader);
+            void cancelLoading();
         public:
             void clear();
             
             void setTextureMode(int minFilter, int magFilter);
+            
+            /**
+             * Indicates whether textures should be compressed when they are loaded. Changing this does not affect
+             * textures that are already loaded.
+             */
+            bool compressTextures() const;
+            void setCompressTextures(bool compressTextures);
             void commitChanges();
             
             Texture* texture(const String& name) const;
@@ -78,6 +141,7 @@ namespace TrenchBroom {
         private:
             void resetTextureMode();
             void prepare();
+            void evictUnusedTextures();
 
             void updateTextures();
         };
@@ -112,7 +112,7 @@ public:
     using ExceptionStream::ExceptionStream;
 };
 
-class OctreeException : public ExceptionStream<OctreeException> {
+class AABBTreeException : public ExceptionStream<AABBTreeException> {
 public:
     using ExceptionStream::ExceptionStream;
 };
@@ -1185,6 +1185,236 @@ namespace TrenchBroom {
             return (*m_func)(a1, a2, a3, a4, a5, a6, a7, a8, a9);
         }
     };
+    
+    template <typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10>
+    class FuncBase10 {
+    public:
+        virtual ~FuncBase10() {}
+        virtual R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10) const = 0;
+    };
+    
+    template <typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10>
+    class FuncPtr10 : public FuncBase10<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10> {
+    public:
+        typedef R (*F)(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10);
+    private:
+        F m_function;
+    public:
+        FuncPtr10(F function) :
+        m_function(function) {}
+        
+        R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10) const override {
+            return (*m_function)(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
+        }
+    };
+    
+#ifdef _MSC_VER
+    template <typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10>
+    class StdCallFuncPtr10 : public FuncBase10<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10> {
+    public:
+        typedef R (__stdcall *F)(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10);
+    private:
+        F m_function;
+    public:
+        StdCallFuncPtr10(F function) :
+        m_function(function) {}
+        
+        R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10) const {
+            return (*m_function)(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
+        }
+    };
+#endif
+    
+    template <class C, typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10>
+    class MemFuncPtr10 : public FuncBase10<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10> {
+    public:
+        typedef R (C::*F)(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10);
+    private:
+        C* m_receiver;
+        F m_function;
+    public:
+        MemFuncPtr10(C* receiver, F function) :
+        m_receiver(receiver),
+        m_function(function) {}
+        
+        R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10) const override {
+            return (m_receiver->*m_function)(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
+        }
+    };
+    
+    template <class C, typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10>
+    class ConstMemFuncPtr10 : public FuncBase10<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10> {
+    public:
+        typedef R (C::*F)(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10) const;
+    private:
+        const C* m_receiver;
+        F m_function;
+    public:
+        ConstMemFuncPtr10(const C* receiver, F function) :
+        m_receiver(receiver),
+        m_function(function) {}
+        
+        R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10) const {
+            return (m_receiver->*m_function)(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
+        }
+    };
+    
+    template <typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10>
+    class Func10 {
+    private:
+        FuncBase10<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10>* m_func;
+    public:
+        Func10() :
+        m_func(nullptr) {}
+        
+        ~Func10() {
+            delete m_func;
+            m_func = nullptr;
+        }
+        
+        void bindFunc(typename FuncPtr10<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10>::F func) {
+            delete m_func;
+            m_func = new FuncPtr10<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10>(func);
+        }
+        
+#ifdef _MSC_VER
+        void bindFunc(typename StdCallFuncPtr10<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10>::F func) {
+            delete m_func;
+            m_func = new StdCallFuncPtr10<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10>(func);
+        }
+#endif
+        
+        template <class C>
+        void bindMemFunc(C* receiver, typename MemFuncPtr10<C,R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10>::F func) {
+            delete m_func;
+            m_func = new MemFuncPtr10<C,R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10>(receiver, func);
+        }
+        
+        void unbindFunc() {
+            delete m_func;
+            m_func = 0;
+        }
+        
+        R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10) {
+            ensure(m_func != nullptr, "func is null");
+            return (*m_func)(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
+        }
+    };
+    
+    template <typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10, typename A11>
+    class FuncBase11 {
+    public:
+        virtual ~FuncBase11() {}
+        virtual R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11) const = 0;
+    };
+    
+    template <typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10, typename A11>
+    class FuncPtr11 : public FuncBase11<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10,A11> {
+    public:
+        typedef R (*F)(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11);
+    private:
+        F m_function;
+    public:
+        FuncPtr11(F function) :
+        m_function(function) {}
+        
+        R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11) const override {
+            return (*m_function)(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11);
+        }
+    };
+    
+#ifdef _MSC_VER
+    template <typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10, typename A11>
+    class StdCallFuncPtr11 : public FuncBase11<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10,A11> {
+    public:
+        typedef R (__stdcall *F)(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11);
+    private:
+        F m_function;
+    public:
+        StdCallFuncPtr11(F function) :
+        m_function(function) {}
+        
+        R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11) const {
+            return (*m_function)(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11);
+        }
+    };
+#endif
+    
+    template <class C, typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10, typename A11>
+    class MemFuncPtr11 : public FuncBase11<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10,A11> {
+    public:
+        typedef R (C::*F)(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11);
+    private:
+        C* m_receiver;
+        F m_function;
+    public:
+        MemFuncPtr11(C* receiver, F function) :
+        m_receiver(receiver),
+        m_function(function) {}
+        
+        R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11) const override {
+            return (m_receiver->*m_function)(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11);
+        }
+    };
+    
+    template <class C, typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10, typename A11>
+    class ConstMemFuncPtr11 : public FuncBase11<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10,A11> {
+    public:
+        typedef R (C::*F)(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11) const;
+    private:
+        const C* m_receiver;
+        F m_function;
+    public:
+        ConstMemFuncPtr11(const C* receiver, F function) :
+        m_receiver(receiver),
+        m_function(function) {}
+        
+        R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11) const {
+            return (m_receiver->*m_function)(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11);
+        }
+    };
+    
+    template <typename R, typename A1, typename A2, typename A3, typename A4, typename A5, typename A6, typename A7, typename A8, typename A9, typename A10, typename A11>
+    class Func11 {
+    private:
+        FuncBase11<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10,A11>* m_func;
+    public:
+        Func11() :
+        m_func(nullptr) {}
+        
+        ~Func11() {
+            delete m_func;
+            m_func = nullptr;
+        }
+        
+        void bindFunc(typename FuncPtr11<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10,A11>::F func) {
+            delete m_func;
+            m_func = new FuncPtr11<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10,A11>(func);
+        }
+        
+#ifdef _MSC_VER
+        void bindFunc(typename StdCallFuncPtr11<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10,A11>::F func) {
+            delete m_func;
+            m_func = new StdCallFuncPtr11<R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10,A11>(func);
+        }
+#endif
+        
+        template <class C>
+        void bindMemFunc(C* receiver, typename MemFuncPtr11<C,R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10,A11>::F func) {
+            delete m_func;
+            m_func = new MemFuncPtr11<C,R,A1,A2,A3,A4,A5,A6,A7,A8,A9,A10,A11>(receiver, func);
+        }
+        
+        void unbindFunc() {
+            delete m_func;
+            m_func = 0;
+        }
+        
+        R operator()(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11) {
+            ensure(m_func != nullptr, "func is null");
+            return (*m_func)(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11);
+        }
+    };
 }
 
 #endif /* defined(TrenchBroom_Functor) */
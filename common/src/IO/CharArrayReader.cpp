@@ -36,6 +36,10 @@ namespace TrenchBroom {
             return static_cast<size_t>(m_end - m_begin);
         }
 
+        size_t CharArrayReader::position() const {
+            return static_cast<size_t>(m_current - m_begin);
+        }
+
         void CharArrayReader::seekFromBegin(const size_t offset) {
             assert(offset < size());
             m_current = m_begin + offset;
@@ -47,7 +51,7 @@ namespace TrenchBroom {
         }
 
         void CharArrayReader::seekForward(const size_t offset) {
-            assert(m_current + offset < m_end);
+            assert(m_current + offset <= m_end);
             m_current += offset;
         }
 
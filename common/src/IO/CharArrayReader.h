@@ -46,6 +46,7 @@ namespace TrenchBroom {
             CharArrayReader(const char* begin, const char* end);
 
             size_t size() const;
+            size_t position() const;
             void seekFromBegin(size_t offset);
             void seekFromEnd(size_t offset);
             void seekForward(size_t offset);
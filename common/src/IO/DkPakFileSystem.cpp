@@ -118,9 +118,9 @@ namespace TrenchBroom {
                 MappedFile::Ptr entryFile(new MappedFileView(m_file, filePath, entryBegin, entryEnd));
                 
                 if (compressed)
-                    m_root.addFile(filePath, new SimpleFile(entryFile));
+                    m_index.addFile(filePath, new SimpleFile(entryFile));
                 else
-                    m_root.addFile(filePath, new CompressedFile(entryFile, uncompressedSize));
+                    m_index.addFile(filePath, new CompressedFile(entryFile, uncompressedSize));
             }
         }
     }
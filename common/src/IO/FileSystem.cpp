@@ -89,6 +89,22 @@ namespace TrenchBroom {
             }
         }
 
+        bool FileSystem::hasFixedContents() const {
+            return doHasFixedContents();
+        }
+
+        Path::List FileSystem::allFiles() const {
+            return doGetAllFiles();
+        }
+
+        bool FileSystem::doHasFixedContents() const {
+            return false;
+        }
+
+        Path::List FileSystem::doGetAllFiles() const {
+            return findItemsRecursively(Path(""), FileTypeMatcher(true, false));
+        }
+
         WritableFileSystem::WritableFileSystem() {}
 
         /*
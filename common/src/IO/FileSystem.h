@@ -64,6 +64,17 @@ namespace TrenchBroom {
             
             Path::List getDirectoryContents(const Path& path) const;
             const MappedFile::Ptr openFile(const Path& path) const;
+
+            /**
+             * Indicates whether the contents of this file system never change once it has been created, e.g. because
+             * it is backed by an archive. The files of such a file system can be indexed up front.
+             */
+            bool hasFixedContents() const;
+
+            /**
+             * Returns the paths of all files in this file system, but not the paths of directories.
+             */
+            Path::List allFiles() const;
         private:
             template <class M>
             void doFindItems(const Path& searchPath, const M& matcher, const bool recurse, Path::List& result) const {
@@ -83,6 +94,9 @@ namespace TrenchBroom {
             virtual Path::List doGetDirectoryContents(const Path& path) const = 0;
 
             virtual const MappedFile::Ptr doOpenFile(const Path& path) const = 0;
+
+            virtual bool doHasFixedContents() const;
+            virtual Path::List doGetAllFiles() const;
         };
         
         class WritableFileSystem : public virtual FileSystem {
@@ -35,11 +35,20 @@ namespace TrenchBroom {
         
         void FileSystemHierarchy::addFileSystem(FileSystem* fileSystem) {
             ensure(fileSystem != nullptr, "fileSystem is null");
+            const size_t position = m_fileSystems.size();
             m_fileSystems.push_back(fileSystem);
+            
+            if (fileSystem->hasFixedContents())
+                indexFileSystem(fileSystem, position);
+            else
+                m_unindexedFileSystems.push_back(position);
         }
 
         void FileSystemHierarchy::clear() {
             VectorUtils::clearAndDelete(m_fileSystems);
+            m_fileIndex.clear();
+            m_directoryIndex.clear();
+            m_unindexedFileSystems.clear();
         }
 
         Path FileSystemHierarchy::doMakeAbsolute(const Path& relPath) const {
@@ -50,8 +59,11 @@ namespace TrenchBroom {
         }
 
         bool FileSystemHierarchy::doDirectoryExists(const Path& path) const {
-            for (auto it = m_fileSystems.rbegin(), end = m_fileSystems.rend(); it != end; ++it) {
-                const FileSystem* fileSystem = *it;
+            if (m_directoryIndex.count(indexKey(path)) > 0)
+                return true;
+            
+            for (auto it = m_unindexedFileSystems.rbegin(), end = m_unindexedFileSystems.rend(); it != end; ++it) {
+                const FileSystem* fileSystem = m_fileSystems[*it];
                 if (fileSystem->directoryExists(path))
                     return true;
             }
@@ -63,18 +75,61 @@ namespace TrenchBroom {
         }
         
         FileSystem* FileSystemHierarchy::findFileSystemContaining(const Path& path) const {
-            for (auto it = m_fileSystems.rbegin(), end = m_fileSystems.rend(); it != end; ++it) {
-                FileSystem* fileSystem = *it;
+            const auto indexIt = m_fileIndex.find(indexKey(path));
+            const bool indexed = indexIt != std::end(m_fileIndex);
+            
+            // the file systems that were not indexed must be searched if they take precedence over the indexed file
+            // system that contains the file
+            for (auto it = m_unindexedFileSystems.rbegin(), end = m_unindexedFileSystems.rend(); it != end; ++it) {
+                const size_t position = *it;
+                if (indexed && position < indexIt->second)
+                    break;
+                
+                FileSystem* fileSystem = m_fileSystems[position];
                 if (fileSystem->fileExists(path))
                     return fileSystem;
             }
+            
+            if (indexed)
+                return m_fileSystems[indexIt->second];
             return nullptr;
         }
 
+        void FileSystemHierarchy::indexFileSystem(const FileSystem* fileSystem, const size_t position) {
+            // the root directory exists even if the file system is empty
+            m_directoryIndex[indexKey(Path(""))];
+            
+            for (const Path& path : fileSystem->allFiles()) {
+                m_fileIndex[indexKey(path)] = position;
+                
+                Path current = path;
+                while (!current.isEmpty()) {
+                    const Path name = current.lastComponent();
+                    const Path parent = current.deleteLastComponent();
+                    
+                    EntryMap& entries = m_directoryIndex[indexKey(parent)];
+                    if (!entries.insert(std::make_pair(indexKey(name), name)).second)
+                        break; // the parent directories are already known
+                    current = parent;
+                }
+            }
+        }
+
+        String FileSystemHierarchy::indexKey(const Path& path) {
+            return StringUtils::toLower(path.asString('/'));
+        }
+
         Path::List FileSystemHierarchy::doGetDirectoryContents(const Path& path) const {
             Path::List result;
-            for (auto it = m_fileSystems.rbegin(), end = m_fileSystems.rend(); it != end; ++it) {
-                const FileSystem* fileSystem = *it;
+            
+            const auto indexIt = m_directoryIndex.find(indexKey(path));
+            if (indexIt != std::end(m_directoryIndex)) {
+                for (const auto& entry : indexIt->second)
+                    result.push_back(entry.second);
+            }
+            
+            for (auto it = m_unindexedFileSystems.rbegin(), end = m_unindexedFileSystems.rend(); it != end; ++it) {
+                const FileSystem* fileSystem = m_fileSystems[*it];
                 if (fileSystem->directoryExists(path)) {
                     const Path::List contents = fileSystem->getDirectoryContents(path);
                     VectorUtils::append(result, contents);
@@ -86,14 +141,9 @@ namespace TrenchBroom {
         }
         
         const MappedFile::Ptr FileSystemHierarchy::doOpenFile(const Path& path) const {
-            for (auto it = m_fileSystems.rbegin(), end = m_fileSystems.rend(); it != end; ++it) {
-                const FileSystem* fileSystem = *it;
-                if (fileSystem->fileExists(path)) {
-                    const MappedFile::Ptr file = fileSystem->openFile(path);
-                    if (file.get() != nullptr)
-                        return file;
-                }
-            }
+            const FileSystem* fileSystem = findFileSystemContaining(path);
+            if (fileSystem != nullptr)
+                return fileSystem->openFile(path);
             return MappedFile::Ptr();
         }
 
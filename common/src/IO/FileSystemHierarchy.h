@@ -26,16 +26,36 @@
 #include "IO/FileSystem.h"
 #include "IO/Path.h"
 
+#include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
     namespace IO {
         class Path;
         
+        /**
+         * Searches a list of file systems, where file systems that were added later take precedence.
+         *
+         * The files of file systems with fixed contents, such as archives, are indexed by their lower case paths when
+         * the file systems are added, so that finding the file system containing a file only has to search the file
+         * systems that may change, such as the disk file systems of the search paths.
+         */
         class FileSystemHierarchy : public virtual FileSystem {
         private:
             typedef std::vector<FileSystem*> FileSystemList;
+            // maps a file path to the position of the last indexed file system that contains it
+            typedef std::unordered_map<String, size_t> FileIndex;
+            // maps a directory path to the lower case names and actual names of its entries in indexed file systems
+            typedef std::map<String, Path> EntryMap;
+            typedef std::unordered_map<String, EntryMap> DirectoryIndex;
+            typedef std::vector<size_t> PositionList;
+            
             FileSystemList m_fileSystems;
+            FileIndex m_fileIndex;
+            DirectoryIndex m_directoryIndex;
+            // positions of the file systems that were not indexed, in ascending order
+            PositionList m_unindexedFileSystems;
         public:
             FileSystemHierarchy();
             virtual ~FileSystemHierarchy() override;
@@ -48,6 +68,9 @@ namespace TrenchBroom {
             bool doFileExists(const Path& path) const override;
             FileSystem* findFileSystemContaining(const Path& path) const;
             
+            void indexFileSystem(const FileSystem* fileSystem, size_t position);
+            static String indexKey(const Path& path);
+            
             Path::List doGetDirectoryContents(const Path& path) const override;
             const MappedFile::Ptr doOpenFile(const Path& path) const override;
 
@@ -19,6 +19,7 @@
 
 #include "IOUtils.h"
 
+#include "IO/OutputBuffer.h"
 #include "IO/Path.h"
 
 namespace TrenchBroom {
@@ -78,6 +79,14 @@ namespace TrenchBroom {
             std::fprintf(stream, "// Format: %s\n", mapFormat.c_str());
         }
 
+        void writeGameComment(OutputBuffer& buffer, const String& gameName, const String& mapFormat) {
+            buffer.append("// Game: ");
+            buffer.append(gameName);
+            buffer.append("\n// Format: ");
+            buffer.append(mapFormat);
+            buffer.append('\n');
+        }
+
         Vec3f readVec3f(const char*& cursor) {
             Vec3f value;
             for (size_t i = 0; i < 3; i++)
@@ -42,6 +42,7 @@
 
 namespace TrenchBroom {
     namespace IO {
+        class OutputBuffer;
         class Path;
         
         class OpenFile {
@@ -69,6 +70,7 @@ namespace TrenchBroom {
         String readInfoComment(std::istream& stream, const String& name);
         
         void writeGameComment(FILE* stream, const String& gameName, const String& mapFormat);
+        void writeGameComment(OutputBuffer& buffer, const String& gameName, const String& mapFormat);
         
         template <typename T>
         void advance(const char*& cursor, const size_t i = 1) {
@@ -67,7 +67,7 @@ namespace TrenchBroom {
                 const Path filePath(StringUtils::toLower(entryName));
                 MappedFile::Ptr entryFile(new MappedFileView(m_file, filePath, entryBegin, entryEnd));
 
-                m_root.addFile(filePath, new SimpleFile(entryFile));
+                m_index.addFile(filePath, new SimpleFile(entryFile));
             }
         }
     }
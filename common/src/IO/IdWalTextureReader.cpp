@@ -37,9 +37,9 @@ namespace TrenchBroom {
         
         Assets::Texture* IdWalTextureReader::doReadTexture(const char* const begin, const char* const end, const Path& path) const {
             static const size_t MipLevels = 4;
-            static Color tempColor, averageColor;
-            static Assets::TextureBuffer::List buffers(MipLevels);
-            static size_t offset[MipLevels];
+            Color averageColor;
+            Assets::TextureBuffer::List buffers(MipLevels);
+            size_t offset[MipLevels];
 
             CharArrayReader reader(begin, end);
             const String name = reader.readString(WalLayout::TextureNameLength);
@@ -56,9 +56,10 @@ namespace TrenchBroom {
                 const size_t size = mipSize(width, height, i);
                 const char* data = begin + offset[i];
 
-                m_palette.indexedToRgb(data, size, buffers[i], tempColor);
                 if (i == 0)
-                    averageColor = tempColor;
+                    m_palette.indexedToRgb(data, size, buffers[i], averageColor);
+                else
+                    m_palette.indexedToRgb(data, size, buffers[i]);
             }
             
             return new Assets::Texture(textureName(name, path), width, height, averageColor, buffers);
@@ -40,99 +40,97 @@ namespace TrenchBroom {
             return m_file;
         }
         
-        ImageFileSystem::Directory::Directory(const Path& path) :
-        m_path(path) {}
+        ImageFileSystem::FileIndex::FileIndex() {
+            // the root directory always exists
+            m_directories[key(Path(""))];
+        }
         
-        ImageFileSystem::Directory::~Directory() {
-            MapUtils::clearAndDelete(m_directories);
-            MapUtils::clearAndDelete(m_files);
+        ImageFileSystem::FileIndex::~FileIndex() {
+            for (auto& entry : m_files)
+                delete entry.second.file;
+            m_files.clear();
         }
         
-        void ImageFileSystem::Directory::addFile(const Path& path, MappedFile::Ptr file) {
+        void ImageFileSystem::FileIndex::addFile(const Path& path, MappedFile::Ptr file) {
             addFile(path, new SimpleFile(file));
         }
 
-        void ImageFileSystem::Directory::addFile(const Path& path, File* file) {
+        void ImageFileSystem::FileIndex::addFile(const Path& path, File* file) {
             ensure(file != nullptr, "file is null");
-            const Path filename = path.lastComponent();
-            if (path.length() == 1) {
+            assert(!path.isEmpty());
+            
+            const Entry entry = { path, file };
+            const auto result = m_files.insert(std::make_pair(key(path), entry));
+            if (!result.second) {
                 // silently overwrite duplicates, the latest entries win
-                MapUtils::insertOrReplaceAndDelete(m_files, filename, file);
+                delete result.first->second.file;
+                result.first->second = entry;
             } else {
-                Directory& dir = findOrCreateDirectory(path.deleteLastComponent());
-                dir.addFile(filename, file);
+                addEntry(path);
             }
         }
         
-        bool ImageFileSystem::Directory::directoryExists(const Path& path) const {
-            if (path.isEmpty())
-                return true;
-            DirMap::const_iterator it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories))
-                return false;
-            return it->second->directoryExists(path.deleteFirstComponent());
+        bool ImageFileSystem::FileIndex::directoryExists(const Path& path) const {
+            return m_directories.count(key(path)) > 0;
         }
         
-        bool ImageFileSystem::Directory::fileExists(const Path& path) const {
-            if (path.length() == 1)
-                return m_files.count(path) > 0;
-            DirMap::const_iterator it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories))
-                return false;
-            return it->second->fileExists(path.deleteFirstComponent());
+        bool ImageFileSystem::FileIndex::fileExists(const Path& path) const {
+            return m_files.count(key(path)) > 0;
         }
         
-        const ImageFileSystem::Directory& ImageFileSystem::Directory::findDirectory(const Path& path) const {
-            if (path.isEmpty())
-                return *this;
-            DirMap::const_iterator it = m_directories.find(path.firstComponent());
-            if (it == std::end(m_directories))
-                throw FileSystemException("Path does not exist: '" + (m_path + path).asString() + "'");
-            return it->second->findDirectory(path.deleteFirstComponent());
-        }
-        
-        const MappedFile::Ptr ImageFileSystem::Directory::findFile(const Path& path) const {
+        const MappedFile::Ptr ImageFileSystem::FileIndex::findFile(const Path& path) const {
             assert(!path.isEmpty());
             
-            const Path name = path.firstComponent();
-            if (path.length() == 1) {
-                FileMap::const_iterator it = m_files.find(name);
-                if (it == std::end(m_files))
-                    throw FileSystemException("File not found: '" + (m_path + path).asString() + "'");
-                return it->second->open();
-            }
-            DirMap::const_iterator it = m_directories.find(name);
-            if (it == std::end(m_directories))
-                throw FileSystemException("File not found: '" + (m_path + path).asString() + "'");
-            return it->second->findFile(path.deleteFirstComponent());
+            const auto it = m_files.find(key(path));
+            if (it == std::end(m_files))
+                throw FileSystemException("File not found: '" + path.asString() + "'");
+            return it->second.file->open();
         }
         
-        Path::List ImageFileSystem::Directory::contents() const {
+        Path::List ImageFileSystem::FileIndex::contents(const Path& path) const {
+            const auto it = m_directories.find(key(path));
+            if (it == std::end(m_directories))
+                throw FileSystemException("Path does not exist: '" + path.asString() + "'");
+            
             Path::List contents;
+            contents.reserve(it->second.size());
             
-            for (const auto& entry : m_directories)
-                contents.push_back(Path(entry.first));
+            for (const auto& entry : it->second)
+                contents.push_back(entry.second);
+            
+            return contents;
+        }
+        
+        Path::List ImageFileSystem::FileIndex::allFiles() const {
+            Path::List result;
+            result.reserve(m_files.size());
             
             for (const auto& entry : m_files)
-                contents.push_back(Path(entry.first));
+                result.push_back(entry.second.path);
             
-            return contents;
+            return result;
+        }
+        
+        String ImageFileSystem::FileIndex::key(const Path& path) {
+            return StringUtils::toLower(path.asString('/'));
         }
         
-        ImageFileSystem::Directory& ImageFileSystem::Directory::findOrCreateDirectory(const Path& path) {
-            if (path.isEmpty())
-                return *this;
-            const Path name = path.firstComponent();
-            DirMap::iterator it = m_directories.lower_bound(name);
-            if (it == std::end(m_directories) || name != it->first)
-                it = m_directories.insert(it, std::make_pair(name, new Directory(m_path + Path(name))));
-            return it->second->findOrCreateDirectory(path.deleteFirstComponent());
+        void ImageFileSystem::FileIndex::addEntry(const Path& path) {
+            Path current = path;
+            while (!current.isEmpty()) {
+                const Path name = current.lastComponent();
+                const Path parent = current.deleteLastComponent();
+                
+                EntryMap& entries = m_directories[key(parent)];
+                if (!entries.insert(std::make_pair(key(name), name)).second)
+                    break; // the parent directories are already known
+                current = parent;
+            }
         }
         
         ImageFileSystem::ImageFileSystem(const Path& path, MappedFile::Ptr file) :
         m_path(path),
-        m_file(file),
-        m_root(Path("")) {}
+        m_file(file) {}
         
         
         ImageFileSystem::~ImageFileSystem() {}
@@ -146,24 +144,27 @@ namespace TrenchBroom {
         }
         
         bool ImageFileSystem::doDirectoryExists(const Path& path) const {
-            const Path searchPath = path.makeLowerCase();
-            return m_root.directoryExists(searchPath);
+            return m_index.directoryExists(path);
         }
         
         bool ImageFileSystem::doFileExists(const Path& path) const {
-            const Path searchPath = path.makeLowerCase();
-            return m_root.fileExists(searchPath);
+            return m_index.fileExists(path);
         }
         
         Path::List ImageFileSystem::doGetDirectoryContents(const Path& path) const {
-            const Path searchPath = path.makeLowerCase();
-            const Directory& directory = m_root.findDirectory(path);
-            return directory.contents();
+            return m_index.contents(path);
         }
         
         const MappedFile::Ptr ImageFileSystem::doOpenFile(const Path& path) const {
-            const Path searchPath = path.makeLowerCase();
-            return m_root.findFile(path);
+            return m_index.findFile(path);
+        }
+
+        bool ImageFileSystem::doHasFixedContents() const {
+            return true;
+        }
+        
+        Path::List ImageFileSystem::doGetAllFiles() const {
+            return m_index.allFiles();
         }
     }
 }
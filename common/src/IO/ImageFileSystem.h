@@ -25,6 +25,7 @@
 #include "IO/Path.h"
 
 #include <map>
+#include <unordered_map>
 
 namespace TrenchBroom {
     namespace IO {
@@ -48,17 +49,26 @@ namespace TrenchBroom {
                 MappedFile::Ptr doOpen() override;
             };
             
-            class Directory {
+            /**
+             * Indexes the files of an image by their lower case paths, so that a file can be looked up without
+             * walking the directory hierarchy. Every directory that contains a file is indexed, too.
+             */
+            class FileIndex {
             private:
-                typedef std::map<Path, Directory*, Path::Less<StringUtils::CaseInsensitiveStringLess>> DirMap;
-                typedef std::map<Path, File*,      Path::Less<StringUtils::CaseInsensitiveStringLess>> FileMap;
+                struct Entry {
+                    Path path;
+                    File* file;
+                };
+                typedef std::unordered_map<String, Entry> FileMap;
+                // maps the lower case names of the entries of a directory to their actual names
+                typedef std::map<String, Path> EntryMap;
+                typedef std::unordered_map<String, EntryMap> DirMap;
                 
-                Path m_path;
-                DirMap m_directories;
                 FileMap m_files;
+                DirMap m_directories;
             public:
-                Directory(const Path& path);
-                ~Directory();
+                FileIndex();
+                ~FileIndex();
                 
                 void addFile(const Path& path, MappedFile::Ptr file);
                 void addFile(const Path& path, File* file);
@@ -66,16 +76,17 @@ namespace TrenchBroom {
                 bool directoryExists(const Path& path) const;
                 bool fileExists(const Path& path) const;
                 
-                const Directory& findDirectory(const Path& path) const;
                 const MappedFile::Ptr findFile(const Path& path) const;
-                Path::List contents() const;
+                Path::List contents(const Path& path) const;
+                Path::List allFiles() const;
             private:
-                Directory& findOrCreateDirectory(const Path& path);
+                static String key(const Path& path);
+                void addEntry(const Path& path);
             };
         protected:
             Path m_path;
             MappedFile::Ptr m_file;
-            Directory m_root;
+            FileIndex m_index;
         protected:
             ImageFileSystem(const Path& path, MappedFile::Ptr file);
         public:
@@ -89,6 +100,9 @@ namespace TrenchBroom {
             
             Path::List doGetDirectoryContents(const Path& path) const override;
             const MappedFile::Ptr doOpenFile(const Path& path) const override;
+            
+            bool doHasFixedContents() const override;
+            Path::List doGetAllFiles() const override;
         private:
             virtual void doReadDirectory() = 0;
         };
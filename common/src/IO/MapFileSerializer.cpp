@@ -19,6 +19,7 @@
 
 #include "MapFileSerializer.h"
 #include "Exceptions.h"
+#include "ParallelUtils.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/Path.h"
 #include "Model/BrushFace.h"
@@ -28,251 +29,272 @@ namespace TrenchBroom {
         class StandardFileSerializer : public MapFileSerializer {
         private:
             bool m_longFormat;
-            String FaceFormat;
         public:
             StandardFileSerializer(FILE* stream, const bool longFormat) :
             MapFileSerializer(stream),
-            m_longFormat(longFormat) {
-                StringStream str;
-                str <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "%s %.6g %.6g %.6g %.6g %.6g";
-                if (m_longFormat)
-                    str << " %d %d %.6g";
-                FaceFormat = str.str();
-            }
+            m_longFormat(longFormat) {}
+            
+            StandardFileSerializer(OutputBuffer& buffer, const bool longFormat) :
+            MapFileSerializer(buffer),
+            m_longFormat(longFormat) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
+            size_t doWriteBrushFace(OutputBuffer& buffer, Model::BrushFace* face) override {
                 const String& textureName = face->textureName().empty() ? Model::BrushFace::NoTextureName : face->textureName();
-                const Model::BrushFace::Points& points = face->points();
+                
+                writePoints(buffer, face);
+                buffer.append(textureName);
+                buffer.append(' ');
+                buffer.appendDouble(face->xOffset(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(face->yOffset(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(face->rotation(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(face->xScale(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(face->yScale(), 6);
                 
                 if (m_longFormat) {
-                    std::fprintf(stream, FaceFormat.c_str(),
-                                 points[0].x(),
-                                 points[0].y(),
-                                 points[0].z(),
-                                 points[1].x(),
-                                 points[1].y(),
-                                 points[1].z(),
-                                 points[2].x(),
-                                 points[2].y(),
-                                 points[2].z(),
-                                 textureName.c_str(),
-                                 face->xOffset(),
-                                 face->yOffset(),
-                                 face->rotation(),
-                                 face->xScale(),
-                                 face->yScale(),
-                                 face->surfaceContents(),
-                                 face->surfaceFlags(),
-                                 face->surfaceValue());
-                } else {
-                    std::fprintf(stream, FaceFormat.c_str(),
-                                 points[0].x(),
-                                 points[0].y(),
-                                 points[0].z(),
-                                 points[1].x(),
-                                 points[1].y(),
-                                 points[1].z(),
-                                 points[2].x(),
-                                 points[2].y(),
-                                 points[2].z(),
-                                 textureName.c_str(),
-                                 face->xOffset(),
-                                 face->yOffset(),
-                                 face->rotation(),
-                                 face->xScale(),
-                                 face->yScale());
+                    buffer.append(' ');
+                    buffer.appendInteger(face->surfaceContents());
+                    buffer.append(' ');
+                    buffer.appendInteger(face->surfaceFlags());
+                    buffer.append(' ');
+                    buffer.appendDouble(face->surfaceValue(), 6);
                 }
-                std::fprintf(stream, "\n");
+                buffer.append('\n');
                 return 1;
             }
         };
         
         class Hexen2FileSerializer : public MapFileSerializer {
-        private:
-            String FaceFormat;
         public:
             Hexen2FileSerializer(FILE* stream) :
-            MapFileSerializer(stream) {
-                StringStream str;
-                str <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "%s %.6g %.6g %.6g %.6g %.6g 0\n"; // the extra value is written here
-                
-                FaceFormat = str.str();
-            }
+            MapFileSerializer(stream) {}
+            
+            Hexen2FileSerializer(OutputBuffer& buffer) :
+            MapFileSerializer(buffer) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
+            size_t doWriteBrushFace(OutputBuffer& buffer, Model::BrushFace* face) override {
                 const String& textureName = face->textureName().empty() ? Model::BrushFace::NoTextureName : face->textureName();
-                const Model::BrushFace::Points& points = face->points();
                 
-                std::fprintf(stream, FaceFormat.c_str(),
-                             points[0].x(),
-                             points[0].y(),
-                             points[0].z(),
-                             points[1].x(),
-                             points[1].y(),
-                             points[1].z(),
-                             points[2].x(),
-                             points[2].y(),
-                             points[2].z(),
-                             textureName.c_str(),
-                             face->xOffset(),
-                             face->yOffset(),
-                             face->rotation(),
-                             face->xScale(),
-                             face->yScale());
+                writePoints(buffer, face);
+                buffer.append(textureName);
+                buffer.append(' ');
+                buffer.appendDouble(face->xOffset(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(face->yOffset(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(face->rotation(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(face->xScale(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(face->yScale(), 6);
+                buffer.append(" 0\n"); // the extra value is written here
                 return 1;
             }
         };
         
         class ValveFileSerializer : public MapFileSerializer {
-        private:
-            String FaceFormat;
         public:
             ValveFileSerializer(FILE* stream) :
-            MapFileSerializer(stream) {
-                StringStream str;
-                str <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "( %." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g " <<
-                "%." << FloatPrecision << "g ) " <<
-                "%s " <<
-                "[ %.6g %.6g %.6g %.6g ] " <<
-                "[ %.6g %.6g %.6g %.6g ] " <<
-                "%.6g %.6g %.6g\n";
-                
-                FaceFormat = str.str();
-            }
+            MapFileSerializer(stream) {}
+            
+            ValveFileSerializer(OutputBuffer& buffer) :
+            MapFileSerializer(buffer) {}
         private:
-            size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) override {
+            size_t doWriteBrushFace(OutputBuffer& buffer, Model::BrushFace* face) override {
                 const String& textureName = face->textureName().empty() ? Model::BrushFace::NoTextureName : face->textureName();
                 const Vec3 xAxis = face->textureXAxis();
                 const Vec3 yAxis = face->textureYAxis();
-                const Model::BrushFace::Points& points = face->points();
                 
-                std::fprintf(stream, FaceFormat.c_str(),
-                             points[0].x(),
-                             points[0].y(),
-                             points[0].z(),
-                             points[1].x(),
-                             points[1].y(),
-                             points[1].z(),
-                             points[2].x(),
-                             points[2].y(),
-                             points[2].z(),
-                             
-                             textureName.c_str(),
-                             
-                             xAxis.x(),
-                             xAxis.y(),
-                             xAxis.z(),
-                             face->xOffset(),
-                             
-                             yAxis.x(),
-                             yAxis.y(),
-                             yAxis.z(),
-                             face->yOffset(),
-                             
-                             face->rotation(),
-                             face->xScale(),
-                             face->yScale());
+                writePoints(buffer, face);
+                buffer.append(textureName);
+                
+                buffer.append(" [ ");
+                buffer.appendDouble(xAxis.x(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(xAxis.y(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(xAxis.z(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(face->xOffset(), 6);
+                
+                buffer.append(" ] [ ");
+                buffer.appendDouble(yAxis.x(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(yAxis.y(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(yAxis.z(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(face->yOffset(), 6);
+                
+                buffer.append(" ] ");
+                buffer.appendDouble(face->rotation(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(face->xScale(), 6);
+                buffer.append(' ');
+                buffer.appendDouble(face->yScale(), 6);
+                buffer.append('\n');
                 return 1;
             }
         };
 
-        NodeSerializer::Ptr MapFileSerializer::create(const Model::MapFormat::Type format, FILE* stream) {
+        template <typename Target>
+        NodeSerializer::Ptr createFileSerializer(const Model::MapFormat::Type format, Target& target) {
             switch (format) {
                 case Model::MapFormat::Standard:
-                    return NodeSerializer::Ptr(new StandardFileSerializer(stream, false));
+                    return NodeSerializer::Ptr(new StandardFileSerializer(target, false));
                 case Model::MapFormat::Quake2:
-                    return NodeSerializer::Ptr(new StandardFileSerializer(stream, true));
+                    return NodeSerializer::Ptr(new StandardFileSerializer(target, true));
                 case Model::MapFormat::Valve:
-                    return NodeSerializer::Ptr(new ValveFileSerializer(stream));
+                    return NodeSerializer::Ptr(new ValveFileSerializer(target));
                 case Model::MapFormat::Hexen2:
-                    return NodeSerializer::Ptr(new Hexen2FileSerializer(stream));
+                    return NodeSerializer::Ptr(new Hexen2FileSerializer(target));
                 case Model::MapFormat::Unknown:
                 default:
                     throw FileFormatException("Unknown map file format");
             }
         }
         
+        NodeSerializer::Ptr MapFileSerializer::create(const Model::MapFormat::Type format, FILE* stream) {
+            return createFileSerializer(format, stream);
+        }
+        
+        NodeSerializer::Ptr MapFileSerializer::create(const Model::MapFormat::Type format, OutputBuffer& buffer) {
+            return createFileSerializer(format, buffer);
+        }
+        
         MapFileSerializer::MapFileSerializer(FILE* stream) :
         m_line(1),
-        m_stream(stream) {
+        m_stream(stream),
+        m_fileBuffer(FlushSize),
+        m_buffer(m_fileBuffer) {
             ensure(m_stream != nullptr, "stream is null");
         }
         
+        MapFileSerializer::MapFileSerializer(OutputBuffer& buffer) :
+        m_line(1),
+        m_stream(nullptr),
+        m_buffer(buffer) {}
+        
         void MapFileSerializer::doBeginFile() {}
-        void MapFileSerializer::doEndFile() {}
+        
+        void MapFileSerializer::doEndFile() {
+            if (m_stream != nullptr)
+                m_buffer.writeTo(m_stream);
+        }
 
         void MapFileSerializer::doBeginEntity(const Model::Node* node) {
-            std::fprintf(m_stream, "// entity %u\n", entityNo());
+            m_buffer.append("// entity ");
+            m_buffer.appendUnsigned(entityNo());
+            m_buffer.append('\n');
             ++m_line;
             m_startLineStack.push_back(m_line);
-            std::fprintf(m_stream, "{\n");
+            m_buffer.append("{\n");
             ++m_line;
         }
         
         void MapFileSerializer::doEndEntity(Model::Node* node) {
-            std::fprintf(m_stream, "}\n");
+            m_buffer.append("}\n");
             ++m_line;
             setFilePosition(node);
+            flushIfNecessary();
         }
         
-        void MapFileSerializer::doEntityAttribute(const Model::EntityAttribute& attribute) { 
-            std::fprintf(m_stream, "\"%s\" \"%s\"\n",
-                         escapeEntityAttribute( attribute.name()).c_str(),
-                         escapeEntityAttribute(attribute.value()).c_str());
+        void MapFileSerializer::doEntityAttribute(const Model::AttributeName& name, const Model::AttributeValue& value) {
+            m_buffer.append('"');
+            writeEscaped(name);
+            m_buffer.append("\" \"");
+            writeEscaped(value);
+            m_buffer.append("\"\n");
             ++m_line;
         }
         
         void MapFileSerializer::doBeginBrush(const Model::Brush* brush) {
-            std::fprintf(m_stream, "// brush %u\n", brushNo());
+            m_buffer.append("// brush ");
+            m_buffer.appendUnsigned(brushNo());
+            m_buffer.append('\n');
             ++m_line;
             m_startLineStack.push_back(m_line);
-            std::fprintf(m_stream, "{\n");
+            m_buffer.append("{\n");
             ++m_line;
         }
         
         void MapFileSerializer::doEndBrush(Model::Brush* brush) {
-            std::fprintf(m_stream, "}\n");
+            m_buffer.append("}\n");
             ++m_line;
             setFilePosition(brush);
+            flushIfNecessary();
         }
         
         void MapFileSerializer::doBrushFace(Model::BrushFace* face) {
-            const size_t lines = doWriteBrushFace(m_stream, face);
+            const size_t lines = doWriteBrushFace(m_buffer, face);
             face->setFilePosition(m_line, lines);
             m_line += lines;
         }
         
+        void MapFileSerializer::doBrushes(const Model::BrushList& brushes) {
+            if (brushes.size() < 2 * BrushesPerChunk) {
+                NodeSerializer::doBrushes(brushes);
+                return;
+            }
+            
+            // format chunks of brushes into separate buffers in parallel, then append the buffers in order
+            struct BrushChunk {
+                OutputBuffer buffer;
+                std::vector<size_t> faceLines;
+            };
+            
+            const size_t chunkCount = (brushes.size() + BrushesPerChunk - 1) / BrushesPerChunk;
+            std::vector<BrushChunk> chunks(chunkCount);
+            const ObjectNo firstBrushNo = brushNo();
+            
+            ParallelUtils::parallelFor(chunkCount, [&](const size_t i) {
+                BrushChunk& chunk = chunks[i];
+                const size_t first = i * BrushesPerChunk;
+                const size_t last = std::min(first + BrushesPerChunk, brushes.size());
+                for (size_t j = first; j < last; ++j) {
+                    chunk.buffer.append("// brush ");
+                    chunk.buffer.appendUnsigned(firstBrushNo + j);
+                    chunk.buffer.append("\n{\n");
+                    for (Model::BrushFace* face : brushes[j]->faces())
+                        chunk.faceLines.push_back(doWriteBrushFace(chunk.buffer, face));
+                    chunk.buffer.append("}\n");
+                }
+            });
+            
+            // the file positions depend on all preceding chunks, so they are set afterwards
+            for (size_t i = 0; i < chunkCount; ++i) {
+                const BrushChunk& chunk = chunks[i];
+                const size_t first = i * BrushesPerChunk;
+                const size_t last = std::min(first + BrushesPerChunk, brushes.size());
+                
+                size_t faceIndex = 0;
+                for (size_t j = first; j < last; ++j) {
+                    Model::Brush* brush = brushes[j];
+                    const size_t startLine = ++m_line;
+                    ++m_line;
+                    for (Model::BrushFace* face : brush->faces()) {
+                        const size_t lines = chunk.faceLines[faceIndex++];
+                        face->setFilePosition(m_line, lines);
+                        m_line += lines;
+                    }
+                    ++m_line;
+                    brush->setFilePosition(startLine, m_line - startLine);
+                }
+                
+                m_buffer.append(chunk.buffer);
+                flushIfNecessary();
+            }
+            
+            skipBrushes(brushes.size());
+        }
+        
         void MapFileSerializer::setFilePosition(Model::Node* node) {
             const size_t start = startLine();
-            node->setFilePosition(start, m_line - start);
+            if (node != nullptr)
+                node->setFilePosition(start, m_line - start);
         }
 
         size_t MapFileSerializer::startLine() {
@@ -281,5 +303,33 @@ namespace TrenchBroom {
             m_startLineStack.pop_back();
             return result;
         }
+
+        void MapFileSerializer::writeEscaped(const String& str) {
+            // same as escapeEntityAttribute, but without creating a temporary string
+            for (size_t i = 0; i < str.size(); ++i) {
+                const char c = str[i];
+                if (c == '"' && (i == 0 || str[i - 1] != '\\'))
+                    m_buffer.append('\\');
+                m_buffer.append(c);
+            }
+        }
+        
+        void MapFileSerializer::flushIfNecessary() {
+            if (m_stream != nullptr && m_buffer.size() >= FlushSize)
+                m_buffer.writeTo(m_stream);
+        }
+
+        void MapFileSerializer::writePoints(OutputBuffer& buffer, const Model::BrushFace* face) {
+            const Model::BrushFace::Points& points = face->points();
+            for (size_t i = 0; i < 3; ++i) {
+                buffer.append("( ");
+                buffer.appendDouble(points[i].x(), FloatPrecision);
+                buffer.append(' ');
+                buffer.appendDouble(points[i].y(), FloatPrecision);
+                buffer.append(' ');
+                buffer.appendDouble(points[i].z(), FloatPrecision);
+                buffer.append(" ) ");
+            }
+        }
     }
 }
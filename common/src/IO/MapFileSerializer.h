@@ -21,6 +21,7 @@
 #define TrenchBroom_MapFileSerializer
 
 #include "IO/NodeSerializer.h"
+#include "IO/OutputBuffer.h"
 #include "Model/MapFormat.h"
 #include "Model/Brush.h"
 #include "Model/Node.h"
@@ -33,29 +34,45 @@ namespace TrenchBroom {
         
         class MapFileSerializer : public NodeSerializer {
         private:
+            static const size_t FlushSize = 1 << 20;
+            static const size_t BrushesPerChunk = 256;
+            
             typedef std::vector<size_t> LineStack;
             LineStack m_startLineStack;
             size_t m_line;
             FILE* m_stream;
+            OutputBuffer m_fileBuffer;
+            OutputBuffer& m_buffer;
         public:
             static Ptr create(Model::MapFormat::Type format, FILE* stream);
+            /**
+             * Creates a serializer that appends the entire map to the given buffer instead of writing it to a file.
+             */
+            static Ptr create(Model::MapFormat::Type format, OutputBuffer& buffer);
         protected:
             MapFileSerializer(FILE* file);
+            MapFileSerializer(OutputBuffer& buffer);
         private:
             void doBeginFile() override;
             void doEndFile() override;
             
             void doBeginEntity(const Model::Node* node) override;
             void doEndEntity(Model::Node* node) override;
-            void doEntityAttribute(const Model::EntityAttribute& attribute) override;
+            void doEntityAttribute(const Model::AttributeName& name, const Model::AttributeValue& value) override;
             void doBeginBrush(const Model::Brush* brush) override;
             void doEndBrush(Model::Brush* brush) override;
             void doBrushFace(Model::BrushFace* face) override;
+            void doBrushes(const Model::BrushList& brushes) override;
         private:
             void setFilePosition(Model::Node* node);
             size_t startLine();
+            
+            void writeEscaped(const String& str);
+            void flushIfNecessary();
+        protected:
+            static void writePoints(OutputBuffer& buffer, const Model::BrushFace* face);
         private:
-            virtual size_t doWriteBrushFace(FILE* stream, Model::BrushFace* face) = 0;
+            virtual size_t doWriteBrushFace(OutputBuffer& buffer, Model::BrushFace* face) = 0;
         };
     }
 }
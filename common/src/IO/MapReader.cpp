@@ -21,6 +21,7 @@
 
 #include "CollectionUtils.h"
 #include "Logger.h"
+#include "ParallelUtils.h"
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/Entity.h"
@@ -55,25 +56,41 @@ namespace TrenchBroom {
             return m_id;
         }
 
+        MapReader::DeferredBrush::DeferredBrush(Model::Node* i_parent, const Model::BrushFaceList& i_faces, const size_t i_startLine, const size_t i_lineCount, const ExtraAttributes& i_extraAttributes) :
+        parent(i_parent),
+        faces(i_faces),
+        startLine(i_startLine),
+        lineCount(i_lineCount),
+        extraAttributes(i_extraAttributes),
+        brush(nullptr) {}
+
         MapReader::MapReader(const char* begin, const char* end) :
         StandardMapParser(begin, end),
         m_factory(nullptr),
         m_brushParent(nullptr),
-        m_currentNode(nullptr) {}
+        m_currentNode(nullptr),
+        m_deferBrushGeometry(false) {}
         
         MapReader::MapReader(const String& str) :
         StandardMapParser(str),
         m_factory(nullptr),
         m_brushParent(nullptr),
-        m_currentNode(nullptr) {}
+        m_currentNode(nullptr),
+        m_deferBrushGeometry(false) {}
         
         MapReader::~MapReader() {
             VectorUtils::clearAndDelete(m_faces);
+            clearDeferredBrushes();
+        }
+
+        void MapReader::setDeferBrushGeometry(const bool deferBrushGeometry) {
+            m_deferBrushGeometry = deferBrushGeometry;
         }
 
         void MapReader::readEntities(Model::MapFormat::Type format, const BBox3& worldBounds, ParserStatus& status) {
             m_worldBounds = worldBounds;
             parseEntities(format, status);
+            createDeferredBrushes(status);
             resolveNodes(status);
         }
         
@@ -223,6 +240,11 @@ namespace TrenchBroom {
         }
 
         void MapReader::createBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) {
+            if (m_deferBrushGeometry) {
+                deferBrush(startLine, lineCount, extraAttributes);
+                return;
+            }
+            
             try {
                 // sort the faces by the weight of their plane normals like QBSP does
                 Model::BrushFace::sortFaces(m_faces);
@@ -242,6 +264,69 @@ namespace TrenchBroom {
 
         }
 
+        void MapReader::deferBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes) {
+            m_deferredNodes.push_back(DeferredNode { m_brushParent, nullptr, m_deferredBrushes.size() });
+            m_deferredBrushes.push_back(DeferredBrush(m_brushParent, m_faces, startLine, lineCount, extraAttributes));
+            m_faces.clear();
+        }
+
+        void MapReader::createDeferredBrushes(ParserStatus& status) {
+            if (m_deferredNodes.empty())
+                return;
+            
+            // brushes are independent of each other, so their geometry can be built concurrently
+            ParallelUtils::parallelFor(m_deferredBrushes.size(), [this](const size_t index) {
+                DeferredBrush& info = m_deferredBrushes[index];
+                try {
+                    // sort the faces by the weight of their plane normals like QBSP does
+                    Model::BrushFace::sortFaces(info.faces);
+                    info.brush = m_factory->createBrush(m_worldBounds, info.faces);
+                } catch (GeometryException& e) {
+                    info.error = e.what();
+                }
+                info.faces.clear(); // the faces are owned by the brush or have been deleted by its constructor
+            });
+            
+            // hand the nodes and brushes to the subclass in file order
+            for (DeferredNode& entry : m_deferredNodes) {
+                if (entry.node != nullptr) {
+                    Model::Node* node = entry.node;
+                    entry.node = nullptr;
+                    onNode(entry.parent, node, status);
+                } else {
+                    DeferredBrush& info = m_deferredBrushes[entry.brushIndex];
+                    if (info.brush != nullptr) {
+                        Model::Brush* brush = info.brush;
+                        info.brush = nullptr;
+                        
+                        setFilePosition(brush, info.startLine, info.lineCount);
+                        setExtraAttributes(brush, info.extraAttributes);
+                        onBrush(info.parent, brush, status);
+                    } else {
+                        StringStream msg;
+                        msg << "Skipping brush: " << info.error;
+                        status.error(info.startLine, msg.str());
+                    }
+                }
+            }
+            
+            m_deferredNodes.clear();
+            m_deferredBrushes.clear();
+        }
+
+        void MapReader::clearDeferredBrushes() {
+            for (DeferredBrush& info : m_deferredBrushes) {
+                VectorUtils::clearAndDelete(info.faces);
+                delete info.brush;
+            }
+            m_deferredBrushes.clear();
+
+            // the nodes that have not been handed to the subclass yet are not attached to any parent
+            for (DeferredNode& entry : m_deferredNodes)
+                delete entry.node;
+            m_deferredNodes.clear();
+        }
+
         MapReader::ParentInfo::Type MapReader::storeNode(Model::Node* node, const Model::EntityAttribute::List& attributes, ParserStatus& status) {
             const String& layerIdStr = findAttribute(attributes, Model::AttributeNames::Layer);
             if (!StringUtils::isBlank(layerIdStr)) {
@@ -250,7 +335,7 @@ namespace TrenchBroom {
                     const Model::IdType layerId = static_cast<Model::IdType>(rawId);
                     Model::Layer* layer = MapUtils::find(m_layers, layerId, static_cast<Model::Layer*>(nullptr));
                     if (layer != nullptr)
-                        onNode(layer, node, status);
+                        addNode(layer, node, status);
                     else
                         m_unresolvedNodes.push_back(std::make_pair(node, ParentInfo::layer(layerId)));
                     return ParentInfo::Type_Layer;
@@ -267,7 +352,7 @@ namespace TrenchBroom {
                         const Model::IdType groupId = static_cast<Model::IdType>(rawId);
                         Model::Group* group = MapUtils::find(m_groups, groupId, static_cast<Model::Group*>(nullptr));
                         if (group != nullptr)
-                            onNode(group, node, status);
+                            addNode(group, node, status);
                         else
                             m_unresolvedNodes.push_back(std::make_pair(node, ParentInfo::group(groupId)));
                         return ParentInfo::Type_Group;
@@ -279,10 +364,17 @@ namespace TrenchBroom {
                 }
             }
             
-            onNode(nullptr, node, status);
+            addNode(nullptr, node, status);
             return ParentInfo::Type_None;
         }
 
+        void MapReader::addNode(Model::Node* parent, Model::Node* node, ParserStatus& status) {
+            if (m_deferBrushGeometry)
+                m_deferredNodes.push_back(DeferredNode { parent, node, 0 });
+            else
+                onNode(parent, node, status);
+        }
+
         void MapReader::stripParentAttributes(Model::AttributableNode* attributable, const ParentInfo::Type parentType) {
             switch (parentType) {
                 case ParentInfo::Type_Layer:
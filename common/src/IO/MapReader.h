@@ -69,6 +69,35 @@ namespace TrenchBroom {
             typedef std::pair<Model::Node*, ParentInfo> NodeParentPair;
             typedef std::vector<NodeParentPair> NodeParentList;
             
+            /**
+             * A brush whose faces have been parsed, but whose geometry has not been built yet.
+             */
+            struct DeferredBrush {
+                Model::Node* parent;
+                Model::BrushFaceList faces;
+                size_t startLine;
+                size_t lineCount;
+                ExtraAttributes extraAttributes;
+                Model::Brush* brush;
+                String error;
+                
+                DeferredBrush(Model::Node* i_parent, const Model::BrushFaceList& i_faces, size_t i_startLine, size_t i_lineCount, const ExtraAttributes& i_extraAttributes);
+            };
+            typedef std::vector<DeferredBrush> DeferredBrushList;
+            
+            /**
+             * A node or a deferred brush that is added to its parent once all deferred brushes have been built. If node
+             * is null, the entry refers to the deferred brush at the given index. The node is reset to null once it has
+             * been added to its parent, so that only the nodes which are still owned by the reader are deleted if
+             * reading fails.
+             */
+            struct DeferredNode {
+                Model::Node* parent;
+                Model::Node* node;
+                size_t brushIndex;
+            };
+            typedef std::vector<DeferredNode> DeferredNodeList;
+            
             BBox3 m_worldBounds;
             Model::ModelFactory* m_factory;
             
@@ -79,10 +108,21 @@ namespace TrenchBroom {
             LayerMap m_layers;
             GroupMap m_groups;
             NodeParentList m_unresolvedNodes;
+            
+            bool m_deferBrushGeometry;
+            DeferredBrushList m_deferredBrushes;
+            DeferredNodeList m_deferredNodes;
         protected:
             MapReader(const char* begin, const char* end);
             MapReader(const String& str);
             
+            /**
+             * If enabled, the geometry of the brushes is not built while parsing. Instead, the faces of all brushes are
+             * collected and the brushes are built on multiple threads once the entities have been parsed. The brushes
+             * and nodes are then passed to the subclass in the order in which they were read.
+             */
+            void setDeferBrushGeometry(bool deferBrushGeometry);
+            
             void readEntities(Model::MapFormat::Type format, const BBox3& worldBounds, ParserStatus& status);
             void readBrushes(Model::MapFormat::Type format, const BBox3& worldBounds, ParserStatus& status);
             void readBrushFaces(Model::MapFormat::Type format, const BBox3& worldBounds, ParserStatus& status);
@@ -100,8 +140,12 @@ namespace TrenchBroom {
             void createGroup(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createEntity(size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status);
             void createBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status);
+            void deferBrush(size_t startLine, size_t lineCount, const ExtraAttributes& extraAttributes);
+            void createDeferredBrushes(ParserStatus& status);
+            void clearDeferredBrushes();
 
             ParentInfo::Type storeNode(Model::Node* node, const Model::EntityAttribute::List& attributes, ParserStatus& status);
+            void addNode(Model::Node* parent, Model::Node* node, ParserStatus& status);
             void stripParentAttributes(Model::AttributableNode* attributable, ParentInfo::Type parentType);
             
             void resolveNodes(ParserStatus& status);
@@ -0,0 +1,85 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapSnapshot.h"
+
+#include "CollectionUtils.h"
+#include "IO/NodeSerializer.h"
+#include "IO/NodeWriter.h"
+#include "Model/BrushFace.h"
+#include "Model/World.h"
+
+namespace TrenchBroom {
+    namespace IO {
+        class MapSnapshot::Recorder : public NodeSerializer {
+        private:
+            EntityList& m_entities;
+        public:
+            Recorder(EntityList& entities) :
+            m_entities(entities) {}
+        private:
+            void doBeginFile() override {}
+            void doEndFile() override {}
+            
+            void doBeginEntity(const Model::Node* node) override {
+                m_entities.push_back(EntitySnapshot());
+            }
+            
+            void doEndEntity(Model::Node* node) override {}
+            
+            void doEntityAttribute(const Model::AttributeName& name, const Model::AttributeValue& value) override {
+                m_entities.back().attributes.push_back(Model::EntityAttribute(name, value));
+            }
+            
+            void doBeginBrush(const Model::Brush* brush) override {
+                m_entities.back().brushes.push_back(Model::BrushFaceList());
+            }
+            
+            void doEndBrush(Model::Brush* brush) override {}
+            
+            void doBrushFace(Model::BrushFace* face) override {
+                m_entities.back().brushes.back().push_back(face->cloneWithoutTexture());
+            }
+        };
+        
+        MapSnapshot::MapSnapshot(Model::World* world) :
+        m_format(world->format()) {
+            NodeWriter writer(world, new Recorder(m_entities));
+            writer.writeMap();
+        }
+        
+        MapSnapshot::~MapSnapshot() {
+            for (EntitySnapshot& entity : m_entities) {
+                for (Model::BrushFaceList& faces : entity.brushes)
+                    VectorUtils::clearAndDelete(faces);
+            }
+        }
+        
+        Model::MapFormat::Type MapSnapshot::format() const {
+            return m_format;
+        }
+        
+        void MapSnapshot::write(NodeSerializer& serializer) const {
+            serializer.beginFile();
+            for (const EntitySnapshot& entity : m_entities)
+                serializer.entity(entity.attributes, entity.brushes);
+            serializer.endFile();
+        }
+    }
+}
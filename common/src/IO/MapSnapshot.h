@@ -0,0 +1,64 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_MapSnapshot
+#define TrenchBroom_MapSnapshot
+
+#include "Macros.h"
+#include "Model/EntityAttributes.h"
+#include "Model/MapFormat.h"
+#include "Model/ModelTypes.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        class NodeSerializer;
+        
+        /**
+         * Records what the serializer writes for a map: the attributes of every entity and copies of the faces of
+         * every brush, in the order in which they are written. Taking a snapshot builds no brush geometry, references
+         * no textures and leaves the nodes alone, so the snapshot can be written on another thread while the map is
+         * being edited.
+         */
+        class MapSnapshot {
+        private:
+            class Recorder;
+            
+            struct EntitySnapshot {
+                Model::EntityAttribute::List attributes;
+                std::vector<Model::BrushFaceList> brushes;
+            };
+            typedef std::vector<EntitySnapshot> EntityList;
+            
+            Model::MapFormat::Type m_format;
+            EntityList m_entities;
+        public:
+            MapSnapshot(Model::World* world);
+            ~MapSnapshot();
+            
+            Model::MapFormat::Type format() const;
+            void write(NodeSerializer& serializer) const;
+            
+            deleteCopyAndAssignment(MapSnapshot)
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_MapSnapshot) */
@@ -182,8 +182,8 @@ namespace TrenchBroom {
             m_stream << "}\n";
         }
         
-        void MapStreamSerializer::doEntityAttribute(const Model::EntityAttribute& attribute) {
-            m_stream << "\"" << escapeEntityAttribute(attribute.name()) << "\" \"" << escapeEntityAttribute(attribute.value()) << "\"\n";
+        void MapStreamSerializer::doEntityAttribute(const Model::AttributeName& name, const Model::AttributeValue& value) {
+            m_stream << "\"" << escapeEntityAttribute(name) << "\" \"" << escapeEntityAttribute(value) << "\"\n";
         }
         
         void MapStreamSerializer::doBeginBrush(const Model::Brush* brush) {
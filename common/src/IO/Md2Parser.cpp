@@ -35,171 +35,6 @@
 
 namespace TrenchBroom {
     namespace IO {
-        const Vec3f Md2Parser::Normals[162] = {
-            Vec3f(-0.525731f, 0.000000f, 0.850651f),
-            Vec3f(-0.442863f, 0.238856f, 0.864188f),
-            Vec3f(-0.295242f, 0.000000f, 0.955423f),
-            Vec3f(-0.309017f, 0.500000f, 0.809017f),
-            Vec3f(-0.162460f, 0.262866f, 0.951056f),
-            Vec3f(0.000000f, 0.000000f, 1.000000f),
-            Vec3f(0.000000f, 0.850651f, 0.525731f),
-            Vec3f(-0.147621f, 0.716567f, 0.681718f),
-            Vec3f(0.147621f, 0.716567f, 0.681718f),
-            Vec3f(0.000000f, 0.525731f, 0.850651f),
-            Vec3f(0.309017f, 0.500000f, 0.809017f),
-            Vec3f(0.525731f, 0.000000f, 0.850651f),
-            Vec3f(0.295242f, 0.000000f, 0.955423f),
-            Vec3f(0.442863f, 0.238856f, 0.864188f),
-            Vec3f(0.162460f, 0.262866f, 0.951056f),
-            Vec3f(-0.681718f, 0.147621f, 0.716567f),
-            Vec3f(-0.809017f, 0.309017f, 0.500000f),
-            Vec3f(-0.587785f, 0.425325f, 0.688191f),
-            Vec3f(-0.850651f, 0.525731f, 0.000000f),
-            Vec3f(-0.864188f, 0.442863f, 0.238856f),
-            Vec3f(-0.716567f, 0.681718f, 0.147621f),
-            Vec3f(-0.688191f, 0.587785f, 0.425325f),
-            Vec3f(-0.500000f, 0.809017f, 0.309017f),
-            Vec3f(-0.238856f, 0.864188f, 0.442863f),
-            Vec3f(-0.425325f, 0.688191f, 0.587785f),
-            Vec3f(-0.716567f, 0.681718f, -0.147621f),
-            Vec3f(-0.500000f, 0.809017f, -0.309017f),
-            Vec3f(-0.525731f, 0.850651f, 0.000000f),
-            Vec3f(0.000000f, 0.850651f, -0.525731f),
-            Vec3f(-0.238856f, 0.864188f, -0.442863f),
-            Vec3f(0.000000f, 0.955423f, -0.295242f),
-            Vec3f(-0.262866f, 0.951056f, -0.162460f),
-            Vec3f(0.000000f, 1.000000f, 0.000000f),
-            Vec3f(0.000000f, 0.955423f, 0.295242f),
-            Vec3f(-0.262866f, 0.951056f, 0.162460f),
-            Vec3f(0.238856f, 0.864188f, 0.442863f),
-            Vec3f(0.262866f, 0.951056f, 0.162460f),
-            Vec3f(0.500000f, 0.809017f, 0.309017f),
-            Vec3f(0.238856f, 0.864188f, -0.442863f),
-            Vec3f(0.262866f, 0.951056f, -0.162460f),
-            Vec3f(0.500000f, 0.809017f, -0.309017f),
-            Vec3f(0.850651f, 0.525731f, 0.000000f),
-            Vec3f(0.716567f, 0.681718f, 0.147621f),
-            Vec3f(0.716567f, 0.681718f, -0.147621f),
-            Vec3f(0.525731f, 0.850651f, 0.000000f),
-            Vec3f(0.425325f, 0.688191f, 0.587785f),
-            Vec3f(0.864188f, 0.442863f, 0.238856f),
-            Vec3f(0.688191f, 0.587785f, 0.425325f),
-            Vec3f(0.809017f, 0.309017f, 0.500000f),
-            Vec3f(0.681718f, 0.147621f, 0.716567f),
-            Vec3f(0.587785f, 0.425325f, 0.688191f),
-            Vec3f(0.955423f, 0.295242f, 0.000000f),
-            Vec3f(1.000000f, 0.000000f, 0.000000f),
-            Vec3f(0.951056f, 0.162460f, 0.262866f),
-            Vec3f(0.850651f, -0.525731f, 0.000000f),
-            Vec3f(0.955423f, -0.295242f, 0.000000f),
-            Vec3f(0.864188f, -0.442863f, 0.238856f),
-            Vec3f(0.951056f, -0.162460f, 0.262866f),
-            Vec3f(0.809017f, -0.309017f, 0.500000f),
-            Vec3f(0.681718f, -0.147621f, 0.716567f),
-            Vec3f(0.850651f, 0.000000f, 0.525731f),
-            Vec3f(0.864188f, 0.442863f, -0.238856f),
-            Vec3f(0.809017f, 0.309017f, -0.500000f),
-            Vec3f(0.951056f, 0.162460f, -0.262866f),
-            Vec3f(0.525731f, 0.000000f, -0.850651f),
-            Vec3f(0.681718f, 0.147621f, -0.716567f),
-            Vec3f(0.681718f, -0.147621f, -0.716567f),
-            Vec3f(0.850651f, 0.000000f, -0.525731f),
-            Vec3f(0.809017f, -0.309017f, -0.500000f),
-            Vec3f(0.864188f, -0.442863f, -0.238856f),
-            Vec3f(0.951056f, -0.162460f, -0.262866f),
-            Vec3f(0.147621f, 0.716567f, -0.681718f),
-            Vec3f(0.309017f, 0.500000f, -0.809017f),
-            Vec3f(0.425325f, 0.688191f, -0.587785f),
-            Vec3f(0.442863f, 0.238856f, -0.864188f),
-            Vec3f(0.587785f, 0.425325f, -0.688191f),
-            Vec3f(0.688191f, 0.587785f, -0.425325f),
-            Vec3f(-0.147621f, 0.716567f, -0.681718f),
-            Vec3f(-0.309017f, 0.500000f, -0.809017f),
-            Vec3f(0.000000f, 0.525731f, -0.850651f),
-            Vec3f(-0.525731f, 0.000000f, -0.850651f),
-            Vec3f(-0.442863f, 0.238856f, -0.864188f),
-            Vec3f(-0.295242f, 0.000000f, -0.955423f),
-            Vec3f(-0.162460f, 0.262866f, -0.951056f),
-            Vec3f(0.000000f, 0.000000f, -1.000000f),
-            Vec3f(0.295242f, 0.000000f, -0.955423f),
-            Vec3f(0.162460f, 0.262866f, -0.951056f),
-            Vec3f(-0.442863f, -0.238856f, -0.864188f),
-            Vec3f(-0.309017f, -0.500000f, -0.809017f),
-            Vec3f(-0.162460f, -0.262866f, -0.951056f),
-            Vec3f(0.000000f, -0.850651f, -0.525731f),
-            Vec3f(-0.147621f, -0.716567f, -0.681718f),
-            Vec3f(0.147621f, -0.716567f, -0.681718f),
-            Vec3f(0.000000f, -0.525731f, -0.850651f),
-            Vec3f(0.309017f, -0.500000f, -0.809017f),
-            Vec3f(0.442863f, -0.238856f, -0.864188f),
-            Vec3f(0.162460f, -0.262866f, -0.951056f),
-            Vec3f(0.238856f, -0.864188f, -0.442863f),
-            Vec3f(0.500000f, -0.809017f, -0.309017f),
-            Vec3f(0.425325f, -0.688191f, -0.587785f),
-            Vec3f(0.716567f, -0.681718f, -0.147621f),
-            Vec3f(0.688191f, -0.587785f, -0.425325f),
-            Vec3f(0.587785f, -0.425325f, -0.688191f),
-            Vec3f(0.000000f, -0.955423f, -0.295242f),
-            Vec3f(0.000000f, -1.000000f, 0.000000f),
-            Vec3f(0.262866f, -0.951056f, -0.162460f),
-            Vec3f(0.000000f, -0.850651f, 0.525731f),
-            Vec3f(0.000000f, -0.955423f, 0.295242f),
-            Vec3f(0.238856f, -0.864188f, 0.442863f),
-            Vec3f(0.262866f, -0.951056f, 0.162460f),
-            Vec3f(0.500000f, -0.809017f, 0.309017f),
-            Vec3f(0.716567f, -0.681718f, 0.147621f),
-            Vec3f(0.525731f, -0.850651f, 0.000000f),
-            Vec3f(-0.238856f, -0.864188f, -0.442863f),
-            Vec3f(-0.500000f, -0.809017f, -0.309017f),
-            Vec3f(-0.262866f, -0.951056f, -0.162460f),
-            Vec3f(-0.850651f, -0.525731f, 0.000000f),
-            Vec3f(-0.716567f, -0.681718f, -0.147621f),
-            Vec3f(-0.716567f, -0.681718f, 0.147621f),
-            Vec3f(-0.525731f, -0.850651f, 0.000000f),
-            Vec3f(-0.500000f, -0.809017f, 0.309017f),
-            Vec3f(-0.238856f, -0.864188f, 0.442863f),
-            Vec3f(-0.262866f, -0.951056f, 0.162460f),
-            Vec3f(-0.864188f, -0.442863f, 0.238856f),
-            Vec3f(-0.809017f, -0.309017f, 0.500000f),
-            Vec3f(-0.688191f, -0.587785f, 0.425325f),
-            Vec3f(-0.681718f, -0.147621f, 0.716567f),
-            Vec3f(-0.442863f, -0.238856f, 0.864188f),
-            Vec3f(-0.587785f, -0.425325f, 0.688191f),
-            Vec3f(-0.309017f, -0.500000f, 0.809017f),
-            Vec3f(-0.147621f, -0.716567f, 0.681718f),
-            Vec3f(-0.425325f, -0.688191f, 0.587785f),
-            Vec3f(-0.162460f, -0.262866f, 0.951056f),
-            Vec3f(0.442863f, -0.238856f, 0.864188f),
-            Vec3f(0.162460f, -0.262866f, 0.951056f),
-            Vec3f(0.309017f, -0.500000f, 0.809017f),
-            Vec3f(0.147621f, -0.716567f, 0.681718f),
-            Vec3f(0.000000f, -0.525731f, 0.850651f),
-            Vec3f(0.425325f, -0.688191f, 0.587785f),
-            Vec3f(0.587785f, -0.425325f, 0.688191f),
-            Vec3f(0.688191f, -0.587785f, 0.425325f),
-            Vec3f(-0.955423f, 0.295242f, 0.000000f),
-            Vec3f(-0.951056f, 0.162460f, 0.262866f),
-            Vec3f(-1.000000f, 0.000000f, 0.000000f),
-            Vec3f(-0.850651f, 0.000000f, 0.525731f),
-            Vec3f(-0.955423f, -0.295242f, 0.000000f),
-            Vec3f(-0.951056f, -0.162460f, 0.262866f),
-            Vec3f(-0.864188f, 0.442863f, -0.238856f),
-            Vec3f(-0.951056f, 0.162460f, -0.262866f),
-            Vec3f(-0.809017f, 0.309017f, -0.500000f),
-            Vec3f(-0.864188f, -0.442863f, -0.238856f),
-            Vec3f(-0.951056f, -0.162460f, -0.262866f),
-            Vec3f(-0.809017f, -0.309017f, -0.500000f),
-            Vec3f(-0.681718f, 0.147621f, -0.716567f),
-            Vec3f(-0.681718f, -0.147621f, -0.716567f),
-            Vec3f(-0.850651f, 0.000000f, -0.525731f),
-            Vec3f(-0.688191f, 0.587785f, -0.425325f),
-            Vec3f(-0.587785f, 0.425325f, -0.688191f),
-            Vec3f(-0.425325f, 0.688191f, -0.587785f),
-            Vec3f(-0.425325f, -0.688191f, -0.587785f),
-            Vec3f(-0.587785f, -0.425325f, -0.688191f),
-            Vec3f(-0.688191f, -0.587785f, -0.425325f)
-        };
-        
         Md2Parser::Md2Frame::Md2Frame(const size_t vertexCount) :
         vertices(vertexCount) {}
 
@@ -211,26 +46,21 @@ namespace TrenchBroom {
             return position * scale + offset;
         }
 
-        const Vec3f& Md2Parser::Md2Frame::normal(const size_t index) const {
-            const Md2Vertex& vertex = vertices[index];
-            return Normals[vertex.normalIndex];
-        }
-
         Md2Parser::Md2Mesh::Md2Mesh(const int i_vertexCount) :
         type(i_vertexCount < 0 ? Fan : Strip),
         vertexCount(static_cast<size_t>(i_vertexCount < 0 ? -i_vertexCount : i_vertexCount)),
         vertices(vertexCount) {}
 
-        Md2Parser::Md2Parser(const String& name, const char* begin, const char* end, const Assets::Palette& palette, const FileSystem& fs) :
+        Md2Parser::Md2Parser(const String& name, MappedFile::Ptr file, const Assets::Palette& palette, const FileSystem& fs) :
         m_name(name),
-        m_begin(begin),
-        /* m_end(end), */
+        m_file(file),
         m_palette(palette),
         m_fs(fs) {}
         
         // http://tfc.duke.free.fr/old/models/md2.htm
         Assets::EntityModel* Md2Parser::doParseModel() {
-            const char* cursor = m_begin;
+            const char* begin = m_file->begin();
+            const char* cursor = begin;
             const int ident = readInt<int32_t>(cursor);
             const int version = readInt<int32_t>(cursor);
             
@@ -256,11 +86,22 @@ namespace TrenchBroom {
             const size_t frameOffset = readSize<int32_t>(cursor);
             const size_t commandOffset = readSize<int32_t>(cursor);
 
-            const Md2SkinList skins = parseSkins(m_begin + skinOffset, skinCount);
-            const Md2FrameList frames = parseFrames(m_begin + frameOffset, frameCount, frameVertexCount);
-            const Md2MeshList meshes = parseMeshes(m_begin + commandOffset, commandCount);
+            const size_t frameSize = 2 * 3 * sizeof(float) + Md2Layout::FrameNameLength + frameVertexCount * sizeof(Md2Vertex);
+            if (frameOffset + frameCount * frameSize > m_file->size())
+                throw AssetException() << "MD2 model frames exceed file size";
+
+            const Md2SkinList skins = parseSkins(begin + skinOffset, skinCount);
+            const Md2MeshList meshes = parseMeshes(begin + commandOffset, commandCount);
+            const Assets::TextureList modelTextures = loadTextures(skins);
+            
+            // the frames are decoded when they are used, the decoder keeps the file mapped until then
+            const MappedFile::Ptr file = m_file;
+            const Assets::Md2Model::FrameDecoder decoder = [file, frameOffset, frameSize, frameVertexCount, meshes](const size_t frameIndex) {
+                const Md2Frame frame = parseFrame(file->begin() + frameOffset + frameIndex * frameSize, frameVertexCount);
+                return buildFrame(frame, meshes);
+            };
             
-            return buildModel(skins, frames, meshes);
+            return new Assets::Md2Model(m_name, modelTextures, frameCount, decoder);
         }
 
         Md2Parser::Md2SkinList Md2Parser::parseSkins(const char* begin, const size_t skinCount) {
@@ -269,20 +110,6 @@ namespace TrenchBroom {
             return skins;
         }
 
-        Md2Parser::Md2FrameList Md2Parser::parseFrames(const char* begin, const size_t frameCount, const size_t frameVertexCount) {
-            Md2FrameList frames(frameCount, Md2Frame(frameVertexCount));
-
-            const char* cursor = begin;
-            for (size_t i = 0; i < frameCount; ++i) {
-                frames[i].scale = readVec3f(cursor);
-                frames[i].offset = readVec3f(cursor);
-                readBytes(cursor, frames[i].name, Md2Layout::FrameNameLength);
-                readVector(cursor, frames[i].vertices);
-            }
-            
-            return frames;
-        }
-
         Md2Parser::Md2MeshList Md2Parser::parseMeshes(const char* begin, const size_t commandCount) {
             Md2MeshList meshes;
             
@@ -303,12 +130,6 @@ namespace TrenchBroom {
             return meshes;
         }
 
-        Assets::EntityModel* Md2Parser::buildModel(const Md2SkinList& skins, const Md2FrameList& frames, const Md2MeshList& meshes) {
-            const Assets::TextureList modelTextures = loadTextures(skins);
-            const Assets::Md2Model::FrameList modelFrames = buildFrames(frames, meshes);
-            return new Assets::Md2Model(m_name, modelTextures, modelFrames);
-        }
-
         Assets::TextureList Md2Parser::loadTextures(const Md2SkinList& skins) {
             Assets::TextureList textures;
             textures.reserve(skins.size());
@@ -337,13 +158,16 @@ namespace TrenchBroom {
             return new Assets::Texture(skin.name, image.width(), image.height(), avgColor, rgbImage);
         }
 
-        Assets::Md2Model::FrameList Md2Parser::buildFrames(const Md2FrameList& frames, const Md2MeshList& meshes) {
-            Assets::Md2Model::FrameList modelFrames;
-            modelFrames.reserve(frames.size());
+        Md2Parser::Md2Frame Md2Parser::parseFrame(const char* begin, const size_t frameVertexCount) {
+            Md2Frame frame(frameVertexCount);
+            
+            const char* cursor = begin;
+            frame.scale = readVec3f(cursor);
+            frame.offset = readVec3f(cursor);
+            readBytes(cursor, frame.name, Md2Layout::FrameNameLength);
+            readVector(cursor, frame.vertices);
             
-            for (const Md2Frame& frame : frames)
-                modelFrames.push_back(buildFrame(frame, meshes));
-            return modelFrames;
+            return frame;
         }
 
         Assets::Md2Model::Frame* Md2Parser::buildFrame(const Md2Frame& frame, const Md2MeshList& meshes) {
@@ -371,7 +195,7 @@ namespace TrenchBroom {
             return new Assets::Md2Model::Frame(builder.vertices(), builder.indexArray());
         }
         
-        Assets::Md2Model::VertexList Md2Parser::getVertices(const Md2Frame& frame, const Md2MeshVertexList& meshVertices) const {
+        Assets::Md2Model::VertexList Md2Parser::getVertices(const Md2Frame& frame, const Md2MeshVertexList& meshVertices) {
             typedef Assets::Md2Model::Vertex Vertex;
 
             Vertex::List result(0);
@@ -379,10 +203,9 @@ namespace TrenchBroom {
             
             for (const Md2MeshVertex& md2MeshVertex : meshVertices) {
                 const Vec3f position = frame.vertex(md2MeshVertex.vertexIndex);
-                const Vec3f& normal = frame.normal(md2MeshVertex.vertexIndex);
                 const Vec2f& texCoords = md2MeshVertex.texCoords;
                 
-                result.push_back(Vertex(position, normal, texCoords));
+                result.push_back(Vertex(position, texCoords));
             }
             
             return result;
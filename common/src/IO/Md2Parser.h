@@ -25,6 +25,7 @@
 #include "Assets/AssetTypes.h"
 #include "Assets/Md2Model.h"
 #include "IO/EntityModelParser.h"
+#include "IO/MappedFile.h"
 
 #include <vector>
 
@@ -48,8 +49,6 @@ namespace TrenchBroom {
         // see http://tfc.duke.free.fr/coding/md2-specs-en.html
         class Md2Parser : public EntityModelParser {
         private:
-            static const Vec3f Normals[162];
-
             struct Md2Skin {
                 char name[Md2Layout::SkinNameLength];
             };
@@ -69,7 +68,6 @@ namespace TrenchBroom {
                 
                 Md2Frame(size_t vertexCount);
                 Vec3f vertex(size_t index) const;
-                const Vec3f& normal(size_t index) const;
             };
             typedef std::vector<Md2Frame> Md2FrameList;
 
@@ -95,23 +93,24 @@ namespace TrenchBroom {
             
             
             String m_name;
-            const char* m_begin;
-            /* const char* m_end; */
+            MappedFile::Ptr m_file;
             const Assets::Palette& m_palette;
             const FileSystem& m_fs;
         public:
-            Md2Parser(const String& name, const char* begin, const char* end, const Assets::Palette& palette, const FileSystem& fs);
+            /**
+             * Creates a parser for the given file. The parsed model keeps a reference to the file and decodes its
+             * frames from it when they are used.
+             */
+            Md2Parser(const String& name, MappedFile::Ptr file, const Assets::Palette& palette, const FileSystem& fs);
         private:
             Assets::EntityModel* doParseModel() override;
             Md2SkinList parseSkins(const char* begin, const size_t skinCount);
-            Md2FrameList parseFrames(const char* begin, const size_t frameCount, const size_t frameVertexCount);
             Md2MeshList parseMeshes(const char* begin, const size_t commandCount);
-            Assets::EntityModel* buildModel(const Md2SkinList& skins, const Md2FrameList& frames, const Md2MeshList& meshes);
             Assets::TextureList loadTextures(const Md2SkinList& skins);
             Assets::Texture* readTexture(const Md2Skin& skin);
-            Assets::Md2Model::FrameList buildFrames(const Md2FrameList& frames, const Md2MeshList& meshes);
-            Assets::Md2Model::Frame* buildFrame(const Md2Frame& frame, const Md2MeshList& meshes);
-            Assets::Md2Model::VertexList getVertices(const Md2Frame& frame, const Md2MeshVertexList& meshVertices) const;
+            static Md2Frame parseFrame(const char* begin, const size_t frameVertexCount);
+            static Assets::Md2Model::Frame* buildFrame(const Md2Frame& frame, const Md2MeshList& meshes);
+            static Assets::Md2Model::VertexList getVertices(const Md2Frame& frame, const Md2MeshVertexList& meshVertices);
         };
     }
 }
@@ -20,6 +20,7 @@
 #include "MdlParser.h"
 
 #include "CollectionUtils.h"
+#include "Exceptions.h"
 #include "Macros.h"
 #include "Assets/Texture.h"
 #include "Assets/MdlModel.h"
@@ -27,6 +28,8 @@
 #include "IO/IOUtils.h"
 
 #include <cassert>
+#include <limits>
+#include <memory>
 
 namespace TrenchBroom {
     namespace IO {
@@ -37,7 +40,7 @@ namespace TrenchBroom {
             static const unsigned int SimpleFrameName   = 0x8;
             static const unsigned int SimpleFrameLength = 0x10;
             static const unsigned int MultiFrameTimes   = 0xC;
-            // static const unsigned int FrameVertexSize   = 0x4;
+            static const unsigned int FrameVertexSize   = 0x4;
         }
 
         const Vec3f MdlParser::Normals[] = {
@@ -206,17 +209,17 @@ namespace TrenchBroom {
         };
 
         
-        MdlParser::MdlParser(const String& name, const char* begin, const char* end, const Assets::Palette& palette) :
+        MdlParser::MdlParser(const String& name, MappedFile::Ptr file, const Assets::Palette& palette) :
         m_name(name),
-        m_begin(begin),
-        m_end(end),
+        m_file(file),
+        m_begin(m_file->begin()),
+        m_end(m_file->end()),
         m_palette(palette) {
             assert(m_begin < m_end);
-            unused(m_end);
         }
 
         Assets::EntityModel* MdlParser::doParseModel() {
-            Assets::MdlModel* model = new Assets::MdlModel(m_name);
+            std::unique_ptr<Assets::MdlModel> model(new Assets::MdlModel(m_name));
             
             const char* cursor = m_begin + MdlLayout::HeaderScale;
             const Vec3f scale = readVec3f(cursor);
@@ -235,8 +238,7 @@ namespace TrenchBroom {
             const MdlSkinTriangleList skinTriangles = parseSkinTriangles(cursor, skinTriangleCount);
             parseFrames(cursor, *model, frameCount, skinTriangles, skinVertices, skinWidth, skinHeight, origin, scale);
 
-            assert(cursor <= m_end);
-            return model;
+            return model.release();
         }
 
         void MdlParser::parseSkins(const char*& cursor, Assets::MdlModel& model, const size_t count, const size_t width, const size_t height) {
@@ -303,29 +305,38 @@ namespace TrenchBroom {
         }
 
         void MdlParser::parseFrames(const char*& cursor, Assets::MdlModel& model, const size_t count, const MdlSkinTriangleList& skinTriangles, const MdlSkinVertexList& skinVertices, const size_t skinWidth, const size_t skinHeight, const Vec3f& origin, const Vec3f& scale) {
+            const size_t frameSize = MdlLayout::SimpleFrameName + MdlLayout::SimpleFrameLength + skinVertices.size() * MdlLayout::FrameVertexSize;
+            
+            // only the offsets of the frames are recorded here, the frames are decoded when they are used
+            static const size_t EmptyFrameGroup = std::numeric_limits<size_t>::max();
+            std::vector<size_t> frameOffsets(count);
+            
             for (size_t i = 0; i < count; ++i) {
                 const int type = readInt<int32_t>(cursor);
                 if (type == 0) { // single frame
-                    model.addFrame(parseFrame(cursor, skinTriangles, skinVertices, skinWidth, skinHeight, origin, scale));
-                } else { // frame group
-                    Assets::MdlFrameGroup* frameGroup = new Assets::MdlFrameGroup();
-                    
+                    frameOffsets[i] = static_cast<size_t>(cursor - m_begin);
+                    cursor += frameSize;
+                } else { // frame group, only its first frame is used
                     const char* base = cursor;
                     const size_t groupFrameCount = readSize<int32_t>(cursor);
                     
-                    const char* timeCursor = base + MdlLayout::MultiFrameTimes;
                     const char* frameCursor = base + MdlLayout::MultiFrameTimes + groupFrameCount * sizeof(float);
-
-                    for (size_t j = 0; j < groupFrameCount; ++j) {
-                        const float time = readFloat<float>(timeCursor);
-                        Assets::MdlFrame* frame = parseFrame(frameCursor, skinTriangles, skinVertices, skinWidth, skinHeight, origin, scale);
-                        frameGroup->addFrame(frame, time);
-                    }
-                    
-                    model.addFrame(frameGroup);
-                    cursor = frameCursor;
+                    frameOffsets[i] = groupFrameCount > 0 ? static_cast<size_t>(frameCursor - m_begin) : EmptyFrameGroup;
+                    cursor = frameCursor + groupFrameCount * frameSize;
                 }
+                
+                if (cursor > m_end)
+                    throw AssetException() << "MDL model frames exceed file size";
             }
+            
+            const MappedFile::Ptr file = m_file;
+            model.setFrames(count, [=](const size_t frameIndex) -> Assets::MdlFrame* {
+                if (frameOffsets[frameIndex] == EmptyFrameGroup)
+                    return nullptr;
+                
+                const char* frameCursor = file->begin() + frameOffsets[frameIndex];
+                return parseFrame(frameCursor, skinTriangles, skinVertices, skinWidth, skinHeight, origin, scale);
+            });
         }
 
         Assets::MdlFrame* MdlParser::parseFrame(const char*& cursor, const MdlSkinTriangleList& skinTriangles, const MdlSkinVertexList& skinVertices, const size_t skinWidth, const size_t skinHeight, const Vec3f& origin, const Vec3f& scale) {
@@ -372,7 +383,7 @@ namespace TrenchBroom {
             return new Assets::MdlFrame(String(name), frameTriangles, bounds);
         }
 
-        Vec3f MdlParser::unpackFrameVertex(const PackedFrameVertex& vertex, const Vec3f& origin, const Vec3f& scale) const {
+        Vec3f MdlParser::unpackFrameVertex(const PackedFrameVertex& vertex, const Vec3f& origin, const Vec3f& scale) {
             Vec3f result;
             for (size_t i = 0; i < 3; ++i)
                 result[i] = origin[i] + scale[i]*static_cast<float>(vertex[i]);
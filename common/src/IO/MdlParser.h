@@ -25,6 +25,7 @@
 #include "ByteBuffer.h"
 #include "Assets/AssetTypes.h"
 #include "IO/EntityModelParser.h"
+#include "IO/MappedFile.h"
 
 #include <vector>
 
@@ -57,11 +58,16 @@ namespace TrenchBroom {
             typedef std::vector<PackedFrameVertex> PackedFrameVertexList;
             
             String m_name;
+            MappedFile::Ptr m_file;
             const char* m_begin;
             const char* m_end;
             const Assets::Palette& m_palette;
         public:
-            MdlParser(const String& name, const char* begin, const char* end, const Assets::Palette& palette);
+            /**
+             * Creates a parser for the given file. The parsed model keeps a reference to the file and decodes its
+             * frames from it when they are used.
+             */
+            MdlParser(const String& name, MappedFile::Ptr file, const Assets::Palette& palette);
         private:
             Assets::EntityModel* doParseModel() override;
             
@@ -69,8 +75,8 @@ namespace TrenchBroom {
             MdlSkinVertexList parseSkinVertices(const char*& cursor, const size_t count);
             MdlSkinTriangleList parseSkinTriangles(const char*& cursor, const size_t count);
             void parseFrames(const char*& cursor, Assets::MdlModel& model, const size_t count, const MdlSkinTriangleList& skinTriangles, const MdlSkinVertexList& skinVertices, const size_t skinWidth, const size_t skinHeight, const Vec3f& origin, const Vec3f& scale);
-            Assets::MdlFrame* parseFrame(const char*& cursor, const MdlSkinTriangleList& skinTriangles, const MdlSkinVertexList& skinVertices, const size_t skinWidth, const size_t skinHeight, const Vec3f& origin, const Vec3f& scale);
-            Vec3f unpackFrameVertex(const PackedFrameVertex& vertex, const Vec3f& origin, const Vec3f& scale) const;
+            static Assets::MdlFrame* parseFrame(const char*& cursor, const MdlSkinTriangleList& skinTriangles, const MdlSkinVertexList& skinVertices, const size_t skinWidth, const size_t skinHeight, const Vec3f& origin, const Vec3f& scale);
+            static Vec3f unpackFrameVertex(const PackedFrameVertex& vertex, const Vec3f& origin, const Vec3f& scale);
         };
     }
 }
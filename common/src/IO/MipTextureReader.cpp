@@ -20,6 +20,7 @@
 #include "MipTextureReader.h"
 
 #include "Color.h"
+#include "Exceptions.h"
 #include "StringUtils.h"
 #include "Assets/Palette.h"
 #include "Assets/Texture.h"
@@ -30,6 +31,7 @@ namespace TrenchBroom {
     namespace IO {
         namespace MipLayout {
             static const size_t TextureNameLength = 16;
+            static const size_t MipLevels = 4;
         }
         
         MipTextureReader::MipTextureReader(const NameStrategy& nameStrategy) :
@@ -44,34 +46,71 @@ namespace TrenchBroom {
             return result;
         }
         
-        Assets::Texture* MipTextureReader::doReadTexture(const char* const begin, const char* const end, const Path& path) const {
-            static const size_t MipLevels = 4;
+        Assets::Texture* MipTextureReader::doReadTexture(MappedFile::Ptr file) const {
+            CharArrayReader reader(file->begin(), file->end());
+            
+            String name;
+            size_t width, height;
+            size_t offset[MipLayout::MipLevels];
+            readHeader(reader, name, width, height, offset);
+            
+            // Only the average color is computed now, the mips are decoded when the texture is first used.
+            const Assets::Palette palette = doGetPalette(reader, offset, width, height);
+            const Color averageColor = palette.averageColor(file->begin() + offset[0], mipSize(width, height, 0));
             
-            static Color tempColor, averageColor;
-            static Assets::TextureBuffer::List buffers(MipLevels);
-            static size_t offset[MipLevels];
+            std::vector<size_t> offsets(offset, offset + MipLayout::MipLevels);
+            const Assets::TextureDecoder decoder = [file, offsets, width, height, palette]() {
+                Color ignoredColor;
+                return decodeMips(file->begin(), &offsets.front(), width, height, palette, ignoredColor);
+            };
             
+            return new Assets::Texture(textureName(name, file->path()), width, height, averageColor, decoder);
+        }
+        
+        Assets::Texture* MipTextureReader::doReadTexture(const char* const begin, const char* const end, const Path& path) const {
             CharArrayReader reader(begin, end);
-            const String name = reader.readString(MipLayout::TextureNameLength);
-            const size_t width = reader.readSize<int32_t>();
-            const size_t height = reader.readSize<int32_t>();
-            for (size_t i = 0; i < MipLevels; ++i)
+            
+            String name;
+            size_t width, height;
+            size_t offset[MipLayout::MipLevels];
+            readHeader(reader, name, width, height, offset);
+            
+            const Assets::Palette palette = doGetPalette(reader, offset, width, height);
+            
+            Color averageColor;
+            const Assets::TextureBuffer::List buffers = decodeMips(begin, offset, width, height, palette, averageColor);
+            
+            return new Assets::Texture(textureName(name, path), width, height, averageColor, buffers);
+        }
+        
+        void MipTextureReader::readHeader(CharArrayReader& reader, String& name, size_t& width, size_t& height, size_t offset[]) {
+            name = reader.readString(MipLayout::TextureNameLength);
+            width = reader.readSize<int32_t>();
+            height = reader.readSize<int32_t>();
+            for (size_t i = 0; i < MipLayout::MipLevels; ++i)
                 offset[i] = reader.readSize<int32_t>();
             
+            for (size_t i = 0; i < MipLayout::MipLevels; ++i) {
+                if (offset[i] + mipSize(width, height, i) > reader.size())
+                    throw AssetException() << "Mip level " << i << " of texture '" << name << "' exceeds the texture data";
+            }
+        }
+        
+        Assets::TextureBuffer::List MipTextureReader::decodeMips(const char* const begin, const size_t offset[], const size_t width, const size_t height, const Assets::Palette& palette, Color& averageColor) {
+            Assets::TextureBuffer::List buffers(MipLayout::MipLevels);
             Assets::setMipBufferSize(buffers, width, height);
-            Assets::Palette palette = doGetPalette(reader, offset, width, height);
             
-            for (size_t i = 0; i < MipLevels; ++i) {
+            for (size_t i = 0; i < MipLayout::MipLevels; ++i) {
                 const char* data = begin + offset[i];
                 const size_t size = mipSize(width, height, i);
                 
-                palette.indexedToRgb(data, size, buffers[i], tempColor);
                 if (i == 0)
-                    averageColor = tempColor;
-                
+                    palette.indexedToRgb(data, size, buffers[i], averageColor);
+                else
+                    palette.indexedToRgb(data, size, buffers[i]);
             }
             
-            return new Assets::Texture(textureName(name, path), width, height, averageColor, buffers);
+            return buffers;
         }
     }
 }
@@ -22,6 +22,7 @@
 
 #include "IO/TextureReader.h"
 #include "Assets/Palette.h"
+#include "Assets/Texture.h"
 
 namespace TrenchBroom {
     namespace IO {
@@ -36,8 +37,12 @@ namespace TrenchBroom {
         public:
             static size_t mipFileSize(size_t width, size_t height, size_t mipLevels);
         protected:
+            Assets::Texture* doReadTexture(MappedFile::Ptr file) const override;
             Assets::Texture* doReadTexture(const char* const begin, const char* const end, const Path& path) const override;
             virtual Assets::Palette doGetPalette(CharArrayReader& reader, const size_t offset[], size_t width, size_t height) const = 0;
+        private:
+            static void readHeader(CharArrayReader& reader, String& name, size_t& width, size_t& height, size_t offset[]);
+            static Assets::TextureBuffer::List decodeMips(const char* begin, const size_t offset[], size_t width, size_t height, const Assets::Palette& palette, Color& averageColor);
         };
     }
 }
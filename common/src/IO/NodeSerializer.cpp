@@ -19,6 +19,7 @@
 
 #include "NodeSerializer.h"
 
+#include "Model/AssortNodesVisitor.h"
 #include "Model/Brush.h"
 #include "Model/Group.h"
 #include "Model/Layer.h"
@@ -27,19 +28,6 @@
 
 namespace TrenchBroom {
     namespace IO {
-        class NodeSerializer::BrushSerializer : public Model::NodeVisitor {
-        private:
-            NodeSerializer& m_serializer;
-        public:
-            BrushSerializer(NodeSerializer& serializer) : m_serializer(serializer) {}
-            
-            void doVisit(Model::World* world) override   {}
-            void doVisit(Model::Layer* layer) override   {}
-            void doVisit(Model::Group* group) override   {}
-            void doVisit(Model::Entity* entity) override {}
-            void doVisit(Model::Brush* brush) override   { m_serializer.brush(brush); }
-        };
-
         NodeSerializer::NodeSerializer() :
         m_entityNo(0),
         m_brushNo(0) {}
@@ -65,38 +53,51 @@ namespace TrenchBroom {
         }
 
         void NodeSerializer::defaultLayer(Model::World* world) {
-            entity(world, world->attributes(), Model::EntityAttribute::EmptyList, world->defaultLayer());
+            entity(world, world->attributes(), nullptr, world->defaultLayer());
         }
 
         void NodeSerializer::customLayer(Model::Layer* layer) {
-            entity(layer, layerAttributes(layer), Model::EntityAttribute::EmptyList, layer);
+            beginEntity(layer);
+            layerAttributes(layer);
+            brushes(layer);
+            endEntity(layer);
         }
         
-        void NodeSerializer::group(Model::Group* group, const Model::EntityAttribute::List& parentAttributes) {
-            entity(group, groupAttributes(group), parentAttributes, group);
+        void NodeSerializer::group(Model::Group* group, const Model::Node* parent) {
+            beginEntity(group);
+            groupAttributes(group);
+            parentAttributes(parent);
+            brushes(group);
+            endEntity(group);
         }
 
-        void NodeSerializer::entity(Model::Node* node, const Model::EntityAttribute::List& attributes, const Model::EntityAttribute::List& parentAttributes, Model::Node* brushParent) {
-            beginEntity(node, attributes, parentAttributes);
-            
-            BrushSerializer brushSerializer(*this);
-            brushParent->iterate(brushSerializer);
-            
+        void NodeSerializer::entity(Model::Node* node, const Model::EntityAttribute::List& attributes, const Model::Node* parent, Model::Node* brushParent) {
+            beginEntity(node);
+            entityAttributes(attributes);
+            parentAttributes(parent);
+            brushes(brushParent);
             endEntity(node);
         }
 
-        void NodeSerializer::entity(Model::Node* node, const Model::EntityAttribute::List& attributes, const Model::EntityAttribute::List& parentAttributes, const Model::BrushList& entityBrushes) {
-            beginEntity(node, attributes, parentAttributes);
+        void NodeSerializer::entity(Model::Node* node, const Model::EntityAttribute::List& attributes, const Model::Node* parent, const Model::BrushList& entityBrushes) {
+            beginEntity(node);
+            entityAttributes(attributes);
+            parentAttributes(parent);
             brushes(entityBrushes);
             endEntity(node);
         }
 
-        void NodeSerializer::beginEntity(const Model::Node* node, const Model::EntityAttribute::List& attributes, const Model::EntityAttribute::List& extraAttributes) {
-            beginEntity(node);
+        void NodeSerializer::entity(const Model::EntityAttribute::List& attributes, const std::vector<Model::BrushFaceList>& brushes) {
+            beginEntity(nullptr);
             entityAttributes(attributes);
-            entityAttributes(extraAttributes);
+            for (const Model::BrushFaceList& faces : brushes) {
+                beginBrush(nullptr);
+                brushFaces(faces);
+                endBrush(nullptr);
+            }
+            endEntity(nullptr);
         }
-        
+
         void NodeSerializer::beginEntity(const Model::Node* node) {
             m_brushNo = 0;
             doBeginEntity(node);
@@ -109,14 +110,28 @@ namespace TrenchBroom {
         
         void NodeSerializer::entityAttributes(const Model::EntityAttribute::List& attributes) {
             std::for_each(std::begin(attributes), std::end(attributes),
-                          [this](const Model::EntityAttribute& attribute) { entityAttribute(attribute); });
+                          [this](const Model::EntityAttribute& attribute) { entityAttribute(attribute.name(), attribute.value()); });
         }
 
-        void NodeSerializer::entityAttribute(const Model::EntityAttribute& attribute) {
-            doEntityAttribute(attribute);
+        void NodeSerializer::entityAttribute(const Model::AttributeName& name, const Model::AttributeValue& value) {
+            doEntityAttribute(name, value);
+        }
+        
+        void NodeSerializer::brushes(Model::Node* brushParent) {
+            Model::CollectBrushesVisitor collectBrushes;
+            brushParent->iterate(collectBrushes);
+            brushes(collectBrushes.brushes());
         }
         
         void NodeSerializer::brushes(const Model::BrushList& brushes) {
+            doBrushes(brushes);
+        }
+        
+        void NodeSerializer::skipBrushes(const size_t count) {
+            m_brushNo += static_cast<ObjectNo>(count);
+        }
+
+        void NodeSerializer::doBrushes(const Model::BrushList& brushes) {
             std::for_each(std::begin(brushes), std::end(brushes),
                           [this](Model::Brush* brush) { this->brush(brush); });
         }
@@ -145,52 +160,39 @@ namespace TrenchBroom {
             doBrushFace(face);
         }
         
-        class NodeSerializer::GetParentAttributes : public Model::ConstNodeVisitor {
+        class NodeSerializer::WriteParentAttributes : public Model::ConstNodeVisitor {
         private:
-            const LayerIds& m_layerIds;
-            const GroupIds& m_groupIds;
-            Model::EntityAttribute::List m_attributes;
+            NodeSerializer& m_serializer;
         public:
-            GetParentAttributes(const LayerIds& layerIds, const GroupIds& groupIds) :
-            m_layerIds(layerIds),
-            m_groupIds(groupIds) {}
-            
-            const Model::EntityAttribute::List& attributes() const {
-                return m_attributes;
-            }
+            WriteParentAttributes(NodeSerializer& serializer) :
+            m_serializer(serializer) {}
         private:
             void doVisit(const Model::World* world) override   {}
-            void doVisit(const Model::Layer* layer) override   { m_attributes.push_back(Model::EntityAttribute(Model::AttributeNames::Layer, m_layerIds.getId(layer)));}
-            void doVisit(const Model::Group* group) override   { m_attributes.push_back(Model::EntityAttribute(Model::AttributeNames::Group, m_groupIds.getId(group))); }
+            void doVisit(const Model::Layer* layer) override   { m_serializer.entityAttribute(Model::AttributeNames::Layer, m_serializer.m_layerIds.getId(layer)); }
+            void doVisit(const Model::Group* group) override   { m_serializer.entityAttribute(Model::AttributeNames::Group, m_serializer.m_groupIds.getId(group)); }
             void doVisit(const Model::Entity* entity) override {}
             void doVisit(const Model::Brush* brush) override   {}
         };
         
-        Model::EntityAttribute::List NodeSerializer::parentAttributes(const Model::Node* node) {
-            if (node == nullptr)
-                return Model::EntityAttribute::List(0);
-            
-            GetParentAttributes visitor(m_layerIds, m_groupIds);
-            node->accept(visitor);
-            return visitor.attributes();
-        }
-        
-        Model::EntityAttribute::List NodeSerializer::layerAttributes(const Model::Layer* layer) {
-            Model::EntityAttribute::List attrs;
-            attrs.push_back(Model::EntityAttribute(Model::AttributeNames::Classname, Model::AttributeValues::LayerClassname));
-            attrs.push_back(Model::EntityAttribute(Model::AttributeNames::GroupType, Model::AttributeValues::GroupTypeLayer));
-            attrs.push_back(Model::EntityAttribute(Model::AttributeNames::LayerName, layer->name()));
-            attrs.push_back(Model::EntityAttribute(Model::AttributeNames::LayerId, m_layerIds.getId(layer)));
-            return attrs;
-        }
-        
-        Model::EntityAttribute::List NodeSerializer::groupAttributes(const Model::Group* group) {
-            Model::EntityAttribute::List attrs;
-            attrs.push_back(Model::EntityAttribute(Model::AttributeNames::Classname, Model::AttributeValues::GroupClassname));
-            attrs.push_back(Model::EntityAttribute(Model::AttributeNames::GroupType, Model::AttributeValues::GroupTypeGroup));
-            attrs.push_back(Model::EntityAttribute(Model::AttributeNames::GroupName, group->name()));
-            attrs.push_back(Model::EntityAttribute(Model::AttributeNames::GroupId, m_groupIds.getId(group)));
-            return attrs;
+        void NodeSerializer::parentAttributes(const Model::Node* parent) {
+            if (parent != nullptr) {
+                WriteParentAttributes visitor(*this);
+                parent->accept(visitor);
+            }
+        }
+        
+        void NodeSerializer::layerAttributes(const Model::Layer* layer) {
+            entityAttribute(Model::AttributeNames::Classname, Model::AttributeValues::LayerClassname);
+            entityAttribute(Model::AttributeNames::GroupType, Model::AttributeValues::GroupTypeLayer);
+            entityAttribute(Model::AttributeNames::LayerName, layer->name());
+            entityAttribute(Model::AttributeNames::LayerId, m_layerIds.getId(layer));
+        }
+        
+        void NodeSerializer::groupAttributes(const Model::Group* group) {
+            entityAttribute(Model::AttributeNames::Classname, Model::AttributeValues::GroupClassname);
+            entityAttribute(Model::AttributeNames::GroupType, Model::AttributeValues::GroupTypeGroup);
+            entityAttribute(Model::AttributeNames::GroupName, group->name());
+            entityAttribute(Model::AttributeNames::GroupId, m_groupIds.getId(group));
         }
 
         String NodeSerializer::escapeEntityAttribute(const String& str) const {
@@ -25,14 +25,13 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
         class Path;
         
         class NodeSerializer {
-        private:
-            class BrushSerializer;
         protected:
             static const int FloatPrecision = 17;
             typedef unsigned int ObjectNo;
@@ -78,24 +77,45 @@ namespace TrenchBroom {
         protected:
             ObjectNo entityNo() const;
             ObjectNo brushNo() const;
+            
+            /**
+             * Advances the brush number by the given count. Subclasses that override doBrushes to write the brushes
+             * themselves must call this after writing them.
+             */
+            void skipBrushes(size_t count);
         public:
             void beginFile();
             void endFile();
         public:
             void defaultLayer(Model::World* world);
             void customLayer(Model::Layer* layer);
-            void group(Model::Group* group, const Model::EntityAttribute::List& parentAttributes);
             
-            void entity(Model::Node* node, const Model::EntityAttribute::List& attributes, const Model::EntityAttribute::List& parentAttributes, Model::Node* brushParent);
-            void entity(Model::Node* node, const Model::EntityAttribute::List& attributes, const Model::EntityAttribute::List& parentAttributes, const Model::BrushList& entityBrushes);
+            /**
+             * Writes the given group. If the given parent is a layer or a group, an attribute that links the group to
+             * it is written, too.
+             */
+            void group(Model::Group* group, const Model::Node* parent);
+            
+            /**
+             * Writes an entity with the given attributes. If the given parent is a layer or a group, an attribute that
+             * links the entity to it is written, too.
+             */
+            void entity(Model::Node* node, const Model::EntityAttribute::List& attributes, const Model::Node* parent, Model::Node* brushParent);
+            void entity(Model::Node* node, const Model::EntityAttribute::List& attributes, const Model::Node* parent, const Model::BrushList& entityBrushes);
+            
+            /**
+             * Writes an entity with the given attributes and brushes, each of which is given by its faces. Since there
+             * are no nodes, no file positions are recorded except for those of the faces.
+             */
+            void entity(const Model::EntityAttribute::List& attributes, const std::vector<Model::BrushFaceList>& brushes);
         private:
-            void beginEntity(const Model::Node* node, const Model::EntityAttribute::List& attributes, const Model::EntityAttribute::List& extraAttributes);
             void beginEntity(const Model::Node* node);
             void endEntity(Model::Node* node);
             
             void entityAttributes(const Model::EntityAttribute::List& attributes);
-            void entityAttribute(const Model::EntityAttribute& attribute);
+            void entityAttribute(const Model::AttributeName& name, const Model::AttributeValue& value);
 
+            void brushes(Model::Node* brushParent);
             void brushes(const Model::BrushList& brushes);
             void brush(Model::Brush* brush);
             
@@ -106,12 +126,11 @@ namespace TrenchBroom {
         private:
             void brushFace(Model::BrushFace* face);
         private:
-            class GetParentAttributes;
-        public:
-            Model::EntityAttribute::List parentAttributes(const Model::Node* node);
-        private:
-            Model::EntityAttribute::List layerAttributes(const Model::Layer* layer);
-            Model::EntityAttribute::List groupAttributes(const Model::Group* group);
+            class WriteParentAttributes;
+            
+            void parentAttributes(const Model::Node* parent);
+            void layerAttributes(const Model::Layer* layer);
+            void groupAttributes(const Model::Group* group);
         protected:
             String escapeEntityAttribute(const String& str) const;
         private:
@@ -120,11 +139,17 @@ namespace TrenchBroom {
             
             virtual void doBeginEntity(const Model::Node* node) = 0;
             virtual void doEndEntity(Model::Node* node) = 0;
-            virtual void doEntityAttribute(const Model::EntityAttribute& attribute) = 0;
+            virtual void doEntityAttribute(const Model::AttributeName& name, const Model::AttributeValue& value) = 0;
             
             virtual void doBeginBrush(const Model::Brush* brush) = 0;
             virtual void doEndBrush(Model::Brush* brush) = 0;
             virtual void doBrushFace(Model::BrushFace* face) = 0;
+        protected:
+            /**
+             * Writes the given brushes of the current entity. The default implementation writes them one after
+             * another using doBeginBrush, doBrushFace and doEndBrush.
+             */
+            virtual void doBrushes(const Model::BrushList& brushes);
         };
     }
 }
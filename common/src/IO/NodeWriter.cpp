@@ -74,24 +74,24 @@ namespace TrenchBroom {
         class NodeWriter::WriteNode : public Model::NodeVisitor {
         private:
             NodeSerializer& m_serializer;
-            const Model::EntityAttribute::List m_parentAttributes;
+            const Model::Node* m_parent;
         public:
             WriteNode(NodeSerializer& serializer, const Model::Node* parent = nullptr) :
             m_serializer(serializer),
-            m_parentAttributes(m_serializer.parentAttributes(parent)) {}
+            m_parent(parent) {}
             
             void doVisit(Model::World* world) override   { stopRecursion(); }
             void doVisit(Model::Layer* layer) override   { stopRecursion(); }
             
             void doVisit(Model::Group* group) override   {
-                m_serializer.group(group, m_parentAttributes);
+                m_serializer.group(group, m_parent);
                 WriteNode visitor(m_serializer, group);
                 group->iterate(visitor);
                 stopRecursion();
             }
             
             void doVisit(Model::Entity* entity) override {
-                m_serializer.entity(entity, entity->attributes(), m_parentAttributes, entity);
+                m_serializer.entity(entity, entity->attributes(), m_parent, entity);
                 stopRecursion();
             }
 
@@ -102,6 +102,10 @@ namespace TrenchBroom {
         m_world(world),
         m_serializer(MapFileSerializer::create(m_world->format(), stream)) {}
         
+        NodeWriter::NodeWriter(Model::World* world, OutputBuffer& buffer) :
+        m_world(world),
+        m_serializer(MapFileSerializer::create(m_world->format(), buffer)) {}
+        
         NodeWriter::NodeWriter(Model::World* world, std::ostream& stream) :
         m_world(world),
         m_serializer(MapStreamSerializer::create(m_world->format(), stream)) {}
@@ -162,7 +166,7 @@ namespace TrenchBroom {
         
         void NodeWriter::writeWorldBrushes(const Model::BrushList& brushes) {
             if (!brushes.empty())
-                m_serializer->entity(m_world, m_world->attributes(), Model::EntityAttribute::EmptyList, brushes);
+                m_serializer->entity(m_world, m_world->attributes(), nullptr, brushes);
         }
         
         void NodeWriter::writeEntityBrushes(const EntityBrushesMap& entityBrushes) {
@@ -170,7 +174,7 @@ namespace TrenchBroom {
                           [this](const EntityBrushesMap::value_type& entry) {
                               Model::Entity* entity = entry.first;
                               const Model::BrushList& brushes = entry.second;
-                              m_serializer->entity(entity, entity->attributes(), Model::EntityAttribute::EmptyList, brushes);
+                              m_serializer->entity(entity, entity->attributes(), nullptr, brushes);
                           });
         }
 
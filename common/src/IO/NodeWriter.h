@@ -28,6 +28,7 @@
 
 namespace TrenchBroom {
     namespace IO {
+        class OutputBuffer;
         class Path;
         class NodeSerializer;
         
@@ -41,6 +42,7 @@ namespace TrenchBroom {
             NodeSerializer::Ptr m_serializer;
         public:
             NodeWriter(Model::World* world, FILE* stream);
+            NodeWriter(Model::World* world, OutputBuffer& buffer);
             NodeWriter(Model::World* world, std::ostream& stream);
             NodeWriter(Model::World* world, NodeSerializer* serializer);
             
@@ -96,7 +96,7 @@ namespace TrenchBroom {
 
         void ObjFileSerializer::doBeginEntity(const Model::Node* node) {}
         void ObjFileSerializer::doEndEntity(Model::Node* node) {}
-        void ObjFileSerializer::doEntityAttribute(const Model::EntityAttribute& attribute) {}
+        void ObjFileSerializer::doEntityAttribute(const Model::AttributeName& name, const Model::AttributeValue& value) {}
         
         void ObjFileSerializer::doBeginBrush(const Model::Brush* brush) {
             m_currentObject.entityNo = entityNo();
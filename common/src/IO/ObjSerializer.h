@@ -96,7 +96,7 @@ namespace TrenchBroom {
             
             void doBeginEntity(const Model::Node* node) override;
             void doEndEntity(Model::Node* node) override;
-            void doEntityAttribute(const Model::EntityAttribute& attribute) override;
+            void doEntityAttribute(const Model::AttributeName& name, const Model::AttributeValue& value) override;
             
             void doBeginBrush(const Model::Brush* brush) override;
             void doEndBrush(Model::Brush* brush) override;
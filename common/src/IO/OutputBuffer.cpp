@@ -0,0 +1,153 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "OutputBuffer.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace TrenchBroom {
+    namespace IO {
+        OutputBuffer::OutputBuffer(const size_t capacity) {
+            m_buffer.reserve(capacity);
+        }
+        
+        bool OutputBuffer::empty() const {
+            return m_buffer.empty();
+        }
+        
+        size_t OutputBuffer::size() const {
+            return m_buffer.size();
+        }
+        
+        const String& OutputBuffer::str() const {
+            return m_buffer;
+        }
+        
+        void OutputBuffer::clear() {
+            m_buffer.clear();
+        }
+
+        void OutputBuffer::append(const OutputBuffer& other) {
+            m_buffer.append(other.m_buffer);
+        }
+
+        void OutputBuffer::appendUnsigned(unsigned long long value) {
+            char digits[24];
+            char* cur = digits + sizeof(digits);
+            do {
+                *--cur = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value > 0);
+            m_buffer.append(cur, static_cast<size_t>(digits + sizeof(digits) - cur));
+        }
+        
+        void OutputBuffer::appendInteger(const long long value) {
+            if (value < 0) {
+                m_buffer.push_back('-');
+                appendUnsigned(0ull - static_cast<unsigned long long>(value));
+            } else {
+                appendUnsigned(static_cast<unsigned long long>(value));
+            }
+        }
+        
+        void OutputBuffer::appendDouble(const double value, const int precision) {
+            assert(precision > 0 && precision <= 17);
+            if (!appendExactDecimal(value, precision)) {
+                char str[32];
+                const int length = std::snprintf(str, sizeof(str), "%.*g", precision, value);
+                assert(length > 0 && static_cast<size_t>(length) < sizeof(str));
+                m_buffer.append(str, static_cast<size_t>(length));
+            }
+        }
+
+        void OutputBuffer::writeTo(FILE* stream) {
+            if (!m_buffer.empty()) {
+                std::fwrite(m_buffer.data(), 1, m_buffer.size(), stream);
+                m_buffer.clear();
+            }
+        }
+
+        /*
+         Handles values whose exact decimal expansion has at most the given number of significant digits and a few
+         decimal places, such as integers and values like 0.5 or -16.125. For these, %g prints all digits of the
+         exact value without rounding, using fixed notation, with trailing zeros removed. Returns false for all other
+         values, which must then be formatted by the C library.
+         */
+        bool OutputBuffer::appendExactDecimal(const double value, const int precision) {
+            static const unsigned long long PowersOf10[] = {
+                1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+                1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+                100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull
+            };
+            static const int MaxDecimals = 10;
+            
+            if (!std::isfinite(value))
+                return false;
+            
+            const unsigned long long limit = PowersOf10[precision];
+            const double magnitude = std::abs(value);
+            if (magnitude >= static_cast<double>(limit))
+                return false;
+            
+            // find the smallest number of binary places that makes the value integral; the exact decimal expansion
+            // then has the same number of decimal places
+            int decimals = 0;
+            double scaled = magnitude;
+            while (scaled != std::floor(scaled)) {
+                if (++decimals > MaxDecimals)
+                    return false;
+                scaled *= 2.0;
+            }
+            
+            // the digits of magnitude * 10^decimals, computed as scaled * 5^decimals without overflow
+            unsigned long long digits = static_cast<unsigned long long>(scaled);
+            for (int i = 0; i < decimals; ++i) {
+                if (digits > limit / 5)
+                    return false;
+                digits *= 5;
+            }
+            
+            if (digits >= limit)
+                return false; // too many significant digits, %g would round
+            
+            // %g switches to exponential notation if the exponent is less than -4, but any non-zero value with at most
+            // MaxDecimals binary places is at least 2^-10 > 10^-4
+            
+            if (std::signbit(value))
+                m_buffer.push_back('-');
+            
+            if (decimals == 0) {
+                appendUnsigned(digits);
+            } else {
+                const unsigned long long divisor = PowersOf10[decimals];
+                appendUnsigned(digits / divisor);
+                m_buffer.push_back('.');
+                
+                unsigned long long fraction = digits % divisor;
+                for (int i = decimals - 1; i >= 0; --i) {
+                    m_buffer.push_back(static_cast<char>('0' + fraction / PowersOf10[i]));
+                    fraction %= PowersOf10[i];
+                }
+            }
+            return true;
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_OutputBuffer
+#define TrenchBroom_OutputBuffer
+
+#include "StringUtils.h"
+
+#include <cstdio>
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * A growable character buffer that formats numbers without going through the C library's format string
+         * machinery. Numbers are formatted exactly like printf would format them with the corresponding conversion.
+         */
+        class OutputBuffer {
+        private:
+            String m_buffer;
+        public:
+            OutputBuffer(size_t capacity = 0);
+            
+            bool empty() const;
+            size_t size() const;
+            const String& str() const;
+            void clear();
+            
+            void append(const char c) {
+                m_buffer.push_back(c);
+            }
+            
+            void append(const char* str, const size_t length) {
+                m_buffer.append(str, length);
+            }
+            
+            void append(const String& str) {
+                m_buffer.append(str);
+            }
+            
+            template <size_t N>
+            void append(const char (&str)[N]) {
+                m_buffer.append(str, N - 1);
+            }
+            
+            void append(const OutputBuffer& other);
+            
+            // same as printf("%llu", value)
+            void appendUnsigned(unsigned long long value);
+            // same as printf("%lld", value)
+            void appendInteger(long long value);
+            // same as printf("%.*g", precision, value), precision must be in [1, 17]
+            void appendDouble(double value, int precision);
+            
+            /**
+             * Writes the contents of this buffer to the given stream and clears it.
+             */
+            void writeTo(FILE* stream);
+        private:
+            bool appendExactDecimal(double value, int precision);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_OutputBuffer) */
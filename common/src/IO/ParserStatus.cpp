@@ -74,6 +74,10 @@ namespace TrenchBroom {
             throw ParserException(buildMessage(line, str));
         }
 
+        void ParserStatus::log(const Logger::LogLevel level, const String& str) {
+            doLog(level, str);
+        }
+
         void ParserStatus::log(const Logger::LogLevel level, const size_t line, const size_t column, const String& str) {
             doLog(level, buildMessage(line, column, str));
         }
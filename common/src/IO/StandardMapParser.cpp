@@ -20,9 +20,15 @@
 #include "StandardMapParser.h"
 
 #include "Logger.h"
+#include "ParallelUtils.h"
 #include "TemporarilySetAny.h"
+#include "IO/ParserStatus.h"
 #include "Model/BrushFace.h"
 
+#include <algorithm>
+#include <exception>
+#include <memory>
+
 namespace TrenchBroom {
     namespace IO {
         const String& QuakeMapTokenizer::NumberDelim() {
@@ -34,6 +40,10 @@ namespace TrenchBroom {
         Tokenizer(begin, end, "\"", '\\'),
         m_skipEol(true) {}
         
+        QuakeMapTokenizer::QuakeMapTokenizer(const char* begin, const char* end, const size_t line, const size_t column) :
+        Tokenizer(begin, end, "\"", '\\', line, column),
+        m_skipEol(true) {}
+        
         QuakeMapTokenizer::QuakeMapTokenizer(const String& str) :
         Tokenizer(str, "\"", '\\'),
         m_skipEol(true) {}
@@ -113,14 +123,553 @@ namespace TrenchBroom {
             return Token(QuakeMapToken::Eof, nullptr, nullptr, length(), line(), column());
         }
 
+        /*
+         * Large maps are parsed in chunks on multiple threads. A quick scan over the raw text first determines the
+         * extent of every entity and brush. Then every entity is parsed without its brushes (the brushes are replaced
+         * by empty placeholders that span the same lines and columns), and consecutive brushes are parsed in batches.
+         * The chunk parsers record their callbacks and log messages, which are replayed on the calling thread in the
+         * order in which they appear in the file. Since every chunk is tokenized with the line and column at which it
+         * starts, the replayed events are identical to those of a sequential parse.
+         *
+         * If the scan finds anything unusual, the file is parsed sequentially instead.
+         */
+        class StandardMapParser::ChunkStatus : public ParserStatus {
+        private:
+            ChunkParser& m_parser;
+        public:
+            ChunkStatus(ChunkParser& parser);
+        private:
+            void doProgress(double progress) override;
+            void doLog(Logger::LogLevel level, const String& str) override;
+        };
+        
+        class StandardMapParser::ChunkParser : public StandardMapParser {
+        public:
+            typedef enum {
+                Event_BeginEntity,
+                Event_EndEntity,
+                Event_BeginBrush,
+                Event_EndBrush,
+                Event_BrushFace,
+                Event_Log,
+                Event_BrushStart,       // a brush chunk starts parsing a brush
+                Event_BrushPlaceholder  // an entity chunk encountered a placeholder for a brush
+            } EventType;
+            
+            struct Event {
+                EventType type;
+                size_t line;
+                size_t lineCount;
+                size_t index;
+                
+                Event(const EventType i_type, const size_t i_line, const size_t i_lineCount, const size_t i_index) :
+                type(i_type),
+                line(i_line),
+                lineCount(i_lineCount),
+                index(i_index) {}
+            };
+            typedef std::vector<Event> EventList;
+            
+            struct Entity {
+                Model::EntityAttribute::List attributes;
+                ExtraAttributes extraAttributes;
+                
+                Entity(const Model::EntityAttribute::List& i_attributes, const ExtraAttributes& i_extraAttributes) :
+                attributes(i_attributes),
+                extraAttributes(i_extraAttributes) {}
+            };
+            
+            struct Face {
+                Vec3 point1;
+                Vec3 point2;
+                Vec3 point3;
+                Model::BrushFaceAttributes attribs;
+                Vec3 texAxisX;
+                Vec3 texAxisY;
+                
+                Face(const Vec3& i_point1, const Vec3& i_point2, const Vec3& i_point3, const Model::BrushFaceAttributes& i_attribs, const Vec3& i_texAxisX, const Vec3& i_texAxisY) :
+                point1(i_point1),
+                point2(i_point2),
+                point3(i_point3),
+                attribs(i_attribs),
+                texAxisX(i_texAxisX),
+                texAxisY(i_texAxisY) {}
+            };
+            
+            struct Log {
+                Logger::LogLevel level;
+                String message;
+                
+                Log(const Logger::LogLevel i_level, const String& i_message) :
+                level(i_level),
+                message(i_message) {}
+            };
+            
+            static const size_t NoIndex = static_cast<size_t>(-1);
+        private:
+            bool m_entity;
+            ChunkStatus m_status;
+            EventList m_events;
+            std::vector<Entity> m_entities;
+            std::vector<ExtraAttributes> m_brushAttributes;
+            std::vector<Face> m_faces;
+            std::vector<Log> m_logs;
+            std::exception_ptr m_exception;
+        public:
+            ChunkParser(const char* begin, const char* end, const size_t line, const size_t column, const Model::MapFormat::Type format, const bool entity) :
+            StandardMapParser(begin, end, line, column),
+            m_entity(entity),
+            m_status(*this) {
+                setFormat(format);
+            }
+            
+            void parse() {
+                try {
+                    if (m_entity) {
+                        parseEntity(m_status);
+                    } else {
+                        Token token = m_tokenizer.peekToken();
+                        while (token.type() != QuakeMapToken::Eof) {
+                            expect(QuakeMapToken::OBrace, token);
+                            m_events.push_back(Event(Event_BrushStart, token.line(), 0, NoIndex));
+                            parseBrush(m_status);
+                            token = m_tokenizer.peekToken();
+                        }
+                    }
+                } catch (...) {
+                    m_exception = std::current_exception();
+                }
+            }
+            
+            const EventList& events() const { return m_events; }
+            const Entity& entity(const size_t index) const { return m_entities[index]; }
+            const ExtraAttributes& brushAttributes(const size_t index) const { return m_brushAttributes[index]; }
+            const Face& face(const size_t index) const { return m_faces[index]; }
+            const Log& log(const size_t index) const { return m_logs[index]; }
+            
+            bool failed() const {
+                return m_exception != nullptr;
+            }
+            
+            void rethrow() const {
+                if (m_exception != nullptr)
+                    std::rethrow_exception(m_exception);
+            }
+            
+            void recordLog(const Logger::LogLevel level, const String& str) {
+                m_events.push_back(Event(Event_Log, 0, 0, m_logs.size()));
+                m_logs.push_back(Log(level, str));
+            }
+        private:
+            void onFormatSet(const Model::MapFormat::Type format) override {}
+            
+            void onBeginEntity(const size_t line, const Model::EntityAttribute::List& attributes, const ExtraAttributes& extraAttributes, ParserStatus& status) override {
+                m_events.push_back(Event(Event_BeginEntity, line, 0, m_entities.size()));
+                m_entities.push_back(Entity(attributes, extraAttributes));
+            }
+            
+            void onEndEntity(const size_t startLine, const size_t lineCount, ParserStatus& status) override {
+                m_events.push_back(Event(Event_EndEntity, startLine, lineCount, NoIndex));
+            }
+            
+            void onBeginBrush(const size_t line, ParserStatus& status) override {
+                m_events.push_back(Event(m_entity ? Event_BrushPlaceholder : Event_BeginBrush, line, 0, NoIndex));
+            }
+            
+            void onEndBrush(const size_t startLine, const size_t lineCount, const ExtraAttributes& extraAttributes, ParserStatus& status) override {
+                if (m_entity)
+                    return;
+                
+                if (extraAttributes.empty()) {
+                    m_events.push_back(Event(Event_EndBrush, startLine, lineCount, NoIndex));
+                } else {
+                    m_events.push_back(Event(Event_EndBrush, startLine, lineCount, m_brushAttributes.size()));
+                    m_brushAttributes.push_back(extraAttributes);
+                }
+            }
+            
+            void onBrushFace(const size_t line, const Vec3& point1, const Vec3& point2, const Vec3& point3, const Model::BrushFaceAttributes& attribs, const Vec3& texAxisX, const Vec3& texAxisY, ParserStatus& status) override {
+                m_events.push_back(Event(Event_BrushFace, line, 0, m_faces.size()));
+                m_faces.push_back(Face(point1, point2, point3, attribs, texAxisX, texAxisY));
+            }
+        };
+        
+        StandardMapParser::ChunkStatus::ChunkStatus(ChunkParser& parser) :
+        ParserStatus(nullptr),
+        m_parser(parser) {}
+        
+        void StandardMapParser::ChunkStatus::doProgress(const double progress) {}
+        
+        void StandardMapParser::ChunkStatus::doLog(const Logger::LogLevel level, const String& str) {
+            m_parser.recordLog(level, str);
+        }
+
+        struct StandardMapParser::Chunk {
+            struct BrushRange {
+                const char* begin;
+                const char* end;
+                size_t endColumn;
+                
+                BrushRange(const char* i_begin, const char* i_end, const size_t i_endColumn) :
+                begin(i_begin),
+                end(i_end),
+                endColumn(i_endColumn) {}
+            };
+            typedef std::vector<BrushRange> BrushRangeList;
+            
+            bool entity;
+            const char* begin;
+            const char* end;
+            size_t line;
+            size_t column;
+            size_t brushCount;
+            BrushRangeList brushes;
+            std::unique_ptr<ChunkParser> parser;
+            
+            Chunk(const bool i_entity, const char* i_begin, const size_t i_line, const size_t i_column) :
+            entity(i_entity),
+            begin(i_begin),
+            end(i_begin),
+            line(i_line),
+            column(i_column),
+            brushCount(0) {}
+        };
+        
+        class StandardMapParser::ChunkScanner {
+        private:
+            static const size_t MaxBrushesPerChunk = 64;
+            
+            typedef enum {
+                Token_OBrace,
+                Token_CBrace,
+                Token_OParenthesis,
+                Token_CParenthesis,
+                Token_OBracket,
+                Token_CBracket,
+                Token_Comment,
+                Token_String,
+                Token_Number,
+                Token_Word,
+                Token_Eol,
+                Token_Eof,
+                Token_Invalid
+            } TokenType;
+            
+            const char* m_cur;
+            const char* m_end;
+            size_t m_line;
+            size_t m_column;
+            
+            const char* m_tokenBegin;
+            size_t m_tokenLine;
+            size_t m_tokenColumn;
+            
+            ChunkList& m_chunks;
+        public:
+            ChunkScanner(const char* begin, const char* end, ChunkList& chunks) :
+            m_cur(begin),
+            m_end(end),
+            m_line(1),
+            m_column(1),
+            m_tokenBegin(begin),
+            m_tokenLine(1),
+            m_tokenColumn(1),
+            m_chunks(chunks) {}
+            
+            bool scan() {
+                TokenType token = nextToken(true);
+                while (token != Token_Eof) {
+                    if (token != Token_OBrace || !scanEntity())
+                        return false;
+                    token = nextToken(true);
+                }
+                return true;
+            }
+        private:
+            bool scanEntity() {
+                const size_t entityIndex = m_chunks.size();
+                m_chunks.push_back(Chunk(true, m_tokenBegin, m_tokenLine, m_tokenColumn));
+                
+                size_t batchIndex = 0;
+                bool continueBatch = false;
+                
+                TokenType token = nextToken(true);
+                while (true) {
+                    switch (token) {
+                        case Token_Comment:
+                            if (!scanExtraAttributes())
+                                return false;
+                            continueBatch = false;
+                            break;
+                        case Token_String:
+                            if (nextToken(true) != Token_String)
+                                return false;
+                            continueBatch = false;
+                            break;
+                        case Token_OBrace: {
+                            const char* brushBegin = m_tokenBegin;
+                            if (!continueBatch || m_chunks[batchIndex].brushCount == MaxBrushesPerChunk) {
+                                batchIndex = m_chunks.size();
+                                m_chunks.push_back(Chunk(false, m_tokenBegin, m_tokenLine, m_tokenColumn));
+                            }
+                            if (!scanBrush())
+                                return false;
+                            
+                            m_chunks[entityIndex].brushes.push_back(Chunk::BrushRange(brushBegin, m_cur, m_tokenColumn));
+                            m_chunks[batchIndex].end = m_cur;
+                            ++m_chunks[batchIndex].brushCount;
+                            continueBatch = true;
+                            break;
+                        }
+                        case Token_CBrace:
+                            m_chunks[entityIndex].end = m_cur;
+                            return true;
+                        default:
+                            return false;
+                    }
+                    token = nextToken(true);
+                }
+            }
+            
+            bool scanBrush() {
+                TokenType token = nextToken(true);
+                while (true) {
+                    switch (token) {
+                        case Token_Comment:
+                            if (!scanExtraAttributes())
+                                return false;
+                            token = nextToken(true);
+                            break;
+                        case Token_OParenthesis:
+                            if (!scanFace())
+                                return false;
+                            do {
+                                token = nextToken(true);
+                            } while (token == Token_Number || token == Token_OBracket || token == Token_CBracket);
+                            break;
+                        case Token_CBrace:
+                            return true;
+                        default:
+                            return false;
+                    }
+                }
+            }
+            
+            bool scanFace() {
+                for (size_t i = 0; i < 3; ++i) {
+                    if (i > 0 && nextToken(true) != Token_OParenthesis)
+                        return false;
+                    for (size_t j = 0; j < 3; ++j) {
+                        if (nextToken(true) != Token_Number)
+                            return false;
+                    }
+                    if (nextToken(true) != Token_CParenthesis)
+                        return false;
+                }
+                
+                // texture names can contain braces etc, so they are skipped like StandardMapParser::parseFace reads them
+                while (!eof() && isWhitespace(*m_cur))
+                    advance();
+                if (eof() || *m_cur == '"')
+                    return false;
+                do {
+                    advance();
+                } while (!eof() && !isWhitespace(*m_cur));
+                return true;
+            }
+            
+            bool scanExtraAttributes() {
+                TokenType token = nextToken(false);
+                while (token != Token_Eol && token != Token_Eof) {
+                    if (token != Token_String && token != Token_Word && token != Token_Number)
+                        return false;
+                    token = nextToken(false);
+                }
+                return true;
+            }
+            
+            // mirrors QuakeMapTokenizer::emitToken
+            TokenType nextToken(const bool skipEol) {
+                while (!eof()) {
+                    m_tokenBegin = m_cur;
+                    m_tokenLine = m_line;
+                    m_tokenColumn = m_column;
+                    switch (*m_cur) {
+                        case '/':
+                            advance();
+                            if (curChar() != '/')
+                                return Token_Invalid;
+                            advance();
+                            if (curChar() == '/') {
+                                advance();
+                                return Token_Comment;
+                            }
+                            while (!eof() && *m_cur != '\n' && *m_cur != '\r')
+                                advance();
+                            break;
+                        case '{':
+                            advance();
+                            return Token_OBrace;
+                        case '}':
+                            advance();
+                            return Token_CBrace;
+                        case '(':
+                            advance();
+                            return Token_OParenthesis;
+                        case ')':
+                            advance();
+                            return Token_CParenthesis;
+                        case '[':
+                            advance();
+                            return Token_OBracket;
+                        case ']':
+                            advance();
+                            return Token_CBracket;
+                        case '"':
+                            advance();
+                            return skipQuotedString() ? Token_String : Token_Invalid;
+                        case '\n':
+                            if (!skipEol) {
+                                advance();
+                                return Token_Eol;
+                            }
+                            switchFallthrough();
+                        case '\r':
+                        case ' ':
+                        case '\t':
+                            while (!eof() && isWhitespace(*m_cur))
+                                advance();
+                            break;
+                        default:
+                            if (skipNumber())
+                                return Token_Number;
+                            do {
+                                advance();
+                            } while (!eof() && !isWhitespace(*m_cur));
+                            return Token_Word;
+                    }
+                }
+                m_tokenBegin = m_cur;
+                m_tokenLine = m_line;
+                m_tokenColumn = m_column;
+                return Token_Eof;
+            }
+            
+            // mirrors Tokenizer::readQuotedString with the hack for trailing backslashes
+            bool skipQuotedString() {
+                bool escaped = false;
+                while (!eof() && (*m_cur != '"' || escaped)) {
+                    if (*m_cur == '"' && escaped && (lookAhead() == '\n' || lookAhead() == '}'))
+                        break;
+                    escaped = *m_cur == '\\' && !escaped;
+                    advance();
+                }
+                if (eof())
+                    return false;
+                advance();
+                return true;
+            }
+            
+            // mirrors Tokenizer::readInteger and Tokenizer::readDecimal
+            bool skipNumber() {
+                const char* begin = m_cur;
+                const size_t column = m_column;
+                
+                char c = curChar();
+                if (c == '+' || c == '-' || isDigit(c)) {
+                    if (!isDigit(c))
+                        advance();
+                    skipDigits();
+                    if (isNumberDelim())
+                        return true;
+                    m_cur = begin;
+                    m_column = column;
+                }
+                
+                c = curChar();
+                if (c == '+' || c == '-' || c == '.' || isDigit(c)) {
+                    if (c != '.') {
+                        advance();
+                        skipDigits();
+                    }
+                    if (curChar() == '.') {
+                        advance();
+                        skipDigits();
+                    }
+                    if (curChar() == 'e') {
+                        advance();
+                        c = curChar();
+                        if (c == '+' || c == '-' || isDigit(c)) {
+                            advance();
+                            skipDigits();
+                        }
+                    }
+                    if (isNumberDelim())
+                        return true;
+                    m_cur = begin;
+                    m_column = column;
+                }
+                return false;
+            }
+            
+            void skipDigits() {
+                while (!eof() && isDigit(*m_cur))
+                    advance();
+            }
+            
+            bool isNumberDelim() const {
+                return eof() || isWhitespace(*m_cur) || *m_cur == ')';
+            }
+            
+            static bool isDigit(const char c) {
+                return c >= '0' && c <= '9';
+            }
+            
+            static bool isWhitespace(const char c) {
+                return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+            }
+            
+            bool eof() const {
+                return m_cur >= m_end;
+            }
+            
+            char curChar() const {
+                return eof() ? 0 : *m_cur;
+            }
+            
+            char lookAhead() const {
+                return m_cur + 1 < m_end ? *(m_cur + 1) : 0;
+            }
+            
+            void advance() {
+                if (*m_cur == '\n') {
+                    ++m_line;
+                    m_column = 1;
+                } else {
+                    ++m_column;
+                }
+                ++m_cur;
+            }
+        };
+        
         StandardMapParser::StandardMapParser(const char* begin, const char* end) :
+        m_begin(begin),
+        m_end(end),
         m_tokenizer(QuakeMapTokenizer(begin, end)),
         m_format(Model::MapFormat::Unknown) {}
         
         StandardMapParser::StandardMapParser(const String& str) :
+        m_begin(str.c_str()),
+        m_end(str.c_str() + str.size()),
         m_tokenizer(QuakeMapTokenizer(str)),
         m_format(Model::MapFormat::Unknown) {}
         
+        StandardMapParser::StandardMapParser(const char* begin, const char* end, const size_t line, const size_t column) :
+        m_begin(begin),
+        m_end(end),
+        m_tokenizer(QuakeMapTokenizer(begin, end, line, column)),
+        m_format(Model::MapFormat::Unknown) {}
+        
         StandardMapParser::~StandardMapParser() {}
 
         Model::MapFormat::Type StandardMapParser::detectFormat() {
@@ -174,6 +723,8 @@ namespace TrenchBroom {
         
         void StandardMapParser::parseEntities(const Model::MapFormat::Type format, ParserStatus& status) {
             setFormat(format);
+            if (parseEntitiesInChunks(status))
+                return;
 
             Token token = m_tokenizer.peekToken();
             while (token.type() != QuakeMapToken::Eof) {
@@ -215,6 +766,145 @@ namespace TrenchBroom {
             formatSet(format);
         }
 
+        bool StandardMapParser::parseEntitiesInChunks(ParserStatus& status) {
+            ChunkList chunks;
+            ChunkScanner scanner(m_begin, m_end, chunks);
+            if (!scanner.scan())
+                return false;
+            
+            // the entity whose brushes are currently being replayed, and the index of its next event to replay
+            std::unique_ptr<ChunkParser> entity;
+            size_t entityEvent = 0;
+            
+            const auto finishEntity = [&]() {
+                if (entity != nullptr) {
+                    replayEvents(*entity, entityEvent, entity->events().size(), status);
+                    entity->rethrow();
+                    entity.reset();
+                }
+            };
+            
+            const auto replayEntityUntilPlaceholder = [&]() {
+                const ChunkParser::EventList& events = entity->events();
+                for (size_t i = entityEvent; i < events.size(); ++i) {
+                    if (events[i].type == ChunkParser::Event_BrushPlaceholder) {
+                        replayEvents(*entity, entityEvent, i, status);
+                        entityEvent = i + 1;
+                        return;
+                    }
+                }
+                
+                // the entity chunk failed before reaching this brush
+                assert(entity->failed());
+                finishEntity();
+            };
+            
+            // limit the number of chunks that are parsed ahead so that the recorded events don't take up too much memory
+            const size_t windowSize = 16 * ParallelUtils::threadCount();
+            for (size_t first = 0; first < chunks.size(); first += windowSize) {
+                const size_t count = std::min(windowSize, chunks.size() - first);
+                ParallelUtils::parallelFor(count, [&](const size_t i) {
+                    parseChunk(chunks[first + i]);
+                });
+                
+                for (size_t i = first; i < first + count; ++i) {
+                    Chunk& chunk = chunks[i];
+                    if (chunk.entity) {
+                        finishEntity();
+                        entity = std::move(chunk.parser);
+                        entityEvent = 0;
+                    } else {
+                        const ChunkParser& brushes = *chunk.parser;
+                        const ChunkParser::EventList& events = brushes.events();
+                        size_t brushEvent = 0;
+                        for (size_t j = 0; j < events.size(); ++j) {
+                            if (events[j].type == ChunkParser::Event_BrushStart) {
+                                replayEvents(brushes, brushEvent, j, status);
+                                replayEntityUntilPlaceholder();
+                                brushEvent = j + 1;
+                            }
+                        }
+                        replayEvents(brushes, brushEvent, events.size(), status);
+                        brushes.rethrow();
+                        chunk.parser.reset();
+                    }
+                }
+            }
+            
+            finishEntity();
+            return true;
+        }
+        
+        void StandardMapParser::parseChunk(Chunk& chunk) const {
+            if (chunk.entity) {
+                // replace the contents of every brush with whitespace, keeping the lines and columns of the remaining tokens
+                String text;
+                const char* cur = chunk.begin;
+                for (const Chunk::BrushRange& brush : chunk.brushes) {
+                    text.append(cur, brush.begin + 1);
+                    
+                    const size_t newLines = static_cast<size_t>(std::count(brush.begin + 1, brush.end - 1, '\n'));
+                    if (newLines > 0) {
+                        text.append(newLines, '\n');
+                        text.append(brush.endColumn - 1, ' ');
+                    } else {
+                        text.append(static_cast<size_t>(brush.end - brush.begin - 2), ' ');
+                    }
+                    
+                    text.push_back('}');
+                    cur = brush.end;
+                }
+                text.append(cur, chunk.end);
+                
+                chunk.parser.reset(new ChunkParser(text.data(), text.data() + text.size(), chunk.line, chunk.column, m_format, true));
+                chunk.parser->parse();
+            } else {
+                chunk.parser.reset(new ChunkParser(chunk.begin, chunk.end, chunk.line, chunk.column, m_format, false));
+                chunk.parser->parse();
+            }
+        }
+        
+        void StandardMapParser::replayEvents(const ChunkParser& parser, const size_t first, const size_t last, ParserStatus& status) {
+            static const ExtraAttributes NoExtraAttributes;
+            
+            const ChunkParser::EventList& events = parser.events();
+            for (size_t i = first; i < last; ++i) {
+                const ChunkParser::Event& event = events[i];
+                switch (event.type) {
+                    case ChunkParser::Event_BeginEntity: {
+                        const ChunkParser::Entity& entity = parser.entity(event.index);
+                        beginEntity(event.line, entity.attributes, entity.extraAttributes, status);
+                        break;
+                    }
+                    case ChunkParser::Event_EndEntity:
+                        endEntity(event.line, event.lineCount, status);
+                        break;
+                    case ChunkParser::Event_BeginBrush:
+                        beginBrush(event.line, status);
+                        break;
+                    case ChunkParser::Event_EndBrush:
+                        if (event.index == ChunkParser::NoIndex)
+                            endBrush(event.line, event.lineCount, NoExtraAttributes, status);
+                        else
+                            endBrush(event.line, event.lineCount, parser.brushAttributes(event.index), status);
+                        break;
+                    case ChunkParser::Event_BrushFace: {
+                        const ChunkParser::Face& face = parser.face(event.index);
+                        brushFace(event.line, face.point1, face.point2, face.point3, face.attribs, face.texAxisX, face.texAxisY, status);
+                        break;
+                    }
+                    case ChunkParser::Event_Log: {
+                        const ChunkParser::Log& log = parser.log(event.index);
+                        status.log(log.level, log.message);
+                        break;
+                    }
+                    case ChunkParser::Event_BrushStart:
+                    case ChunkParser::Event_BrushPlaceholder:
+                        break;
+                }
+            }
+        }
+
         void StandardMapParser::parseEntity(ParserStatus& status) {
             Token token = m_tokenizer.nextToken();
             if (token.type() == QuakeMapToken::Eof)
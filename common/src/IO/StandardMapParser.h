@@ -28,6 +28,8 @@
 #include "IO/Tokenizer.h"
 #include "Model/MapFormat.h"
 
+#include <vector>
+
 namespace TrenchBroom {
     namespace IO {
         namespace QuakeMapToken {
@@ -54,6 +56,7 @@ namespace TrenchBroom {
             bool m_skipEol;
         public:
             QuakeMapTokenizer(const char* begin, const char* end);
+            QuakeMapTokenizer(const char* begin, const char* end, size_t line, size_t column);
             QuakeMapTokenizer(const String& str);
             
             void setSkipEol(bool skipEol);
@@ -66,6 +69,14 @@ namespace TrenchBroom {
             typedef QuakeMapTokenizer::Token Token;
             typedef std::set<Model::AttributeName> AttributeNames;
 
+            class ChunkScanner;
+            class ChunkStatus;
+            class ChunkParser;
+            struct Chunk;
+            typedef std::vector<Chunk> ChunkList;
+
+            const char* m_begin;
+            const char* m_end;
             QuakeMapTokenizer m_tokenizer;
             Model::MapFormat::Type m_format;
         public:
@@ -73,6 +84,8 @@ namespace TrenchBroom {
             StandardMapParser(const String& str);
             
             virtual ~StandardMapParser() override;
+        private:
+            StandardMapParser(const char* begin, const char* end, size_t line, size_t column);
         protected:
             Model::MapFormat::Type detectFormat();
             
@@ -84,6 +97,10 @@ namespace TrenchBroom {
         private:
             void setFormat(Model::MapFormat::Type format);
             
+            bool parseEntitiesInChunks(ParserStatus& status);
+            void parseChunk(Chunk& chunk) const;
+            void replayEvents(const ChunkParser& parser, size_t first, size_t last, ParserStatus& status);
+
             void parseEntity(ParserStatus& status);
             void parseEntityAttribute(Model::EntityAttribute::List& attributes, AttributeNames& names, ParserStatus& status);
             void parseBrush(ParserStatus& status);
@@ -0,0 +1,233 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TextureCache.h"
+
+#include "CollectionUtils.h"
+#include "Exceptions.h"
+#include "ParallelUtils.h"
+#include "Assets/Texture.h"
+#include "IO/CharArrayReader.h"
+#include "IO/DiskIO.h"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace IO {
+        static const char CacheFileMagic[4] = { 'T', 'B', 'T', 'C' };
+        static const uint32_t CacheFileVersion = 1;
+        static const uint64_t HashPrime = 1099511628211ULL;
+        
+        TextureCache::TextureCache(const Path& directory, const uint64_t readerKey) :
+        m_directory(directory),
+        m_readerKey(readerKey) {}
+        
+        uint64_t TextureCache::computeKey(const MappedFile::List& files) const {
+            // hashing the file contents dominates, so every file is hashed on its own and the results are combined
+            std::vector<uint64_t> fileHashes(files.size());
+            ParallelUtils::parallelFor(files.size(), [&](const size_t i) {
+                const MappedFile::Ptr file = files[i];
+                fileHashes[i] = hash(file->begin(), file->end(), hash(file->path().asString()));
+            });
+            
+            uint64_t key = hash(reinterpret_cast<const char*>(&m_readerKey), reinterpret_cast<const char*>(&m_readerKey + 1));
+            for (const uint64_t fileHash : fileHashes)
+                key = hash(reinterpret_cast<const char*>(&fileHash), reinterpret_cast<const char*>(&fileHash + 1), key);
+            return key;
+        }
+        
+        bool TextureCache::readTextures(const Path& collectionPath, const uint64_t key, Assets::TextureList& textures) const {
+            try {
+                const Path path = cacheFilePath(collectionPath);
+                if (!Disk::fileExists(path))
+                    return false;
+                
+                Assets::TextureList result;
+                try {
+                    doReadTextures(Disk::openFile(path), key, result);
+                } catch (...) {
+                    VectorUtils::clearAndDelete(result);
+                    throw;
+                }
+                
+                if (result.empty())
+                    return false;
+                VectorUtils::append(textures, result);
+                return true;
+            } catch (const Exception&) {
+                return false;
+            }
+        }
+        
+        void TextureCache::writeTextures(const Path& collectionPath, const uint64_t key, const Assets::TextureList& textures) const {
+            try {
+                const Path path = cacheFilePath(collectionPath);
+                const Path tempPath = path.replaceExtension("tmp");
+                
+                Disk::ensureDirectoryExists(m_directory);
+                doWriteTextures(tempPath, key, textures);
+                Disk::moveFile(tempPath, path, true);
+            } catch (const Exception&) {}
+        }
+        
+        uint64_t TextureCache::hash(const char* begin, const char* end, const uint64_t seed) {
+            // FNV-1a applied to 64 bit words instead of single bytes, which is good enough to detect changed files
+            uint64_t result = seed;
+            const char* cur = begin;
+            while (end - cur >= 8) {
+                uint64_t word;
+                std::memcpy(&word, cur, sizeof(word));
+                result = (result ^ word) * HashPrime;
+                cur += 8;
+            }
+            while (cur < end) {
+                result = (result ^ static_cast<unsigned char>(*cur)) * HashPrime;
+                ++cur;
+            }
+            return result;
+        }
+        
+        uint64_t TextureCache::hash(const String& str, const uint64_t seed) {
+            return hash(str.data(), str.data() + str.size(), seed);
+        }
+        
+        Path TextureCache::cacheFilePath(const Path& collectionPath) const {
+            const uint64_t pathHash = hash(collectionPath.asString(), m_readerKey);
+            
+            StringStream name;
+            name << std::hex << std::setw(16) << std::setfill('0') << pathHash << ".tbtc";
+            return m_directory + Path(name.str());
+        }
+        
+        template <typename T>
+        static T readValue(CharArrayReader& reader) {
+            if (!reader.canRead(sizeof(T)))
+                throw FileFormatException("Texture cache file is truncated");
+            return reader.read<T, T>();
+        }
+        
+        void TextureCache::doReadTextures(MappedFile::Ptr file, const uint64_t key, Assets::TextureList& textures) const {
+            CharArrayReader reader(file->begin(), file->end());
+            
+            char magic[4];
+            if (!reader.canRead(sizeof(magic)))
+                throw FileFormatException("Texture cache file is truncated");
+            reader.read(magic, sizeof(magic));
+            if (std::memcmp(magic, CacheFileMagic, sizeof(magic)) != 0 ||
+                readValue<uint32_t>(reader) != CacheFileVersion ||
+                readValue<uint64_t>(reader) != key)
+                return;
+            
+            const size_t textureCount = readValue<uint32_t>(reader);
+            for (size_t i = 0; i < textureCount; ++i) {
+                const size_t nameLength = readValue<uint32_t>(reader);
+                if (!reader.canRead(nameLength))
+                    throw FileFormatException("Texture cache file is truncated");
+                const String name = reader.readString(nameLength);
+                
+                const size_t width = readValue<uint32_t>(reader);
+                const size_t height = readValue<uint32_t>(reader);
+                const GLenum format = static_cast<GLenum>(readValue<uint32_t>(reader));
+                const float r = readValue<float>(reader);
+                const float g = readValue<float>(reader);
+                const float b = readValue<float>(reader);
+                const float a = readValue<float>(reader);
+                if (width == 0 || height == 0)
+                    throw FileFormatException("Invalid texture dimensions in texture cache file");
+                
+                // remember where the mip buffers are; they are copied out of the mapped file when they are needed
+                typedef std::vector<std::pair<size_t, size_t> > MipRanges;
+                MipRanges mips(readValue<uint32_t>(reader));
+                if (mips.empty())
+                    throw FileFormatException("Texture without mip levels in texture cache file");
+                
+                for (size_t j = 0; j < mips.size(); ++j) {
+                    const size_t size = static_cast<size_t>(readValue<uint64_t>(reader));
+                    if (size < Assets::mipBufferSize(width, height, format, j) || !reader.canRead(size))
+                        throw FileFormatException("Invalid mip buffer size in texture cache file");
+                    
+                    mips[j] = std::make_pair(reader.position(), size);
+                    reader.seekForward(size);
+                }
+                
+                const Assets::TextureDecoder decoder = [file, mips]() {
+                    Assets::TextureBuffer::List buffers;
+                    buffers.reserve(mips.size());
+                    for (const auto& mip : mips) {
+                        Assets::TextureBuffer buffer(mip.second);
+                        std::memcpy(buffer.ptr(), file->begin() + mip.first, mip.second);
+                        buffers.push_back(buffer);
+                    }
+                    return buffers;
+                };
+                textures.push_back(new Assets::Texture(name, width, height, Color(r, g, b, a), decoder, format));
+            }
+        }
+        
+        template <typename T>
+        static void writeValue(std::ofstream& stream, const T& value) {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+        
+        void TextureCache::doWriteTextures(const Path& path, const uint64_t key, const Assets::TextureList& textures) const {
+            std::ofstream stream(path.asString().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!stream.is_open())
+                throw FileSystemException("Could not open texture cache file '" + path.asString() + "'");
+            
+            stream.write(CacheFileMagic, sizeof(CacheFileMagic));
+            writeValue(stream, CacheFileVersion);
+            writeValue(stream, key);
+            writeValue(stream, static_cast<uint32_t>(textures.size()));
+            
+            for (const Assets::Texture* texture : textures) {
+                ensure(!texture->lazy(), "cannot cache lazy texture");
+                const Assets::TextureBuffer::List& buffers = texture->buffers();
+                ensure(!buffers.empty(), "cannot cache texture without buffers");
+                
+                const String& name = texture->name();
+                writeValue(stream, static_cast<uint32_t>(name.size()));
+                stream.write(name.data(), static_cast<std::streamsize>(name.size()));
+                
+                const Color& averageColor = texture->averageColor();
+                writeValue(stream, static_cast<uint32_t>(texture->width()));
+                writeValue(stream, static_cast<uint32_t>(texture->height()));
+                writeValue(stream, static_cast<uint32_t>(texture->format()));
+                writeValue(stream, averageColor.r());
+                writeValue(stream, averageColor.g());
+                writeValue(stream, averageColor.b());
+                writeValue(stream, averageColor.a());
+                
+                writeValue(stream, static_cast<uint32_t>(buffers.size()));
+                for (const Assets::TextureBuffer& buffer : buffers) {
+                    writeValue(stream, static_cast<uint64_t>(buffer.size()));
+                    stream.write(reinterpret_cast<const char*>(buffer.ptr()), static_cast<std::streamsize>(buffer.size()));
+                }
+            }
+            
+            stream.close();
+            if (stream.fail())
+                throw FileSystemException("Could not write texture cache file '" + path.asString() + "'");
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TextureCache_h
+#define TextureCache_h
+
+#include "Macros.h"
+#include "StringUtils.h"
+#include "Assets/AssetTypes.h"
+#include "IO/MappedFile.h"
+#include "IO/Path.h"
+
+#ifdef _MSC_VER
+#include <cstdint>
+#elif defined __GNUC__
+#include <stdint.h>
+#endif
+
+namespace TrenchBroom {
+    namespace IO {
+        /**
+         * Stores the decoded mip buffers and average colors of texture collections on disk so that they need not be
+         * decoded again when the collection is loaded the next time.
+         *
+         * Every collection is stored in a single file in the cache directory. The file is named after the collection
+         * path and records a hash of the contents of the texture files and of the reader settings (e.g. the palette),
+         * so a cache entry becomes invalid as soon as any of these change. Cache files are memory mapped when they are
+         * read, and the mip buffers are only copied out of the mapping when a texture is first used.
+         */
+        class TextureCache {
+        private:
+            Path m_directory;
+            uint64_t m_readerKey;
+        public:
+            /**
+             * Creates a cache that stores its files in the given directory. The given reader key identifies the
+             * texture reader settings and is part of the key of every cache entry.
+             */
+            TextureCache(const Path& directory, uint64_t readerKey);
+            
+            /**
+             * Computes the key of a cache entry for the given texture files.
+             */
+            uint64_t computeKey(const MappedFile::List& files) const;
+            
+            /**
+             * Reads the textures stored for the collection at the given path if there is a cache entry with the given
+             * key. The textures are lazy and are appended to the given list. Returns false if there is no valid cache
+             * entry.
+             */
+            bool readTextures(const Path& collectionPath, uint64_t key, Assets::TextureList& textures) const;
+            
+            /**
+             * Writes the given textures to the cache entry for the collection at the given path. The textures must not
+             * be lazy and must not have been uploaded yet. Errors are ignored since a missing cache entry only costs
+             * time.
+             */
+            void writeTextures(const Path& collectionPath, uint64_t key, const Assets::TextureList& textures) const;
+            
+            /**
+             * Hashes the given bytes, starting with the given seed. Pass the result of a previous call as the seed to
+             * combine several hashes.
+             */
+            static uint64_t hash(const char* begin, const char* end, uint64_t seed = 14695981039346656037ULL);
+            static uint64_t hash(const String& str, uint64_t seed = 14695981039346656037ULL);
+        private:
+            Path cacheFilePath(const Path& collectionPath) const;
+            void doReadTextures(MappedFile::Ptr file, uint64_t key, Assets::TextureList& textures) const;
+            void doWriteTextures(const Path& path, uint64_t key, const Assets::TextureList& textures) const;
+            
+            deleteCopyAndAssignment(TextureCache)
+        };
+    }
+}
+
+#endif /* TextureCache_h */
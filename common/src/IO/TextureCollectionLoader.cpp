@@ -19,12 +19,15 @@
 
 #include "TextureCollectionLoader.h"
 
+#include "ParallelUtils.h"
 #include "Assets/AssetTypes.h"
+#include "Assets/Texture.h"
 #include "Assets/TextureCollection.h"
 #include "Assets/TextureManager.h"
 #include "IO/DiskIO.h"
 #include "IO/FileMatcher.h"
 #include "IO/FileSystem.h"
+#include "IO/TextureCache.h"
 #include "IO/TextureReader.h"
 #include "IO/WadFileSystem.h"
 
@@ -32,18 +35,45 @@
 #include <cassert>
 #include <iterator>
 #include <memory>
+#include <vector>
 
 namespace TrenchBroom {
     namespace IO {
         TextureCollectionLoader::TextureCollectionLoader() {}
         TextureCollectionLoader::~TextureCollectionLoader() {}
 
-        Assets::TextureCollection* TextureCollectionLoader::loadTextureCollection(const Path& path, const String& textureExtension, const TextureReader& textureReader) {
+        Assets::TextureCollection* TextureCollectionLoader::loadTextureCollection(const Path& path, const String& textureExtension, const TextureReader& textureReader, const TextureCache* textureCache, const bool compressTextures) {
+            const MappedFile::List files = doFindTextures(path, textureExtension);
+            
+            uint64_t cacheKey = 0;
+            if (textureCache != nullptr) {
+                cacheKey = textureCache->computeKey(files);
+                if (compressTextures)
+                    cacheKey = TextureCache::hash("compressed", cacheKey);
+                
+                Assets::TextureList cachedTextures;
+                if (textureCache->readTextures(path, cacheKey, cachedTextures))
+                    return new Assets::TextureCollection(path, cachedTextures);
+            }
+            
+            // The textures are read in parallel, but added to the collection in the order of their files.
+            std::vector<std::unique_ptr<Assets::Texture>> textures(files.size());
+            ParallelUtils::parallelFor(files.size(), [&](const size_t i) {
+                textures[i].reset(textureReader.readTexture(files[i]));
+                if (compressTextures)
+                    textures[i]->compress();
+            });
+            
             std::unique_ptr<Assets::TextureCollection> collection(new Assets::TextureCollection(path));
+            for (auto& texture : textures)
+                collection->addTexture(texture.release());
             
-            for (MappedFile::Ptr file : doFindTextures(path, textureExtension)) {
-                Assets::Texture* texture = textureReader.readTexture(file->begin(), file->end(), file->path());
-                collection->addTexture(texture);
+            if (textureCache != nullptr && !collection->textures().empty()) {
+                const Assets::TextureList& collectionTextures = collection->textures();
+                const bool lazy = std::any_of(std::begin(collectionTextures), std::end(collectionTextures),
+                                              [](const Assets::Texture* texture) { return texture->lazy(); });
+                if (!lazy)
+                    textureCache->writeTextures(path, cacheKey, collectionTextures);
             }
             
             return collection.release();
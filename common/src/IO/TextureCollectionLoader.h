@@ -38,6 +38,7 @@ namespace TrenchBroom {
     }
     namespace IO {
         class FileSystem;
+        class TextureCache;
         class TextureReader;
 
         class TextureCollectionLoader {
@@ -48,7 +49,17 @@ namespace TrenchBroom {
         public:
             virtual ~TextureCollectionLoader();
         public:
-            Assets::TextureCollection* loadTextureCollection(const Path& path, const String& textureExtension, const TextureReader& textureReader);
+            /**
+             * Loads the textures of the collection at the given path. The textures are read on several threads, so
+             * the given texture reader must not modify any shared state while reading a texture.
+             *
+             * If a texture cache is given, the textures are taken from the cache if it has an entry for the current
+             * contents of the collection. Otherwise, the decoded textures are written to the cache, unless the texture
+             * reader already defers decoding until the textures are used.
+             *
+             * If requested, the textures are compressed after reading them, see Assets::Texture::compress.
+             */
+            Assets::TextureCollection* loadTextureCollection(const Path& path, const String& textureExtension, const TextureReader& textureReader, const TextureCache* textureCache = nullptr, bool compressTextures = false);
         private:
             virtual MappedFile::List doFindTextures(const Path& path, const String& extension) = 0;
         };
@@ -20,31 +20,35 @@
 #include "TextureLoader.h"
 
 #include "Assets/Palette.h"
-#include "Assets/TextureManager.h"
 #include "EL/Interpolator.h"
 #include "IO/FreeImageTextureReader.h"
 #include "IO/HlMipTextureReader.h"
 #include "IO/IdMipTextureReader.h"
 #include "IO/IdWalTextureReader.h"
 #include "IO/FreeImageTextureReader.h"
+#include "IO/FileSystem.h"
 #include "IO/Path.h"
+#include "IO/TextureCache.h"
 #include "IO/TextureCollectionLoader.h"
 #include "Model/GameConfig.h"
 
 namespace TrenchBroom {
     namespace IO {
-        TextureLoader::TextureLoader(const EL::VariableStore& variables, const FileSystem& gameFS, const IO::Path::List& fileSearchPaths, const Model::GameConfig::TextureConfig& textureConfig) :
+        TextureLoader::TextureLoader(const EL::VariableStore& variables, const FileSystem& gameFS, const IO::Path::List& fileSearchPaths, const Model::GameConfig::TextureConfig& textureConfig, const Path& textureCacheDirectory, const bool compressTextures) :
         m_variables(variables.clone()),
         m_gameFS(gameFS),
         m_fileSearchPaths(fileSearchPaths),
         m_textureExtension(getTextureExtension(textureConfig)),
         m_textureReader(createTextureReader(textureConfig)),
-        m_textureCollectionLoader(createTextureCollectionLoader(textureConfig)) {
+        m_textureCollectionLoader(createTextureCollectionLoader(textureConfig)),
+        m_textureCache(createTextureCache(textureConfig, textureCacheDirectory)),
+        m_compressTextures(compressTextures) {
             ensure(m_textureReader != nullptr, "textureReader is null");
             ensure(m_textureCollectionLoader != nullptr, "textureCollectionLoader is null");
         }
         
         TextureLoader::~TextureLoader() {
+            delete m_textureCache;
             delete m_textureCollectionLoader;
             delete m_textureReader;
             delete m_variables;
@@ -73,10 +77,13 @@ namespace TrenchBroom {
         }
         
         Assets::Palette TextureLoader::loadPalette(const Model::GameConfig::TextureConfig& textureConfig) const {
+            return Assets::Palette::loadFile(m_gameFS, palettePath(textureConfig));
+        }
+
+        Path TextureLoader::palettePath(const Model::GameConfig::TextureConfig& textureConfig) const {
             const String pathSpec = textureConfig.palette.asString();
             const String pathStr = EL::interpolate(pathSpec, EL::EvaluationContext(*m_variables));
-            const Path path(pathStr);
-            return Assets::Palette::loadFile(m_gameFS, path);
+            return Path(pathStr);
         }
 
         TextureCollectionLoader* TextureLoader::createTextureCollectionLoader(const Model::GameConfig::TextureConfig& textureConfig) const {
@@ -92,12 +99,23 @@ namespace TrenchBroom {
             }
         }
 
-        Assets::TextureCollection* TextureLoader::loadTextureCollection(const Path& path) {
-            return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtension, *m_textureReader);
+        TextureCache* TextureLoader::createTextureCache(const Model::GameConfig::TextureConfig& textureConfig, const Path& textureCacheDirectory) const {
+            // mip textures are only decoded when they are first used, so caching them would not save any time
+            const String& format = textureConfig.format.format;
+            if (textureCacheDirectory.isEmpty() || (format != "idwal" && format != "image"))
+                return nullptr;
+            
+            uint64_t readerKey = TextureCache::hash(format);
+            readerKey = TextureCache::hash(m_textureExtension, readerKey);
+            if (format == "idwal") {
+                const MappedFile::Ptr paletteFile = m_gameFS.openFile(palettePath(textureConfig));
+                readerKey = TextureCache::hash(paletteFile->begin(), paletteFile->end(), readerKey);
+            }
+            return new TextureCache(textureCacheDirectory, readerKey);
         }
 
-        void TextureLoader::loadTextures(const Path::List& paths, Assets::TextureManager& textureManager) {
-            textureManager.setTextureCollections(paths, *this);
+        Assets::TextureCollection* TextureLoader::loadTextureCollection(const Path& path) {
+            return m_textureCollectionLoader->loadTextureCollection(path, m_textureExtension, *m_textureReader, m_textureCache, m_compressTextures);
         }
     }
 }
@@ -32,11 +32,11 @@ namespace TrenchBroom {
 
     namespace Assets {
         class Palette;
-        class TextureManager;
     }
     
     namespace IO {
         class FileSystem;
+        class TextureCache;
         class TextureCollectionLoader;
         class TextureReader;
         
@@ -48,17 +48,29 @@ namespace TrenchBroom {
             String m_textureExtension;
             TextureReader* m_textureReader;
             TextureCollectionLoader* m_textureCollectionLoader;
+            TextureCache* m_textureCache;
+            bool m_compressTextures;
         public:
-            TextureLoader(const EL::VariableStore& variables, const FileSystem& gameFS, const IO::Path::List& fileSearchPaths, const Model::GameConfig::TextureConfig& textureConfig);
+            /**
+             * Creates a texture loader. If the given texture cache directory is not empty, the decoded textures of
+             * collections whose textures cannot be decoded lazily are cached in that directory. If requested, the
+             * loaded textures are compressed.
+             */
+            TextureLoader(const EL::VariableStore& variables, const FileSystem& gameFS, const IO::Path::List& fileSearchPaths, const Model::GameConfig::TextureConfig& textureConfig, const Path& textureCacheDirectory = Path(), bool compressTextures = false);
             ~TextureLoader();
         private:
             String getTextureExtension(const Model::GameConfig::TextureConfig& textureConfig) const;
             TextureReader* createTextureReader(const Model::GameConfig::TextureConfig& textureConfig) const;
             Assets::Palette loadPalette(const Model::GameConfig::TextureConfig& textureConfig) const;
+            Path palettePath(const Model::GameConfig::TextureConfig& textureConfig) const;
             TextureCollectionLoader* createTextureCollectionLoader(const Model::GameConfig::TextureConfig& textureConfig) const;
+            TextureCache* createTextureCache(const Model::GameConfig::TextureConfig& textureConfig, const Path& textureCacheDirectory) const;
         public:
+            /**
+             * Loads the texture collection with the given path. May be called from a background thread, but not from
+             * several threads at once.
+             */
             Assets::TextureCollection* loadTextureCollection(const Path& path);
-            void loadTextures(const Path::List& paths, Assets::TextureManager& textureManager);
 
             deleteCopyAndAssignment(TextureLoader)
         };
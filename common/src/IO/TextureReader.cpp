@@ -70,12 +70,16 @@ namespace TrenchBroom {
         }
         
         Assets::Texture* TextureReader::readTexture(MappedFile::Ptr file) const {
-            return readTexture(file->begin(), file->end(), file->path());
+            return doReadTexture(file);
         }
 
         Assets::Texture* TextureReader::readTexture(const char* const begin, const char* const end, const Path& path) const {
             return doReadTexture(begin, end, path);
         }
+        
+        Assets::Texture* TextureReader::doReadTexture(MappedFile::Ptr file) const {
+            return doReadTexture(file->begin(), file->end(), file->path());
+        }
 
         String TextureReader::textureName(const String& textureName, const Path& path) const {
             return m_nameStrategy->textureName(textureName, path);
@@ -75,11 +75,20 @@ namespace TrenchBroom {
         public:
             virtual ~TextureReader();
             
+            /**
+             * Reads the texture in the given file. The returned texture may keep the file and decode its image data
+             * only when it is first used.
+             */
             Assets::Texture* readTexture(MappedFile::Ptr file) const;
+            
+            /**
+             * Reads and decodes the texture in the given memory range, which need not remain valid afterwards.
+             */
             Assets::Texture* readTexture(const char* const begin, const char* const end, const Path& path) const;
         protected:
             String textureName(const String& textureName, const Path& path) const;
         private:
+            virtual Assets::Texture* doReadTexture(MappedFile::Ptr file) const;
             virtual Assets::Texture* doReadTexture(const char* const begin, const char* const end, const Path& path) const = 0;
         public:
             static size_t mipSize(size_t width, size_t height, size_t mipLevel);
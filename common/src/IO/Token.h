@@ -94,25 +94,131 @@ namespace TrenchBroom {
             
             template <typename T>
             T toFloat() const {
-                static const size_t BufferSize = 256;
-                static char buffer[BufferSize];
-                assert(length() < BufferSize);
-                
-                memcpy(buffer, m_begin, length());
-                buffer[length()] = 0;
-                const T f = static_cast<T>(std::atof(buffer));
-                return f;
+                double result;
+                if (!parseDecimal(result))
+                    result = std::atof(data().c_str());
+                return static_cast<T>(result);
             }
             
             template <typename T>
             T toInteger() const {
-                static char buffer[64];
-                assert(length() < 64);
+                long long result;
+                if (!parseInteger(result))
+                    result = static_cast<long long>(std::atoi(data().c_str()));
+                return static_cast<T>(result);
+            }
+        private:
+            /**
+             * Parses the token data in place if it is a plain decimal number whose value can be computed exactly, that
+             * is, if its mantissa has at most 15 significant digits and its decimal exponent is small enough for the
+             * corresponding power of ten to be exactly representable. In that case, a single multiplication or division
+             * yields the correctly rounded result, so it is identical to what std::atof returns.
+             *
+             * Returns false if the token data does not match these conditions.
+             */
+            bool parseDecimal(double& result) const {
+                static const double PowersOfTen[] = {
+                    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+                };
+                static const int MaxPowerOfTen = 22;
+                static const size_t MaxDigits = 15;
+                
+                const char* cur = m_begin;
+                const bool negative = cur < m_end && *cur == '-';
+                if (cur < m_end && (*cur == '-' || *cur == '+'))
+                    ++cur;
+                
+                unsigned long long mantissa = 0;
+                size_t digits = 0;
+                int exponent = 0;
+                bool anyDigits = false;
+                
+                while (cur < m_end && *cur >= '0' && *cur <= '9') {
+                    if (mantissa != 0 || *cur != '0')
+                        ++digits;
+                    mantissa = mantissa * 10 + static_cast<unsigned long long>(*cur - '0');
+                    anyDigits = true;
+                    ++cur;
+                    if (digits > MaxDigits)
+                        return false;
+                }
+                
+                if (cur < m_end && *cur == '.') {
+                    ++cur;
+                    while (cur < m_end && *cur >= '0' && *cur <= '9') {
+                        if (mantissa != 0 || *cur != '0')
+                            ++digits;
+                        mantissa = mantissa * 10 + static_cast<unsigned long long>(*cur - '0');
+                        anyDigits = true;
+                        --exponent;
+                        ++cur;
+                        if (digits > MaxDigits)
+                            return false;
+                    }
+                }
+                
+                if (!anyDigits)
+                    return false;
+                
+                if (cur < m_end && (*cur == 'e' || *cur == 'E')) {
+                    ++cur;
+                    const bool negativeExponent = cur < m_end && *cur == '-';
+                    if (cur < m_end && (*cur == '-' || *cur == '+'))
+                        ++cur;
+                    if (cur == m_end)
+                        return false;
+                    
+                    int explicitExponent = 0;
+                    while (cur < m_end && *cur >= '0' && *cur <= '9') {
+                        explicitExponent = explicitExponent * 10 + (*cur - '0');
+                        if (explicitExponent > 2 * MaxPowerOfTen)
+                            return false;
+                        ++cur;
+                    }
+                    exponent += negativeExponent ? -explicitExponent : explicitExponent;
+                }
+                
+                if (cur != m_end || exponent < -MaxPowerOfTen || exponent > MaxPowerOfTen)
+                    return false;
+                
+                double value = static_cast<double>(mantissa);
+                if (exponent < 0)
+                    value /= PowersOfTen[-exponent];
+                else
+                    value *= PowersOfTen[exponent];
+                result = negative ? -value : value;
+                return true;
+            }
+            
+            /**
+             * Parses an optionally signed sequence of digits at the start of the token data in place. Like std::atoi,
+             * parsing stops at the first character that is not a digit.
+             *
+             * Returns false if the token data does not start with a number or if the number has too many digits.
+             */
+            bool parseInteger(long long& result) const {
+                static const size_t MaxDigits = 18;
+                
+                const char* cur = m_begin;
+                const bool negative = cur < m_end && *cur == '-';
+                if (cur < m_end && (*cur == '-' || *cur == '+'))
+                    ++cur;
+                
+                long long value = 0;
+                size_t digits = 0;
+                while (cur < m_end && *cur >= '0' && *cur <= '9') {
+                    value = value * 10 + (*cur - '0');
+                    ++cur;
+                    if (++digits > MaxDigits)
+                        return false;
+                }
+                
+                if (digits == 0)
+                    return false;
                 
-                memcpy(buffer, m_begin, length());
-                buffer[length()] = 0;
-                const T i = static_cast<T>(std::atoi(buffer));
-                return i;
+                result = negative ? -value : value;
+                return true;
             }
         };
     }
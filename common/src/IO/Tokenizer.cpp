@@ -27,8 +27,22 @@ namespace TrenchBroom {
         m_end(end),
         m_escapableChars(escapableChars),
         m_escapeChar(escapeChar),
-        m_line(1),
-        m_column(1),
+        m_startLine(1),
+        m_startColumn(1),
+        m_line(m_startLine),
+        m_column(m_startColumn),
+        m_escaped(false) {}
+        
+        TokenizerState::TokenizerState(const char* begin, const char* end, const String& escapableChars, const char escapeChar, const size_t line, const size_t column) :
+        m_begin(begin),
+        m_cur(m_begin),
+        m_end(end),
+        m_escapableChars(escapableChars),
+        m_escapeChar(escapeChar),
+        m_startLine(line),
+        m_startColumn(column),
+        m_line(m_startLine),
+        m_column(m_startColumn),
         m_escaped(false) {}
         
         size_t TokenizerState::length() const {
@@ -43,20 +57,6 @@ namespace TrenchBroom {
             return m_end;
         }
         
-        const char* TokenizerState::curPos() const {
-            return m_cur;
-        }
-        
-        char TokenizerState::curChar() const {
-            return *m_cur;
-        }
-        
-        char TokenizerState::lookAhead(const size_t offset) const {
-            if (eof(m_cur + offset))
-                return 0;
-            return *(m_cur + offset);
-        }
-        
         size_t TokenizerState::line() const {
             return m_line;
         }
@@ -65,10 +65,6 @@ namespace TrenchBroom {
             return m_column;
         }
         
-        bool TokenizerState::escaped() const {
-            return !eof() && m_escaped && m_escapableChars.find(curChar()) != String::npos;
-        }
-        
         String TokenizerState::unescape(const String& str) {
             return StringUtils::unescape(str, m_escapableChars, m_escapeChar);
         }
@@ -77,56 +73,18 @@ namespace TrenchBroom {
             m_escaped = false;
         }
 
-        bool TokenizerState::eof() const {
-            return eof(m_cur);
-        }
-        
-        bool TokenizerState::eof(const char* ptr) const {
-            return ptr >= m_end;
-        }
-        
-        size_t TokenizerState::offset(const char* ptr) const {
-            assert(ptr >= m_begin);
-            return static_cast<size_t>(ptr - m_begin);
-        }
-        
         void TokenizerState::advance(const size_t offset) {
             for (size_t i = 0; i < offset; ++i)
                 advance();
         }
         
-        void TokenizerState::advance() {
-            errorIfEof();
-            
-            switch (curChar()) {
-                case '\n':
-                    ++m_line;
-                    m_column = 1;
-                    m_escaped = false;
-                    break;
-                default:
-                    ++m_column;
-                    if (curChar() == m_escapeChar)
-                        m_escaped = !m_escaped;
-                    else
-                        m_escaped = false;
-                    break;
-            }
-            ++m_cur;
-        }
-        
         void TokenizerState::reset() {
             m_cur = m_begin;
-            m_line = 1;
-            m_column = 1;
+            m_line = m_startLine;
+            m_column = m_startColumn;
             m_escaped = false;
         }
         
-        void TokenizerState::errorIfEof() const {
-            if (eof())
-                throw ParserException("Unexpected end of file");
-        }
-
         TokenizerState::Snapshot TokenizerState::snapshot() const {
             return Snapshot(*this);
         }
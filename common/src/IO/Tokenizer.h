@@ -59,38 +59,85 @@ namespace TrenchBroom {
             const char* m_end;
             String m_escapableChars;
             char m_escapeChar;
+            size_t m_startLine;
+            size_t m_startColumn;
             size_t m_line;
             size_t m_column;
             bool m_escaped;
         public:
             TokenizerState(const char* begin, const char* end, const String& escapableChars, char escapeChar);
+            TokenizerState(const char* begin, const char* end, const String& escapableChars, char escapeChar, size_t line, size_t column);
             
             size_t length() const;
             const char* begin() const;
             const char* end() const;
             
-            const char* curPos() const;
-            char curChar() const;
+            // the following functions are called for every character, so they are defined inline
+            const char* curPos() const {
+                return m_cur;
+            }
+            
+            char curChar() const {
+                return *m_cur;
+            }
             
-            char lookAhead(const size_t offset = 1) const;
+            char lookAhead(const size_t offset = 1) const {
+                if (eof(m_cur + offset))
+                    return 0;
+                return *(m_cur + offset);
+            }
             
             size_t line() const;
             size_t column() const;
             
-            bool escaped() const;
+            bool escaped() const {
+                return !eof() && m_escaped && m_escapableChars.find(curChar()) != String::npos;
+            }
+            
             String unescape(const String& str);
             void resetEscaped();
             
-            bool eof() const;
-            bool eof(const char* ptr) const;
+            bool eof() const {
+                return eof(m_cur);
+            }
             
-            size_t offset(const char* ptr) const;
+            bool eof(const char* ptr) const {
+                return ptr >= m_end;
+            }
+            
+            size_t offset(const char* ptr) const {
+                assert(ptr >= m_begin);
+                return static_cast<size_t>(ptr - m_begin);
+            }
             
             void advance(const size_t offset);
-            void advance();
+            
+            void advance() {
+                errorIfEof();
+                
+                switch (curChar()) {
+                    case '\n':
+                        ++m_line;
+                        m_column = 1;
+                        m_escaped = false;
+                        break;
+                    default:
+                        ++m_column;
+                        if (curChar() == m_escapeChar)
+                            m_escaped = !m_escaped;
+                        else
+                            m_escaped = false;
+                        break;
+                }
+                ++m_cur;
+            }
+            
             void reset();
             
-            void errorIfEof() const;
+            void errorIfEof() const {
+                if (eof())
+                    throw ParserException("Unexpected end of file");
+            }
             
             Snapshot snapshot() const;
             void restore(const Snapshot& snapshot);
@@ -107,15 +154,15 @@ namespace TrenchBroom {
 
             class SaveState {
             private:
-                StatePtr m_state;
+                TokenizerState& m_state;
                 TokenizerState::Snapshot m_snapshot;
             public:
-                SaveState(StatePtr state) :
+                SaveState(TokenizerState& state) :
                 m_state(state),
-                m_snapshot(m_state->snapshot()) {}
+                m_snapshot(m_state.snapshot()) {}
                 
                 ~SaveState() {
-                    m_state->restore(m_snapshot);
+                    m_state.restore(m_snapshot);
                 }
             };
 
@@ -131,6 +178,13 @@ namespace TrenchBroom {
             Tokenizer(const char* begin, const char* end, const String& escapableChars, const char escapeChar) :
             m_state(new TokenizerState(begin, end, escapableChars, escapeChar)) {}
 
+            /**
+             * Creates a tokenizer for a part of a larger document. The given line and column are the position of the
+             * given begin pointer in that document, and all tokens are reported relative to it.
+             */
+            Tokenizer(const char* begin, const char* end, const String& escapableChars, const char escapeChar, const size_t line, const size_t column) :
+            m_state(new TokenizerState(begin, end, escapableChars, escapeChar, line, column)) {}
+
             Tokenizer(const String& str, const String& escapableChars, const char escapeChar) :
             m_state(new TokenizerState(str.c_str(), str.c_str() + str.size(), escapableChars, escapeChar)) {}
 
@@ -148,7 +202,7 @@ namespace TrenchBroom {
             }
 
             Token peekToken() {
-                SaveState oldState(m_state);
+                SaveState oldState(*m_state);
                 return nextToken();
             }
 
@@ -262,7 +316,7 @@ namespace TrenchBroom {
                 if (curChar() != '+' && curChar() != '-' && !isDigit(curChar()))
                     return nullptr;
 
-                const TokenizerState previous = *m_state;
+                const TokenizerState::Snapshot previous = m_state->snapshot();
                 if (curChar() == '+' || curChar() == '-')
                     advance();
                 while (!eof() && isDigit(curChar()))
@@ -270,7 +324,7 @@ namespace TrenchBroom {
                 if (eof() || isAnyOf(curChar(), delims))
                     return curPos();
 
-                *m_state = previous;
+                m_state->restore(previous);
                 return nullptr;
             }
 
@@ -278,7 +332,7 @@ namespace TrenchBroom {
                 if (curChar() != '+' && curChar() != '-' && curChar() != '.' && !isDigit(curChar()))
                     return nullptr;
 
-                const TokenizerState previous = *m_state;
+                const TokenizerState::Snapshot previous = m_state->snapshot();
                 if (curChar() != '.') {
                     advance();
                     readDigits();
@@ -300,7 +354,7 @@ namespace TrenchBroom {
                 if (eof() || isAnyOf(curChar(), delims))
                     return curPos();
 
-                *m_state = previous;
+                m_state->restore(previous);
                 return nullptr;
             }
             
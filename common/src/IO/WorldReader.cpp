@@ -29,12 +29,16 @@ namespace TrenchBroom {
         WorldReader::WorldReader(const char* begin, const char* end, const Model::BrushContentTypeBuilder* brushContentTypeBuilder) :
         MapReader(begin, end),
         m_brushContentTypeBuilder(brushContentTypeBuilder),
-        m_world(nullptr) {}
+        m_world(nullptr) {
+            setDeferBrushGeometry(true);
+        }
         
         WorldReader::WorldReader(const String& str, const Model::BrushContentTypeBuilder* brushContentTypeBuilder) :
         MapReader(str),
         m_brushContentTypeBuilder(brushContentTypeBuilder),
-        m_world(nullptr) {}
+        m_world(nullptr) {
+            setDeferBrushGeometry(true);
+        }
         
         Model::World* WorldReader::read(Model::MapFormat::Type format, const BBox3& worldBounds, ParserStatus& status) {
             readEntities(format, worldBounds, status);
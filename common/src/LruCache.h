@@ -0,0 +1,99 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_LruCache_h
+#define TrenchBroom_LruCache_h
+
+#include "Ensure.h"
+
+#include <cassert>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+
+/**
+ * A cache that holds at most a fixed number of values. If a value is added to a full cache, the value that was least
+ * recently accessed is dropped.
+ *
+ * The values are handed out as shared pointers, so a value that is dropped from the cache stays valid for as long as
+ * a caller holds on to it.
+ */
+template <typename Key, typename Value>
+class LruCache {
+public:
+    typedef std::shared_ptr<const Value> ValuePtr;
+private:
+    typedef std::pair<Key, ValuePtr> Entry;
+    typedef std::list<Entry> EntryList;
+    typedef std::map<Key, typename EntryList::iterator> EntryMap;
+
+    size_t m_capacity;
+    // the most recently accessed entry is at the front
+    EntryList m_entries;
+    EntryMap m_index;
+public:
+    LruCache(const size_t capacity) :
+    m_capacity(capacity) {
+        ensure(m_capacity > 0, "capacity is zero");
+    }
+
+    size_t capacity() const {
+        return m_capacity;
+    }
+
+    size_t size() const {
+        return m_entries.size();
+    }
+
+    bool contains(const Key& key) const {
+        return m_index.count(key) > 0;
+    }
+
+    /**
+     * Returns the value with the given key. If the cache does not contain such a value, it is created by calling
+     * the given function with the key, which must return a pointer to a new value that the cache takes ownership of.
+     */
+    template <typename Create>
+    ValuePtr get(const Key& key, Create create) {
+        const auto it = m_index.find(key);
+        if (it != std::end(m_index)) {
+            m_entries.splice(std::begin(m_entries), m_entries, it->second);
+            return it->second->second;
+        }
+
+        ValuePtr value(create(key));
+        if (m_entries.size() == m_capacity) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+
+        m_entries.push_front(std::make_pair(key, value));
+        m_index[key] = std::begin(m_entries);
+        return value;
+    }
+
+    void clear() {
+        m_index.clear();
+        m_entries.clear();
+    }
+};
+
+#endif
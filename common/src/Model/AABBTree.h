@@ -0,0 +1,555 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_AABBTree
+#define TrenchBroom_AABBTree
+
+#include "Exceptions.h"
+#include "MathUtils.h"
+#include "VecMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * A bounding volume hierarchy of axis aligned bounding boxes. Every leaf holds one object, and every inner
+         * node has exactly two children whose bounds it encloses.
+         *
+         * New objects are inserted next to the node that minimizes the increase of the surface areas of the tree,
+         * which is the incremental version of the surface area heuristic, and the tree is kept balanced by rotating
+         * nodes whose subtrees differ in height by more than one. When the bounds of an object change, the bounds of
+         * its ancestors are refitted in place as long as the object stays within the bounds of its parent. Otherwise,
+         * it is moved to a better place in the tree.
+         *
+         * The bounds of the leaves can be enlarged by a margin so that objects that are moved by small distances, such
+         * as the selected objects during a mouse drag, still fit into their leaves and do not change the tree at all.
+         * Queries still test the exact bounds of the objects. When an object leaves its leaf, the new leaf is also
+         * extended in the direction of the movement, so that an object that keeps moving in the same direction is
+         * not moved in the tree on every update.
+         *
+         * Nodes are kept in a vector and are recycled, so that adding and removing objects does not allocate memory
+         * once the tree has grown to its working size.
+         */
+        template <typename F, typename T>
+        class AABBTree {
+        public:
+            typedef std::vector<T> List;
+            typedef BBox<F,3> Box;
+        private:
+            static const size_t NoNode = static_cast<size_t>(-1);
+
+            struct Node {
+                Box bounds;
+                Box objectBounds;
+                size_t parent;
+                size_t left;
+                size_t right;
+                size_t height;
+                T object;
+
+                bool leaf() const {
+                    return left == NoNode;
+                }
+            };
+
+            typedef std::vector<Node> NodeList;
+            typedef std::unordered_map<T, size_t> LeafMap;
+
+            F m_margin;
+            NodeList m_nodes;
+            size_t m_root;
+            size_t m_freeNodes;
+            LeafMap m_leaves;
+        public:
+            AABBTree(const F margin = static_cast<F>(0.0)) :
+            m_margin(margin),
+            m_root(NoNode),
+            m_freeNodes(NoNode) {}
+
+            bool empty() const {
+                return m_root == NoNode;
+            }
+
+            size_t size() const {
+                return m_leaves.size();
+            }
+
+            /**
+             * Returns the bounds of all leaves of this tree, including their margins. The tree must not be empty.
+             */
+            const Box& bounds() const {
+                assert(!empty());
+                return m_nodes[m_root].bounds;
+            }
+
+            void clear() {
+                m_nodes.clear();
+                m_leaves.clear();
+                m_root = NoNode;
+                m_freeNodes = NoNode;
+            }
+
+            void addObject(const Box& bounds, T object) {
+                if (m_leaves.count(object) > 0)
+                    throw AABBTreeException("Object is already contained in this tree");
+
+                const size_t leaf = allocateNode();
+                m_nodes[leaf].bounds = bounds.expanded(m_margin);
+                m_nodes[leaf].objectBounds = bounds;
+                m_nodes[leaf].object = object;
+                insertLeaf(leaf, m_root);
+                m_leaves.insert(std::make_pair(object, leaf));
+            }
+
+            void removeObject(T object) {
+                typename LeafMap::iterator it = m_leaves.find(object);
+                if (it == std::end(m_leaves))
+                    throw AABBTreeException("Cannot find object in tree");
+
+                const size_t leaf = it->second;
+                m_leaves.erase(it);
+                removeLeaf(leaf);
+                freeNode(leaf);
+            }
+
+            void updateObject(const Box& bounds, T object) {
+                typename LeafMap::iterator it = m_leaves.find(object);
+                if (it == std::end(m_leaves))
+                    throw AABBTreeException("Cannot find object in tree");
+
+                const size_t leaf = it->second;
+                const Vec<F,3> displacement = bounds.center() - m_nodes[leaf].objectBounds.center();
+                m_nodes[leaf].objectBounds = bounds;
+                if (m_nodes[leaf].bounds.contains(bounds))
+                    return;
+
+                const Box leafBounds = predictLeafBounds(bounds, displacement);
+                const size_t parent = m_nodes[leaf].parent;
+                if (parent == NoNode || m_nodes[parent].bounds.contains(leafBounds)) {
+                    m_nodes[leaf].bounds = leafBounds;
+                    refit(parent);
+                } else {
+                    // look for a new place near the old one, starting at the closest ancestor that contains the leaf
+                    size_t ancestor = m_nodes[parent].parent;
+                    removeLeaf(leaf);
+                    while (ancestor != NoNode && !m_nodes[ancestor].bounds.contains(leafBounds))
+                        ancestor = m_nodes[ancestor].parent;
+
+                    m_nodes[leaf].bounds = leafBounds;
+                    insertLeaf(leaf, ancestor != NoNode ? ancestor : m_root);
+                }
+            }
+
+            bool containsObject(T object) const {
+                return m_leaves.count(object) > 0;
+            }
+
+            /**
+             * Calls the given visitor for every object whose bounds are hit by the given ray. Subtrees are visited
+             * in front to back order, so the objects closer to the ray origin are generally visited first.
+             *
+             * The visitor is called with the object and the current maximum distance, and it returns the distance up
+             * to which further objects are of interest. Subtrees whose bounds the ray enters beyond that distance are
+             * skipped, so a visitor that looks for the closest hit returns the distance of the closest hit found so
+             * far, and a visitor that wants to see every object just returns the maximum distance it is given.
+             */
+            template <typename V>
+            void findObjects(const Ray<F,3>& ray, V visitor, F maxDistance = std::numeric_limits<F>::max()) const {
+                if (empty())
+                    return;
+
+                typedef std::pair<size_t, F> Entry;
+                std::vector<Entry> stack;
+
+                F distance;
+                if (intersectWithRay(queryBounds(m_nodes[m_root]), ray, maxDistance, distance))
+                    stack.push_back(std::make_pair(m_root, distance));
+
+                while (!stack.empty()) {
+                    const Entry entry = stack.back();
+                    stack.pop_back();
+                    if (entry.second > maxDistance)
+                        continue;
+
+                    const Node& node = m_nodes[entry.first];
+                    if (node.leaf()) {
+                        maxDistance = visitor(node.object, maxDistance);
+                    } else {
+                        F leftDistance, rightDistance;
+                        const bool leftHit = intersectWithRay(queryBounds(m_nodes[node.left]), ray, maxDistance, leftDistance);
+                        const bool rightHit = intersectWithRay(queryBounds(m_nodes[node.right]), ray, maxDistance, rightDistance);
+
+                        // push the farther child first so that the nearer one is visited first
+                        if (leftHit && rightHit) {
+                            if (leftDistance <= rightDistance) {
+                                stack.push_back(std::make_pair(node.right, rightDistance));
+                                stack.push_back(std::make_pair(node.left, leftDistance));
+                            } else {
+                                stack.push_back(std::make_pair(node.left, leftDistance));
+                                stack.push_back(std::make_pair(node.right, rightDistance));
+                            }
+                        } else if (leftHit) {
+                            stack.push_back(std::make_pair(node.left, leftDistance));
+                        } else if (rightHit) {
+                            stack.push_back(std::make_pair(node.right, rightDistance));
+                        }
+                    }
+                }
+            }
+
+            List findObjects(const Ray<F,3>& ray) const {
+                List result;
+                findObjects(ray, [&result](T object, const F maxDistance) {
+                    result.push_back(object);
+                    return maxDistance;
+                });
+                return result;
+            }
+
+            template <typename V>
+            void findObjects(const Vec<F,3>& point, V visitor) const {
+                if (empty())
+                    return;
+
+                std::vector<size_t> stack(1, m_root);
+                while (!stack.empty()) {
+                    const Node& node = m_nodes[stack.back()];
+                    stack.pop_back();
+
+                    if (queryBounds(node).contains(point)) {
+                        if (node.leaf()) {
+                            visitor(node.object);
+                        } else {
+                            stack.push_back(node.right);
+                            stack.push_back(node.left);
+                        }
+                    }
+                }
+            }
+
+            List findObjects(const Vec<F,3>& point) const {
+                List result;
+                findObjects(point, [&result](T object) { result.push_back(object); });
+                return result;
+            }
+
+            /**
+             * Calls the given visitor for every object whose bounds intersect or touch the given bounds.
+             */
+            template <typename V>
+            void findObjects(const Box& bounds, V visitor) const {
+                if (empty())
+                    return;
+
+                std::vector<size_t> stack(1, m_root);
+                while (!stack.empty()) {
+                    const Node& node = m_nodes[stack.back()];
+                    stack.pop_back();
+
+                    if (queryBounds(node).intersects(bounds)) {
+                        if (node.leaf()) {
+                            visitor(node.object);
+                        } else {
+                            stack.push_back(node.right);
+                            stack.push_back(node.left);
+                        }
+                    }
+                }
+            }
+
+            List findObjects(const Box& bounds) const {
+                List result;
+                findObjects(bounds, [&result](T object) { result.push_back(object); });
+                return result;
+            }
+        private:
+            static const Box& queryBounds(const Node& node) {
+                return node.leaf() ? node.objectBounds : node.bounds;
+            }
+
+            size_t allocateNode() {
+                size_t index;
+                if (m_freeNodes != NoNode) {
+                    index = m_freeNodes;
+                    m_freeNodes = m_nodes[index].parent;
+                } else {
+                    index = m_nodes.size();
+                    m_nodes.push_back(Node());
+                }
+
+                Node& node = m_nodes[index];
+                node.parent = node.left = node.right = NoNode;
+                node.height = 0;
+                node.object = T();
+                return index;
+            }
+
+            void freeNode(const size_t index) {
+                Node& node = m_nodes[index];
+                node.object = T();
+                node.left = node.right = NoNode;
+                node.parent = m_freeNodes;
+                m_freeNodes = index;
+            }
+
+            /**
+             * Inserts the given leaf into the subtree rooted at the given node, which must be part of this tree unless
+             * the tree is empty.
+             */
+            void insertLeaf(const size_t leaf, const size_t subtree) {
+                if (m_root == NoNode) {
+                    m_root = leaf;
+                    m_nodes[leaf].parent = NoNode;
+                    return;
+                }
+
+                const Box bounds = m_nodes[leaf].bounds;
+                const size_t sibling = findBestSibling(subtree, bounds);
+
+                const size_t oldParent = m_nodes[sibling].parent;
+                const size_t newParent = allocateNode();
+
+                Node& parent = m_nodes[newParent];
+                parent.parent = oldParent;
+                parent.left = sibling;
+                parent.right = leaf;
+                parent.height = m_nodes[sibling].height + 1;
+                parent.bounds = m_nodes[sibling].bounds.mergedWith(bounds);
+
+                if (oldParent == NoNode) {
+                    m_root = newParent;
+                } else if (m_nodes[oldParent].left == sibling) {
+                    m_nodes[oldParent].left = newParent;
+                } else {
+                    m_nodes[oldParent].right = newParent;
+                }
+
+                m_nodes[sibling].parent = newParent;
+                m_nodes[leaf].parent = newParent;
+                rebalance(oldParent);
+            }
+
+            /**
+             * Descends from the given node to the node that becomes the sibling of a new leaf with the given bounds. At
+             * every inner node, the cost of making it the sibling is compared to the cost of descending into one of
+             * its children, where the cost is the increase in the surface area of the tree.
+             */
+            size_t findBestSibling(const size_t subtree, const Box& bounds) const {
+                size_t index = subtree;
+                while (!m_nodes[index].leaf()) {
+                    const Node& node = m_nodes[index];
+
+                    const F area = surfaceArea(node.bounds);
+                    const F mergedArea = surfaceArea(node.bounds.mergedWith(bounds));
+
+                    const F cost = static_cast<F>(2.0) * mergedArea;
+                    const F inheritedCost = static_cast<F>(2.0) * (mergedArea - area);
+                    const F leftCost = descendCost(node.left, bounds) + inheritedCost;
+                    const F rightCost = descendCost(node.right, bounds) + inheritedCost;
+
+                    if (cost < leftCost && cost < rightCost)
+                        break;
+                    index = leftCost < rightCost ? node.left : node.right;
+                }
+                return index;
+            }
+
+            F descendCost(const size_t index, const Box& bounds) const {
+                const Node& node = m_nodes[index];
+                const F mergedArea = surfaceArea(node.bounds.mergedWith(bounds));
+                if (node.leaf())
+                    return mergedArea;
+                return mergedArea - surfaceArea(node.bounds);
+            }
+
+            void removeLeaf(const size_t leaf) {
+                if (leaf == m_root) {
+                    m_root = NoNode;
+                    return;
+                }
+
+                const size_t parent = m_nodes[leaf].parent;
+                const size_t grandParent = m_nodes[parent].parent;
+                const size_t sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+
+                if (grandParent == NoNode) {
+                    m_root = sibling;
+                } else if (m_nodes[grandParent].left == parent) {
+                    m_nodes[grandParent].left = sibling;
+                } else {
+                    m_nodes[grandParent].right = sibling;
+                }
+                m_nodes[sibling].parent = grandParent;
+                m_nodes[leaf].parent = NoNode;
+
+                freeNode(parent);
+                rebalance(grandParent);
+            }
+
+            /**
+             * Walks from the given node to the root, restoring the balance of every node on the way and updating its
+             * height and bounds.
+             */
+            void rebalance(size_t index) {
+                while (index != NoNode) {
+                    index = rotate(index);
+
+                    Node& node = m_nodes[index];
+                    const Node& left = m_nodes[node.left];
+                    const Node& right = m_nodes[node.right];
+                    node.height = std::max(left.height, right.height) + 1;
+                    node.bounds = left.bounds.mergedWith(right.bounds);
+                    index = node.parent;
+                }
+            }
+
+            /**
+             * If the heights of the subtrees of the given node differ by more than one, the higher child is rotated
+             * up to take the place of the given node. Returns the index of the node that is now at this position.
+             */
+            size_t rotate(const size_t a) {
+                const size_t b = m_nodes[a].left;
+                const size_t c = m_nodes[a].right;
+                const int balance = static_cast<int>(m_nodes[c].height) - static_cast<int>(m_nodes[b].height);
+
+                if (balance > 1)
+                    return rotateUp(a, c, b);
+                if (balance < -1)
+                    return rotateUp(a, b, c);
+                return a;
+            }
+
+            /**
+             * Rotates the given higher child up so that it becomes the parent of the given node. The higher of its own
+             * children stays with it, and the other one replaces it as a child of the given node.
+             */
+            size_t rotateUp(const size_t a, const size_t higher, const size_t other) {
+                const size_t f = m_nodes[higher].left;
+                const size_t g = m_nodes[higher].right;
+                const size_t keep = m_nodes[f].height > m_nodes[g].height ? f : g;
+                const size_t move = keep == f ? g : f;
+
+                // the higher child takes the place of a
+                const size_t parent = m_nodes[a].parent;
+                m_nodes[higher].parent = parent;
+                if (parent == NoNode) {
+                    m_root = higher;
+                } else if (m_nodes[parent].left == a) {
+                    m_nodes[parent].left = higher;
+                } else {
+                    m_nodes[parent].right = higher;
+                }
+
+                m_nodes[higher].left = a;
+                m_nodes[higher].right = keep;
+                m_nodes[a].parent = higher;
+
+                if (m_nodes[a].left == higher) {
+                    m_nodes[a].left = move;
+                } else {
+                    m_nodes[a].right = move;
+                }
+                m_nodes[move].parent = a;
+
+                Node& lower = m_nodes[a];
+                lower.height = std::max(m_nodes[other].height, m_nodes[move].height) + 1;
+                lower.bounds = m_nodes[other].bounds.mergedWith(m_nodes[move].bounds);
+
+                Node& upper = m_nodes[higher];
+                upper.height = std::max(lower.height, m_nodes[keep].height) + 1;
+                upper.bounds = lower.bounds.mergedWith(m_nodes[keep].bounds);
+
+                return higher;
+            }
+
+            void refit(size_t index) {
+                while (index != NoNode) {
+                    Node& node = m_nodes[index];
+                    const Box bounds = m_nodes[node.left].bounds.mergedWith(m_nodes[node.right].bounds);
+                    if (bounds == node.bounds)
+                        break;
+                    node.bounds = bounds;
+                    index = node.parent;
+                }
+            }
+
+            /**
+             * Returns the leaf bounds for an object that has left its leaf after moving by the given displacement.
+             * Besides the margin, the bounds are extended in the direction of the movement by a multiple of the
+             * displacement, but by no more than a multiple of the margin, so that an object that keeps moving in the
+             * same direction stays in its new leaf for several updates.
+             */
+            Box predictLeafBounds(const Box& bounds, const Vec<F,3>& displacement) const {
+                static const F PredictionFactor = static_cast<F>(4.0);
+                const F maxExtension = PredictionFactor * m_margin;
+
+                Box result = bounds.expanded(m_margin);
+                for (size_t i = 0; i < 3; ++i) {
+                    const F extension = std::min(PredictionFactor * std::abs(displacement[i]), maxExtension);
+                    if (displacement[i] < static_cast<F>(0.0))
+                        result.min[i] -= extension;
+                    else
+                        result.max[i] += extension;
+                }
+                return result;
+            }
+
+            static F surfaceArea(const Box& bounds) {
+                const Vec<F,3> size = bounds.size();
+                return size.x() * size.y() + size.y() * size.z() + size.z() * size.x();
+            }
+
+            /**
+             * Slab test that also accepts rays starting inside of the given bounds, in which case the distance is 0.
+             */
+            static bool intersectWithRay(const Box& bounds, const Ray<F,3>& ray, const F maxDistance, F& distance) {
+                F tMin = static_cast<F>(0.0);
+                F tMax = maxDistance;
+                for (size_t i = 0; i < 3; ++i) {
+                    const F origin = ray.origin[i];
+                    const F direction = ray.direction[i];
+                    if (direction == static_cast<F>(0.0)) {
+                        if (origin < bounds.min[i] || origin > bounds.max[i])
+                            return false;
+                    } else {
+                        const F inverse = static_cast<F>(1.0) / direction;
+                        F t0 = (bounds.min[i] - origin) * inverse;
+                        F t1 = (bounds.max[i] - origin) * inverse;
+                        if (t0 > t1)
+                            std::swap(t0, t1);
+                        tMin = std::max(tMin, t0);
+                        tMax = std::min(tMax, t1);
+                        if (tMin > tMax)
+                            return false;
+                    }
+                }
+                distance = tMin;
+                return true;
+            }
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_AABBTree) */
@@ -19,11 +19,13 @@
 
 #include "Brush.h"
 
+#include "Allocator.h"
 #include "CollectionUtils.h"
 #include "Macros.h"
 #include "Model/BrushContentTypeBuilder.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushGeometry.h"
+#include "Model/BrushPlaneTopology.h"
 #include "Model/BrushSnapshot.h"
 #include "Model/Entity.h"
 #include "Model/FindContainerVisitor.h"
@@ -127,6 +129,21 @@ namespace TrenchBroom {
             }
         };
 
+        class Brush::SetFaceGeometryCallback : public BrushGeometry::Callback {
+        private:
+            const BrushFaceList& m_faces;
+            size_t m_index;
+        public:
+            SetFaceGeometryCallback(const BrushFaceList& faces) :
+            m_faces(faces),
+            m_index(0) {}
+
+            void faceWasCreated(BrushFaceGeometry* face) override {
+                ensure(m_index < m_faces.size(), "more geometry faces than brush faces");
+                m_faces[m_index++]->setGeometry(face);
+            }
+        };
+
         class Brush::MoveVerticesCallback : public BrushGeometry::Callback {
         private:
             typedef std::map<Vec3, BrushFaceList> IncidenceMap;
@@ -692,6 +709,8 @@ namespace TrenchBroom {
         }
 
         bool Brush::canMoveVertices(const BBox3& worldBounds, const Vec3::List& vertices, const Vec3& delta) const {
+            // the test geometry is discarded as a whole, so its topology is released in bulk
+            const AllocatorArena arena;
             return doCanMoveVertices(worldBounds, vertices, delta, true).success;
         }
 
@@ -756,6 +775,7 @@ namespace TrenchBroom {
             ensure(m_geometry != nullptr, "geometry is null");
             ensure(!vertexPositions.empty(), "no vertex positions");
 
+            const AllocatorArena arena;
             BrushGeometry testGeometry(*m_geometry);
 
             for (const auto& position : vertexPositions) {
@@ -790,6 +810,7 @@ namespace TrenchBroom {
         }
 
         bool Brush::canSnapVertices(const BBox3& worldBounds, const FloatType snapToF) {
+            const AllocatorArena arena;
             BrushGeometry newGeometry;
 
             for (const auto* vertex : m_geometry->vertices()) {
@@ -831,6 +852,7 @@ namespace TrenchBroom {
             ensure(!edgePositions.empty(), "no edge positions");
 
             const auto vertexPositions = Edge3::asVertexList(edgePositions);
+            const AllocatorArena arena;
             const auto result = doCanMoveVertices(worldBounds, vertexPositions, delta, false);
 
             if (!result.success) {
@@ -869,6 +891,7 @@ namespace TrenchBroom {
             ensure(!facePositions.empty(), "no face positions");
 
             const auto vertexPositions = Polygon3::asVertexList(facePositions);
+            const AllocatorArena arena;
             const auto result = doCanMoveVertices(worldBounds, vertexPositions, delta, false);
 
             if (!result.success) {
@@ -1039,7 +1062,7 @@ namespace TrenchBroom {
         }
 
         BrushList Brush::subtract(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName, const Brush* subtrahend) const {
-            const auto result = m_geometry->subtract(*subtrahend->m_geometry);
+            const auto result = subtractGeometry(subtrahend);
 
             BrushList brushes;
             brushes.reserve(result.size());
@@ -1052,6 +1075,10 @@ namespace TrenchBroom {
             return brushes;
         }
 
+        BrushGeometry::SubtractResult Brush::subtractGeometry(const Brush* subtrahend) const {
+            return m_geometry->subtract(*subtrahend->m_geometry);
+        }
+
         void Brush::intersect(const BBox3& worldBounds, const Brush* brush) {
             for (const auto* face : brush->faces()) {
                 addFace(face->clone());
@@ -1098,6 +1125,7 @@ namespace TrenchBroom {
                 }
             }
 
+            m_facePlanes.update(m_faces);
             invalidateContentType();
             invalidateVertexCache();
         }
@@ -1122,14 +1150,39 @@ namespace TrenchBroom {
 
         void Brush::rebuildGeometry(const BBox3& worldBounds) {
             deleteGeometry();
-            m_geometry = new BrushGeometry(worldBounds.expanded(1.0));
 
-            AddFacesToGeometry addFacesToGeometry(*m_geometry, m_faces);
+            Plane3::List planes;
+            planes.reserve(m_faces.size());
+            for (const auto* face : m_faces) {
+                planes.push_back(face->boundary());
+            }
+
+            // Most brushes are boxes or have only a few faces, their topology can be computed directly from the face
+            // planes. All others are built by clipping a polyhedron that encloses the world.
+            auto brushEmpty = false;
+            auto brushValid = true;
+
+            const BrushPlaneTopology topology(planes, worldBounds);
+            if (topology.success()) {
+                SetFaceGeometryCallback setFaceGeometry(m_faces);
+                m_geometry = new BrushGeometry(topology.vertices(), topology.faces(), setFaceGeometry);
+
+                HealEdgesCallback healCallback;
+                m_geometry->correctVertexPositions();
+                brushValid = m_geometry->healEdges(healCallback);
+            } else {
+                m_geometry = new BrushGeometry(worldBounds.expanded(1.0));
+
+                const AddFacesToGeometry addFacesToGeometry(*m_geometry, m_faces);
+                brushEmpty = addFacesToGeometry.brushEmpty();
+                brushValid = addFacesToGeometry.brushValid();
+            }
+
             updateFacesFromGeometry(worldBounds);
 
-            if (addFacesToGeometry.brushEmpty()) {
+            if (brushEmpty) {
                 throw GeometryException("Brush is empty");
-            } else  if (!addFacesToGeometry.brushValid()) {
+            } else  if (!brushValid) {
                 throw GeometryException("Brush is invalid");
             } else if (!fullySpecified()) {
                 throw GeometryException("Brush is not fully specified");
@@ -1295,13 +1348,13 @@ namespace TrenchBroom {
                 return BrushFaceHit();
             }
 
-            for (auto* face : m_faces) {
-                const auto distance = face->intersectWithRay(ray);
-                if (!Math::isnan(distance)) {
-                    return BrushFaceHit(face, distance);
-                }
+            assert(m_facePlanes.size() == m_faces.size());
+            size_t index;
+            const auto distance = m_facePlanes.intersectWithRay(ray, index);
+            if (Math::isnan(distance)) {
+                return BrushFaceHit();
             }
-            return BrushFaceHit();
+            return BrushFaceHit(m_faces[index], distance);
         }
 
         Node* Brush::doGetContainer() const {
@@ -26,6 +26,7 @@
 #include "ProjectingSequence.h"
 #include "Polyhedron_Matcher.h"
 #include "Model/BrushContentType.h"
+#include "Model/BrushFacePlanes.h"
 #include "Model/BrushGeometry.h"
 #include "Model/Node.h"
 #include "Model/Object.h"
@@ -63,6 +64,7 @@ namespace TrenchBroom {
             class AddFaceToGeometryCallback;
             class HealEdgesCallback;
             class AddFacesToGeometry;
+            class SetFaceGeometryCallback;
             class MoveVerticesCallback;
             typedef MoveVerticesCallback RemoveVertexCallback;
             class QueryCallback;
@@ -74,6 +76,7 @@ namespace TrenchBroom {
         private:
             BrushFaceList m_faces;
             BrushGeometry* m_geometry;
+            BrushFacePlanes m_facePlanes;
             
             const BrushContentTypeBuilder* m_contentTypeBuilder;
             mutable BrushContentType::FlagType m_contentType;
@@ -210,9 +213,22 @@ namespace TrenchBroom {
         public:
             // CSG operations
             BrushList subtract(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName, const Brush* subtrahend) const;
-            void intersect(const BBox3& worldBounds, const Brush* brush);
-        private:
+            
+            /**
+             * Computes the fragments of this brush that remain after subtracting the given brush without creating any
+             * brushes. This only reads the geometry of both brushes, so it may be called for several brushes in
+             * parallel.
+             */
+            BrushGeometry::SubtractResult subtractGeometry(const Brush* subtrahend) const;
+            
+            /**
+             * Creates a brush from a fragment of this brush that resulted from subtracting the given brush. Faces that
+             * lie on a face of this brush take their attributes from that face, and faces that lie on a face of the
+             * subtrahend take their attributes from the subtrahend.
+             */
             Brush* createBrush(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName, const BrushGeometry& geometry, const Brush* subtrahend) const;
+            
+            void intersect(const BBox3& worldBounds, const Brush* brush);
         private:
             void updateFacesFromGeometry(const BBox3& worldBounds);
             void updatePointsFromVertices(const BBox3& worldBounds);
@@ -117,6 +117,10 @@ namespace TrenchBroom {
             return result;
         }
 
+        BrushFace* BrushFace::cloneWithoutTexture() const {
+            return new BrushFace(points()[0], points()[1], points()[2], m_attribs.takeSnapshot(), m_texCoordSystem->clone());
+        }
+
         BrushFaceSnapshot* BrushFace::takeSnapshot() {
             return new BrushFaceSnapshot(this, m_texCoordSystem);
         }
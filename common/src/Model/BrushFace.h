@@ -101,6 +101,12 @@ namespace TrenchBroom {
             
             BrushFace* clone() const;
             
+            /**
+             * Returns a copy of this face that only knows the name of its texture. Unlike clone, this leaves the usage
+             * count of the texture alone, so the copy can be used and deleted on any thread.
+             */
+            BrushFace* cloneWithoutTexture() const;
+            
             BrushFaceSnapshot* takeSnapshot();
             TexCoordSystemSnapshot* takeTexCoordSystemSnapshot() const;
             void restoreTexCoordSystemSnapshot(const TexCoordSystemSnapshot* coordSystemSnapshot);
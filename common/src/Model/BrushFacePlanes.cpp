@@ -0,0 +1,169 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "BrushFacePlanes.h"
+
+#include "Model/BrushFace.h"
+
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TB_BRUSH_FACE_PLANES_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace TrenchBroom {
+    namespace Model {
+#ifdef TB_BRUSH_FACE_PLANES_SSE2
+        static const size_t PlaneBlockSize = 2;
+#else
+        static const size_t PlaneBlockSize = 1;
+#endif
+        
+        BrushFacePlanes::BrushFacePlanes() :
+        m_count(0) {}
+        
+        void BrushFacePlanes::update(const BrushFaceList& faces) {
+            m_count = faces.size();
+            
+            // Pad the arrays to a multiple of the block size with planes that are never hit: their normal is null,
+            // so they are parallel to every ray, and every point is below them.
+            const size_t paddedCount = (m_count + PlaneBlockSize - 1) / PlaneBlockSize * PlaneBlockSize;
+            m_normalX.assign(paddedCount, 0.0);
+            m_normalY.assign(paddedCount, 0.0);
+            m_normalZ.assign(paddedCount, 0.0);
+            m_distance.assign(paddedCount, std::numeric_limits<FloatType>::max());
+            
+            for (size_t i = 0; i < m_count; ++i) {
+                const Plane3& boundary = faces[i]->boundary();
+                m_normalX[i] = boundary.normal.x();
+                m_normalY[i] = boundary.normal.y();
+                m_normalZ[i] = boundary.normal.z();
+                m_distance[i] = boundary.distance;
+            }
+        }
+        
+        void BrushFacePlanes::clear() {
+            m_normalX.clear();
+            m_normalY.clear();
+            m_normalZ.clear();
+            m_distance.clear();
+            m_count = 0;
+        }
+        
+        size_t BrushFacePlanes::size() const {
+            return m_count;
+        }
+        
+        FloatType BrushFacePlanes::intersectWithRay(const Ray3& ray, size_t& index) const {
+            static const FloatType epsilon = Math::Constants<FloatType>::almostZero();
+            
+            FloatType enter = -std::numeric_limits<FloatType>::infinity();
+            FloatType exit = std::numeric_limits<FloatType>::infinity();
+            FloatType enterIndex = -1.0;
+            bool outside = false;
+            
+#ifdef TB_BRUSH_FACE_PLANES_SSE2
+            const __m128d originX = _mm_set1_pd(ray.origin.x());
+            const __m128d originY = _mm_set1_pd(ray.origin.y());
+            const __m128d originZ = _mm_set1_pd(ray.origin.z());
+            const __m128d directionX = _mm_set1_pd(ray.direction.x());
+            const __m128d directionY = _mm_set1_pd(ray.direction.y());
+            const __m128d directionZ = _mm_set1_pd(ray.direction.z());
+            const __m128d posEpsilon = _mm_set1_pd(epsilon);
+            const __m128d negEpsilon = _mm_set1_pd(-epsilon);
+            const __m128d zero = _mm_setzero_pd();
+            const __m128d step = _mm_set1_pd(static_cast<FloatType>(PlaneBlockSize));
+            
+            __m128d enters = _mm_set1_pd(enter);
+            __m128d exits = _mm_set1_pd(exit);
+            __m128d enterIndices = _mm_set1_pd(enterIndex);
+            __m128d outsides = zero;
+            __m128d indices = _mm_set_pd(1.0, 0.0);
+            
+            for (size_t i = 0; i < m_distance.size(); i += PlaneBlockSize) {
+                const __m128d normalX = _mm_loadu_pd(&m_normalX[i]);
+                const __m128d normalY = _mm_loadu_pd(&m_normalY[i]);
+                const __m128d normalZ = _mm_loadu_pd(&m_normalZ[i]);
+                const __m128d distance = _mm_loadu_pd(&m_distance[i]);
+                
+                const __m128d dot = _mm_add_pd(_mm_add_pd(_mm_mul_pd(normalX, directionX), _mm_mul_pd(normalY, directionY)), _mm_mul_pd(normalZ, directionZ));
+                const __m128d originDistance = _mm_sub_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(normalX, originX), _mm_mul_pd(normalY, originY)), _mm_mul_pd(normalZ, originZ)), distance);
+                const __m128d rayDistance = _mm_div_pd(_mm_sub_pd(zero, originDistance), dot);
+                
+                const __m128d front = _mm_cmplt_pd(dot, negEpsilon);
+                const __m128d back = _mm_cmpgt_pd(dot, posEpsilon);
+                const __m128d parallelAbove = _mm_andnot_pd(_mm_or_pd(front, back), _mm_cmpgt_pd(originDistance, posEpsilon));
+                outsides = _mm_or_pd(outsides, parallelAbove);
+                
+                const __m128d later = _mm_and_pd(front, _mm_cmpgt_pd(rayDistance, enters));
+                enters = _mm_or_pd(_mm_and_pd(later, rayDistance), _mm_andnot_pd(later, enters));
+                enterIndices = _mm_or_pd(_mm_and_pd(later, indices), _mm_andnot_pd(later, enterIndices));
+                
+                const __m128d earlier = _mm_and_pd(back, _mm_cmplt_pd(rayDistance, exits));
+                exits = _mm_or_pd(_mm_and_pd(earlier, rayDistance), _mm_andnot_pd(earlier, exits));
+                
+                indices = _mm_add_pd(indices, step);
+            }
+            
+            double enterLanes[PlaneBlockSize], exitLanes[PlaneBlockSize], enterIndexLanes[PlaneBlockSize];
+            _mm_storeu_pd(enterLanes, enters);
+            _mm_storeu_pd(exitLanes, exits);
+            _mm_storeu_pd(enterIndexLanes, enterIndices);
+            outside = _mm_movemask_pd(outsides) != 0;
+            
+            for (size_t i = 0; i < PlaneBlockSize; ++i) {
+                // prefer the lower index if several planes are entered at the same distance
+                if (enterLanes[i] > enter || (enterLanes[i] == enter && enterIndexLanes[i] < enterIndex)) {
+                    enter = enterLanes[i];
+                    enterIndex = enterIndexLanes[i];
+                }
+                if (exitLanes[i] < exit)
+                    exit = exitLanes[i];
+            }
+#else
+            for (size_t i = 0; i < m_count; ++i) {
+                const FloatType dot = m_normalX[i] * ray.direction.x() + m_normalY[i] * ray.direction.y() + m_normalZ[i] * ray.direction.z();
+                const FloatType originDistance = m_normalX[i] * ray.origin.x() + m_normalY[i] * ray.origin.y() + m_normalZ[i] * ray.origin.z() - m_distance[i];
+                
+                if (dot < -epsilon) {
+                    const FloatType rayDistance = -originDistance / dot;
+                    if (rayDistance > enter) {
+                        enter = rayDistance;
+                        enterIndex = static_cast<FloatType>(i);
+                    }
+                } else if (dot > epsilon) {
+                    const FloatType rayDistance = -originDistance / dot;
+                    if (rayDistance < exit)
+                        exit = rayDistance;
+                } else if (originDistance > epsilon) {
+                    outside = true;
+                }
+            }
+#endif
+            
+            if (outside || enterIndex < 0.0 || Math::neg(enter) || Math::gt(enter, exit))
+                return Math::nan<FloatType>();
+            
+            index = static_cast<size_t>(enterIndex);
+            return enter;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_BrushFacePlanes
+#define TrenchBroom_BrushFacePlanes
+
+#include "TrenchBroom.h"
+#include "VecMath.h"
+#include "Model/ModelTypes.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Stores the boundary planes of the faces of a brush as separate arrays of normal components and distances,
+         * so that a ray can be tested against all planes at once.
+         *
+         * Since a brush is convex, a ray hits it if and only if the largest distance at which it enters a front facing
+         * plane is not greater than the smallest distance at which it exits a back facing plane. The face with the
+         * largest entry distance is the face that is hit. This replaces testing the ray against each face polygon.
+         */
+        class BrushFacePlanes {
+        private:
+            std::vector<FloatType> m_normalX;
+            std::vector<FloatType> m_normalY;
+            std::vector<FloatType> m_normalZ;
+            std::vector<FloatType> m_distance;
+            size_t m_count;
+        public:
+            BrushFacePlanes();
+            
+            /**
+             * Replaces the stored planes with the boundaries of the given faces. The index of a plane is the index of
+             * its face in the given list.
+             */
+            void update(const BrushFaceList& faces);
+            void clear();
+            
+            size_t size() const;
+            
+            /**
+             * Returns the distance at which the given ray enters the convex volume bounded by the stored planes, or
+             * NaN if the ray misses the volume or starts inside it. If the ray hits the volume, the index of the plane
+             * through which the ray enters is stored in the given index.
+             */
+            FloatType intersectWithRay(const Ray3& ray, size_t& index) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_BrushFacePlanes) */
@@ -0,0 +1,237 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrushPlaneTopology.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <utility>
+
+namespace TrenchBroom {
+    namespace Model {
+        // Vertices that are closer than this, but not close enough to be merged, are left to the clipping algorithm.
+        static const FloatType MinVertexDistance = 10.0 * Math::Constants<FloatType>::almostZero();
+
+        BrushPlaneTopology::BrushPlaneTopology(const Plane3::List& planes, const BBox3& bounds) :
+        m_success(false) {
+            if (planes.size() < 4 || planes.size() > MaxPlaneCount) {
+                return;
+            }
+
+            if (!findBoxVertices(planes) && !findVertices(planes)) {
+                return;
+            }
+
+            m_success = findFaces(planes) && checkClosed() && checkBounds(bounds);
+        }
+
+        bool BrushPlaneTopology::success() const {
+            return m_success;
+        }
+
+        const Vec3::List& BrushPlaneTopology::vertices() const {
+            return m_vertices;
+        }
+
+        const std::vector<BrushPlaneTopology::IndexList>& BrushPlaneTopology::faces() const {
+            return m_faces;
+        }
+
+        bool BrushPlaneTopology::findBoxVertices(const Plane3::List& planes) {
+            if (planes.size() != 6) {
+                return false;
+            }
+
+            // the extents of the box along each axis, taken from the planes facing away from and towards the axis
+            FloatType min[3] = { 0.0, 0.0, 0.0 };
+            FloatType max[3] = { 0.0, 0.0, 0.0 };
+            bool found[6] = { false, false, false, false, false, false };
+
+            for (const auto& plane : planes) {
+                const auto axis = plane.normal.firstComponent();
+                const auto& normal = plane.normal;
+                if (normal[(axis + 1) % 3] != 0.0 || normal[(axis + 2) % 3] != 0.0 || std::abs(normal[axis]) != 1.0) {
+                    return false;
+                }
+
+                const auto positive = normal[axis] > 0.0;
+                const auto slot = 2 * axis + (positive ? 1 : 0);
+                if (found[slot]) {
+                    return false;
+                }
+                found[slot] = true;
+
+                if (positive) {
+                    max[axis] = plane.distance;
+                } else {
+                    min[axis] = -plane.distance;
+                }
+            }
+
+            for (size_t i = 0; i < 3; ++i) {
+                if (max[i] - min[i] < MinVertexDistance) {
+                    return false;
+                }
+            }
+
+            m_vertices.reserve(8);
+            for (size_t i = 0; i < 8; ++i) {
+                m_vertices.push_back(Vec3((i & 1) ? max[0] : min[0],
+                                          (i & 2) ? max[1] : min[1],
+                                          (i & 4) ? max[2] : min[2]));
+            }
+            return true;
+        }
+
+        bool BrushPlaneTopology::findVertices(const Plane3::List& planes) {
+            for (size_t i = 0; i < planes.size(); ++i) {
+                const auto& n1 = planes[i].normal;
+                for (size_t j = i + 1; j < planes.size(); ++j) {
+                    const auto& n2 = planes[j].normal;
+                    for (size_t k = j + 1; k < planes.size(); ++k) {
+                        const auto& n3 = planes[k].normal;
+
+                        const auto n2n3 = crossed(n2, n3);
+                        const auto det = n1.dot(n2n3);
+                        if (Math::zero(det)) {
+                            continue;
+                        }
+
+                        const auto point = (planes[i].distance * n2n3 +
+                                            planes[j].distance * crossed(n3, n1) +
+                                            planes[k].distance * crossed(n1, n2)) / det;
+
+                        const auto outside = std::any_of(std::begin(planes), std::end(planes), [&point](const Plane3& plane) {
+                            return plane.pointStatus(point) == Math::PointStatus::PSAbove;
+                        });
+
+                        if (!outside && !addVertex(point)) {
+                            return false;
+                        }
+                    }
+                }
+            }
+
+            return m_vertices.size() >= 4;
+        }
+
+        bool BrushPlaneTopology::addVertex(const Vec3& position) {
+            for (const auto& vertex : m_vertices) {
+                // vertices where more than three planes meet are found several times
+                if (vertex.equals(position, Math::Constants<FloatType>::pointStatusEpsilon())) {
+                    return true;
+                }
+                if (vertex.squaredDistanceTo(position) < MinVertexDistance * MinVertexDistance) {
+                    return false;
+                }
+            }
+
+            m_vertices.push_back(position);
+            return true;
+        }
+
+        bool BrushPlaneTopology::findFaces(const Plane3::List& planes) {
+            m_faces.reserve(planes.size());
+
+            for (const auto& plane : planes) {
+                IndexList face;
+                for (size_t i = 0; i < m_vertices.size(); ++i) {
+                    if (plane.pointStatus(m_vertices[i]) == Math::PointStatus::PSInside) {
+                        face.push_back(i);
+                    }
+                }
+
+                if (face.size() < 3 || !sortFace(plane, face)) {
+                    return false;
+                }
+
+                m_faces.push_back(face);
+            }
+
+            return true;
+        }
+
+        bool BrushPlaneTopology::sortFace(const Plane3& plane, IndexList& face) const {
+            Vec3 center;
+            for (const auto index : face) {
+                center += m_vertices[index];
+            }
+            center /= static_cast<FloatType>(face.size());
+
+            // (u, v, normal) is a right handed basis, so sorting by the angle in the (u, v) plane yields a counter
+            // clockwise order when looking against the normal
+            const auto u = (m_vertices[face.front()] - center).normalized();
+            const auto v = crossed(plane.normal, u);
+
+            std::vector<std::pair<FloatType, size_t>> angles;
+            angles.reserve(face.size());
+            for (const auto index : face) {
+                const auto offset = m_vertices[index] - center;
+                angles.push_back(std::make_pair(std::atan2(offset.dot(v), offset.dot(u)), index));
+            }
+            std::sort(std::begin(angles), std::end(angles));
+
+            for (size_t i = 0; i < face.size(); ++i) {
+                face[i] = angles[i].second;
+            }
+
+            // every corner must turn left, otherwise some vertex lies on an edge of the face
+            for (size_t i = 0; i < face.size(); ++i) {
+                const auto& p0 = m_vertices[face[i]];
+                const auto& p1 = m_vertices[face[(i + 1) % face.size()]];
+                const auto& p2 = m_vertices[face[(i + 2) % face.size()]];
+                const auto turn = crossed((p1 - p0).normalized(), (p2 - p1).normalized()).dot(plane.normal);
+                if (turn < Math::Constants<FloatType>::colinearEpsilon()) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool BrushPlaneTopology::checkClosed() const {
+            typedef std::set<std::pair<size_t, size_t>> HalfEdgeSet;
+            HalfEdgeSet halfEdges;
+
+            for (const auto& face : m_faces) {
+                for (size_t i = 0; i < face.size(); ++i) {
+                    if (!halfEdges.insert(std::make_pair(face[i], face[(i + 1) % face.size()])).second) {
+                        return false;
+                    }
+                }
+            }
+
+            for (const auto& halfEdge : halfEdges) {
+                if (halfEdges.count(std::make_pair(halfEdge.second, halfEdge.first)) == 0) {
+                    return false;
+                }
+            }
+
+            const auto edgeCount = halfEdges.size() / 2;
+            return m_vertices.size() + m_faces.size() == edgeCount + 2;
+        }
+
+        bool BrushPlaneTopology::checkBounds(const BBox3& bounds) const {
+            return std::all_of(std::begin(m_vertices), std::end(m_vertices), [&bounds](const Vec3& vertex) {
+                return bounds.contains(vertex);
+            });
+        }
+    }
+}
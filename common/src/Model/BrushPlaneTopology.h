@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_BrushPlaneTopology
+#define TrenchBroom_BrushPlaneTopology
+
+#include "TrenchBroom.h"
+#include "VecMath.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Computes the vertices and faces of the convex volume bounded by a small number of planes directly, without
+         * clipping a polyhedron by each plane in turn.
+         *
+         * Six planes that face the six axis directions are recognized as an axis aligned box, whose corners are known
+         * right away. Otherwise, the vertices are found by intersecting every triple of planes and keeping the points
+         * that are not above any plane. The vertices on each plane are then sorted into a counter clockwise boundary.
+         *
+         * The computation only succeeds if every plane contributes a convex face and the faces form a closed
+         * polyhedron. Planes that do not touch the volume, coincide with another plane or only touch it in an edge or
+         * a vertex, as well as vertices that are nearly coincident, make it fail, so that such brushes can be left to
+         * the more forgiving clipping algorithm.
+         */
+        class BrushPlaneTopology {
+        public:
+            typedef std::vector<size_t> IndexList;
+            static const size_t MaxPlaneCount = 12;
+        private:
+            Vec3::List m_vertices;
+            std::vector<IndexList> m_faces;
+            bool m_success;
+        public:
+            /**
+             * Computes the topology of the volume bounded by the given planes. It fails if any vertex lies outside of
+             * the given bounds, or if there are more than MaxPlaneCount planes.
+             */
+            BrushPlaneTopology(const Plane3::List& planes, const BBox3& bounds);
+
+            bool success() const;
+
+            const Vec3::List& vertices() const;
+
+            /**
+             * Returns the indices of the vertices of each face in counter clockwise order. The face at an index is
+             * bounded by the plane at the same index.
+             */
+            const std::vector<IndexList>& faces() const;
+        private:
+            bool findBoxVertices(const Plane3::List& planes);
+            bool findVertices(const Plane3::List& planes);
+            bool addVertex(const Vec3& position);
+            bool findFaces(const Plane3::List& planes);
+            bool sortFace(const Plane3& plane, IndexList& face) const;
+            bool checkClosed() const;
+            bool checkBounds(const BBox3& bounds) const;
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_BrushPlaneTopology) */
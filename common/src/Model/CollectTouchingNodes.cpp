@@ -0,0 +1,187 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "CollectTouchingNodes.h"
+
+#include "ParallelUtils.h"
+#include "Model/Brush.h"
+#include "Model/EditorContext.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/NodeVisitor.h"
+#include "Model/World.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Visits the nodes of the world in the same order as a recursive visitor would, but starts only at those
+         * children of the layers whose bounds touch the bounds of any of the given brushes. Groups and entities are
+         * tested immediately because the tests only involve their bounds. Brushes are collected together with the
+         * given brushes that they could touch and are tested in parallel afterwards.
+         */
+        class CollectNodesInBrushes : public NodeVisitor {
+        public:
+            typedef enum {
+                Mode_Touching,
+                Mode_Contained
+            } Mode;
+        private:
+            struct Candidate {
+                Node* node;
+                BrushList brushes;
+                bool match;
+                
+                Candidate(Node* i_node, const BrushList& i_brushes, const bool i_match) :
+                node(i_node),
+                brushes(i_brushes),
+                match(i_match) {}
+            };
+            
+            typedef std::vector<Candidate> CandidateList;
+            typedef std::unordered_map<Node*, BrushList> NodeBrushesMap;
+            
+            const EditorContext& m_editorContext;
+            const Mode m_mode;
+            const BrushList* m_brushes;
+            CandidateList m_candidates;
+        public:
+            CollectNodesInBrushes(const EditorContext& editorContext, const Mode mode) :
+            m_editorContext(editorContext),
+            m_mode(mode),
+            m_brushes(nullptr) {}
+            
+            NodeList collect(World* world, const BrushList& brushes) {
+                for (Layer* layer : world->allLayers())
+                    collect(layer, brushes);
+                
+                ParallelUtils::parallelFor(m_candidates.size(), [this](const size_t i) {
+                    Candidate& candidate = m_candidates[i];
+                    if (!candidate.match)
+                        candidate.match = match(candidate.node, candidate.brushes);
+                });
+                
+                NodeList result;
+                for (const Candidate& candidate : m_candidates) {
+                    if (candidate.match)
+                        result.push_back(candidate.node);
+                }
+                return result;
+            }
+        private:
+            void collect(Layer* layer, const BrushList& brushes) {
+                NodeBrushesMap layerCandidates;
+                for (Brush* brush : brushes) {
+                    for (Node* node : layer->findChildren(brush->bounds()))
+                        layerCandidates[node].push_back(brush);
+                }
+                
+                if (layerCandidates.empty())
+                    return;
+                
+                for (Node* child : layer->children()) {
+                    const NodeBrushesMap::const_iterator it = layerCandidates.find(child);
+                    if (it != std::end(layerCandidates)) {
+                        m_brushes = &it->second;
+                        child->accept(*this);
+                    }
+                }
+                m_brushes = nullptr;
+            }
+            
+            void doVisit(World* world) override {}
+            void doVisit(Layer* layer) override {}
+            
+            void doVisit(Group* group) override {
+                visitContainer(group);
+            }
+            
+            void doVisit(Entity* entity) override {
+                visitContainer(entity);
+            }
+            
+            void doVisit(Brush* brush) override {
+                if (!m_editorContext.selectable(brush))
+                    return;
+                
+                BrushList brushes;
+                for (Brush* other : *m_brushes) {
+                    if (other != brush && canMatch(other, brush))
+                        brushes.push_back(other);
+                }
+                
+                if (!brushes.empty())
+                    m_candidates.push_back(Candidate(brush, brushes, false));
+            }
+            
+            template <typename N>
+            void visitContainer(N* node) {
+                if (m_editorContext.selectable(node) && match(node, *m_brushes)) {
+                    m_candidates.push_back(Candidate(node, BrushList(), true));
+                } else {
+                    for (Node* child : node->children())
+                        child->accept(*this);
+                }
+            }
+            
+            bool canMatch(const Brush* brush, const Node* node) const {
+                switch (m_mode) {
+                    case Mode_Touching:
+                        return brush->bounds().intersects(node->bounds());
+                    case Mode_Contained:
+                        return brush->bounds().contains(node->bounds());
+                    switchDefault()
+                }
+            }
+            
+            bool match(const Node* node, const BrushList& brushes) const {
+                for (const Brush* brush : brushes) {
+                    if (brush != node && match(brush, node))
+                        return true;
+                }
+                return false;
+            }
+            
+            bool match(const Brush* brush, const Node* node) const {
+                switch (m_mode) {
+                    case Mode_Touching:
+                        return brush->intersects(node);
+                    case Mode_Contained:
+                        return brush->contains(node);
+                    switchDefault()
+                }
+            }
+        };
+        
+        NodeList collectTouchingNodes(World* world, const BrushList& brushes, const EditorContext& editorContext) {
+            CollectNodesInBrushes collector(editorContext, CollectNodesInBrushes::Mode_Touching);
+            return collector.collect(world, brushes);
+        }
+        
+        NodeList collectContainedNodes(World* world, const BrushList& brushes, const EditorContext& editorContext) {
+            CollectNodesInBrushes collector(editorContext, CollectNodesInBrushes::Mode_Contained);
+            return collector.collect(world, brushes);
+        }
+    }
+}
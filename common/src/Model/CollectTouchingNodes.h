@@ -0,0 +1,46 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_CollectTouchingNodes
+#define TrenchBroom_CollectTouchingNodes
+
+#include "Model/ModelTypes.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        class EditorContext;
+        class World;
+        
+        /**
+         * Returns the selectable nodes of the given world that touch any of the given brushes. The result is the same
+         * as that of CollectTouchingNodesVisitor, but only the nodes found in the spatial indices of the layers are
+         * tested, and brushes are tested against each other in parallel.
+         */
+        NodeList collectTouchingNodes(World* world, const BrushList& brushes, const EditorContext& editorContext);
+        
+        /**
+         * Returns the selectable nodes of the given world that are contained in any of the given brushes. The result
+         * is the same as that of CollectContainedNodesVisitor.
+         */
+        NodeList collectContainedNodes(World* world, const BrushList& brushes, const EditorContext& editorContext);
+    }
+}
+
+#endif /* defined(TrenchBroom_CollectTouchingNodes) */
@@ -0,0 +1,125 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ConvexMerge.h"
+
+#include "CollectionUtils.h"
+#include "ParallelUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushGeometry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        // Smaller inputs are not worth splitting up.
+        static const size_t MinChunkSize = 64;
+        
+        static const Brush* findContainingBrush(const BrushList& brushes) {
+            if (brushes.empty())
+                return nullptr;
+            
+            BBox3 bounds = brushes.front()->bounds();
+            for (const Brush* brush : brushes)
+                bounds.mergeWith(brush->bounds());
+            
+            // only a brush whose bounds span the bounds of all brushes can contain all others
+            for (const Brush* candidate : brushes) {
+                if (!candidate->bounds().contains(bounds))
+                    continue;
+                
+                std::atomic<bool> containsAll(true);
+                ParallelUtils::parallelFor(brushes.size(), [&](const size_t i) {
+                    const Brush* brush = brushes[i];
+                    if (containsAll && brush != candidate && !candidate->contains(brush))
+                        containsAll = false;
+                });
+                
+                if (containsAll)
+                    return candidate;
+            }
+            
+            return nullptr;
+        }
+        
+        /**
+         * Splits the given points into chunks and computes the convex hulls of the chunks in parallel. A point that is
+         * not a vertex of the hull of its chunk is not a vertex of the hull of all points either, so only the vertices
+         * of the chunk hulls are added to the final hull.
+         */
+        static Polyhedron3 convexHull(const Vec3::List& points, const ConvexMergeProgress& progress) {
+            const size_t chunkCount = std::min(4 * ParallelUtils::threadCount(), points.size() / MinChunkSize);
+            if (chunkCount <= 1) {
+                const Polyhedron3 result(points);
+                progress(1.0);
+                return result;
+            }
+            
+            // the final hull counts as one more chunk
+            const double total = static_cast<double>(chunkCount + 1);
+            
+            std::vector<Vec3::List> chunkVertices(chunkCount);
+            ParallelUtils::parallelFor(chunkCount, [&points, &chunkVertices, chunkCount](const size_t i) {
+                const auto first = std::next(std::begin(points), static_cast<Vec3::List::difference_type>(i * points.size() / chunkCount));
+                const auto last = std::next(std::begin(points), static_cast<Vec3::List::difference_type>((i + 1) * points.size() / chunkCount));
+                
+                const Polyhedron3 chunkHull(Vec3::List(first, last));
+                chunkVertices[i] = chunkHull.vertexPositions();
+            }, [&progress, total](const size_t processed) {
+                progress(static_cast<double>(processed) / total);
+            });
+            
+            Vec3::List candidates;
+            for (const Vec3::List& vertices : chunkVertices)
+                VectorUtils::append(candidates, vertices);
+            
+            const Polyhedron3 result(candidates);
+            progress(1.0);
+            return result;
+        }
+        
+        Polyhedron3 convexMerge(const BrushList& brushes, const ConvexMergeProgress& progress) {
+            const Brush* containing = findContainingBrush(brushes);
+            if (containing != nullptr) {
+                progress(1.0);
+                return Polyhedron3(containing->vertexPositions());
+            }
+            
+            Vec3::List points;
+            for (const Brush* brush : brushes) {
+                for (const BrushVertex* vertex : brush->vertices())
+                    points.push_back(vertex->position());
+            }
+            return convexHull(points, progress);
+        }
+        
+        Polyhedron3 convexMerge(const BrushFaceList& faces, const ConvexMergeProgress& progress) {
+            Vec3::List points;
+            for (const BrushFace* face : faces) {
+                for (const BrushVertex* vertex : face->vertices())
+                    points.push_back(vertex->position());
+            }
+            return convexHull(points, progress);
+        }
+    }
+}
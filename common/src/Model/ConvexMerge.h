@@ -0,0 +1,51 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_ConvexMerge
+#define TrenchBroom_ConvexMerge
+
+#include "TrenchBroom.h"
+#include "VecMath.h"
+#include "Model/ModelTypes.h"
+
+#include <functional>
+
+namespace TrenchBroom {
+    namespace Model {
+        /**
+         * Receives the fraction of the work that has been done so far, between 0 and 1.
+         */
+        typedef std::function<void(double)> ConvexMergeProgress;
+        
+        /**
+         * Returns the convex hull of the vertices of the given brushes.
+         *
+         * If all other brushes are contained in one of the brushes, that brush already is the convex hull, and its
+         * vertices are returned without considering the other brushes any further.
+         */
+        Polyhedron3 convexMerge(const BrushList& brushes, const ConvexMergeProgress& progress);
+        
+        /**
+         * Returns the convex hull of the vertices of the given brush faces.
+         */
+        Polyhedron3 convexMerge(const BrushFaceList& faces, const ConvexMergeProgress& progress);
+    }
+}
+
+#endif /* defined(TrenchBroom_ConvexMerge) */
@@ -0,0 +1,158 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CsgSubtract.h"
+
+#include "CollectionUtils.h"
+#include "ParallelUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushFaceAttributes.h"
+#include "Model/ModelFactory.h"
+
+#include <iterator>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        CsgSubtract::Fragment::Fragment(const BrushGeometry& i_geometry, Brush* minuend) :
+        geometry(i_geometry),
+        minuends(1, minuend) {}
+        
+        CsgSubtract::CsgSubtract(const BrushList& minuends, const Brush* subtrahend) :
+        m_subtrahend(subtrahend) {
+            subtract(findCandidates(minuends));
+            
+            for (auto& entry : m_fragments)
+                mergeFragments(entry.second);
+        }
+        
+        const BrushList& CsgSubtract::subtractedBrushes() const {
+            return m_subtractedBrushes;
+        }
+        
+        ParentChildrenMap CsgSubtract::createBrushes(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName) const {
+            ParentChildrenMap result;
+            for (const auto& entry : m_fragments) {
+                Node* parent = entry.first;
+                for (const Fragment& fragment : entry.second) {
+                    const Brush* first = fragment.minuends.front();
+                    Brush* brush = first->createBrush(factory, worldBounds, defaultTextureName, fragment.geometry, m_subtrahend);
+                    
+                    if (fragment.minuends.size() > 1) {
+                        // the faces that do not lie on a face of the first minuend may lie on a face of another one
+                        for (auto it = std::next(std::begin(fragment.minuends)), end = std::end(fragment.minuends); it != end; ++it)
+                            brush->cloneFaceAttributesFrom(*it);
+                        brush->cloneInvertedFaceAttributesFrom(m_subtrahend);
+                    }
+                    
+                    result[parent].push_back(brush);
+                }
+            }
+            return result;
+        }
+        
+        BrushList CsgSubtract::findCandidates(const BrushList& minuends) const {
+            const BBox3& bounds = m_subtrahend->bounds();
+            
+            BrushList result;
+            for (Brush* minuend : minuends) {
+                if (minuend != m_subtrahend && bounds.intersects(minuend->bounds()))
+                    result.push_back(minuend);
+            }
+            return result;
+        }
+        
+        void CsgSubtract::subtract(const BrushList& candidates) {
+            std::vector<BrushGeometry::SubtractResult> results(candidates.size());
+            
+            ParallelUtils::parallelFor(candidates.size(), [this, &candidates, &results](const size_t i) {
+                const Brush* minuend = candidates[i];
+                if (m_subtrahend->intersects(minuend))
+                    results[i] = minuend->subtractGeometry(m_subtrahend);
+            });
+            
+            for (size_t i = 0; i < candidates.size(); ++i) {
+                if (!results[i].empty()) {
+                    Brush* minuend = candidates[i];
+                    m_subtractedBrushes.push_back(minuend);
+                    
+                    FragmentList& fragments = m_fragments[minuend->parent()];
+                    for (const BrushGeometry& geometry : results[i])
+                        fragments.push_back(Fragment(geometry, minuend));
+                }
+            }
+        }
+        
+        void CsgSubtract::mergeFragments(FragmentList& fragments) {
+            bool merged = true;
+            while (merged) {
+                merged = false;
+                for (auto first = std::begin(fragments); first != std::end(fragments); ++first) {
+                    auto second = std::next(first);
+                    while (second != std::end(fragments)) {
+                        if (canMerge(*first, *second) && first->geometry.mergeConvexUnion(second->geometry)) {
+                            VectorUtils::append(first->minuends, second->minuends);
+                            second = fragments.erase(second);
+                            merged = true;
+                        } else {
+                            ++second;
+                        }
+                    }
+                }
+            }
+        }
+        
+        bool CsgSubtract::canMerge(const Fragment& first, const Fragment& second) {
+            if (!first.geometry.bounds().intersects(second.geometry.bounds()))
+                return false;
+            
+            for (const Brush* firstMinuend : first.minuends) {
+                for (const Brush* secondMinuend : second.minuends) {
+                    if (!canMerge(firstMinuend, secondMinuend))
+                        return false;
+                }
+            }
+            return true;
+        }
+        
+        bool CsgSubtract::canMerge(const Brush* first, const Brush* second) {
+            if (first == second)
+                return true;
+            
+            // the merged brush would otherwise look different from the fragments it replaces
+            for (const BrushFace* firstFace : first->faces()) {
+                const BrushFace* secondFace = second->findFace(firstFace->boundary());
+                if (secondFace != nullptr && !equalAttributes(firstFace->attribs(), secondFace->attribs()))
+                    return false;
+            }
+            return true;
+        }
+        
+        bool CsgSubtract::equalAttributes(const BrushFaceAttributes& first, const BrushFaceAttributes& second) {
+            return (first.textureName() == second.textureName() &&
+                    first.offset() == second.offset() &&
+                    first.scale() == second.scale() &&
+                    first.rotation() == second.rotation() &&
+                    first.surfaceContents() == second.surfaceContents() &&
+                    first.surfaceFlags() == second.surfaceFlags() &&
+                    first.surfaceValue() == second.surfaceValue());
+        }
+    }
+}
@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_CsgSubtract
+#define TrenchBroom_CsgSubtract
+
+#include "TrenchBroom.h"
+#include "VecMath.h"
+#include "StringUtils.h"
+#include "Model/BrushGeometry.h"
+#include "Model/ModelTypes.h"
+
+#include <list>
+#include <map>
+
+namespace TrenchBroom {
+    namespace Model {
+        class BrushFaceAttributes;
+        class ModelFactory;
+        
+        /**
+         * Subtracts a brush from a list of brushes.
+         *
+         * Only the brushes whose bounds intersect the bounds of the subtrahend are considered at all. The remaining
+         * brushes are tested against the subtrahend and subtracted from in parallel, since each of these only reads
+         * the geometry of the brushes involved. Afterwards, fragments with the same parent are merged whenever their
+         * union is convex and the brushes they stem from agree on the attributes of their coplanar faces. This merges
+         * the pieces that are left over when a brush is carved out of a number of adjacent brushes.
+         *
+         * A brush that does not intersect the subtrahend is left alone, and so is a brush that is entirely contained
+         * in it.
+         */
+        class CsgSubtract {
+        private:
+            struct Fragment {
+                BrushGeometry geometry;
+                BrushList minuends;
+                
+                Fragment(const BrushGeometry& i_geometry, Brush* minuend);
+            };
+            
+            typedef std::list<Fragment> FragmentList;
+            typedef std::map<Node*, FragmentList> ParentFragmentsMap;
+            
+            const Brush* m_subtrahend;
+            BrushList m_subtractedBrushes;
+            ParentFragmentsMap m_fragments;
+        public:
+            CsgSubtract(const BrushList& minuends, const Brush* subtrahend);
+            
+            /**
+             * Returns the minuends that are replaced by the fragments.
+             */
+            const BrushList& subtractedBrushes() const;
+            
+            /**
+             * Creates a brush for each fragment and returns them grouped by the parent of the minuends they stem from.
+             */
+            ParentChildrenMap createBrushes(const ModelFactory& factory, const BBox3& worldBounds, const String& defaultTextureName) const;
+        private:
+            BrushList findCandidates(const BrushList& minuends) const;
+            void subtract(const BrushList& candidates);
+            
+            static void mergeFragments(FragmentList& fragments);
+            static bool canMerge(const Fragment& first, const Fragment& second);
+            static bool canMerge(const Brush* first, const Brush* second);
+            static bool equalAttributes(const BrushFaceAttributes& first, const BrushFaceAttributes& second);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_CsgSubtract) */
@@ -78,6 +78,10 @@ namespace TrenchBroom {
             doWriteMap(world, path);
         }
 
+        void Game::writeMap(const IO::MapSnapshot& snapshot, IO::OutputBuffer& buffer) const {
+            doWriteMap(snapshot, buffer);
+        }
+
         void Game::exportMap(World* world, const Model::ExportFormat format, const IO::Path& path) const {
             ensure(world != nullptr, "world is null");
             doExportMap(world, format, path);
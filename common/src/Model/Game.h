@@ -41,6 +41,11 @@ namespace TrenchBroom {
         class TextureManager;
     }
     
+    namespace IO {
+        class MapSnapshot;
+        class OutputBuffer;
+    }
+    
     namespace Model {
         class BrushContentTypeBuilder;
         
@@ -74,6 +79,7 @@ namespace TrenchBroom {
             World* newMap(MapFormat::Type format, const BBox3& worldBounds) const;
             World* loadMap(MapFormat::Type format, const BBox3& worldBounds, const IO::Path& path, Logger* logger) const;
             void writeMap(World* world, const IO::Path& path) const;
+            void writeMap(const IO::MapSnapshot& snapshot, IO::OutputBuffer& buffer) const;
             void exportMap(World* world, Model::ExportFormat format, const IO::Path& path) const;
         public: // parsing and serializing objects
             NodeList parseNodes(const String& str, World* world, const BBox3& worldBounds, Logger* logger) const;
@@ -116,6 +122,7 @@ namespace TrenchBroom {
             virtual World* doNewMap(MapFormat::Type format, const BBox3& worldBounds) const = 0;
             virtual World* doLoadMap(MapFormat::Type format, const BBox3& worldBounds, const IO::Path& path, Logger* logger) const = 0;
             virtual void doWriteMap(World* world, const IO::Path& path) const = 0;
+            virtual void doWriteMap(const IO::MapSnapshot& snapshot, IO::OutputBuffer& buffer) const = 0;
             virtual void doExportMap(World* world, Model::ExportFormat format, const IO::Path& path) const = 0;
             
             virtual NodeList doParseNodes(const String& str, World* world, const BBox3& worldBounds, Logger* logger) const = 0;
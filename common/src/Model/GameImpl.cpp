@@ -21,6 +21,7 @@
 
 #include "Macros.h"
 #include "Assets/Palette.h"
+#include "Assets/TextureManager.h"
 #include "IO/BrushFaceReader.h"
 #include "IO/Bsp29Parser.h"
 #include "IO/DefParser.h"
@@ -32,7 +33,9 @@
 #include "IO/IdPakFileSystem.h"
 #include "IO/IdWalTextureReader.h"
 #include "IO/IOUtils.h"
+#include "IO/MapFileSerializer.h"
 #include "IO/MapParser.h"
+#include "IO/MapSnapshot.h"
 #include "IO/MdlParser.h"
 #include "IO/Md2Parser.h"
 #include "IO/NodeReader.h"
@@ -51,6 +54,7 @@
 #include "Exceptions.h"
 
 #include <cstdio>
+#include <memory>
 
 namespace TrenchBroom {
     namespace Model {
@@ -162,6 +166,14 @@ namespace TrenchBroom {
             writer.writeMap();
         }
 
+        void GameImpl::doWriteMap(const IO::MapSnapshot& snapshot, IO::OutputBuffer& buffer) const {
+            const String mapFormatName = formatName(snapshot.format());
+            IO::writeGameComment(buffer, gameName(), mapFormatName);
+
+            IO::NodeSerializer::Ptr serializer = IO::MapFileSerializer::create(snapshot.format(), buffer);
+            snapshot.write(*serializer);
+        }
+
         void GameImpl::doExportMap(World* world, const Model::ExportFormat format, const IO::Path& path) const {
             IO::OpenFile open(path, true);
 
@@ -212,8 +224,10 @@ namespace TrenchBroom {
             const IO::Path::List paths = extractTextureCollections(node);
 
             const IO::Path::List fileSearchPaths = textureCollectionSearchPaths(documentPath);
-            IO::TextureLoader textureLoader(variables, m_gameFS, fileSearchPaths, m_config.textureConfig());
-            textureLoader.loadTextures(paths, textureManager);
+            const IO::Path textureCacheDirectory = IO::SystemPaths::userDataDirectory() + IO::Path("TextureCache");
+            // the loader is kept alive by the texture manager until the collections have been loaded in the background
+            auto textureLoader = std::make_shared<IO::TextureLoader>(variables, m_gameFS, fileSearchPaths, m_config.textureConfig(), textureCacheDirectory, textureManager.compressTextures());
+            textureManager.setTextureCollections(paths, textureLoader);
         }
 
         IO::Path::List GameImpl::textureCollectionSearchPaths(const IO::Path& documentPath) const {
@@ -370,14 +384,14 @@ namespace TrenchBroom {
         Assets::EntityModel* GameImpl::loadMdlModel(const String& name, const IO::MappedFile::Ptr& file) const {
             const Assets::Palette palette = loadTexturePalette();
 
-            IO::MdlParser parser(name, file->begin(), file->end(), palette);
+            IO::MdlParser parser(name, file, palette);
             return parser.parseModel();
         }
 
         Assets::EntityModel* GameImpl::loadMd2Model(const String& name, const IO::MappedFile::Ptr& file) const {
             const Assets::Palette palette = loadTexturePalette();
 
-            IO::Md2Parser parser(name, file->begin(), file->end(), palette, m_gameFS);
+            IO::Md2Parser parser(name, file, palette, m_gameFS);
             return parser.parseModel();
         }
 
@@ -61,6 +61,7 @@ namespace TrenchBroom {
             World* doNewMap(MapFormat::Type format, const BBox3& worldBounds) const override;
             World* doLoadMap(MapFormat::Type format, const BBox3& worldBounds, const IO::Path& path, Logger* logger) const override;
             void doWriteMap(World* world, const IO::Path& path) const override;
+            void doWriteMap(const IO::MapSnapshot& snapshot, IO::OutputBuffer& buffer) const override;
             void doExportMap(World* world, Model::ExportFormat format, const IO::Path& path) const override;
 
             NodeList doParseNodes(const String& str, World* world, const BBox3& worldBounds, Logger* logger) const override;
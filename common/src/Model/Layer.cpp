@@ -22,31 +22,51 @@
 #include "Model/Brush.h"
 #include "Model/Group.h"
 #include "Model/Entity.h"
+#include "Model/HitFilter.h"
 #include "Model/IssueGenerator.h"
 #include "Model/NodeVisitor.h"
+#include "Model/PickResult.h"
 
 namespace TrenchBroom {
     namespace Model {
         Layer::Layer(const String& name, const BBox3& worldBounds) :
         m_name(name),
-        m_octree(worldBounds, static_cast<FloatType>(64.0f)) {}
+        m_worldBounds(worldBounds),
+        // objects moved by one default grid step stay in their leaves
+        m_tree(static_cast<FloatType>(16.0)) {}
         
         void Layer::setName(const String& name) {
             m_name = name;
         }
 
+        NodeList Layer::findChildren(const BBox3& bounds) const {
+            return m_tree.findObjects(bounds);
+        }
+
+        void Layer::pickClosest(const Ray3& ray, const HitFilter& stop, Hit::List& hits, FloatType& closest) const {
+            m_tree.findObjects(ray, [&ray, &stop, &hits, &closest](const Node* node, const FloatType maxDistance) {
+                PickResult nodeHits;
+                node->pick(ray, nodeHits);
+                for (const Hit& hit : nodeHits.all()) {
+                    if (hit.distance() < closest && stop.matches(hit))
+                        closest = hit.distance();
+                    hits.push_back(hit);
+                }
+                return closest;
+            }, closest);
+        }
+
         const String& Layer::doGetName() const {
             return m_name;
         }
 
         const BBox3& Layer::doGetBounds() const {
-            return m_octree.bounds();
+            return m_worldBounds;
         }
 
         Node* Layer::doClone(const BBox3& worldBounds) const {
             Layer* layer = new Layer(m_name, worldBounds);
             cloneAttributes(layer);
-            layer->addChildren(clone(worldBounds, children()));
             return layer;
         }
 
@@ -73,60 +93,60 @@ namespace TrenchBroom {
             return false;
         }
 
-        class Layer::AddNodeToOctree : public NodeVisitor {
+        class Layer::AddNodeToTree : public NodeVisitor {
         private:
-            NodeTree& m_octree;
+            NodeTree& m_tree;
         public:
-            AddNodeToOctree(NodeTree& octree) :
-            m_octree(octree) {}
+            AddNodeToTree(NodeTree& tree) :
+            m_tree(tree) {}
         private:
             void doVisit(World* world) override   {}
             void doVisit(Layer* layer) override   {}
-            void doVisit(Group* group) override   { m_octree.addObject(group->bounds(), group); }
-            void doVisit(Entity* entity) override { m_octree.addObject(entity->bounds(), entity); }
-            void doVisit(Brush* brush) override   { m_octree.addObject(brush->bounds(), brush); }
+            void doVisit(Group* group) override   { m_tree.addObject(group->bounds(), group); }
+            void doVisit(Entity* entity) override { m_tree.addObject(entity->bounds(), entity); }
+            void doVisit(Brush* brush) override   { m_tree.addObject(brush->bounds(), brush); }
         };
         
-        class Layer::RemoveNodeFromOctree : public NodeVisitor {
+        class Layer::RemoveNodeFromTree : public NodeVisitor {
         private:
-            NodeTree& m_octree;
+            NodeTree& m_tree;
         public:
-            RemoveNodeFromOctree(NodeTree& octree) :
-            m_octree(octree) {}
+            RemoveNodeFromTree(NodeTree& tree) :
+            m_tree(tree) {}
         private:
             void doVisit(World* world) override   {}
             void doVisit(Layer* layer) override   {}
-            void doVisit(Group* group) override   { m_octree.removeObject(group); }
-            void doVisit(Entity* entity) override { m_octree.removeObject(entity); }
-            void doVisit(Brush* brush) override   { m_octree.removeObject(brush); }
+            void doVisit(Group* group) override   { m_tree.removeObject(group); }
+            void doVisit(Entity* entity) override { m_tree.removeObject(entity); }
+            void doVisit(Brush* brush) override   { m_tree.removeObject(brush); }
         };
         
-        class Layer::UpdateNodeInOctree : public NodeVisitor {
+        class Layer::UpdateNodeInTree : public NodeVisitor {
         private:
-            NodeTree& m_octree;
+            NodeTree& m_tree;
         public:
-            UpdateNodeInOctree(NodeTree& octree) :
-            m_octree(octree) {}
+            UpdateNodeInTree(NodeTree& tree) :
+            m_tree(tree) {}
         private:
             void doVisit(World* world) override   {}
             void doVisit(Layer* layer) override   {}
-            void doVisit(Group* group) override   { m_octree.updateObject(group->bounds(), group); }
-            void doVisit(Entity* entity) override { m_octree.updateObject(entity->bounds(), entity); }
-            void doVisit(Brush* brush) override   { m_octree.updateObject(brush->bounds(), brush); }
+            void doVisit(Group* group) override   { m_tree.updateObject(group->bounds(), group); }
+            void doVisit(Entity* entity) override { m_tree.updateObject(entity->bounds(), entity); }
+            void doVisit(Brush* brush) override   { m_tree.updateObject(brush->bounds(), brush); }
         };
 
         void Layer::doChildWasAdded(Node* node) {
-            AddNodeToOctree visitor(m_octree);
+            AddNodeToTree visitor(m_tree);
             node->accept(visitor);
         }
         
         void Layer::doChildWillBeRemoved(Node* node) {
-            RemoveNodeFromOctree visitor(m_octree);
+            RemoveNodeFromTree visitor(m_tree);
             node->accept(visitor);
         }
         
         void Layer::doChildBoundsDidChange(Node* node) {
-            UpdateNodeInOctree visitor(m_octree);
+            UpdateNodeInTree visitor(m_tree);
             node->accept(visitor);
         }
 
@@ -147,13 +167,18 @@ namespace TrenchBroom {
         }
 
         void Layer::doPick(const Ray3& ray, PickResult& pickResult) const {
-            for (const Node* node : m_octree.findObjects(ray))
+            // the pick result must contain every hit, so the entire ray is searched, see pickClosest for a search
+            // that ends at the closest hit
+            m_tree.findObjects(ray, [&ray, &pickResult](const Node* node, const FloatType maxDistance) {
                 node->pick(ray, pickResult);
+                return maxDistance;
+            });
         }
         
         void Layer::doFindNodesContaining(const Vec3& point, NodeList& result) {
-            for (Node* node : m_octree.findObjects(point))
+            m_tree.findObjects(point, [&point, &result](Node* node) {
                 node->findNodesContaining(point, result);
+            });
         }
 
         FloatType Layer::doIntersectWithRay(const Ray3& ray) const {
@@ -23,20 +23,37 @@
 #include "StringUtils.h"
 #include "Model/ModelTypes.h"
 #include "Model/Node.h"
-#include "Model/Octree.h"
+#include "Model/AABBTree.h"
+#include "Model/Hit.h"
 
 namespace TrenchBroom {
     namespace Model {
+        class HitFilter;
+        
         class Layer : public Node {
         private:
             String m_name;
+            BBox3 m_worldBounds;
             
-            typedef Octree<FloatType, Node*> NodeTree;
-            NodeTree m_octree;
+            typedef AABBTree<FloatType, Node*> NodeTree;
+            NodeTree m_tree;
         public:
             Layer(const String& name, const BBox3& worldBounds);
             
             void setName(const String& name);
+            
+            /**
+             * Returns the children of this layer whose bounds intersect or touch the given bounds.
+             */
+            NodeList findChildren(const BBox3& bounds) const;
+            
+            /**
+             * Picks the children of this layer front to back and adds their hits to the given list. The search ends
+             * behind the closest hit that matches the given filter, and the given distance is lowered to the distance
+             * of that hit. Children that the ray enters beyond the given distance are skipped, so several layers can
+             * be searched with the same distance. Some of the added hits may be farther away than the final distance.
+             */
+            void pickClosest(const Ray3& ray, const HitFilter& stop, Hit::List& hits, FloatType& closest) const;
         private: // implement Node interface
             const String& doGetName() const override;
             const BBox3& doGetBounds() const override;
@@ -46,9 +63,9 @@ namespace TrenchBroom {
             bool doCanRemoveChild(const Node* child) const override;
             bool doRemoveIfEmpty() const override;
             
-            class AddNodeToOctree;
-            class RemoveNodeFromOctree;
-            class UpdateNodeInOctree;
+            class AddNodeToTree;
+            class RemoveNodeFromTree;
+            class UpdateNodeInTree;
             
             void doChildWasAdded(Node* node) override;
             void doChildWillBeRemoved(Node* node) override;
@@ -23,7 +23,12 @@
 #include "Model/Brush.h"
 #include "Model/BrushFace.h"
 #include "Model/CollectNodesWithDescendantSelectionCountVisitor.h"
+#include "Model/Hit.h"
 #include "Model/IssueGenerator.h"
+#include "Model/Layer.h"
+#include "Model/PickResult.h"
+
+#include <limits>
 
 namespace TrenchBroom {
     namespace Model {
@@ -52,6 +57,19 @@ namespace TrenchBroom {
             return visitor.layers();
         }
 
+        FloatType World::pickClosest(const Ray3& ray, const HitFilter& stop, PickResult& pickResult) const {
+            Hit::List hits;
+            FloatType closest = std::numeric_limits<FloatType>::max();
+            for (const Layer* layer : allLayers())
+                layer->pickClosest(ray, stop, hits, closest);
+            
+            for (const Hit& hit : hits) {
+                if (hit.distance() <= closest)
+                    pickResult.addHit(hit);
+            }
+            return closest;
+        }
+
         void World::createDefaultLayer(const BBox3& worldBounds) {
             m_defaultLayer = createLayer("Default Layer", worldBounds);
             addChild(m_defaultLayer);
@@ -104,6 +122,7 @@ namespace TrenchBroom {
         Node* World::doClone(const BBox3& worldBounds) const {
             World* world = m_factory.createWorld(worldBounds);
             cloneAttributes(world);
+            world->setAttributes(attributes());
             return world;
         }
 
@@ -113,6 +132,7 @@ namespace TrenchBroom {
             
             World* world = m_factory.createWorld(worldBounds);
             cloneAttributes(world);
+            world->setAttributes(attributes());
 
             world->defaultLayer()->addChildren(cloneRecursively(worldBounds, m_defaultLayer->children()));
             
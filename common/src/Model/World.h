@@ -33,6 +33,7 @@
 namespace TrenchBroom {
     namespace Model {
         class BrushContentTypeBuilder;
+        class HitFilter;
         class PickResult;
         
         class World : public AttributableNode, public ModelFactory {
@@ -49,6 +50,13 @@ namespace TrenchBroom {
             LayerList customLayers() const;
         private:
             void createDefaultLayer(const BBox3& worldBounds);
+        public: // picking
+            /**
+             * Adds the hits along the given ray to the given pick result, but only up to the closest hit that matches
+             * the given filter. Objects behind that hit are not picked at all. Returns the distance of that hit, or the
+             * maximum distance if there is no such hit.
+             */
+            FloatType pickClosest(const Ray3& ray, const HitFilter& stop, PickResult& pickResult) const;
         public: // index
             const AttributableNodeIndex& attributableNodeIndex() const;
         public: // selection
@@ -0,0 +1,109 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TrenchBroom_ParallelUtils_h
+#define TrenchBroom_ParallelUtils_h
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ParallelUtils {
+    /**
+     * Returns the number of worker threads to use for parallel loops, which is the number of hardware threads, but
+     * at least 1.
+     */
+    inline size_t threadCount() {
+        const size_t count = static_cast<size_t>(std::thread::hardware_concurrency());
+        return std::max(count, static_cast<size_t>(1));
+    }
+
+    /**
+     * Calls the given function for every index in [0, count) using up to threadCount() threads, including the
+     * calling thread. The indices are handed out dynamically, so the function must not depend on the order in which
+     * it is called. The function returns once all indices have been processed.
+     *
+     * The given progress function is called with the number of processed indices after each index that the calling
+     * thread has processed, and once more with count when all indices have been processed. It is only ever called on
+     * the calling thread, so it may safely notify the user interface.
+     *
+     * If the function throws, the remaining indices are skipped and the first exception is rethrown on the calling
+     * thread.
+     */
+    template <typename F, typename P>
+    void parallelFor(const size_t count, F f, P progress) {
+        const size_t numThreads = std::min(threadCount(), count);
+        if (numThreads <= 1) {
+            for (size_t i = 0; i < count; ++i) {
+                f(i);
+                progress(i + 1);
+            }
+            return;
+        }
+
+        std::atomic<size_t> next(0);
+        std::atomic<size_t> done(0);
+        std::exception_ptr exception;
+        std::mutex exceptionMutex;
+
+        const auto work = [&](const bool report) {
+            try {
+                size_t i;
+                while ((i = next.fetch_add(1)) < count) {
+                    f(i);
+                    const size_t processed = ++done;
+                    if (report)
+                        progress(processed);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!exception)
+                    exception = std::current_exception();
+                next = count;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads - 1);
+        for (size_t i = 0; i < numThreads - 1; ++i)
+            threads.emplace_back(work, false);
+        work(true);
+
+        for (auto& thread : threads)
+            thread.join();
+
+        if (exception)
+            std::rethrow_exception(exception);
+        progress(count);
+    }
+
+    /**
+     * Calls the given function for every index in [0, count) in parallel without reporting progress.
+     */
+    template <typename F>
+    void parallelFor(const size_t count, F f) {
+        parallelFor(count, f, [](const size_t processed) {});
+    }
+}
+
+#endif
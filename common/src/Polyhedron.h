@@ -298,11 +298,19 @@ public: // Constructors
     Polyhedron(const typename V::List& positions);
     Polyhedron(const typename V::List& positions, Callback& callback);
 
+    /**
+     * Creates a closed polyhedron with the given vertices and faces without computing a convex hull. Each face is
+     * given by the indices of its vertices in counter clockwise order. The caller must ensure that the faces form a
+     * valid closed polyhedron. The callback is notified of each face in the given order.
+     */
+    Polyhedron(const typename V::List& positions, const std::vector<std::vector<size_t>>& faces, Callback& callback);
+
     Polyhedron(const Polyhedron<T,FP,VP>& other);
     Polyhedron(Polyhedron<T,FP,VP>&& other);
 private: // Constructor helpers
     void addPoints(const V& p1, const V& p2, const V& p3, const V& p4, Callback& callback);
     void setBounds(const BBox<T,3>& bounds, Callback& callback);
+    void setFaces(const typename V::List& positions, const std::vector<std::vector<size_t>>& faces, Callback& callback);
 private: // Copy helper
     class Copy;
 public: // Destructor
@@ -340,6 +348,11 @@ public: // Accessors
     
     const BBox<T,3>& bounds() const;
     
+    /**
+     * Returns the volume enclosed by this polyhedron, or 0 if it is not a closed polyhedron.
+     */
+    T volume() const;
+    
     bool empty() const;
     bool point() const;
     bool edge() const;
@@ -410,6 +423,15 @@ public:
     void removeVertexByPosition(const V& position);
     void merge(const Polyhedron& other);
     void merge(const Polyhedron& other, Callback& callback);
+    
+    /**
+     * Merges the given polyhedron into this one if their union is convex, and returns whether they were merged. Both
+     * polyhedra must be closed and must not overlap, which is the case for the fragments of a subtraction. Under
+     * these conditions, the union is convex if and only if the volume of the convex hull equals the sum of the
+     * volumes of both polyhedra.
+     */
+    bool mergeConvexUnion(const Polyhedron& other);
+    bool mergeConvexUnion(const Polyhedron& other, Callback& callback);
 private:
     Vertex* addFirstPoint(const V& position, Callback& callback);
     Vertex* addSecondPoint(const V& position, Callback& callback);
@@ -265,6 +265,36 @@ void Polyhedron<T,FP,VP>::merge(const Polyhedron& other, Callback& callback) {
     }
 }
 
+template <typename T, typename FP, typename VP>
+bool Polyhedron<T,FP,VP>::mergeConvexUnion(const Polyhedron& other) {
+    Callback c;
+    return mergeConvexUnion(other, c);
+}
+
+template <typename T, typename FP, typename VP>
+bool Polyhedron<T,FP,VP>::mergeConvexUnion(const Polyhedron& other, Callback& callback) {
+    if (!polyhedron() || !closed() || !other.polyhedron() || !other.closed())
+        return false;
+    
+    // polyhedra that do not even touch cannot have a convex union
+    if (!bounds().intersects(other.bounds()))
+        return false;
+    
+    Polyhedron hull(*this);
+    hull.merge(other, callback);
+    
+    // the rounding error grows with the size of the polyhedra, so the tolerance is relative to their volume
+    static const T RelativeVolumeEpsilon = static_cast<T>(0.000001);
+    const T sum = volume() + other.volume();
+    const T difference = hull.volume() - sum;
+    if (Math::abs(difference) > RelativeVolumeEpsilon * sum)
+        return false;
+    
+    using std::swap;
+    swap(*this, hull);
+    return true;
+}
+
 // Adds the given point to an empty polyhedron.
 template <typename T, typename FP, typename VP>
 typename Polyhedron<T,FP,VP>::Vertex* Polyhedron<T,FP,VP>::addFirstPoint(const V& position, Callback& callback) {
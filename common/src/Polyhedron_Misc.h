@@ -163,6 +163,11 @@ Polyhedron<T,FP,VP>::Polyhedron(const typename V::List& positions, Callback& cal
     addPoints(std::begin(positions), std::end(positions), callback);
 }
 
+template <typename T, typename FP, typename VP>
+Polyhedron<T,FP,VP>::Polyhedron(const typename V::List& positions, const std::vector<std::vector<size_t>>& faces, Callback& callback) {
+    setFaces(positions, faces, callback);
+}
+
 template <typename T, typename FP, typename VP>
 Polyhedron<T,FP,VP>::Polyhedron(const Polyhedron<T,FP,VP>& other) {
     Copy copy(other.faces(), other.edges(), other.vertices(), *this);
@@ -307,6 +312,51 @@ void Polyhedron<T,FP,VP>::setBounds(const BBox<T,3>& bounds, Callback& callback)
     m_bounds = bounds;
 }
 
+template <typename T, typename FP, typename VP>
+void Polyhedron<T,FP,VP>::setFaces(const typename V::List& positions, const std::vector<std::vector<size_t>>& faces, Callback& callback) {
+    std::vector<Vertex*> vertices;
+    vertices.reserve(positions.size());
+    
+    for (const V& position : positions) {
+        Vertex* vertex = new Vertex(position);
+        m_vertices.append(vertex, 1);
+        vertices.push_back(vertex);
+        callback.vertexWasCreated(vertex);
+    }
+    
+    // maps the indices of the origin and the destination of each half edge to the half edge
+    typedef std::map<std::pair<size_t, size_t>, HalfEdge*> HalfEdgeMap;
+    HalfEdgeMap halfEdges;
+    
+    for (const std::vector<size_t>& face : faces) {
+        assert(face.size() >= 3);
+        
+        HalfEdgeList boundary;
+        for (size_t i = 0; i < face.size(); ++i) {
+            HalfEdge* halfEdge = new HalfEdge(vertices[face[i]]);
+            boundary.append(halfEdge, 1);
+            halfEdges.insert(std::make_pair(std::make_pair(face[i], face[(i + 1) % face.size()]), halfEdge));
+        }
+        
+        Face* newFace = new Face(boundary);
+        m_faces.append(newFace, 1);
+        callback.faceWasCreated(newFace);
+    }
+    
+    for (const auto& entry : halfEdges) {
+        const size_t origin = entry.first.first;
+        const size_t destination = entry.first.second;
+        if (origin < destination) {
+            const auto twin = halfEdges.find(std::make_pair(destination, origin));
+            ensure(twin != std::end(halfEdges), "polyhedron is not closed");
+            m_edges.append(new Edge(entry.second, twin->second), 1);
+        }
+    }
+    
+    updateBounds();
+    assert(checkInvariant());
+}
+
 template <typename T, typename FP, typename VP>
 class Polyhedron<T,FP,VP>::Copy {
 private:
@@ -592,6 +642,31 @@ const BBox<T,3>& Polyhedron<T,FP,VP>::bounds() const {
     return m_bounds;
 }
 
+template <typename T, typename FP, typename VP>
+T Polyhedron<T,FP,VP>::volume() const {
+    if (!polyhedron() || !closed())
+        return static_cast<T>(0.0);
+    
+    // sum up the signed volumes of the tetrahedra spanned by the center and a fan triangulation of each face; using
+    // the center instead of the world origin keeps the rounding error independent of the polyhedron's position
+    const V center = bounds().center();
+    
+    T result = static_cast<T>(0.0);
+    for (const Face* face : m_faces) {
+        const HalfEdge* first = face->boundary().front();
+        const V p0 = first->origin()->position() - center;
+        
+        const HalfEdge* current = first->next();
+        while (current->next() != first) {
+            const V p1 = current->origin()->position() - center;
+            const V p2 = current->next()->origin()->position() - center;
+            result += p0.dot(crossed(p1, p2));
+            current = current->next();
+        }
+    }
+    return result / static_cast<T>(6.0);
+}
+
 template <typename T, typename FP, typename VP>
 bool Polyhedron<T,FP,VP>::empty() const {
     return vertexCount() == 0;
@@ -111,6 +111,9 @@ namespace TrenchBroom {
 
         Preference<int> TextureMinFilter(IO::Path("Renderer/Texture mode min filter"), 0x2700);
         Preference<int> TextureMagFilter(IO::Path("Renderer/Texture mode mag filter"), 0x2600);
+        Preference<bool> TextureArrays(IO::Path("Renderer/Batch textures in arrays"), false);
+        Preference<bool> TextureCompression(IO::Path("Renderer/Compress textures"), false);
+        Preference<bool> InstancedEntityModels(IO::Path("Renderer/Instanced entity models"), false);
 
         Preference<bool> TextureLock(IO::Path("Editor/Texture lock"), true);
 
@@ -108,6 +108,9 @@ namespace TrenchBroom {
         
         extern Preference<int> TextureMinFilter;
         extern Preference<int> TextureMagFilter;
+        extern Preference<bool> TextureArrays;
+        extern Preference<bool> TextureCompression;
+        extern Preference<bool> InstancedEntityModels;
         
         extern Preference<bool> TextureLock;
         
@@ -20,6 +20,7 @@
 #ifndef TrenchBroom_AllocationTracker
 #define TrenchBroom_AllocationTracker
 
+#include <cstddef>
 #include <vector>
 #include <set>
 #include <utility>
@@ -197,6 +197,7 @@ namespace TrenchBroom {
             typedef AttributeSpec<AttributeType_Position, GL_FLOAT, 3> P3;
             typedef AttributeSpec<AttributeType_Normal, GL_FLOAT, 3> N;
             typedef AttributeSpec<AttributeType_TexCoord0, GL_FLOAT, 2> T02;
+            typedef AttributeSpec<AttributeType_TexCoord1, GL_FLOAT, 1> T11;
             typedef AttributeSpec<AttributeType_TexCoord1, GL_FLOAT, 2> T12;
             typedef AttributeSpec<AttributeType_Color, GL_FLOAT, 4> C4;
         }
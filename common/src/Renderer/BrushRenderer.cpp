@@ -30,6 +30,7 @@
 #include "Renderer/BrushRendererArrays.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderUtils.h"
+#include "Renderer/TextureArrays.h"
 #include "Renderer/TexturedIndexArrayBuilder.h"
 #include "Renderer/VertexSpec.h"
 
@@ -123,7 +124,8 @@ namespace TrenchBroom {
         m_tint(false),
         m_showOccludedEdges(false),
         m_transparencyAlpha(1.0f),
-        m_showHiddenBrushes(false) {
+        m_showHiddenBrushes(false),
+        m_textureArrays(nullptr) {
             clear();
         }
         
@@ -194,13 +196,13 @@ namespace TrenchBroom {
             m_allBrushes.clear();
             m_invalidBrushes.clear();
 
-            m_vertexArray = std::make_shared<BrushVertexArray>();
+            m_vertexArray = std::make_shared<BrushVertexArray>(m_textureArrays != nullptr);
             m_edgeIndices = std::make_shared<BrushIndexArray>();
             m_transparentFaces = std::make_shared<TextureToBrushIndicesMap>();
             m_opaqueFaces = std::make_shared<TextureToBrushIndicesMap>();
 
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
+            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_textureArrays, m_faceColor);
+            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_textureArrays, m_faceColor);
             m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
         }
 
@@ -247,6 +249,15 @@ namespace TrenchBroom {
             }
         }
 
+        void BrushRenderer::setTextureArrays(TextureArrays* textureArrays) {
+            if (textureArrays != m_textureArrays) {
+                // the brushes must be removed from the old vertex array before it is replaced
+                invalidate();
+                m_textureArrays = textureArrays;
+                m_vertexArray = std::make_shared<BrushVertexArray>(m_textureArrays != nullptr);
+            }
+        }
+
         void BrushRenderer::render(RenderContext& renderContext, RenderBatch& renderBatch) {
             renderOpaque(renderContext, renderBatch);
             renderTransparent(renderContext, renderBatch);
@@ -326,8 +337,8 @@ namespace TrenchBroom {
             m_invalidBrushes.clear();
             assert(valid());
 
-            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_faceColor);
-            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_faceColor);
+            m_opaqueFaceRenderer = FaceRenderer(m_vertexArray, m_opaqueFaces, m_textureArrays, m_faceColor);
+            m_transparentFaceRenderer = FaceRenderer(m_vertexArray, m_transparentFaces, m_textureArrays, m_faceColor);
             m_edgeRenderer = IndexedEdgeRenderer(m_vertexArray, m_edgeIndices);
         }
 
@@ -428,6 +439,19 @@ namespace TrenchBroom {
             std::memcpy(dest, cachedVertices.data(), cachedVertices.size() * sizeof(*dest));
             info.vertexHolderKey = vertBlock;
 
+            // the cached vertices don't know the texture array layers since they depend on the renderer
+            if (m_textureArrays != nullptr) {
+                auto* layers = m_vertexArray->getPointerToWriteLayersTo(vertBlock);
+                for (const auto& cache : brushCache.cachedFacesSortedByTexture()) {
+                    if (m_textureArrays->accepts(cache.texture)) {
+                        const VertexSpecs::T1::Vertex layer(Vec1f::fill(m_textureArrays->layer(cache.texture)));
+                        for (size_t i = 0; i < cache.vertexCount; ++i) {
+                            layers[cache.indexOfFirstVertexRelativeToBrush + i] = layer;
+                        }
+                    }
+                }
+            }
+
             const GLuint brushVerticesStartIndex = static_cast<GLuint>(vertBlock->pos);
 
             // insert edge indices into VBO
@@ -39,6 +39,7 @@ namespace TrenchBroom {
     namespace Renderer {
         class RenderBatch;
         class RenderContext;
+        class TextureArrays;
         class Vbo;
 
         class BrushRenderer {
@@ -167,6 +168,7 @@ namespace TrenchBroom {
             float m_transparencyAlpha;
             
             bool m_showHiddenBrushes;
+            TextureArrays* m_textureArrays;
         public:
             template <typename FilterT>
             BrushRenderer(const FilterT& filter) :
@@ -176,7 +178,8 @@ namespace TrenchBroom {
             m_tint(false),
             m_showOccludedEdges(false),
             m_transparencyAlpha(1.0f),
-            m_showHiddenBrushes(false) {
+            m_showHiddenBrushes(false),
+            m_textureArrays(nullptr) {
                 clear();
             }
             
@@ -215,6 +218,12 @@ namespace TrenchBroom {
             void setOccludedEdgeColor(const Color& occludedEdgeColor);
             void setTransparencyAlpha(float transparencyAlpha);
             void setShowHiddenBrushes(bool showHiddenBrushes);
+
+            /**
+             * Sets the texture arrays to use for rendering faces, or null to render each texture separately. The
+             * texture arrays must outlive this renderer.
+             */
+            void setTextureArrays(TextureArrays* textureArrays);
         public: // rendering
             void render(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
@@ -86,6 +86,11 @@ namespace TrenchBroom {
             glAssert(glDrawElements(primType, renderCount, glType<Index>(), renderOffset));
         }
 
+        void IndexHolder::addRange(GLCounts& counts, std::vector<const GLvoid*>& offsets) const {
+            counts.push_back(static_cast<GLsizei>(size()));
+            offsets.push_back(reinterpret_cast<const GLvoid*>(m_block->offset()));
+        }
+
         std::shared_ptr<IndexHolder> IndexHolder::swap(std::vector<IndexHolder::Index> &elements) {
             return std::make_shared<IndexHolder>(elements);
         }
@@ -133,6 +138,11 @@ namespace TrenchBroom {
             m_indexHolder.render(primType, 0, m_indexHolder.size());
         }
 
+        void BrushIndexArray::addRange(GLCounts& counts, std::vector<const GLvoid*>& offsets) const {
+            assert(m_indexHolder.prepared());
+            m_indexHolder.addRange(counts, offsets);
+        }
+
         bool BrushIndexArray::prepared() const {
             return m_indexHolder.prepared();
         }
@@ -144,8 +154,10 @@ namespace TrenchBroom {
 
         // BrushVertexArray
 
-        BrushVertexArray::BrushVertexArray() : m_vertexHolder(),
-                                               m_allocationTracker(0) {}
+        BrushVertexArray::BrushVertexArray(const bool hasLayers) : m_vertexHolder(),
+                                                                   m_layerHolder(),
+                                                                   m_hasLayers(hasLayers),
+                                                                   m_allocationTracker(0) {}
 
         std::pair<AllocationTracker::Block*, BrushVertexArray::Vertex*> BrushVertexArray::getPointerToInsertVerticesAt(const size_t vertexCount) {
             if (auto block = m_allocationTracker.allocate(vertexCount); block != nullptr) {
@@ -158,6 +170,9 @@ namespace TrenchBroom {
                                             m_allocationTracker.capacity() + vertexCount);
             m_allocationTracker.expand(newSize);
             m_vertexHolder.resize(newSize);
+            if (m_hasLayers) {
+                m_layerHolder.resize(newSize);
+            }
 
             // insert again
             auto block = m_allocationTracker.allocate(vertexCount);
@@ -167,6 +182,11 @@ namespace TrenchBroom {
             return {block, dest};
         }
 
+        BrushVertexArray::LayerVertex* BrushVertexArray::getPointerToWriteLayersTo(AllocationTracker::Block* key) {
+            assert(m_hasLayers);
+            return m_layerHolder.getPointerToWriteElementsTo(key->pos, key->size);
+        }
+
         void BrushVertexArray::deleteVerticesWithKey(AllocationTracker::Block* key) {
             m_allocationTracker.free(key);
 
@@ -177,20 +197,27 @@ namespace TrenchBroom {
         }
 
         bool BrushVertexArray::setupVertices() {
+            if (m_hasLayers) {
+                m_layerHolder.setupVertices();
+            }
             return m_vertexHolder.setupVertices();
         }
 
         void BrushVertexArray::cleanupVertices() {
             m_vertexHolder.cleanupVertices();
+            if (m_hasLayers) {
+                m_layerHolder.cleanupVertices();
+            }
         }
 
         bool BrushVertexArray::prepared() const {
-            return m_vertexHolder.prepared();
+            return m_vertexHolder.prepared() && m_layerHolder.prepared();
         }
 
         void BrushVertexArray::prepare(Vbo& vbo) {
             m_vertexHolder.prepare(vbo);
-            assert(m_vertexHolder.prepared());
+            m_layerHolder.prepare(vbo);
+            assert(prepared());
         }
     }
 }
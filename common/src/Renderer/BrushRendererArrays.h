@@ -206,6 +206,7 @@ namespace TrenchBroom {
             explicit IndexHolder(std::vector<Index>& elements);
             void zeroRange(size_t offsetWithinBlock, size_t count);
             void render(PrimType primType, size_t offset, size_t count) const;
+            void addRange(GLCounts& counts, std::vector<const GLvoid*>& offsets) const;
 
             static std::shared_ptr<IndexHolder> swap(std::vector<Index>& elements);
         };
@@ -239,6 +240,12 @@ namespace TrenchBroom {
             void zeroElementsWithKey(AllocationTracker::Block* key);
 
             void render(const PrimType primType) const;
+
+            /**
+             * Appends the count and the VBO offset of all indices to the given lists so that several index arrays
+             * can be rendered with a single call to glMultiDrawElements.
+             */
+            void addRange(GLCounts& counts, std::vector<const GLvoid*>& offsets) const;
             bool prepared() const;
             void prepare(Vbo& vbo);
         };
@@ -290,11 +297,19 @@ namespace TrenchBroom {
         class BrushVertexArray {
         private:
             using Vertex = Renderer::VertexSpecs::P3NT2::Vertex;
+            using LayerVertex = Renderer::VertexSpecs::T1::Vertex;
 
             VertexHolder<Vertex> m_vertexHolder;
+            // the texture array layers of the vertices are kept in a separate array so that they take no space
+            // unless texture arrays are in use
+            VertexHolder<LayerVertex> m_layerHolder;
+            bool m_hasLayers;
             AllocationTracker m_allocationTracker;
         public:
-            BrushVertexArray();
+            /**
+             * Creates a vertex array. If hasLayers is true, it also holds a texture array layer for every vertex.
+             */
+            explicit BrushVertexArray(bool hasLayers = false);
 
             /**
              * Call this to request writing the given number of vertices.
@@ -306,6 +321,12 @@ namespace TrenchBroom {
              */
             std::pair<AllocationTracker::Block*, Vertex*> getPointerToInsertVerticesAt(size_t vertexCount);
 
+            /**
+             * Returns a pointer where the caller should write the texture array layers of the vertices in the given
+             * block. Must only be called if this array holds layers.
+             */
+            LayerVertex* getPointerToWriteLayersTo(AllocationTracker::Block* key);
+
             void deleteVerticesWithKey(AllocationTracker::Block* key);
 
             // setting up GL attributes
@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "EntityModelMesh.h"
+
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        EntityModelMesh::EntityModelMesh(Vertex::List& vertices, const TexturedIndexRangeMap& indices) :
+        m_indices(indices),
+        m_vertexArray(nullptr),
+        m_block(nullptr),
+        m_prepared(false) {
+            m_vertices.swap(vertices);
+        }
+
+        EntityModelMesh::~EntityModelMesh() {
+            if (m_block != nullptr) {
+                m_vertexArray->deleteVertices(m_block);
+                m_block = nullptr;
+            }
+        }
+
+        bool EntityModelMesh::empty() const {
+            return m_block == nullptr && m_vertices.empty();
+        }
+
+        bool EntityModelMesh::prepared() const {
+            return m_prepared;
+        }
+
+        void EntityModelMesh::prepare(EntityModelVertexArray& vertexArray) {
+            if (prepared())
+                return;
+
+            if (!m_vertices.empty()) {
+                m_vertexArray = &vertexArray;
+                m_block = m_vertexArray->insertVertices(m_vertices);
+                m_indices = m_indices.offset(m_block->pos);
+                Vertex::List().swap(m_vertices);
+            }
+            m_prepared = true;
+        }
+
+        void EntityModelMesh::render(Transformation& transformation, const Mat4x4f::List& modelMatrices) {
+            assert(prepared());
+            if (m_block != nullptr)
+                m_indices.render(transformation, modelMatrices);
+        }
+        
+        void EntityModelMesh::render(const size_t instanceCount) {
+            assert(prepared());
+            if (m_block != nullptr)
+                m_indices.render(instanceCount);
+        }
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_EntityModelMesh
+#define TrenchBroom_EntityModelMesh
+
+#include "VecMath.h"
+#include "Renderer/AllocationTracker.h"
+#include "Renderer/EntityModelVertexArray.h"
+#include "Renderer/TexturedIndexRangeMap.h"
+
+namespace TrenchBroom {
+    namespace Renderer {
+        class Transformation;
+
+        /**
+         * The renderable mesh of one frame of an entity model with a particular skin. When the mesh is prepared, its
+         * vertices are moved into a shared EntityModelVertexArray, and its index ranges are offset to point into the
+         * range that was allocated for them.
+         */
+        class EntityModelMesh {
+        public:
+            using Vertex = EntityModelVertexArray::Vertex;
+        private:
+            // released once the vertices have been copied into the vertex array
+            Vertex::List m_vertices;
+            TexturedIndexRangeMap m_indices;
+            EntityModelVertexArray* m_vertexArray;
+            AllocationTracker::Block* m_block;
+            bool m_prepared;
+        public:
+            /**
+             * NOTE: This destructively moves the contents of `vertices` into the mesh.
+             */
+            EntityModelMesh(Vertex::List& vertices, const TexturedIndexRangeMap& indices);
+            ~EntityModelMesh();
+
+            EntityModelMesh(const EntityModelMesh& other) = delete;
+            EntityModelMesh& operator=(const EntityModelMesh& other) = delete;
+
+            bool empty() const;
+
+            bool prepared() const;
+            void prepare(EntityModelVertexArray& vertexArray);
+
+            /**
+             * Renders the mesh once for each of the given model matrices. The vertex array that the mesh was prepared
+             * with must be set up.
+             */
+            void render(Transformation& transformation, const Mat4x4f::List& modelMatrices);
+            
+            /**
+             * Renders the given number of instances of the mesh with instanced draw calls. The vertex array that the
+             * mesh was prepared with and the per instance model matrices must be set up.
+             */
+            void render(size_t instanceCount);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_EntityModelMesh) */
@@ -31,14 +31,21 @@
 #include "Renderer/RenderContext.h"
 #include "Renderer/Shaders.h"
 #include "Renderer/ShaderManager.h"
-#include "Renderer/TexturedIndexRangeRenderer.h"
+#include "Renderer/EntityModelMesh.h"
+#include "Renderer/EntityModelVertexArray.h"
 #include "Renderer/Transformation.h"
+#include "Renderer/Vbo.h"
+#include "Renderer/VboBlock.h"
+
+#include <cstring>
 
 namespace TrenchBroom {
     namespace Renderer {
         EntityModelRenderer::EntityModelRenderer(Assets::EntityModelManager& entityModelManager, const Model::EditorContext& editorContext) :
         m_entityModelManager(entityModelManager),
         m_editorContext(editorContext),
+        m_instanceBlock(nullptr),
+        m_instancingSupport(Support::Unknown),
         m_applyTinting(false),
         m_showHiddenEntities(false) {}
 
@@ -48,14 +55,14 @@ namespace TrenchBroom {
         
         void EntityModelRenderer::addEntity(Model::Entity* entity) {
             const Assets::ModelSpecification& modelSpec = entity->modelSpecification();
-            TexturedIndexRangeRenderer* renderer = m_entityModelManager.renderer(modelSpec);
+            EntityModelMesh* renderer = m_entityModelManager.renderer(modelSpec);
             if (renderer != nullptr)
                 m_entities.insert(std::make_pair(entity, renderer));
         }
         
         void EntityModelRenderer::updateEntity(Model::Entity* entity) {
             const Assets::ModelSpecification& modelSpec = entity->modelSpecification();
-            TexturedIndexRangeRenderer* renderer = m_entityModelManager.renderer(modelSpec);
+            EntityModelMesh* renderer = m_entityModelManager.renderer(modelSpec);
             EntityMap::iterator it = m_entities.find(entity);
             
             if (renderer == nullptr && it == std::end(m_entities))
@@ -105,12 +112,78 @@ namespace TrenchBroom {
 
         void EntityModelRenderer::doPrepareVertices(Vbo& vertexVbo) {
             m_entityModelManager.prepare(vertexVbo);
+            
+            collectInstances();
+            
+            // instanced drawing is opt-in until it has been tested on more drivers, in particular whether the model
+            // matrix attribute is kept clear of the locations of the fixed function attributes
+            if (!m_instances.empty() && pref(Preferences::InstancedEntityModels) && instancingSupported())
+                uploadInstances(vertexVbo);
+        }
+        
+        void EntityModelRenderer::collectInstances() {
+            m_instances.clear();
+            for (const auto& entry : m_entities) {
+                Model::Entity* entity = entry.first;
+                if (!m_showHiddenEntities && !m_editorContext.visible(entity))
+                    continue;
+                
+                const Mat4x4f translation(translationMatrix(entity->origin()));
+                const Mat4x4f rotation(entity->rotation());
+                m_instances[entry.second].push_back(translation * rotation);
+            }
+        }
+        
+        bool EntityModelRenderer::instancingSupported() {
+            if (m_instancingSupport == Support::Unknown) {
+                const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+                const bool extension = extensions != nullptr && std::strstr(extensions, "GL_ARB_instanced_arrays") != nullptr;
+                m_instancingSupport = extension ? Support::Supported : Support::Unsupported;
+            }
+            return m_instancingSupport == Support::Supported;
+        }
+        
+        void EntityModelRenderer::uploadInstances(Vbo& vertexVbo) {
+            // the matrices are stored in column major order, one after another, grouped by their meshes
+            std::vector<float> matrices;
+            for (const auto& entry : m_instances) {
+                for (const Mat4x4f& matrix : entry.second) {
+                    for (size_t col = 0; col < 4; ++col) {
+                        for (size_t row = 0; row < 4; ++row)
+                            matrices.push_back(matrix[col][row]);
+                    }
+                }
+            }
+            
+            assert(m_instanceBlock == nullptr);
+            m_instanceBlock = vertexVbo.allocateBlock(matrices.size() * sizeof(float));
+            
+            MapVboBlock map(m_instanceBlock);
+            m_instanceBlock->writeBuffer(0, matrices);
         }
         
         void EntityModelRenderer::doRender(RenderContext& renderContext) {
+            if (m_instances.empty())
+                return;
+            
+            if (m_instanceBlock != nullptr) {
+                ActiveShader shader(renderContext.shaderManager(), Shaders::EntityModelInstancedShader);
+                setupShader(shader);
+                renderInstanced(shader.attributeLocation("ModelMatrix"));
+
+                m_instanceBlock->free();
+                m_instanceBlock = nullptr;
+            } else {
+                ActiveShader shader(renderContext.shaderManager(), Shaders::EntityModelShader);
+                setupShader(shader);
+                renderSingle(renderContext.transformation());
+            }
+            m_instances.clear();
+        }
+        
+        void EntityModelRenderer::setupShader(ActiveShader& shader) const {
             PreferenceManager& prefs = PreferenceManager::instance();
             
-            ActiveShader shader(renderContext.shaderManager(), Shaders::EntityModelShader);
             shader.set("Brightness", prefs.get(Preferences::Brightness));
             shader.set("ApplyTinting", m_applyTinting);
             shader.set("TintColor", m_tintColor);
@@ -119,21 +192,51 @@ namespace TrenchBroom {
             
             glAssert(glEnable(GL_TEXTURE_2D));
             glAssert(glActiveTexture(GL_TEXTURE0));
+        }
+        
+        void EntityModelRenderer::renderInstanced(const GLuint modelMatrixLocation) {
+            EntityModelVertexArray& vertexArray = m_entityModelManager.vertexArray();
+            if (!vertexArray.setupVertices())
+                return;
             
-            for (const auto& entry : m_entities) {
-                Model::Entity* entity = entry.first;
-                if (!m_showHiddenEntities && !m_editorContext.visible(entity))
-                    continue;
-                
-                TexturedIndexRangeRenderer* renderer = entry.second;
-                
-                const Mat4x4f translation(translationMatrix(entity->origin()));
-                const Mat4x4f rotation(entity->rotation());
-                const Mat4x4f matrix = translation * rotation;
-                MultiplyModelMatrix multMatrix(renderContext.transformation(), matrix);
+            // a mat4 attribute occupies four consecutive locations, one for each column
+            const size_t columnSize = 4 * sizeof(float);
+            const size_t matrixSize = 4 * columnSize;
+            for (GLuint i = 0; i < 4; ++i) {
+                glAssert(glEnableVertexAttribArray(modelMatrixLocation + i));
+                glAssert(glVertexAttribDivisor(modelMatrixLocation + i, 1));
+            }
+            
+            size_t offset = m_instanceBlock->offset();
+            for (const auto& entry : m_instances) {
+                EntityModelMesh* mesh = entry.first;
+                const size_t instanceCount = entry.second.size();
                 
-                renderer->render();
+                for (GLuint i = 0; i < 4; ++i) {
+                    const GLvoid* columnOffset = reinterpret_cast<GLvoid*>(offset + i * columnSize);
+                    glAssert(glVertexAttribPointer(modelMatrixLocation + i, 4, GL_FLOAT, false, static_cast<GLsizei>(matrixSize), columnOffset));
+                }
+                mesh->render(instanceCount);
+                offset += instanceCount * matrixSize;
+            }
+            
+            for (GLuint i = 0; i < 4; ++i) {
+                glAssert(glVertexAttribDivisor(modelMatrixLocation + i, 0));
+                glAssert(glDisableVertexAttribArray(modelMatrixLocation + i));
+            }
+            vertexArray.cleanupVertices();
+        }
+        
+        void EntityModelRenderer::renderSingle(Transformation& transformation) {
+            EntityModelVertexArray& vertexArray = m_entityModelManager.vertexArray();
+            if (!vertexArray.setupVertices())
+                return;
+            
+            for (const auto& entry : m_instances) {
+                EntityModelMesh* mesh = entry.first;
+                mesh->render(transformation, entry.second);
             }
+            vertexArray.cleanupVertices();
         }
     }
 }
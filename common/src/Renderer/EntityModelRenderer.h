@@ -21,6 +21,7 @@
 #define TrenchBroom_EntityModelRenderer
 
 #include "Color.h"
+#include "VecMath.h"
 #include "Assets/ModelDefinition.h"
 #include "Model/ModelTypes.h"
 #include "Renderer/Renderable.h"
@@ -40,19 +41,40 @@ namespace TrenchBroom {
     }
     
     namespace Renderer {
+        class ActiveShader;
         class RenderBatch;
         class RenderContext;
-        class TexturedIndexRangeRenderer;
+        class EntityModelMesh;
+        class Transformation;
+        class VboBlock;
         
+        /**
+         * Renders the models of entities. The visible entities are grouped by their mesh. If instanced arrays are
+         * supported, the model matrices of all instances are uploaded into the vertex VBO and each mesh is drawn with
+         * instanced draw calls. Otherwise, every instance is drawn with its own model matrix.
+         */
         class EntityModelRenderer : public DirectRenderable {
         private:
-            typedef std::map<Model::Entity*, TexturedIndexRangeRenderer*> EntityMap;
+            typedef std::map<Model::Entity*, EntityModelMesh*> EntityMap;
+            typedef std::map<EntityModelMesh*, Mat4x4f::List> MeshInstances;
             
             Assets::EntityModelManager& m_entityModelManager;
             const Model::EditorContext& m_editorContext;
             
             EntityMap m_entities;
             
+            // the instances to render in the current frame, and the VBO block holding their model matrices if they
+            // are rendered with instanced draw calls
+            MeshInstances m_instances;
+            VboBlock* m_instanceBlock;
+            
+            enum class Support {
+                Unknown,
+                Supported,
+                Unsupported
+            };
+            Support m_instancingSupport;
+            
             bool m_applyTinting;
             Color m_tintColor;
             
@@ -98,7 +120,14 @@ namespace TrenchBroom {
             void render(RenderBatch& renderBatch);
         private:
             void doPrepareVertices(Vbo& vertexVbo) override;
+            void collectInstances();
+            bool instancingSupported();
+            void uploadInstances(Vbo& vertexVbo);
+            
             void doRender(RenderContext& renderContext) override;
+            void setupShader(ActiveShader& shader) const;
+            void renderInstanced(GLuint modelMatrixLocation);
+            void renderSingle(Transformation& transformation);
         };
     }
 }
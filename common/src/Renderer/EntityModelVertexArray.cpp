@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "Renderer/EntityModelVertexArray.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        EntityModelVertexArray::EntityModelVertexArray() :
+        m_vertexHolder(),
+        m_allocationTracker(0) {}
+
+        bool EntityModelVertexArray::empty() const {
+            return m_vertexHolder.empty();
+        }
+
+        AllocationTracker::Block* EntityModelVertexArray::insertVertices(const std::vector<Vertex>& vertices) {
+            const size_t vertexCount = vertices.size();
+            assert(vertexCount > 0);
+
+            AllocationTracker::Block* block = m_allocationTracker.allocate(vertexCount);
+            if (block == nullptr) {
+                const size_t newSize = std::max(2 * m_allocationTracker.capacity(),
+                                                m_allocationTracker.capacity() + vertexCount);
+                m_allocationTracker.expand(newSize);
+                m_vertexHolder.resize(newSize);
+
+                block = m_allocationTracker.allocate(vertexCount);
+                assert(block != nullptr);
+            }
+
+            Vertex* dest = m_vertexHolder.getPointerToWriteElementsTo(block->pos, vertexCount);
+            std::copy(std::begin(vertices), std::end(vertices), dest);
+            return block;
+        }
+
+        void EntityModelVertexArray::deleteVertices(AllocationTracker::Block* block) {
+            // the vertices are only drawn through the index ranges of their meshes, so there is no need to
+            // clear them in the VBO
+            m_allocationTracker.free(block);
+        }
+
+        bool EntityModelVertexArray::setupVertices() {
+            if (empty())
+                return false;
+            return m_vertexHolder.setupVertices();
+        }
+
+        void EntityModelVertexArray::cleanupVertices() {
+            m_vertexHolder.cleanupVertices();
+        }
+
+        bool EntityModelVertexArray::prepared() const {
+            return m_vertexHolder.prepared();
+        }
+
+        void EntityModelVertexArray::prepare(Vbo& vbo) {
+            m_vertexHolder.prepare(vbo);
+            assert(m_vertexHolder.prepared());
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_EntityModelVertexArray
+#define TrenchBroom_EntityModelVertexArray
+
+#include "Renderer/AllocationTracker.h"
+#include "Renderer/BrushRendererArrays.h"
+#include "Renderer/VertexSpec.h"
+
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        class Vbo;
+
+        /**
+         * Holds the vertices of all entity model meshes in a single VBO block. Each mesh occupies a range of the
+         * block which is managed by an AllocationTracker, so the vertex attributes only need to be set up once to
+         * render any number of meshes.
+         *
+         * The block grows as needed; the position of a range never changes once it has been allocated.
+         */
+        class EntityModelVertexArray {
+        public:
+            using Vertex = VertexSpecs::P3T2::Vertex;
+        private:
+            VertexHolder<Vertex> m_vertexHolder;
+            AllocationTracker m_allocationTracker;
+        public:
+            EntityModelVertexArray();
+
+            bool empty() const;
+
+            /**
+             * Copies the given vertices into a newly allocated range and returns the range. The range remains
+             * valid until it is passed to deleteVertices().
+             */
+            AllocationTracker::Block* insertVertices(const std::vector<Vertex>& vertices);
+
+            /**
+             * Marks the given range as free so that it can be reused by later insertions.
+             */
+            void deleteVertices(AllocationTracker::Block* block);
+
+            // setting up GL attributes
+            bool setupVertices();
+            void cleanupVertices();
+
+            // uploading the VBO
+            bool prepared() const;
+            void prepare(Vbo& vbo);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_EntityModelVertexArray) */
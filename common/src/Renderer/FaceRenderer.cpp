@@ -30,6 +30,7 @@
 #include "Renderer/Shaders.h"
 #include "Renderer/ShaderProgram.h"
 #include "Renderer/ShaderManager.h"
+#include "Renderer/TextureArrays.h"
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -61,13 +62,15 @@ namespace TrenchBroom {
         };
         
         FaceRenderer::FaceRenderer() :
+        m_textureArrays(nullptr),
         m_grayscale(false),
         m_tint(false),
         m_alpha(1.0f) {}
         
-        FaceRenderer::FaceRenderer(BrushVertexArrayPtr vertexArray, TextureToBrushIndicesMapPtr indexArrayMap, const Color& faceColor) :
+        FaceRenderer::FaceRenderer(BrushVertexArrayPtr vertexArray, TextureToBrushIndicesMapPtr indexArrayMap, TextureArrays* textureArrays, const Color& faceColor) :
         m_vertexArray(vertexArray),
         m_indexArrayMap(indexArrayMap),
+        m_textureArrays(textureArrays),
         m_faceColor(faceColor),
         m_grayscale(false),
         m_tint(false),
@@ -76,6 +79,7 @@ namespace TrenchBroom {
         FaceRenderer::FaceRenderer(const FaceRenderer& other) :
         m_vertexArray(other.m_vertexArray),
         m_indexArrayMap(other.m_indexArrayMap),
+        m_textureArrays(other.m_textureArrays),
         m_faceColor(other.m_faceColor),
         m_grayscale(other.m_grayscale),
         m_tint(other.m_tint),
@@ -92,6 +96,7 @@ namespace TrenchBroom {
             using std::swap;
             swap(left.m_vertexArray, right.m_vertexArray);
             swap(left.m_indexArrayMap, right.m_indexArrayMap);
+            swap(left.m_textureArrays, right.m_textureArrays);
             swap(left.m_faceColor, right.m_faceColor);
             swap(left.m_grayscale, right.m_grayscale);
             swap(left.m_tint, right.m_tint);
@@ -133,48 +138,91 @@ namespace TrenchBroom {
                 return;
 
             if (m_vertexArray->setupVertices()) {
-                ShaderManager& shaderManager = context.shaderManager();
-                ActiveShader shader(shaderManager, Shaders::FaceShader);
-                PreferenceManager& prefs = PreferenceManager::instance();
-                
                 const bool applyTexture = context.showTextures();
-                const bool shadeFaces = context.shadeFaces();
-                const bool showFog = context.showFog();
-                
+                const bool useTextureArrays = applyTexture && m_textureArrays != nullptr && m_textureArrays->supported();
+
                 glAssert(glEnable(GL_TEXTURE_2D));
                 glAssert(glActiveTexture(GL_TEXTURE0));
-                shader.set("Brightness", prefs.get(Preferences::Brightness));
-                shader.set("RenderGrid", context.showGrid());
-                shader.set("GridSize", static_cast<float>(context.gridSize()));
-                shader.set("GridAlpha", prefs.get(Preferences::GridAlpha));
-                shader.set("ApplyTexture", applyTexture);
-                shader.set("Texture", 0);
-                shader.set("ApplyTinting", m_tint);
-                if (m_tint)
-                    shader.set("TintColor", m_tintColor);
-                shader.set("GrayScale", m_grayscale);
-                shader.set("CameraPosition", context.camera().position());
-                shader.set("ShadeFaces", shadeFaces);
-                shader.set("ShowFog", showFog);
-                shader.set("Alpha", m_alpha);
-                
-                RenderFunc func(shader, applyTexture, m_faceColor);
                 if (m_alpha < 1.0f) {
                     glAssert(glDepthMask(GL_FALSE));
                 }
-                for (const auto& [texture, brushIndexHolderPtr] : *m_indexArrayMap) {
-                    if (brushIndexHolderPtr->empty()) {
-                        continue;
+
+                {
+                    ActiveShader shader(context.shaderManager(), Shaders::FaceShader);
+                    setUniforms(context, shader, applyTexture);
+
+                    RenderFunc func(shader, applyTexture, m_faceColor);
+                    for (const auto& [texture, brushIndexHolderPtr] : *m_indexArrayMap) {
+                        // textures that are in an array are rendered by renderTextureArrays
+                        if (brushIndexHolderPtr->empty() || (useTextureArrays && m_textureArrays->accepts(texture))) {
+                            continue;
+                        }
+                        func.before(texture);
+                        brushIndexHolderPtr->render(GL_TRIANGLES);
+                        func.after(texture);
                     }
-                    func.before(texture);
-                    brushIndexHolderPtr->render(GL_TRIANGLES);
-                    func.after(texture);
                 }
+
+                if (useTextureArrays) {
+                    ActiveShader shader(context.shaderManager(), Shaders::FaceArrayShader);
+                    setUniforms(context, shader, applyTexture);
+                    renderTextureArrays(shader);
+                }
+
                 if (m_alpha < 1.0f) {
                     glAssert(glDepthMask(GL_TRUE));
                 }
                 m_vertexArray->cleanupVertices();
             }
         }
+
+        void FaceRenderer::setUniforms(RenderContext& context, ActiveShader& shader, const bool applyTexture) const {
+            PreferenceManager& prefs = PreferenceManager::instance();
+
+            shader.set("Brightness", prefs.get(Preferences::Brightness));
+            shader.set("RenderGrid", context.showGrid());
+            shader.set("GridSize", static_cast<float>(context.gridSize()));
+            shader.set("GridAlpha", prefs.get(Preferences::GridAlpha));
+            shader.set("ApplyTexture", applyTexture);
+            shader.set("Texture", 0);
+            shader.set("ApplyTinting", m_tint);
+            if (m_tint)
+                shader.set("TintColor", m_tintColor);
+            shader.set("GrayScale", m_grayscale);
+            shader.set("CameraPosition", context.camera().position());
+            shader.set("ShadeFaces", context.shadeFaces());
+            shader.set("ShowFog", context.showFog());
+            shader.set("Alpha", m_alpha);
+        }
+
+        void FaceRenderer::renderTextureArrays(ActiveShader& shader) {
+            std::vector<const Assets::Texture*> textures;
+            std::vector<const BrushIndexArray*> indexArrays;
+            textures.reserve(m_indexArrayMap->size());
+            indexArrays.reserve(m_indexArrayMap->size());
+
+            for (const auto& [texture, brushIndexHolderPtr] : *m_indexArrayMap) {
+                if (m_textureArrays->accepts(texture) && !brushIndexHolderPtr->empty()) {
+                    textures.push_back(texture);
+                    indexArrays.push_back(brushIndexHolderPtr.get());
+                }
+            }
+
+            shader.set("ApplyTexture", true);
+
+            GLCounts counts;
+            std::vector<const GLvoid*> offsets;
+            for (const auto& batch : m_textureArrays->batch(textures)) {
+                counts.clear();
+                offsets.clear();
+                for (const size_t index : batch.indices) {
+                    indexArrays[index]->addRange(counts, offsets);
+                }
+
+                m_textureArrays->activate(batch.array);
+                glAssert(glMultiDrawElements(GL_TRIANGLES, counts.data(), glType<GLuint>(), offsets.data(), static_cast<GLsizei>(counts.size())));
+                m_textureArrays->deactivate();
+            }
+        }
     }
 }
@@ -37,6 +37,7 @@ namespace TrenchBroom {
         class BrushVertexArray;
         class RenderBatch;
         class RenderContext;
+        class TextureArrays;
         class Vbo;
 
         using BrushVertexArrayPtr = std::shared_ptr<BrushVertexArray>;
@@ -49,6 +50,7 @@ namespace TrenchBroom {
 
             BrushVertexArrayPtr m_vertexArray;
             TextureToBrushIndicesMapPtr m_indexArrayMap;
+            TextureArrays* m_textureArrays;
             Color m_faceColor;
             bool m_grayscale;
             bool m_tint;
@@ -56,7 +58,11 @@ namespace TrenchBroom {
             float m_alpha;
         public:
             FaceRenderer();
-            FaceRenderer(BrushVertexArrayPtr vertexArray, TextureToBrushIndicesMapPtr indexArrayMap, const Color& faceColor);
+            /**
+             * If texture arrays are given and supported, faces whose textures share an array are rendered with a
+             * single draw call. The vertices must then contain the layer of each face's texture.
+             */
+            FaceRenderer(BrushVertexArrayPtr vertexArray, TextureToBrushIndicesMapPtr indexArrayMap, TextureArrays* textureArrays, const Color& faceColor);
             
             FaceRenderer(const FaceRenderer& other);
             FaceRenderer& operator=(FaceRenderer other);
@@ -71,6 +77,8 @@ namespace TrenchBroom {
         private:
             void prepareVerticesAndIndices(Vbo& vertexVbo, Vbo& indexVbo) override;
             void doRender(RenderContext& context) override;
+            void setUniforms(RenderContext& context, ActiveShader& shader, bool applyTexture) const;
+            void renderTextureArrays(ActiveShader& shader);
         };
 
         void swap(FaceRenderer& left, FaceRenderer& right);
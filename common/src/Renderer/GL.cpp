@@ -95,6 +95,9 @@ namespace TrenchBroom {
     Func3<void, GLenum, GLenum, GLfloat> glTexParameterf;
     Func3<void, GLenum, GLenum, GLint> glTexParameteri;
     Func9<void, GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*> glTexImage2D;
+    Func10<void, GLenum, GLint, GLint, GLsizei, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*> glTexImage3D;
+    Func11<void, GLenum, GLint, GLint, GLint, GLint, GLsizei, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*> glTexSubImage3D;
+    Func8<void, GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei, const GLvoid*> glCompressedTexImage2D;
     Func1<void, GLenum> glActiveTexture;
     
     Func2<void, GLsizei, GLuint*> glGenBuffers;
@@ -122,6 +125,8 @@ namespace TrenchBroom {
     Func4<void, GLenum, GLsizei, GLenum, const GLvoid*> glDrawElements;
     Func6<void, GLenum, GLuint, GLuint, GLsizei, GLenum, const GLvoid*> glDrawRangeElements;
     Func5<void, GLenum, const GLsizei*, GLenum, const GLvoid**, GLsizei> glMultiDrawElements;
+    Func4<void, GLenum, GLint, GLsizei, GLsizei> glDrawArraysInstanced;
+    Func2<void, GLuint, GLuint> glVertexAttribDivisor;
     
     Func1<GLuint, GLenum> glCreateShader;
     Func1<void, GLuint> glDeleteShader;
@@ -176,6 +181,7 @@ namespace TrenchBroom {
     Func4<void, GLint, GLsizei, GLboolean, const GLfloat*> glUniformMatrix4x3fv;
     
     Func2<GLint, GLuint, const GLchar*> glGetUniformLocation;
+    Func2<GLint, GLuint, const GLchar*> glGetAttribLocation;
     
 #ifdef __APPLE__
     Func2<void, GLenum, GLint> glFinishObjectAPPLE;
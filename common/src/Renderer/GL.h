@@ -111,9 +111,13 @@ namespace TrenchBroom {
 #define GL_RGB 0x1907
 #define GL_RGBA 0x1908
 #define GL_BGR 0x80E0
+#define GL_BGRA 0x80E1
 #define GL_LUMINANCE 0x1909
 #define GL_LUMINANCE_ALPHA 0x190A
 
+#define GL_VERSION 0x1F02
+#define GL_EXTENSIONS 0x1F03
+
 #define GL_POINT 0x1B00
 #define GL_LINE 0x1B01
 #define GL_FILL 0x1B02
@@ -173,6 +177,11 @@ namespace TrenchBroom {
 #define GL_INFO_LOG_LENGTH 0x8B84
 #define GL_CURRENT_PROGRAM 0x8B8D
 
+#define GL_TEXTURE_2D_ARRAY 0x8C1A
+
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+
     typedef unsigned int GLenum;
     typedef unsigned int GLbitfield;
     typedef int GLsizei;
@@ -284,6 +293,9 @@ namespace TrenchBroom {
     extern Func3<void, GLenum, GLenum, GLfloat> glTexParameterf;
     extern Func3<void, GLenum, GLenum, GLint> glTexParameteri;
     extern Func9<void, GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*> glTexImage2D;
+    extern Func10<void, GLenum, GLint, GLint, GLsizei, GLsizei, GLsizei, GLint, GLenum, GLenum, const GLvoid*> glTexImage3D;
+    extern Func11<void, GLenum, GLint, GLint, GLint, GLint, GLsizei, GLsizei, GLsizei, GLenum, GLenum, const GLvoid*> glTexSubImage3D;
+    extern Func8<void, GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei, const GLvoid*> glCompressedTexImage2D;
     extern Func1<void, GLenum> glActiveTexture;
     
     extern Func2<void, GLsizei, GLuint*> glGenBuffers;
@@ -311,6 +323,8 @@ namespace TrenchBroom {
     extern Func4<void, GLenum, GLsizei, GLenum, const GLvoid*> glDrawElements;
     extern Func6<void, GLenum, GLuint, GLuint, GLsizei, GLenum, const GLvoid*> glDrawRangeElements;
     extern Func5<void, GLenum, const GLsizei*, GLenum, const GLvoid**, GLsizei> glMultiDrawElements;
+    extern Func4<void, GLenum, GLint, GLsizei, GLsizei> glDrawArraysInstanced;
+    extern Func2<void, GLuint, GLuint> glVertexAttribDivisor;
 
     extern Func1<GLuint, GLenum> glCreateShader;
     extern Func1<void, GLuint> glDeleteShader;
@@ -365,6 +379,7 @@ namespace TrenchBroom {
     extern Func4<void, GLint, GLsizei, GLboolean, const GLfloat*> glUniformMatrix4x3fv;
     
     extern Func2<GLint, GLuint, const GLchar*> glGetUniformLocation;
+    extern Func2<GLint, GLuint, const GLchar*> glGetAttribLocation;
 
 #ifdef __APPLE__
     extern Func2<void, GLenum, GLint> glFinishObjectAPPLE;
@@ -110,6 +110,19 @@ namespace TrenchBroom {
             indicesAndCounts.add(primType, index, count, m_dynamicGrowth);
         }
 
+        IndexRangeMap IndexRangeMap::offset(const size_t offset) const {
+            IndexRangeMap result;
+            result.m_dynamicGrowth = m_dynamicGrowth;
+            
+            for (const auto& entry : *m_data) {
+                IndicesAndCounts indicesAndCounts = entry.second;
+                for (GLint& index : indicesAndCounts.indices)
+                    index += static_cast<GLint>(offset);
+                result.m_data->insert(std::make_pair(entry.first, indicesAndCounts));
+            }
+            return result;
+        }
+        
         void IndexRangeMap::render(VertexArray& vertexArray) const {
             for (const auto& entry : *m_data) {
                 const PrimType primType = entry.first;
@@ -118,5 +131,25 @@ namespace TrenchBroom {
                 vertexArray.render(primType, indicesAndCounts.indices, indicesAndCounts.counts, primCount);
             }
         }
+        
+        void IndexRangeMap::render() const {
+            for (const auto& entry : *m_data) {
+                const PrimType primType = entry.first;
+                const IndicesAndCounts& indicesAndCounts = entry.second;
+                const GLsizei primCount = static_cast<GLsizei>(indicesAndCounts.size());
+                glAssert(glMultiDrawArrays(primType, indicesAndCounts.indices.data(), indicesAndCounts.counts.data(), primCount));
+            }
+        }
+        
+        void IndexRangeMap::render(const size_t instanceCount) const {
+            const GLsizei primCount = static_cast<GLsizei>(instanceCount);
+            for (const auto& entry : *m_data) {
+                const PrimType primType = entry.first;
+                const IndicesAndCounts& indicesAndCounts = entry.second;
+                for (size_t i = 0; i < indicesAndCounts.size(); ++i) {
+                    glAssert(glDrawArraysInstanced(primType, indicesAndCounts.indices[i], indicesAndCounts.counts[i], primCount));
+                }
+            }
+        }
     }
 }
@@ -66,7 +66,23 @@ namespace TrenchBroom {
             
             void add(PrimType primType, size_t index, size_t count);
             
+            /**
+             * Returns a copy of this map where every index is increased by the given offset.
+             */
+            IndexRangeMap offset(size_t offset) const;
+            
             void render(VertexArray& vertexArray) const;
+            
+            /**
+             * Renders the primitives using the vertex attributes that are currently set up.
+             */
+            void render() const;
+            
+            /**
+             * Renders the given number of instances of the primitives using the vertex attributes that are currently
+             * set up. Requires support for instanced arrays.
+             */
+            void render(size_t instanceCount) const;
         };
     }
 }
@@ -41,6 +41,7 @@
 #include "Renderer/RenderBatch.h"
 #include "Renderer/RenderContext.h"
 #include "Renderer/RenderService.h"
+#include "Renderer/TextureArrays.h"
 #include "Renderer/RenderUtils.h"
 #include "View/Selection.h"
 #include "View/MapDocument.h"
@@ -117,7 +118,8 @@ namespace TrenchBroom {
         m_defaultRenderer(createDefaultRenderer(m_document)),
         m_selectionRenderer(createSelectionRenderer(m_document)),
         m_lockedRenderer(createLockRenderer(m_document)),
-        m_entityLinkRenderer(new EntityLinkRenderer(m_document)) {
+        m_entityLinkRenderer(new EntityLinkRenderer(m_document)),
+        m_textureArrays(new TextureArrays()) {
             bindObservers();
             setupRenderers();
         }
@@ -129,6 +131,7 @@ namespace TrenchBroom {
             delete m_lockedRenderer;
             delete m_selectionRenderer;
             delete m_defaultRenderer;
+            delete m_textureArrays;
         }
         
         ObjectRenderer* MapRenderer::createDefaultRenderer(View::MapDocumentWPtr document) {
@@ -189,6 +192,7 @@ namespace TrenchBroom {
         void MapRenderer::commitPendingChanges() {
             View::MapDocumentSPtr document = lock(m_document);
             document->commitPendingAssets();
+            m_textureArrays->commitChanges();
         }
         
         class SetupGL : public Renderable {
@@ -295,6 +299,11 @@ namespace TrenchBroom {
             setupSelectionRenderer(m_selectionRenderer);
             setupLockedRenderer(m_lockedRenderer);
             setupEntityLinkRenderer();
+
+            TextureArrays* textureArrays = pref(Preferences::TextureArrays) ? m_textureArrays : nullptr;
+            m_defaultRenderer->setTextureArrays(textureArrays);
+            m_selectionRenderer->setTextureArrays(textureArrays);
+            m_lockedRenderer->setTextureArrays(textureArrays);
         }
         
         void MapRenderer::setupDefaultRenderer(ObjectRenderer* renderer) {
@@ -485,6 +494,7 @@ namespace TrenchBroom {
             document->selectionDidChangeNotifier.addObserver(this, &MapRenderer::selectionDidChange);
             document->textureCollectionsDidChangeNotifier.addObserver(this, &MapRenderer::textureCollectionsDidChange);
             document->entityDefinitionsDidChangeNotifier.addObserver(this, &MapRenderer::entityDefinitionsDidChange);
+            document->entityModelsWereLoadedNotifier.addObserver(this, &MapRenderer::entityModelsWereLoaded);
             document->modsDidChangeNotifier.addObserver(this, &MapRenderer::modsDidChange);
             document->editorContextDidChangeNotifier.addObserver(this, &MapRenderer::editorContextDidChange);
             document->mapViewConfigDidChangeNotifier.addObserver(this, &MapRenderer::mapViewConfigDidChange);
@@ -510,6 +520,7 @@ namespace TrenchBroom {
                 document->selectionDidChangeNotifier.removeObserver(this, &MapRenderer::selectionDidChange);
                 document->textureCollectionsDidChangeNotifier.removeObserver(this, &MapRenderer::textureCollectionsDidChange);
                 document->entityDefinitionsDidChangeNotifier.removeObserver(this, &MapRenderer::entityDefinitionsDidChange);
+                document->entityModelsWereLoadedNotifier.removeObserver(this, &MapRenderer::entityModelsWereLoaded);
                 document->modsDidChangeNotifier.removeObserver(this, &MapRenderer::modsDidChange);
                 document->editorContextDidChangeNotifier.removeObserver(this, &MapRenderer::editorContextDidChange);
                 document->mapViewConfigDidChangeNotifier.removeObserver(this, &MapRenderer::mapViewConfigDidChange);
@@ -594,6 +605,8 @@ namespace TrenchBroom {
         }
         
         void MapRenderer::textureCollectionsDidChange() {
+            // the removed textures may still occupy array layers, the arrays are deleted when the next frame is rendered
+            m_textureArrays->clear();
             invalidateRenderers(Renderer_All);
         }
         
@@ -603,6 +616,13 @@ namespace TrenchBroom {
             invalidateEntityLinkRenderer();
         }
         
+        void MapRenderer::entityModelsWereLoaded() {
+            // entities without a model are rendered as solid boxes, so the bounds must be rebuilt as well
+            m_defaultRenderer->invalidateEntities();
+            m_selectionRenderer->invalidateEntities();
+            m_lockedRenderer->invalidateEntities();
+        }
+        
         void MapRenderer::modsDidChange() {
             reloadEntityModels();
             invalidateRenderers(Renderer_All);
@@ -41,6 +41,7 @@ namespace TrenchBroom {
         class ObjectRenderer;
         class RenderBatch;
         class RenderContext;
+        class TextureArrays;
         
         class MapRenderer {
         private:
@@ -56,6 +57,7 @@ namespace TrenchBroom {
             ObjectRenderer* m_selectionRenderer;
             ObjectRenderer* m_lockedRenderer;
             EntityLinkRenderer* m_entityLinkRenderer;
+            TextureArrays* m_textureArrays;
         public:
             MapRenderer(View::MapDocumentWPtr document);
             ~MapRenderer();
@@ -137,6 +139,7 @@ namespace TrenchBroom {
             
             void textureCollectionsDidChange();
             void entityDefinitionsDidChange();
+            void entityModelsWereLoaded();
             void modsDidChange();
             
             void editorContextDidChange();
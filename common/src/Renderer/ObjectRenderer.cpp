@@ -41,6 +41,10 @@ namespace TrenchBroom {
             m_brushRenderer.invalidateBrushes(brushes);
         }
 
+        void ObjectRenderer::invalidateEntities() {
+            m_entityRenderer.invalidate();
+        }
+
         void ObjectRenderer::clear() {
             m_groupRenderer.clear();
             m_entityRenderer.clear();
@@ -138,6 +142,10 @@ namespace TrenchBroom {
             m_brushRenderer.setShowHiddenBrushes(showHiddenObjects);
         }
 
+        void ObjectRenderer::setTextureArrays(TextureArrays* textureArrays) {
+            m_brushRenderer.setTextureArrays(textureArrays);
+        }
+
         void ObjectRenderer::renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch) {
             m_brushRenderer.renderOpaque(renderContext, renderBatch);
             m_entityRenderer.render(renderContext, renderBatch);
@@ -34,6 +34,7 @@ namespace TrenchBroom {
     namespace Renderer {
         class FontManager;
         class RenderBatch;
+        class TextureArrays;
         
         class ObjectRenderer {
         private:
@@ -50,6 +51,7 @@ namespace TrenchBroom {
             void setObjects(const Model::GroupList& groups, const Model::EntityList& entities, const Model::BrushList& brushes);
             void invalidate();
             void invalidateBrushes(const Model::BrushList& brushes);
+            void invalidateEntities();
             void clear();
             void reloadModels();
         public: // configuration
@@ -80,6 +82,7 @@ namespace TrenchBroom {
             void setBrushEdgeColor(const Color& brushEdgeColor);
             
             void setShowHiddenObjects(bool showHiddenObjects);
+            void setTextureArrays(TextureArrays* textureArrays);
         public: // rendering
             void renderOpaque(RenderContext& renderContext, RenderBatch& renderBatch);
             void renderTransparent(RenderContext& renderContext, RenderBatch& renderBatch);
@@ -152,9 +152,24 @@ namespace TrenchBroom {
             }
 
             m_variableCache.clear();
+            m_attributeCache.clear();
             m_needsLinking = false;
         }
 
+        GLuint ShaderProgram::attributeLocation(const String& name) const {
+            assert(checkActive());
+            AttributeVariableCache::iterator it = m_attributeCache.find(name);
+            if (it == std::end(m_attributeCache)) {
+                const GLint index = glGetAttribLocation(m_programId, name.c_str());
+                if (index == -1)
+                    throw RenderException("Location of attribute variable '" + name + "' could not be found in shader program " + m_name);
+                
+                m_attributeCache[name] = index;
+                return static_cast<GLuint>(index);
+            }
+            return static_cast<GLuint>(it->second);
+        }
+
         GLint ShaderProgram::findUniformLocation(const String& name) const {
             UniformVariableCache::iterator it = m_variableCache.find(name);
             if (it == std::end(m_variableCache)) {
@@ -30,7 +30,9 @@ namespace TrenchBroom {
             extern const ShaderConfig VaryingPUniformCShader;
             extern const ShaderConfig MiniMapEdgeShader;
             extern const ShaderConfig EntityModelShader;
+            extern const ShaderConfig EntityModelInstancedShader;
             extern const ShaderConfig FaceShader;
+            extern const ShaderConfig FaceArrayShader;
             extern const ShaderConfig ColoredTextShader;
             extern const ShaderConfig TextBackgroundShader;
             extern const ShaderConfig TextureBrowserShader;
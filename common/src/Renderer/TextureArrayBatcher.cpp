@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TextureArrayBatcher.h"
+
+#include "Ensure.h"
+#include "Assets/Texture.h"
+
+#include <cassert>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        TextureArrayBatcher::Slot::Slot(const size_t i_array, const size_t i_layer) :
+        array(i_array),
+        layer(i_layer) {}
+
+        TextureArrayBatcher::Array::Array(const size_t i_width, const size_t i_height) :
+        width(i_width),
+        height(i_height) {}
+
+        TextureArrayBatcher::Batch::Batch(const size_t i_array) :
+        array(i_array) {}
+
+        TextureArrayBatcher::TextureArrayBatcher(const size_t maxLayers) :
+        m_maxLayers(maxLayers) {
+            assert(m_maxLayers > 0);
+        }
+
+        const TextureArrayBatcher::Slot& TextureArrayBatcher::slot(const Assets::Texture* texture) {
+            ensure(texture != nullptr, "texture is null");
+
+            auto it = m_slots.find(texture);
+            if (it == std::end(m_slots)) {
+                const size_t arrayIndex = findOrCreateArray(texture->width(), texture->height());
+                Array& array = m_arrays[arrayIndex];
+                array.layers.push_back(texture);
+                it = m_slots.insert(std::make_pair(texture, Slot(arrayIndex, array.layers.size() - 1))).first;
+            }
+            return it->second;
+        }
+
+        size_t TextureArrayBatcher::arrayCount() const {
+            return m_arrays.size();
+        }
+
+        const TextureArrayBatcher::Array& TextureArrayBatcher::array(const size_t index) const {
+            assert(index < m_arrays.size());
+            return m_arrays[index];
+        }
+
+        TextureArrayBatcher::Batch::List TextureArrayBatcher::batch(const std::vector<const Assets::Texture*>& textures) {
+            Batch::List result;
+
+            // maps array indices to indices into the result
+            std::unordered_map<size_t, size_t> batchIndices;
+            for (size_t i = 0; i < textures.size(); ++i) {
+                const Assets::Texture* texture = textures[i];
+                if (texture == nullptr) {
+                    continue;
+                }
+
+                const size_t arrayIndex = slot(texture).array;
+                const auto insert = batchIndices.insert(std::make_pair(arrayIndex, result.size()));
+                if (insert.second) {
+                    result.emplace_back(arrayIndex);
+                }
+                result[insert.first->second].indices.push_back(i);
+            }
+
+            return result;
+        }
+
+        void TextureArrayBatcher::clear() {
+            m_arrays.clear();
+            m_slots.clear();
+        }
+
+        size_t TextureArrayBatcher::findOrCreateArray(const size_t width, const size_t height) {
+            // only the most recently created array of a given size can have free layers
+            for (size_t i = m_arrays.size(); i > 0; --i) {
+                const Array& array = m_arrays[i - 1];
+                if (array.width == width && array.height == height) {
+                    if (array.layers.size() < m_maxLayers) {
+                        return i - 1;
+                    }
+                    break;
+                }
+            }
+
+            m_arrays.emplace_back(width, height);
+            return m_arrays.size() - 1;
+        }
+    }
+}
@@ -0,0 +1,99 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_TextureArrayBatcher
+#define TrenchBroom_TextureArrayBatcher
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
+    namespace Renderer {
+        /**
+         * Assigns textures to the layers of array textures and groups textures by the array that contains them. Only
+         * textures of the same size can share an array, and each array holds at most a given number of layers.
+         *
+         * This class does not touch OpenGL, see TextureArrays for the class that creates and fills the array textures.
+         */
+        class TextureArrayBatcher {
+        public:
+            struct Slot {
+                size_t array;
+                size_t layer;
+
+                Slot(size_t i_array, size_t i_layer);
+            };
+
+            struct Array {
+                size_t width;
+                size_t height;
+                std::vector<const Assets::Texture*> layers;
+
+                Array(size_t i_width, size_t i_height);
+            };
+
+            /**
+             * A group of textures that are contained in the same array. The indices refer to the list of textures
+             * that was passed to batch().
+             */
+            struct Batch {
+                using List = std::vector<Batch>;
+
+                size_t array;
+                std::vector<size_t> indices;
+
+                explicit Batch(size_t i_array);
+            };
+        private:
+            size_t m_maxLayers;
+            std::vector<Array> m_arrays;
+            std::unordered_map<const Assets::Texture*, Slot> m_slots;
+        public:
+            explicit TextureArrayBatcher(size_t maxLayers);
+
+            /**
+             * Returns the slot of the given texture, assigning it to the next free layer of an array of the same size
+             * if it has no slot yet. Once assigned, the slot of a texture does not change until clear() is called.
+             */
+            const Slot& slot(const Assets::Texture* texture);
+
+            size_t arrayCount() const;
+            const Array& array(size_t index) const;
+
+            /**
+             * Groups the given textures by their arrays. The batches are ordered by the first texture of each batch
+             * in the given list, and the textures of each batch retain their relative order. Null textures are
+             * skipped.
+             */
+            Batch::List batch(const std::vector<const Assets::Texture*>& textures);
+
+            void clear();
+        private:
+            size_t findOrCreateArray(size_t width, size_t height);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_TextureArrayBatcher) */
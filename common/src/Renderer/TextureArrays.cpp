@@ -0,0 +1,203 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "TextureArrays.h"
+
+#include "MathUtils.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCompression.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        // the minimum number of layers that every implementation of EXT_texture_array must support
+        const size_t TextureArrays::MaxLayers = 64;
+
+        TextureArrays::ArrayTexture::ArrayTexture() :
+        id(0),
+        capacity(0),
+        uploadedLayers(0),
+        maxLevel(0) {}
+
+        TextureArrays::TextureArrays() :
+        m_batcher(MaxLayers),
+        m_support(Support::Unknown) {}
+
+        TextureArrays::~TextureArrays() {
+            clear();
+            commitChanges();
+        }
+
+        bool TextureArrays::supported() {
+            if (m_support == Support::Unknown) {
+                const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+                const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+
+                const bool core = version != nullptr && std::atoi(version) >= 3;
+                const bool extension = extensions != nullptr && std::strstr(extensions, "GL_EXT_texture_array") != nullptr;
+                m_support = (core || extension) ? Support::Supported : Support::Unsupported;
+            }
+            return m_support == Support::Supported;
+        }
+
+        bool TextureArrays::accepts(const Assets::Texture* texture) const {
+            return texture != nullptr && texture->lazy();
+        }
+
+        float TextureArrays::layer(const Assets::Texture* texture) {
+            return static_cast<float>(m_batcher.slot(texture).layer);
+        }
+
+        TextureArrayBatcher::Batch::List TextureArrays::batch(const std::vector<const Assets::Texture*>& textures) {
+            return m_batcher.batch(textures);
+        }
+
+        void TextureArrays::activate(const size_t array) {
+            if (m_arrayTextures.size() < m_batcher.arrayCount()) {
+                m_arrayTextures.resize(m_batcher.arrayCount());
+            }
+
+            const ArrayTexture& arrayTexture = m_arrayTextures[array];
+            const TextureArrayBatcher::Array& layers = m_batcher.array(array);
+            if (arrayTexture.uploadedLayers < layers.layers.size()) {
+                upload(array);
+            }
+
+            // the texture mode may have changed since the layers were copied
+            const Assets::Texture* first = layers.layers.front();
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY, arrayTexture.id));
+            glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, first->minFilter()));
+            glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, first->magFilter()));
+        }
+
+        void TextureArrays::deactivate() {
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY, 0));
+        }
+
+        void TextureArrays::clear() {
+            for (const ArrayTexture& arrayTexture : m_arrayTextures) {
+                if (arrayTexture.id != 0) {
+                    m_toDelete.push_back(arrayTexture.id);
+                }
+            }
+            m_arrayTextures.clear();
+            m_batcher.clear();
+        }
+
+        void TextureArrays::commitChanges() {
+            if (!m_toDelete.empty()) {
+                glAssert(glDeleteTextures(static_cast<GLsizei>(m_toDelete.size()), m_toDelete.data()));
+                m_toDelete.clear();
+            }
+        }
+
+        void TextureArrays::upload(const size_t array) {
+            ArrayTexture& arrayTexture = m_arrayTextures[array];
+            const TextureArrayBatcher::Array& layers = m_batcher.array(array);
+
+            if (layers.layers.size() > arrayTexture.capacity) {
+                // the array is too small, so a larger one is created and all layers are copied again
+                if (arrayTexture.id != 0) {
+                    glAssert(glDeleteTextures(1, &arrayTexture.id));
+                }
+
+                arrayTexture = ArrayTexture();
+                arrayTexture.capacity = std::min(Math::nextPOT(layers.layers.size()), MaxLayers);
+                allocate(arrayTexture, layers);
+            }
+
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY, arrayTexture.id));
+
+            GLint maxLevel = arrayTexture.maxLevel;
+            for (size_t i = arrayTexture.uploadedLayers; i < layers.layers.size(); ++i) {
+                copyLayer(layers, i, maxLevel);
+            }
+
+            // levels that are missing in any of the layers must not be sampled
+            glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, maxLevel));
+
+            arrayTexture.maxLevel = maxLevel;
+            arrayTexture.uploadedLayers = layers.layers.size();
+        }
+
+        void TextureArrays::allocate(ArrayTexture& arrayTexture, const TextureArrayBatcher::Array& array) const {
+            glAssert(glGenTextures(1, &arrayTexture.id));
+            glAssert(glBindTexture(GL_TEXTURE_2D_ARRAY, arrayTexture.id));
+            glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT));
+            glAssert(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT));
+
+            size_t width = array.width;
+            size_t height = array.height;
+            GLint level = 0;
+            while (true) {
+                glAssert(glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA,
+                                      static_cast<GLsizei>(width),
+                                      static_cast<GLsizei>(height),
+                                      static_cast<GLsizei>(arrayTexture.capacity),
+                                      0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr));
+                if (width == 1 && height == 1) {
+                    break;
+                }
+                width = std::max(width / 2, static_cast<size_t>(1));
+                height = std::max(height / 2, static_cast<size_t>(1));
+                ++level;
+            }
+
+            arrayTexture.maxLevel = level;
+        }
+
+        void TextureArrays::copyLayer(const TextureArrayBatcher::Array& array, const size_t layer, GLint& maxLevel) const {
+            const Assets::Texture* texture = array.layers[layer];
+            assert(accepts(texture));
+
+            // the layer is filled from the texture's decoder so that the texture itself need not be read back
+            Assets::TextureBuffer::List buffers = texture->decode();
+            GLenum format = texture->format();
+            if (Assets::isCompressed(format)) {
+                buffers = Assets::decompressMips(buffers, array.width, array.height, format);
+                format = GL_RGBA;
+            }
+
+            glAssert(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+            GLint level = 0;
+            while (level <= maxLevel && static_cast<size_t>(level) < buffers.size()) {
+                const size_t width = array.width >> level;
+                const size_t height = array.height >> level;
+                if (width == 0 || height == 0) {
+                    break;
+                }
+
+                glAssert(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, static_cast<GLint>(layer),
+                                         static_cast<GLsizei>(width),
+                                         static_cast<GLsizei>(height),
+                                         1, format, GL_UNSIGNED_BYTE, buffers[static_cast<size_t>(level)].ptr()));
+                ++level;
+            }
+
+            // levels that this texture does not have must not be sampled from any layer
+            maxLevel = std::min(maxLevel, level - 1);
+        }
+    }
+}
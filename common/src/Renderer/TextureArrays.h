@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef TrenchBroom_TextureArrays
+#define TrenchBroom_TextureArrays
+
+#include "Renderer/GL.h"
+#include "Renderer/TextureArrayBatcher.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class Texture;
+    }
+
+    namespace Renderer {
+        /**
+         * Copies textures of the same size into the layers of array textures so that all faces whose textures share
+         * an array can be rendered with a single draw call. The layers are assigned by a TextureArrayBatcher when a
+         * texture is first requested and are filled from the texture's decoder when the array is activated. Only
+         * lazy textures can be decoded again after they were uploaded, so other textures are not put into arrays.
+         */
+        class TextureArrays {
+        private:
+            static const size_t MaxLayers;
+
+            struct ArrayTexture {
+                GLuint id;
+                size_t capacity;
+                size_t uploadedLayers;
+                GLint maxLevel;
+
+                ArrayTexture();
+            };
+
+            TextureArrayBatcher m_batcher;
+            std::vector<ArrayTexture> m_arrayTextures;
+            std::vector<GLuint> m_toDelete;
+
+            enum class Support {
+                Unknown,
+                Supported,
+                Unsupported
+            };
+            Support m_support;
+        public:
+            TextureArrays();
+            ~TextureArrays();
+
+            /**
+             * Indicates whether array textures are supported by the current OpenGL context. Must only be called
+             * while the context is current.
+             */
+            bool supported();
+
+            /**
+             * Indicates whether the given texture can be put into an array.
+             */
+            bool accepts(const Assets::Texture* texture) const;
+
+            /**
+             * Returns the layer of the array that contains the given texture.
+             */
+            float layer(const Assets::Texture* texture);
+
+            /**
+             * Groups the given textures by the arrays that contain them, see TextureArrayBatcher::batch.
+             */
+            TextureArrayBatcher::Batch::List batch(const std::vector<const Assets::Texture*>& textures);
+
+            /**
+             * Binds the array with the given index, decoding any textures that were added to it since it was last
+             * activated into their layers.
+             */
+            void activate(size_t array);
+            void deactivate();
+
+            /**
+             * Forgets all arrays and the layers of all textures. Must be called when textures are removed since their
+             * addresses may be reused. The array textures are deleted by the next call to commitChanges, so this can
+             * be called while the context is not current.
+             */
+            void clear();
+            
+            /**
+             * Deletes the array textures that were dropped by clear. Must only be called while the context is current.
+             */
+            void commitChanges();
+        private:
+            void upload(size_t array);
+            void allocate(ArrayTexture& arrayTexture, const TextureArrayBatcher::Array& array) const;
+            void copyLayer(const TextureArrayBatcher::Array& array, size_t layer, GLint& maxLevel) const;
+        private:
+            TextureArrays(const TextureArrays& other);
+            TextureArrays& operator=(const TextureArrays& other);
+        };
+    }
+}
+
+#endif /* defined(TrenchBroom_TextureArrays) */
@@ -21,6 +21,7 @@
 
 #include "CollectionUtils.h"
 #include "Renderer/RenderUtils.h"
+#include "Renderer/Transformation.h"
 
 namespace TrenchBroom {
     namespace Renderer {
@@ -86,6 +87,13 @@ namespace TrenchBroom {
             current.add(primType, index, count);
         }
 
+        TexturedIndexRangeMap TexturedIndexRangeMap::offset(const size_t offset) const {
+            TexturedIndexRangeMap result;
+            for (const auto& entry : *m_data)
+                result.m_data->insert(std::make_pair(entry.first, entry.second.offset(offset)));
+            return result;
+        }
+
         void TexturedIndexRangeMap::render(VertexArray& vertexArray) {
             DefaultTextureRenderFunc func;
             render(vertexArray, func);
@@ -102,6 +110,41 @@ namespace TrenchBroom {
             }
         }
 
+        void TexturedIndexRangeMap::render(Transformation& transformation, const Mat4x4f::List& modelMatrices) {
+            DefaultTextureRenderFunc func;
+            render(transformation, modelMatrices, func);
+        }
+        
+        void TexturedIndexRangeMap::render(Transformation& transformation, const Mat4x4f::List& modelMatrices, TextureRenderFunc& func) {
+            for (const auto& entry : *m_data) {
+                const Texture* texture = entry.first;
+                const IndexRangeMap& indexArray = entry.second;
+
+                func.before(texture);
+                for (const Mat4x4f& modelMatrix : modelMatrices) {
+                    MultiplyModelMatrix multMatrix(transformation, modelMatrix);
+                    indexArray.render();
+                }
+                func.after(texture);
+            }
+        }
+        
+        void TexturedIndexRangeMap::render(const size_t instanceCount) {
+            DefaultTextureRenderFunc func;
+            render(instanceCount, func);
+        }
+        
+        void TexturedIndexRangeMap::render(const size_t instanceCount, TextureRenderFunc& func) {
+            for (const auto& entry : *m_data) {
+                const Texture* texture = entry.first;
+                const IndexRangeMap& indexArray = entry.second;
+                
+                func.before(texture);
+                indexArray.render(instanceCount);
+                func.after(texture);
+            }
+        }
+
         IndexRangeMap& TexturedIndexRangeMap::findCurrent(const Texture* texture) {
             if (!isCurrent(texture))
                 m_current = m_data->find(texture);
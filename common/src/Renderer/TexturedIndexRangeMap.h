@@ -21,6 +21,7 @@
 #define TexturedIndexRangeMap_h
 
 #include "SharedPointer.h"
+#include "VecMath.h"
 #include "Renderer/IndexRangeMap.h"
 
 #include <map>
@@ -32,6 +33,7 @@ namespace TrenchBroom {
     
     namespace Renderer {
         class TextureRenderFunc;
+        class Transformation;
         class VertexArray;
         
         class TexturedIndexRangeMap {
@@ -68,8 +70,27 @@ namespace TrenchBroom {
 
             void add(const Texture* texture, PrimType primType, size_t index, size_t count);
             
+            /**
+             * Returns a copy of this map where every index is increased by the given offset.
+             */
+            TexturedIndexRangeMap offset(size_t offset) const;
+            
             void render(VertexArray& vertexArray);
             void render(VertexArray& vertexArray, TextureRenderFunc& func);
+            
+            /**
+             * Renders the primitives once for each of the given model matrices, using the vertex attributes that are
+             * currently set up. Each texture is activated only once for all instances.
+             */
+            void render(Transformation& transformation, const Mat4x4f::List& modelMatrices);
+            void render(Transformation& transformation, const Mat4x4f::List& modelMatrices, TextureRenderFunc& func);
+            
+            /**
+             * Renders the given number of instances of the primitives with one instanced draw call per range, using
+             * the vertex attributes that are currently set up. The per instance attributes must be set up, too.
+             */
+            void render(size_t instanceCount);
+            void render(size_t instanceCount, TextureRenderFunc& func);
         private:
             IndexRangeMap& findCurrent(const Texture* texture);
             bool isCurrent(const Texture* texture) const;
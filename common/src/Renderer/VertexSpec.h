@@ -176,6 +176,7 @@ namespace TrenchBroom {
             typedef VertexSpec3<AttributeSpecs::P3, AttributeSpecs::N, AttributeSpecs::C4> P3NC4;
             typedef VertexSpec3<AttributeSpecs::P3, AttributeSpecs::T02, AttributeSpecs::C4> P3T2C4;
             typedef VertexSpec3<AttributeSpecs::P3, AttributeSpecs::N, AttributeSpecs::T02> P3NT2;
+            typedef VertexSpec1<AttributeSpecs::T11> T1;
         }
     }
 }
@@ -19,33 +19,74 @@
 
 #include "Autosaver.h"
 
+#include "Logger.h"
 #include "StringUtils.h"
-#include "TemporarilySetAny.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/IOUtils.h"
+#include "IO/MapSnapshot.h"
+#include "IO/OutputBuffer.h"
+#include "Model/Game.h"
 #include "View/MapDocument.h"
 
 #include <cassert>
+#include <chrono>
+#include <vector>
+
+#include <wx/string.h>
 
 namespace TrenchBroom {
     namespace View {
+        /**
+         * Records the messages logged while a backup is written on the background thread so that they can be passed
+         * on to the actual logger on the main thread.
+         */
+        class Autosaver::BackupLogger : public Logger {
+        private:
+            typedef std::pair<LogLevel, String> Message;
+            typedef std::vector<Message> MessageList;
+            
+            MessageList m_messages;
+        public:
+            void replay(Logger* logger) {
+                if (logger != nullptr) {
+                    for (const Message& message : m_messages)
+                        logger->log(message.first, message.second);
+                }
+                m_messages.clear();
+            }
+        private:
+            void doLog(const LogLevel level, const String& message) override {
+                m_messages.push_back(std::make_pair(level, message));
+            }
+            
+            void doLog(const LogLevel level, const wxString& message) override {
+                doLog(level, message.ToStdString());
+            }
+        };
+        
         Autosaver::Autosaver(View::MapDocumentWPtr document, const time_t saveInterval, const time_t idleInterval, const size_t maxBackups) :
         m_document(document),
-        m_logger(nullptr),
         m_saveInterval(saveInterval),
         m_idleInterval(idleInterval),
         m_maxBackups(maxBackups),
         m_lastSaveTime(time(nullptr)),
         m_lastModificationTime(0),
-        m_lastModificationCount(lock(m_document)->modificationCount()) {
+        m_lastModificationCount(lock(m_document)->modificationCount()),
+        m_backupLogger(new BackupLogger()) {
             bindObservers();
         }
         
         Autosaver::~Autosaver() {
             unbindObservers();
+            finishPendingBackup(nullptr, true);
             triggerAutosave(nullptr);
+            finishPendingBackup(nullptr, true);
         }
         
         void Autosaver::triggerAutosave(Logger* logger) {
+            if (!finishPendingBackup(logger, false))
+                return;
+            
             const time_t currentTime = time(nullptr);
             
             MapDocumentSPtr document = lock(m_document);
@@ -64,22 +105,60 @@ namespace TrenchBroom {
             if (!IO::Disk::fileExists(IO::Disk::fixPath(document->path())))
                 return;
             
-            TemporarilySetAny<Logger*> setLogger(m_logger, logger);
             autosave(document);
         }
         
+        /**
+         * Passes on the messages of a finished backup to the given logger. If wait is true, this blocks until the
+         * pending backup has been written. Returns true if no backup is being written anymore.
+         */
+        bool Autosaver::finishPendingBackup(Logger* logger, const bool wait) {
+            if (!m_pendingBackup.valid())
+                return true;
+            if (!wait && m_pendingBackup.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                return false;
+            
+            try {
+                m_pendingBackup.get();
+            } catch (const std::exception& e) {
+                m_backupLogger->error("Autosave failed: %s", e.what());
+            }
+            m_backupLogger->replay(logger);
+            return true;
+        }
+        
         void Autosaver::autosave(MapDocumentSPtr document) {
-            const IO::Path& mapPath = document->path();
+            const IO::Path mapPath = document->path();
             assert(IO::Disk::fileExists(IO::Disk::fixPath(mapPath)));
             
+            // the snapshot only copies the attributes and faces, so the document can be modified while the backup is
+            // being formatted and written
+            std::shared_ptr<IO::MapSnapshot> snapshot(new IO::MapSnapshot(document->world()));
+            Model::GameSPtr game = document->game();
+            
+            m_lastSaveTime = time(nullptr);
+            m_lastModificationCount = document->modificationCount();
+            
+            m_pendingBackup = std::async(std::launch::async, [this, mapPath, game, snapshot]() {
+                writeBackup(mapPath, game, *snapshot, *m_backupLogger);
+            });
+        }
+        
+        void Autosaver::writeBackup(const IO::Path& mapPath, Model::GameSPtr game, const IO::MapSnapshot& snapshot, Logger& logger) const {
+            IO::OutputBuffer buffer;
+            game->writeMap(snapshot, buffer);
+            writeBackup(mapPath, buffer, logger);
+        }
+        
+        void Autosaver::writeBackup(const IO::Path& mapPath, IO::OutputBuffer& buffer, Logger& logger) const {
             const IO::Path mapFilename = mapPath.lastComponent();
             const IO::Path mapBasename = mapFilename.deleteExtension();
             
             try {
-                IO::WritableDiskFileSystem fs = createBackupFileSystem(mapPath);
+                IO::WritableDiskFileSystem fs = createBackupFileSystem(mapPath, logger);
                 IO::Path::List backups = collectBackups(fs, mapBasename);
                 
-                thinBackups(fs, backups);
+                thinBackups(fs, backups, logger);
                 cleanBackups(fs, backups, mapBasename);
 
                 assert(backups.size() < m_maxBackups);
@@ -87,20 +166,16 @@ namespace TrenchBroom {
                 
                 const IO::Path backupFilePath = fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
 
-                m_lastSaveTime = time(nullptr);
-                m_lastModificationCount = document->modificationCount();
-                document->saveDocumentTo(backupFilePath);
-                
-                if (m_logger != nullptr)
-                    m_logger->info("Created autosave backup at %s", backupFilePath.asString().c_str());
+                IO::OpenFile open(backupFilePath, true);
+                buffer.writeTo(open.file);
                 
+                logger.info("Created autosave backup at %s", backupFilePath.asString().c_str());
             } catch (FileSystemException e) {
-                if (m_logger != nullptr)
-                    m_logger->error("Aborting autosave");
+                logger.error("Aborting autosave");
             }
         }
         
-        IO::WritableDiskFileSystem Autosaver::createBackupFileSystem(const IO::Path& mapPath) const {
+        IO::WritableDiskFileSystem Autosaver::createBackupFileSystem(const IO::Path& mapPath, Logger& logger) const {
             const IO::Path basePath = mapPath.deleteLastComponent();
             const IO::Path autosavePath = basePath + IO::Path("autosave");
 
@@ -108,8 +183,7 @@ namespace TrenchBroom {
                 // ensures that the directory exists or is created if it doesn't
                 return IO::WritableDiskFileSystem(autosavePath, true);
             } catch (FileSystemException e) {
-                if (m_logger != nullptr)
-                    m_logger->error("Cannot create autosave directory at %s", autosavePath.asString().c_str());
+                logger.error("Cannot create autosave directory at %s", autosavePath.asString().c_str());
                 throw e;
             }
         }
@@ -148,17 +222,15 @@ namespace TrenchBroom {
             return backups;
         }
         
-        void Autosaver::thinBackups(IO::WritableDiskFileSystem& fs, IO::Path::List& backups) const {
+        void Autosaver::thinBackups(IO::WritableDiskFileSystem& fs, IO::Path::List& backups, Logger& logger) const {
             while (backups.size() > m_maxBackups - 1) {
                 const IO::Path filename = backups.front();
                 try {
                     fs.deleteFile(filename);
-                    if (m_logger != nullptr)
-                        m_logger->debug("Deleted autosave backup %s", filename.asString().c_str());
+                    logger.debug("Deleted autosave backup %s", filename.asString().c_str());
                     backups.erase(std::begin(backups));
                 } catch (FileSystemException e) {
-                    if (m_logger != nullptr)
-                        m_logger->error("Cannot delete autosave backup %s", filename.asString().c_str());
+                    logger.error("Cannot delete autosave backup %s", filename.asString().c_str());
                     throw e;
                 }
             }
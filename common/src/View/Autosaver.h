@@ -21,24 +21,37 @@
 #define TrenchBroom_Autosaver
 
 #include "IO/Path.h"
+#include "Model/ModelTypes.h"
 #include "View/ViewTypes.h"
 
 #include <ctime>
+#include <future>
+#include <memory>
 
 namespace TrenchBroom {
     class Logger;
     
     namespace IO {
+        class MapSnapshot;
+        class OutputBuffer;
         class WritableDiskFileSystem;
     }
     
     namespace View {
         class Command;
         
+        /**
+         * Periodically saves a backup of the document. Only a snapshot of the entity attributes and brush faces is
+         * taken on the calling thread. The snapshot is serialized, and the backup files are rotated and written, on a
+         * background thread so that the editor does not stall while the map is formatted or the disk is busy. Messages
+         * produced by the background thread are passed on to the logger the next time that triggerAutosave is called
+         * after the backup has been written.
+         */
         class Autosaver {
         private:
+            class BackupLogger;
+            
             View::MapDocumentWPtr m_document;
-            Logger* m_logger;
             
             time_t m_saveInterval;
             time_t m_idleInterval;
@@ -47,17 +60,23 @@ namespace TrenchBroom {
             time_t m_lastSaveTime;
             time_t m_lastModificationTime;
             size_t m_lastModificationCount;
+            
+            std::unique_ptr<BackupLogger> m_backupLogger;
+            std::future<void> m_pendingBackup;
         public:
             Autosaver(View::MapDocumentWPtr document, time_t saveInterval = 10 * 60, time_t idleInterval = 3, size_t maxBackups = 50);
             ~Autosaver();
             
             void triggerAutosave(Logger* logger);
         private:
+            bool finishPendingBackup(Logger* logger, bool wait);
             void autosave(View::MapDocumentSPtr document);
-            IO::WritableDiskFileSystem createBackupFileSystem(const IO::Path& mapPath) const;
+            void writeBackup(const IO::Path& mapPath, Model::GameSPtr game, const IO::MapSnapshot& snapshot, Logger& logger) const;
+            void writeBackup(const IO::Path& mapPath, IO::OutputBuffer& buffer, Logger& logger) const;
+            IO::WritableDiskFileSystem createBackupFileSystem(const IO::Path& mapPath, Logger& logger) const;
             IO::Path::List collectBackups(const IO::WritableDiskFileSystem& fs, const IO::Path& mapBasename) const;
             bool isBackup(const IO::Path& backupPath, const IO::Path& mapBasename) const;
-            void thinBackups(IO::WritableDiskFileSystem& fs, IO::Path::List& backups) const;
+            void thinBackups(IO::WritableDiskFileSystem& fs, IO::Path::List& backups, Logger& logger) const;
             void cleanBackups(IO::WritableDiskFileSystem& fs, IO::Path::List& backups, const IO::Path& mapBasename) const;
             IO::Path makeBackupName(const IO::Path& mapBasename, const size_t index) const;
         private:
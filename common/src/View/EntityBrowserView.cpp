@@ -33,7 +33,7 @@
 #include "Renderer/Shaders.h"
 #include "Renderer/TextureFont.h"
 #include "Renderer/Transformation.h"
-#include "Renderer/TexturedIndexRangeRenderer.h"
+#include "Renderer/EntityModelMesh.h"
 #include "Renderer/Vertex.h"
 #include "Renderer/VertexArray.h"
 #include "View/MapFrame.h"
@@ -290,6 +290,10 @@ namespace TrenchBroom {
             Renderer::ActivateVbo activate(vertexVbo());
             m_entityModelManager.prepare(vertexVbo());
             
+            Renderer::EntityModelVertexArray& vertexArray = m_entityModelManager.vertexArray();
+            if (!vertexArray.setupVertices())
+                return;
+            
             for (size_t i = 0; i < layout.size(); ++i) {
                 const Layout::Group& group = layout[i];
                 if (group.intersectsY(y, height)) {
@@ -302,14 +306,15 @@ namespace TrenchBroom {
                                 
                                 if (modelRenderer != nullptr) {
                                     const Mat4x4f itemTrans = itemTransformation(cell, y, height);
-                                    Renderer::MultiplyModelMatrix multMatrix(transformation, itemTrans);
-                                    modelRenderer->render();
+                                    modelRenderer->render(transformation, Mat4x4f::List(1, itemTrans));
                                 }
                             }
                         }
                     }
                 }
             }
+            
+            vertexArray.cleanupVertices();
         }
 
         void EntityBrowserView::renderNames(Layout& layout, const float y, const float height, const Mat4x4f& projection) {
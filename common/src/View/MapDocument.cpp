@@ -19,6 +19,7 @@
 
 #include "View/MapDocument.h"
 
+#include "ParallelUtils.h"
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Polyhedron.h"
@@ -37,16 +38,17 @@
 #include "Model/BrushGeometry.h"
 #include "Model/ChangeBrushFaceAttributesRequest.h"
 #include "Model/CollectAttributableNodesVisitor.h"
-#include "Model/CollectContainedNodesVisitor.h"
 #include "Model/CollectMatchingBrushFacesVisitor.h"
 #include "Model/CollectNodesVisitor.h"
 #include "Model/CollectNodesByVisibilityVisitor.h"
 #include "Model/CollectSelectableNodesVisitor.h"
 #include "Model/CollectSelectableNodesWithFilePositionVisitor.h"
 #include "Model/CollectSelectedNodesVisitor.h"
-#include "Model/CollectTouchingNodesVisitor.h"
+#include "Model/CollectTouchingNodes.h"
 #include "Model/CollectUniqueNodesVisitor.h"
 #include "Model/ComputeNodeBoundsVisitor.h"
+#include "Model/ConvexMerge.h"
+#include "Model/CsgSubtract.h"
 #include "Model/EditorContext.h"
 #include "Model/EmptyAttributeNameIssueGenerator.h"
 #include "Model/EmptyAttributeValueIssueGenerator.h"
@@ -59,6 +61,7 @@
 #include "Model/Game.h"
 #include "Model/GameFactory.h"
 #include "Model/Group.h"
+#include "Model/HitFilter.h"
 #include "Model/LongAttributeNameIssueGenerator.h"
 #include "Model/LongAttributeValueIssueGenerator.h"
 #include "Model/MergeNodesIntoWorldVisitor.h"
@@ -136,6 +139,7 @@ namespace TrenchBroom {
         m_lastSelectionBounds(0.0, 32.0),
         m_selectionBoundsValid(true),
         m_viewEffectsService(nullptr) {
+            m_textureManager->setCompressTextures(pref(Preferences::TextureCompression));
             bindObservers();
         }
         
@@ -492,10 +496,7 @@ namespace TrenchBroom {
         void MapDocument::selectTouching(const bool del) {
             const Model::BrushList& brushes = m_selectedNodes.brushes();
             
-            Model::CollectTouchingNodesVisitor<Model::BrushList::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
-            m_world->acceptAndRecurse(visitor);
-            
-            const Model::NodeList nodes = visitor.nodes();
+            const Model::NodeList nodes = Model::collectTouchingNodes(m_world, brushes, editorContext());
             
             Transaction transaction(this, "Select Touching");
             if (del)
@@ -508,10 +509,7 @@ namespace TrenchBroom {
         void MapDocument::selectInside(const bool del) {
             const Model::BrushList& brushes = m_selectedNodes.brushes();
 
-            Model::CollectContainedNodesVisitor<Model::BrushList::const_iterator> visitor(std::begin(brushes), std::end(brushes), editorContext());
-            m_world->acceptAndRecurse(visitor);
-            
-            const Model::NodeList nodes = visitor.nodes();
+            const Model::NodeList nodes = Model::collectContainedNodes(m_world, brushes, editorContext());
 
             Transaction transaction(this, "Select Inside");
             if (del)
@@ -947,19 +945,12 @@ namespace TrenchBroom {
             if (!hasSelectedBrushFaces() && !selectedNodes().hasOnlyBrushes())
                 return false;
             
-            Polyhedron3 polyhedron;
+            const String operation("CSG Convex Merge");
+            const auto progress = [this, &operation](const double fraction) {
+                operationProgressNotifier(operation, fraction);
+            };
             
-            if (hasSelectedBrushFaces()) {
-                for (const Model::BrushFace* face : selectedBrushFaces()) {
-                    for (const Model::BrushVertex* vertex : face->vertices())
-                        polyhedron.addPoint(vertex->position());
-                }
-            } else if (selectedNodes().hasOnlyBrushes()) {
-                for (const Model::Brush* brush : selectedNodes().brushes()) {
-                    for (const Model::BrushVertex* vertex : brush->vertices())
-                        polyhedron.addPoint(vertex->position());
-                }
-            }
+            const Polyhedron3 polyhedron = hasSelectedBrushFaces() ? Model::convexMerge(selectedBrushFaces(), progress) : Model::convexMerge(selectedNodes().brushes(), progress);
             
             if (!polyhedron.polyhedron() || !polyhedron.closed())
                 return false;
@@ -995,17 +986,12 @@ namespace TrenchBroom {
             const Model::BrushList minuends(std::begin(brushes), std::end(brushes) - 1);
             Model::Brush* subtrahend = brushes.back();
             
-            Model::ParentChildrenMap toAdd;
+            const Model::CsgSubtract subtraction(minuends, subtrahend);
+            const Model::ParentChildrenMap toAdd = subtraction.createBrushes(*m_world, m_worldBounds, currentTextureName());
+            
             Model::NodeList toRemove;
             toRemove.push_back(subtrahend);
-            
-            for (Model::Brush* minuend : minuends) {
-                const Model::BrushList result = minuend->subtract(*m_world, m_worldBounds, currentTextureName(), subtrahend);
-                if (!result.empty()) {
-                    VectorUtils::append(toAdd[minuend->parent()], result);
-                    toRemove.push_back(minuend);
-                }
-            }
+            VectorUtils::append(toRemove, subtraction.subtractedBrushes());
             
             Transaction transaction(this, "CSG Subtract");
             deselectAll();
@@ -1057,21 +1043,43 @@ namespace TrenchBroom {
                 return false;
             }
             
+            // shrinking clones the faces of the brushes along with their textures, which must not happen on several
+            // threads at once
+            Model::BrushList shrunkenBrushes(brushes.size(), nullptr);
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                // make an shrunken copy of brush
+                Model::Brush* shrunken = brushes[i]->clone(m_worldBounds);
+                if (shrunken->expand(m_worldBounds, -1.0 * static_cast<FloatType>(m_grid->actualSize()), true)) {
+                    shrunkenBrushes[i] = shrunken;
+                } else {
+                    delete shrunken;
+                }
+            }
+            
+            // the subtractions only read the geometry of the brushes, so they can run in parallel
+            const String operation("CSG Hollow");
+            std::vector<Model::BrushGeometry::SubtractResult> fragments(brushes.size());
+            ParallelUtils::parallelFor(brushes.size(), [&brushes, &shrunkenBrushes, &fragments](const size_t i) {
+                if (shrunkenBrushes[i] != nullptr)
+                    fragments[i] = brushes[i]->subtractGeometry(shrunkenBrushes[i]);
+            }, [this, &operation, &brushes](const size_t processed) {
+                operationProgressNotifier(operation, static_cast<double>(processed) / static_cast<double>(brushes.size()));
+            });
+            
             Model::ParentChildrenMap toAdd;
             Model::NodeList toRemove;
             
-            for (Model::Brush* brush : brushes) {
-                // make an shrunken copy of brush
-                Model::Brush* shrunken = brush->clone(m_worldBounds);
-                if (shrunken->expand(m_worldBounds, -1.0 * static_cast<FloatType>(m_grid->actualSize()), true)) {
-                    // shrinking gave us a valid brush, so subtract it from `brush`
-                    const Model::BrushList fragments = brush->subtract(*m_world, m_worldBounds, currentTextureName(), shrunken);
-                    
-                    VectorUtils::append(toAdd[brush->parent()], fragments);
+            for (size_t i = 0; i < brushes.size(); ++i) {
+                Model::Brush* brush = brushes[i];
+                Model::Brush* shrunken = shrunkenBrushes[i];
+                if (shrunken != nullptr) {
+                    // shrinking gave us a valid brush, so replace `brush` by what remains after subtracting it
+                    Model::NodeList& children = toAdd[brush->parent()];
+                    for (const Model::BrushGeometry& geometry : fragments[i])
+                        children.push_back(brush->createBrush(*m_world, m_worldBounds, currentTextureName(), geometry, shrunken));
                     toRemove.push_back(brush);
+                    delete shrunken;
                 }
-                
-                delete shrunken;
             }
 
             Transaction transaction(this, "CSG Hollow");
@@ -1328,6 +1336,31 @@ namespace TrenchBroom {
                 m_world->pick(pickRay, pickResult);
         }
         
+        void MapDocument::pickClosest(const Ray3& pickRay, Model::PickResult& pickResult) const {
+            if (m_world == nullptr)
+                return;
+            
+            const Model::HitFilterChain stop(new Model::ContextHitFilter(*m_editorContext), new Model::TypedHitFilter(Model::Brush::BrushHit));
+            const FloatType closest = m_world->pickClosest(pickRay, stop, pickResult);
+            
+            Model::PickResult selectedHits;
+            for (const Model::Node* node : m_selectedNodes)
+                node->pick(pickRay, selectedHits);
+            
+            Model::BrushSet brushes;
+            for (const Model::BrushFace* face : m_selectedBrushFaces) {
+                if (brushes.insert(face->brush()).second)
+                    face->brush()->pick(pickRay, selectedHits);
+            }
+            
+            // the hits up to the closest distance have already been added
+            const Model::SelectionHitFilter selected;
+            for (const Model::Hit& hit : selectedHits.all()) {
+                if (hit.distance() > closest && selected.matches(hit))
+                    pickResult.addHit(hit);
+            }
+        }
+        
         Model::NodeList MapDocument::findNodesContaining(const Vec3& point) const {
             Model::NodeList result;
             if (m_world != nullptr)
@@ -1438,6 +1471,7 @@ namespace TrenchBroom {
         
         void MapDocument::loadEntityModels() {
             m_entityModelManager->setLoader(m_game.get());
+            preloadEntityModels();
         }
         
         void MapDocument::unloadEntityModels() {
@@ -1517,11 +1551,48 @@ namespace TrenchBroom {
             clearEntityModels();
             loadEntityDefinitions();
             setEntityDefinitions();
+            preloadEntityModels();
         }
 
         void MapDocument::clearEntityModels() {
             m_entityModelManager->clear();
         }
+
+        class CollectEntityModelPaths : public Model::NodeVisitor {
+        private:
+            IO::Path::List m_paths;
+        public:
+            const IO::Path::List& paths() const {
+                return m_paths;
+            }
+        private:
+            void doVisit(Model::World* world) override   {}
+            void doVisit(Model::Layer* layer) override   {}
+            void doVisit(Model::Group* group) override   {}
+            void doVisit(Model::Entity* entity) override { m_paths.push_back(entity->modelSpecification().path); }
+            void doVisit(Model::Brush* brush) override   {}
+        };
+        
+        void MapDocument::preloadEntityModels() {
+            CollectEntityModelPaths visitor;
+            m_world->acceptAndRecurse(visitor);
+            m_entityModelManager->loadModels(visitor.paths());
+        }
+
+        void MapDocument::collectEntityModels() {
+            if (m_entityModelManager->collectLoadedModels())
+                entityModelsWereLoadedNotifier();
+        }
+
+        void MapDocument::collectTextureCollections() {
+            if (m_textureManager->collectLoadedCollections()) {
+                const Model::NodeList nodes(1, m_world);
+                Notifier1<const Model::NodeList&>::NotifyBeforeAndAfter notifyNodes(nodesWillChangeNotifier, nodesDidChangeNotifier, nodes);
+                Notifier0::NotifyAfter notifyTextureCollections(textureCollectionsDidChangeNotifier);
+                
+                setTextures();
+            }
+        }
         
         class SetTextures : public Model::NodeVisitor {
         private:
@@ -1591,10 +1662,27 @@ namespace TrenchBroom {
         }
         
         void MapDocument::updateGameSearchPaths() {
+            // the background texture loads may read from the game file system
+            m_textureManager->finishLoading();
+
             const IO::Path::List additionalSearchPaths = IO::Path::asPaths(mods());
             m_game->setAdditionalSearchPaths(additionalSearchPaths, this);
         }
         
+        void MapDocument::setGamePath(const IO::Path& gamePath) {
+            // the background model and texture loads read from the game file system, so they must be finished before it
+            // is replaced
+            clearEntityModels();
+            unloadTextures();
+            m_game->setGamePath(gamePath, this);
+            preloadEntityModels();
+            
+            loadTextures();
+            setTextures();
+            
+            //reloadIssues();
+        }
+        
         StringList MapDocument::mods() const {
             return m_game->extractEnabledMods(m_world);
         }
@@ -1693,19 +1781,14 @@ namespace TrenchBroom {
             if (isGamePathPreference(path)) {
                 const Model::GameFactory& gameFactory = Model::GameFactory::instance();
                 const IO::Path newGamePath = gameFactory.gamePath(m_game->gameName());
-                m_game->setGamePath(newGamePath, this);
-                
-                clearEntityModels();
-                
-                unsetTextures();
-                loadTextures();
-                setTextures();
-                
-                //reloadIssues();
+                setGamePath(newGamePath);
             } else if (path == Preferences::TextureMinFilter.path() ||
                        path == Preferences::TextureMagFilter.path()) {
                 m_entityModelManager->setTextureMode(pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
                 m_textureManager->setTextureMode(pref(Preferences::TextureMinFilter), pref(Preferences::TextureMagFilter));
+            } else if (path == Preferences::TextureCompression.path()) {
+                m_textureManager->setCompressTextures(pref(Preferences::TextureCompression));
+                reloadTextureCollections();
             }
         }
 
@@ -137,6 +137,7 @@ namespace TrenchBroom {
             
             Notifier0 textureCollectionsDidChangeNotifier;
             Notifier0 entityDefinitionsDidChangeNotifier;
+            Notifier0 entityModelsWereLoadedNotifier;
             Notifier0 modsDidChangeNotifier;
             
             Notifier0 pointFileWasLoadedNotifier;
@@ -144,6 +145,9 @@ namespace TrenchBroom {
             
             Notifier0 portalFileWasLoadedNotifier;
             Notifier0 portalFileWasUnloadedNotifier;
+            
+            // reports the name of a long running operation and the fraction of it that is done
+            Notifier2<const String&, double> operationProgressNotifier;
         protected:
             MapDocument();
         public:
@@ -371,6 +375,13 @@ namespace TrenchBroom {
             void commitPendingAssets();
         public: // picking
             void pick(const Ray3& pickRay, Model::PickResult& pickResult) const;
+            
+            /**
+             * Picks like pick, but the search along the ray ends at the closest brush that can be picked, so the pick
+             * result does not contain the hits of unselected objects behind it. Since tools look for selected objects
+             * that are occluded by other objects, all hits of selected objects and faces are still added.
+             */
+            void pickClosest(const Ray3& pickRay, Model::PickResult& pickResult) const;
             Model::NodeList findNodesContaining(const Vec3& point) const;
         private: // world management
             void createWorld(Model::MapFormat::Type mapFormat, const BBox3& worldBounds, Model::GameSPtr game);
@@ -386,6 +397,18 @@ namespace TrenchBroom {
             IO::Path::List availableTextureCollections() const;
             void setEnabledTextureCollections(const IO::Path::List& paths);
             void reloadTextureCollections();
+
+            /**
+             * Takes over the entity models that were loaded in the background and notifies the observers if there
+             * were any. Must be called periodically on the main thread.
+             */
+            void collectEntityModels();
+
+            /**
+             * Takes over the texture collections that were loaded in the background, assigns their textures to the
+             * faces and notifies the observers if there were any. Must be called periodically on the main thread.
+             */
+            void collectTextureCollections();
         private:
             void loadAssets();
             void unloadAssets();
@@ -407,6 +430,7 @@ namespace TrenchBroom {
             void reloadEntityDefinitions();
             
             void clearEntityModels();
+            void preloadEntityModels();
 
             void setTextures();
             void setTextures(const Model::NodeList& nodes);
@@ -418,6 +442,11 @@ namespace TrenchBroom {
             IO::Path::List externalSearchPaths() const;
             void updateGameSearchPaths();
         public:
+            /**
+             * Sets the game path and reloads the entity models and textures, which are loaded from the game file system.
+             */
+            void setGamePath(const IO::Path& gamePath);
+            
             StringList mods() const override;
             void setMods(const StringList& mods) override;
             String defaultMod() const;
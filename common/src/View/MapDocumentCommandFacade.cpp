@@ -887,6 +887,7 @@ namespace TrenchBroom {
             
             updateGameSearchPaths();
             setEntityDefinitions();
+            preloadEntityModels();
         }
 
         void MapDocumentCommandFacade::doSetIssueHidden(Model::Issue* issue, const bool hidden) {
@@ -85,6 +85,7 @@ namespace TrenchBroom {
         m_frameManager(nullptr),
         m_autosaver(nullptr),
         m_autosaveTimer(nullptr),
+        m_assetTimer(nullptr),
         m_contextManager(nullptr),
         m_mapView(nullptr),
         m_console(nullptr),
@@ -99,6 +100,7 @@ namespace TrenchBroom {
         m_frameManager(nullptr),
         m_autosaver(nullptr),
         m_autosaveTimer(nullptr),
+        m_assetTimer(nullptr),
         m_contextManager(nullptr),
         m_mapView(nullptr),
         m_console(nullptr),
@@ -128,9 +130,13 @@ namespace TrenchBroom {
             m_document->setParentLogger(logger());
             m_document->setViewEffectsService(m_mapView);
 
-            m_autosaveTimer = new wxTimer(this);
+            m_autosaveTimer = new wxTimer(this, NewControlId());
             m_autosaveTimer->Start(1000);
 
+            // picks up the entity models and texture collections that are loaded in the background
+            m_assetTimer = new wxTimer(this, NewControlId());
+            m_assetTimer->Start(100);
+
             bindObservers();
             bindEvents();
 
@@ -183,6 +189,9 @@ namespace TrenchBroom {
             delete m_autosaveTimer;
             m_autosaveTimer = nullptr;
 
+            delete m_assetTimer;
+            m_assetTimer = nullptr;
+
             delete m_autosaver;
             m_autosaver = nullptr;
 
@@ -613,6 +622,7 @@ namespace TrenchBroom {
             m_document->currentLayerDidChangeNotifier.addObserver(this, &MapFrame::currentLayerDidChange);
             m_document->groupWasOpenedNotifier.addObserver(this, &MapFrame::groupWasOpened);
             m_document->groupWasClosedNotifier.addObserver(this, &MapFrame::groupWasClosed);
+            m_document->operationProgressNotifier.addObserver(this, &MapFrame::operationProgress);
             
             Grid& grid = m_document->grid();
             grid.gridDidChangeNotifier.addObserver(this, &MapFrame::gridDidChange);
@@ -631,6 +641,7 @@ namespace TrenchBroom {
             m_document->currentLayerDidChangeNotifier.removeObserver(this, &MapFrame::currentLayerDidChange);
             m_document->groupWasOpenedNotifier.removeObserver(this, &MapFrame::groupWasOpened);
             m_document->groupWasClosedNotifier.removeObserver(this, &MapFrame::groupWasClosed);
+            m_document->operationProgressNotifier.removeObserver(this, &MapFrame::operationProgress);
             
             Grid& grid = m_document->grid();
             grid.gridDidChangeNotifier.removeObserver(this, &MapFrame::gridDidChange);
@@ -678,6 +689,21 @@ namespace TrenchBroom {
             updateStatusBar();
         }
 
+        void MapFrame::operationProgress(const String& operation, const double progress) {
+            if (progress >= 1.0) {
+                updateStatusBar();
+                return;
+            }
+            
+            wxString text;
+            text << operation << ": " << static_cast<int>(progress * 100.0) << "%";
+            if (text != m_statusBar->GetStatusText()) {
+                m_statusBar->SetStatusText(text);
+                // the operation blocks the event loop, so the status bar must be repainted right away
+                m_statusBar->Update();
+            }
+        }
+
         void MapFrame::bindEvents() {
             Bind(wxEVT_MENU, &MapFrame::OnFileSave, this, wxID_SAVE);
             Bind(wxEVT_MENU, &MapFrame::OnFileSaveAs, this, wxID_SAVEAS);
@@ -781,7 +807,8 @@ namespace TrenchBroom {
             Bind(wxEVT_UPDATE_UI, &MapFrame::OnUpdateUI, this, CommandIds::Actions::FlipObjectsVertically);
 
             Bind(wxEVT_CLOSE_WINDOW, &MapFrame::OnClose, this);
-            Bind(wxEVT_TIMER, &MapFrame::OnAutosaveTimer, this);
+            Bind(wxEVT_TIMER, &MapFrame::OnAutosaveTimer, this, m_autosaveTimer->GetId());
+            Bind(wxEVT_TIMER, &MapFrame::OnAssetTimer, this, m_assetTimer->GetId());
 			Bind(wxEVT_CHILD_FOCUS, &MapFrame::OnChildFocus, this);
 
 #if defined(_WIN32)
@@ -1930,6 +1957,13 @@ namespace TrenchBroom {
 
             m_autosaver->triggerAutosave(logger());
         }
+
+        void MapFrame::OnAssetTimer(wxTimerEvent& event) {
+            if (IsBeingDeleted()) return;
+
+            m_document->collectEntityModels();
+            m_document->collectTextureCollections();
+        }
         
         int MapFrame::indexForGridSize(const int gridSize) {
             return gridSize - Grid::MinSize;
@@ -59,6 +59,7 @@ namespace TrenchBroom {
 
             Autosaver* m_autosaver;
             wxTimer* m_autosaveTimer;
+            wxTimer* m_assetTimer;
 
             SplitterWindow2* m_hSplitter;
             SplitterWindow2* m_vSplitter;
@@ -133,6 +134,7 @@ namespace TrenchBroom {
             void currentLayerDidChange(const TrenchBroom::Model::Layer* layer);
             void groupWasOpened(Model::Group* group);
             void groupWasClosed(Model::Group* group);
+            void operationProgress(const String& operation, double progress);
         private: // menu event handlers
             void bindEvents();
 
@@ -280,6 +282,7 @@ namespace TrenchBroom {
         private: // other event handlers
             void OnClose(wxCloseEvent& event);
             void OnAutosaveTimer(wxTimerEvent& event);
+            void OnAssetTimer(wxTimerEvent& event);
         private: // grid helpers
             static int indexForGridSize(const int gridSize);
             static int gridSizeForIndex(const int index);
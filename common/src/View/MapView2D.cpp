@@ -24,7 +24,7 @@
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
 #include "Model/BrushFace.h"
-#include "Model/CollectContainedNodesVisitor.h"
+#include "Model/CollectTouchingNodes.h"
 #include "Model/CompareHits.h"
 #include "Model/Entity.h"
 #include "Model/HitAdapter.h"
@@ -213,9 +213,7 @@ namespace TrenchBroom {
             Transaction transaction(document, "Select Tall");
             document->deleteObjects();
 
-            Model::CollectContainedNodesVisitor<Model::BrushList::const_iterator> visitor(std::begin(tallBrushes), std::end(tallBrushes), document->editorContext());
-            document->world()->acceptAndRecurse(visitor);
-            document->select(visitor.nodes());
+            document->select(Model::collectContainedNodes(document->world(), tallBrushes, document->editorContext()));
 
             VectorUtils::clearAndDelete(tallBrushes);
         }
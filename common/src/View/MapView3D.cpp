@@ -308,6 +308,16 @@ namespace TrenchBroom {
             return pickResult;
         }
 
+        Model::PickResult MapView3D::doPickClosest(const Ray3& pickRay) const {
+            MapDocumentSPtr document = lock(m_document);
+            const Model::EditorContext& editorContext = document->editorContext();
+            Model::PickResult pickResult = Model::PickResult::byDistance(editorContext);
+
+            // the hits are ordered by distance, so the hits behind the closest brush do not matter while hovering
+            document->pickClosest(pickRay, pickResult);
+            return pickResult;
+        }
+
         void MapView3D::doUpdateViewport(const int x, const int y, const int width, const int height) {
             m_camera.setViewport(Renderer::Camera::Viewport(x, y, width, height));
         }
@@ -325,7 +335,7 @@ namespace TrenchBroom {
                 const Model::EditorContext& editorContext = document->editorContext();
                 Model::PickResult pickResult = Model::PickResult::byDistance(editorContext);
 
-                document->pick(Ray3(pickRay), pickResult);
+                document->pickClosest(Ray3(pickRay), pickResult);
                 const Model::Hit& hit = pickResult.query().pickable().type(Model::Brush::BrushHit).first();
                 
                 if (hit.isMatch()) {
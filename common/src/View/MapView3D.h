@@ -87,6 +87,7 @@ namespace TrenchBroom {
         private: // implement ToolBoxConnector interface
             PickRequest doGetPickRequest(int x, int y) const override;
             Model::PickResult doPick(const Ray3& pickRay) const override;
+            Model::PickResult doPickClosest(const Ray3& pickRay) const override;
         private: // implement RenderView interface
             void doUpdateViewport(int x, int y, int width, int height) override;
         private: // implement MapView interface
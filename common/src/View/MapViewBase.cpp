@@ -124,6 +124,7 @@ namespace TrenchBroom {
             document->selectionDidChangeNotifier.addObserver(this, &MapViewBase::selectionDidChange);
             document->textureCollectionsDidChangeNotifier.addObserver(this, &MapViewBase::textureCollectionsDidChange);
             document->entityDefinitionsDidChangeNotifier.addObserver(this, &MapViewBase::entityDefinitionsDidChange);
+            document->entityModelsWereLoadedNotifier.addObserver(this, &MapViewBase::entityModelsWereLoaded);
             document->modsDidChangeNotifier.addObserver(this, &MapViewBase::modsDidChange);
             document->editorContextDidChangeNotifier.addObserver(this, &MapViewBase::editorContextDidChange);
             document->mapViewConfigDidChangeNotifier.addObserver(this, &MapViewBase::mapViewConfigDidChange);
@@ -154,6 +155,7 @@ namespace TrenchBroom {
                 document->selectionDidChangeNotifier.removeObserver(this, &MapViewBase::selectionDidChange);
                 document->textureCollectionsDidChangeNotifier.removeObserver(this, &MapViewBase::textureCollectionsDidChange);
                 document->entityDefinitionsDidChangeNotifier.removeObserver(this, &MapViewBase::entityDefinitionsDidChange);
+                document->entityModelsWereLoadedNotifier.removeObserver(this, &MapViewBase::entityModelsWereLoaded);
                 document->modsDidChangeNotifier.removeObserver(this, &MapViewBase::modsDidChange);
                 document->editorContextDidChangeNotifier.removeObserver(this, &MapViewBase::editorContextDidChange);
                 document->mapViewConfigDidChangeNotifier.removeObserver(this, &MapViewBase::mapViewConfigDidChange);
@@ -205,6 +207,10 @@ namespace TrenchBroom {
             Refresh();
         }
 
+        void MapViewBase::entityModelsWereLoaded() {
+            Refresh();
+        }
+
         void MapViewBase::modsDidChange() {
             Refresh();
         }
@@ -54,8 +54,7 @@ namespace TrenchBroom {
 
             m_inputState.setPickRequest(doGetPickRequest(m_inputState.mouseX(),  m_inputState.mouseY()));
             Model::PickResult pickResult = doPick(m_inputState.pickRay());
-            m_toolBox->pick(m_toolChain, m_inputState, pickResult);
-            m_inputState.setPickResult(pickResult);
+            setPickResult(pickResult);
         }
 
         void ToolBoxConnector::updateLastActivation() {
@@ -210,6 +209,8 @@ namespace TrenchBroom {
 
             updateModifierKeys();
             if (event.ButtonDown()) {
+                // the pick result of the last mouse move may have ended at the closest hit
+                updatePickResult();
                 captureMouse();
                 m_clickTime = wxGetLocalTimeMillis();
                 m_clickPos = event.GetPosition();
@@ -287,7 +288,7 @@ namespace TrenchBroom {
                     startDrag(event);
                 } else {
                     mouseMoved(event.GetPosition());
-                    updatePickResult();
+                    updateHoverPickResult();
                     m_toolBox->mouseMove(m_toolChain, m_inputState);
                 }
             }
@@ -483,6 +484,23 @@ namespace TrenchBroom {
             updateModifierKeys();
         }
 
+        void ToolBoxConnector::updateHoverPickResult() {
+            ensure(m_toolBox != nullptr, "toolBox is null");
+
+            m_inputState.setPickRequest(doGetPickRequest(m_inputState.mouseX(),  m_inputState.mouseY()));
+            Model::PickResult pickResult = doPickClosest(m_inputState.pickRay());
+            setPickResult(pickResult);
+        }
+
+        void ToolBoxConnector::setPickResult(Model::PickResult& pickResult) {
+            m_toolBox->pick(m_toolChain, m_inputState, pickResult);
+            m_inputState.setPickResult(pickResult);
+        }
+
+        Model::PickResult ToolBoxConnector::doPickClosest(const Ray3& pickRay) const {
+            return doPick(pickRay);
+        }
+
         void ToolBoxConnector::doShowPopupMenu() {}
     }
 }
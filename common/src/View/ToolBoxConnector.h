@@ -116,9 +116,18 @@ namespace TrenchBroom {
             void mouseMoved(const wxPoint& position);
 
             void showPopupMenu();
+            
+            void updateHoverPickResult();
+            void setPickResult(Model::PickResult& pickResult);
         private:
             virtual PickRequest doGetPickRequest(int x, int y) const = 0;
             virtual Model::PickResult doPick(const Ray3& pickRay) const = 0;
+            
+            /**
+             * Picks while the mouse is moved without any buttons pressed. The search can end at the closest hit as
+             * long as the hits that the tools query while hovering are still found. Picks everything by default.
+             */
+            virtual Model::PickResult doPickClosest(const Ray3& pickRay) const;
             virtual void doShowPopupMenu();
         };
     }
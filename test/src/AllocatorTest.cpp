@@ -0,0 +1,140 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Allocator.h"
+
+#include <thread>
+#include <vector>
+
+namespace {
+    struct TestObject : public Allocator<TestObject> {
+        double value;
+
+        TestObject(const double i_value) :
+        value(i_value) {}
+    };
+}
+
+TEST(AllocatorTest, arenaAllocatesContiguously) {
+    const AllocatorArena arena;
+
+    TestObject* first = new TestObject(1.0);
+    TestObject* second = new TestObject(2.0);
+
+    ASSERT_TRUE(arena.contains(first));
+    ASSERT_TRUE(arena.contains(second));
+    ASSERT_EQ(first + 1, second);
+    ASSERT_EQ(1.0, first->value);
+    ASSERT_EQ(2.0, second->value);
+
+    delete second;
+    delete first;
+}
+
+TEST(AllocatorTest, arenaGrowsByBlocks) {
+    const AllocatorArena arena;
+
+    std::vector<TestObject*> objects;
+    for (size_t i = 0; i < 10000; ++i)
+        objects.push_back(new TestObject(static_cast<double>(i)));
+
+    ASSERT_LT(1u, arena.blockCount());
+    for (size_t i = 0; i < objects.size(); ++i) {
+        ASSERT_TRUE(arena.contains(objects[i]));
+        ASSERT_EQ(static_cast<double>(i), objects[i]->value);
+    }
+
+    for (TestObject* object : objects)
+        delete object;
+}
+
+TEST(AllocatorTest, deleteObjectCreatedBeforeArena) {
+    TestObject* outside = new TestObject(1.0);
+    {
+        const AllocatorArena arena;
+        ASSERT_FALSE(arena.contains(outside));
+        ASSERT_FALSE(AllocatorArena::owns(outside));
+        delete outside;
+
+        TestObject* inside = new TestObject(2.0);
+        ASSERT_TRUE(AllocatorArena::owns(inside));
+        delete inside;
+    }
+
+    ASSERT_TRUE(AllocatorArena::active() == nullptr);
+}
+
+TEST(AllocatorTest, nestedArenas) {
+    const AllocatorArena outer;
+    TestObject* first = new TestObject(1.0);
+    {
+        const AllocatorArena inner;
+        ASSERT_EQ(&inner, AllocatorArena::active());
+
+        TestObject* second = new TestObject(2.0);
+        ASSERT_TRUE(inner.contains(second));
+        ASSERT_FALSE(inner.contains(first));
+
+        // objects from the outer arena can be deleted while the inner one is alive
+        ASSERT_TRUE(AllocatorArena::owns(first));
+        delete first;
+        delete second;
+    }
+
+    ASSERT_EQ(&outer, AllocatorArena::active());
+}
+
+TEST(AllocatorTest, deleteObjectsOnOtherThreads) {
+    static const size_t ThreadCount = 4;
+    static const size_t ObjectCount = 5000;
+
+    // objects created on worker threads are deleted on this thread and vice versa
+    std::vector<std::vector<TestObject*>> created(ThreadCount);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < ThreadCount; ++i) {
+        threads.emplace_back([&created, i]() {
+            for (size_t j = 0; j < ObjectCount; ++j)
+                created[i].push_back(new TestObject(static_cast<double>(i * ObjectCount + j)));
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    threads.clear();
+
+    for (size_t i = 0; i < ThreadCount; ++i) {
+        for (size_t j = 0; j < ObjectCount; ++j) {
+            ASSERT_EQ(static_cast<double>(i * ObjectCount + j), created[i][j]->value);
+            delete created[i][j];
+        }
+        created[i].clear();
+        for (size_t j = 0; j < ObjectCount; ++j)
+            created[i].push_back(new TestObject(static_cast<double>(j)));
+    }
+
+    for (size_t i = 0; i < ThreadCount; ++i) {
+        threads.emplace_back([&created, i]() {
+            for (TestObject* object : created[i])
+                delete object;
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+}
@@ -0,0 +1,144 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "Exceptions.h"
+#include "Assets/EntityModel.h"
+#include "Assets/EntityModelManager.h"
+#include "IO/EntityModelLoader.h"
+#include "IO/Path.h"
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class TestModel : public EntityModel {
+        private:
+            Renderer::EntityModelMesh* doBuildRenderer(const size_t skinIndex, const size_t frameIndex) const override { return nullptr; }
+            BBox3f doGetBounds(const size_t skinIndex, const size_t frameIndex) const override { return BBox3f(); }
+            BBox3f doGetTransformedBounds(const size_t skinIndex, const size_t frameIndex, const Mat4x4f& transformation) const override { return BBox3f(); }
+            void doPrepare(int minFilter, int magFilter) override {}
+            void doSetTextureMode(int minFilter, int magFilter) override {}
+        };
+
+        class TestModelLoader : public IO::EntityModelLoader {
+        private:
+            std::shared_future<void> m_gate;
+        public:
+            mutable std::atomic<size_t> loadCount;
+
+            TestModelLoader(std::shared_future<void> gate) :
+            m_gate(gate),
+            loadCount(0) {}
+        private:
+            EntityModel* doLoadEntityModel(const IO::Path& path) const override {
+                m_gate.wait();
+                ++loadCount;
+                if (path.lastComponent().asString() == "missing.mdl")
+                    throw GameException("Cannot load model");
+                return new TestModel();
+            }
+        };
+
+        TEST(EntityModelManagerTest, loadModels) {
+            std::promise<void> gate;
+            gate.set_value();
+            TestModelLoader loader(gate.get_future().share());
+
+            EntityModelManager manager(nullptr, 0, 0);
+            manager.setLoader(&loader);
+
+            const IO::Path path1("progs/player.mdl");
+            const IO::Path path2("progs/armor.mdl");
+            IO::Path::List paths;
+            paths.push_back(path1);
+            paths.push_back(path2);
+            paths.push_back(path1);
+            manager.loadModels(paths);
+
+            ASSERT_TRUE(manager.model(path1) != nullptr);
+            ASSERT_TRUE(manager.model(path2) != nullptr);
+            ASSERT_TRUE(manager.collectLoadedModels());
+            ASSERT_FALSE(manager.collectLoadedModels());
+
+            // loaded models are not loaded again
+            manager.loadModels(paths);
+            ASSERT_EQ(2u, loader.loadCount.load());
+        }
+
+        TEST(EntityModelManagerTest, loadMissingModel) {
+            std::promise<void> gate;
+            gate.set_value();
+            TestModelLoader loader(gate.get_future().share());
+
+            EntityModelManager manager(nullptr, 0, 0);
+            manager.setLoader(&loader);
+
+            const IO::Path path("progs/missing.mdl");
+            manager.loadModels(IO::Path::List(1, path));
+
+            ASSERT_TRUE(manager.model(path) == nullptr);
+            ASSERT_TRUE(manager.collectLoadedModels());
+
+            // failed models are not loaded again
+            manager.loadModels(IO::Path::List(1, path));
+            ASSERT_TRUE(manager.safeGetModel(path) == nullptr);
+            ASSERT_EQ(1u, loader.loadCount.load());
+        }
+
+        TEST(EntityModelManagerTest, rendererOfPendingModel) {
+            std::promise<void> gate;
+            TestModelLoader loader(gate.get_future().share());
+
+            EntityModelManager manager(nullptr, 0, 0);
+            manager.setLoader(&loader);
+
+            const IO::Path path("progs/player.mdl");
+            manager.loadModels(IO::Path::List(1, path));
+
+            // does not wait for the model
+            ASSERT_TRUE(manager.renderer(ModelSpecification(path)) == nullptr);
+            ASSERT_FALSE(manager.collectLoadedModels());
+            ASSERT_EQ(0u, loader.loadCount.load());
+
+            gate.set_value();
+            ASSERT_TRUE(manager.model(path) != nullptr);
+            ASSERT_EQ(1u, loader.loadCount.load());
+        }
+
+        TEST(EntityModelManagerTest, clearWhileLoading) {
+            std::promise<void> gate;
+            TestModelLoader loader(gate.get_future().share());
+
+            EntityModelManager manager(nullptr, 0, 0);
+            manager.setLoader(&loader);
+            manager.loadModels(IO::Path::List(1, IO::Path("progs/player.mdl")));
+
+            std::thread release([&gate]() { gate.set_value(); });
+            manager.clear();
+            release.join();
+
+            ASSERT_FALSE(manager.collectLoadedModels());
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "ByteBuffer.h"
+#include "Color.h"
+#include "Assets/Palette.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static Palette createTestPalette(std::vector<unsigned char>& colors) {
+            colors.resize(768);
+            for (size_t i = 0; i < colors.size(); ++i)
+                colors[i] = static_cast<unsigned char>((i * 37 + 11) % 256);
+            
+            unsigned char* data = new unsigned char[colors.size()];
+            std::copy(std::begin(colors), std::end(colors), data);
+            return Palette(colors.size(), data);
+        }
+        
+        TEST(PaletteTest, indexedToRgb) {
+            std::vector<unsigned char> colors;
+            const Palette palette = createTestPalette(colors);
+            
+            // cover the scalar tail and several accumulator blocks
+            const size_t pixelCounts[] = { 1, 2, 3, 4, 5, 7, 16, 17, 511, 512, 513, 4096, 4099 };
+            for (const size_t pixelCount : pixelCounts) {
+                std::vector<unsigned char> indices(pixelCount);
+                for (size_t i = 0; i < pixelCount; ++i)
+                    indices[i] = static_cast<unsigned char>((i * 7 + i / 3) % 256);
+                
+                // the extra bytes must not be touched
+                Buffer<unsigned char> rgbImage(3 * pixelCount + 4);
+                for (size_t i = 0; i < rgbImage.size(); ++i)
+                    rgbImage[i] = 0xAB;
+                
+                Color averageColor;
+                palette.indexedToRgb(indices.data(), pixelCount, rgbImage, averageColor);
+                
+                double sums[3] = { 0.0, 0.0, 0.0 };
+                for (size_t i = 0; i < pixelCount; ++i) {
+                    for (size_t j = 0; j < 3; ++j) {
+                        const unsigned char expected = colors[3 * indices[i] + j];
+                        ASSERT_EQ(expected, rgbImage[3 * i + j]);
+                        sums[j] += expected;
+                    }
+                }
+                for (size_t i = 3 * pixelCount; i < rgbImage.size(); ++i)
+                    ASSERT_EQ(0xAB, rgbImage[i]);
+                
+                for (size_t j = 0; j < 3; ++j)
+                    ASSERT_FLOAT_EQ(static_cast<float>(sums[j] / pixelCount / 0xFF), averageColor[j]);
+                ASSERT_FLOAT_EQ(1.0f, averageColor[3]);
+                
+                ASSERT_EQ(averageColor, palette.averageColor(indices.data(), pixelCount));
+            }
+        }
+        
+        TEST(PaletteTest, averageColorOfSaturatedImage) {
+            // every pixel uses the brightest color to check that the accumulators don't overflow
+            unsigned char* data = new unsigned char[768];
+            std::fill(data, data + 768, 0xFF);
+            const Palette palette(768, data);
+            
+            const std::vector<unsigned char> indices(1024 * 1024, 3);
+            const Color averageColor = palette.averageColor(indices.data(), indices.size());
+            ASSERT_FLOAT_EQ(1.0f, averageColor[0]);
+            ASSERT_FLOAT_EQ(1.0f, averageColor[1]);
+            ASSERT_FLOAT_EQ(1.0f, averageColor[2]);
+        }
+    }
+}
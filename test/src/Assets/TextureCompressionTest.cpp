@@ -0,0 +1,176 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "Assets/Texture.h"
+#include "Assets/TextureCompression.h"
+
+#include <cstdlib>
+
+namespace TrenchBroom {
+    namespace Assets {
+        static TextureBuffer::List makeMips(const size_t width, const size_t height, const size_t channels, const size_t levels, unsigned char (*pixel)(size_t x, size_t y, size_t channel)) {
+            TextureBuffer::List result;
+            for (size_t level = 0; level < levels; ++level) {
+                const size_t mipWidth = width >> level;
+                const size_t mipHeight = height >> level;
+                TextureBuffer buffer(mipWidth * mipHeight * channels);
+                for (size_t y = 0; y < mipHeight; ++y) {
+                    for (size_t x = 0; x < mipWidth; ++x) {
+                        for (size_t c = 0; c < channels; ++c)
+                            buffer[(y * mipWidth + x) * channels + c] = pixel(x << level, y << level, c);
+                    }
+                }
+                result.push_back(buffer);
+            }
+            return result;
+        }
+
+        static unsigned char solidPixel(const size_t x, const size_t y, const size_t channel) {
+            static const unsigned char color[] = { 255, 0, 255, 128 };
+            return color[channel];
+        }
+
+        static unsigned char gradientPixel(const size_t x, const size_t y, const size_t channel) {
+            switch (channel) {
+                case 0:
+                    return static_cast<unsigned char>(x * 4);
+                case 1:
+                    return static_cast<unsigned char>(y * 4);
+                case 2:
+                    return static_cast<unsigned char>(255 - x * 4);
+                default:
+                    return static_cast<unsigned char>((x + y) * 2);
+            }
+        }
+
+        static int maxError(const TextureBuffer& original, const size_t channels, const TextureBuffer& rgba, const bool swapRedAndBlue = false) {
+            const size_t pixelCount = rgba.size() / 4;
+            int result = 0;
+            for (size_t i = 0; i < pixelCount; ++i) {
+                for (size_t c = 0; c < channels; ++c) {
+                    const size_t source = swapRedAndBlue && c != 1 && c != 3 ? 2 - c : c;
+                    result = std::max(result, std::abs(original[i * channels + source] - rgba[i * 4 + c]));
+                }
+            }
+            return result;
+        }
+
+        TEST(TextureCompressionTest, formats) {
+            ASSERT_TRUE(isCompressible(GL_RGB));
+            ASSERT_TRUE(isCompressible(GL_BGRA));
+            ASSERT_FALSE(isCompressible(GL_COMPRESSED_RGB_S3TC_DXT1_EXT));
+            ASSERT_TRUE(isCompressed(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT));
+            ASSERT_FALSE(isCompressed(GL_RGB));
+
+            ASSERT_EQ(static_cast<GLenum>(GL_COMPRESSED_RGB_S3TC_DXT1_EXT), compressedFormat(GL_BGR));
+            ASSERT_EQ(static_cast<GLenum>(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT), compressedFormat(GL_RGBA));
+
+            ASSERT_EQ(8u, compressedImageSize(4, 4, GL_COMPRESSED_RGB_S3TC_DXT1_EXT));
+            ASSERT_EQ(8u, compressedImageSize(1, 2, GL_COMPRESSED_RGB_S3TC_DXT1_EXT));
+            ASSERT_EQ(6u * 16u, compressedImageSize(10, 5, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT));
+        }
+
+        TEST(TextureCompressionTest, compressSolidColor) {
+            const TextureBuffer::List mips = makeMips(16, 8, 3, 4, solidPixel);
+            const TextureBuffer::List compressed = compressMips(mips, 16, 8, GL_RGB);
+
+            ASSERT_EQ(4u, compressed.size());
+            ASSERT_EQ(4u * 2u * 8u, compressed[0].size());
+            ASSERT_EQ(8u, compressed[3].size());
+
+            const TextureBuffer::List decompressed = decompressMips(compressed, 16, 8, GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+            for (size_t i = 0; i < mips.size(); ++i) {
+                ASSERT_EQ(0, maxError(mips[i], 3, decompressed[i]));
+                ASSERT_EQ(255, decompressed[i][3]);
+            }
+        }
+
+        TEST(TextureCompressionTest, compressGradient) {
+            const TextureBuffer::List mips = makeMips(64, 64, 3, 1, gradientPixel);
+            const TextureBuffer::List compressed = compressMips(mips, 64, 64, GL_RGB);
+            const TextureBuffer::List decompressed = decompressMips(compressed, 64, 64, GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+
+            ASSERT_LE(maxError(mips[0], 3, decompressed[0]), 12);
+        }
+
+        TEST(TextureCompressionTest, compressBgr) {
+            const TextureBuffer::List mips = makeMips(32, 32, 3, 1, gradientPixel);
+            const TextureBuffer::List compressed = compressMips(mips, 32, 32, GL_BGR);
+            const TextureBuffer::List decompressed = decompressMips(compressed, 32, 32, GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+
+            ASSERT_LE(maxError(mips[0], 3, decompressed[0], true), 12);
+        }
+
+        TEST(TextureCompressionTest, compressAlpha) {
+            const TextureBuffer::List mips = makeMips(32, 32, 4, 1, gradientPixel);
+            const TextureBuffer::List compressed = compressMips(mips, 32, 32, GL_RGBA);
+            ASSERT_EQ(8u * 8u * 16u, compressed[0].size());
+
+            const TextureBuffer::List decompressed = decompressMips(compressed, 32, 32, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+            ASSERT_LE(maxError(mips[0], 4, decompressed[0]), 12);
+        }
+
+        TEST(TextureCompressionTest, compressPartialBlocks) {
+            const TextureBuffer::List mips = makeMips(6, 3, 4, 2, solidPixel);
+            const TextureBuffer::List compressed = compressMips(mips, 6, 3, GL_RGBA);
+            ASSERT_EQ(2u * 16u, compressed[0].size());
+            ASSERT_EQ(16u, compressed[1].size());
+
+            const TextureBuffer::List decompressed = decompressMips(compressed, 6, 3, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+            ASSERT_EQ(6u * 3u * 4u, decompressed[0].size());
+            ASSERT_EQ(3u * 1u * 4u, decompressed[1].size());
+            ASSERT_EQ(0, maxError(mips[0], 4, decompressed[0]));
+            ASSERT_EQ(0, maxError(mips[1], 4, decompressed[1]));
+        }
+
+        TEST(TextureCompressionTest, compressTexture) {
+            const TextureBuffer::List mips = makeMips(16, 16, 3, 4, solidPixel);
+            Texture texture("texture", 16, 16, Color(), mips, GL_RGB);
+            texture.compress();
+
+            ASSERT_EQ(static_cast<GLenum>(GL_COMPRESSED_RGB_S3TC_DXT1_EXT), texture.format());
+            ASSERT_EQ(4u, texture.buffers().size());
+            ASSERT_EQ(compressedImageSize(16, 16, GL_COMPRESSED_RGB_S3TC_DXT1_EXT), texture.buffers()[0].size());
+
+            // compressing again has no effect
+            texture.compress();
+            ASSERT_EQ(static_cast<GLenum>(GL_COMPRESSED_RGB_S3TC_DXT1_EXT), texture.format());
+        }
+
+        TEST(TextureCompressionTest, compressLazyTexture) {
+            const TextureBuffer::List mips = makeMips(16, 16, 3, 4, solidPixel);
+            size_t decodeCount = 0;
+            Texture texture("texture", 16, 16, Color(), [&mips, &decodeCount]() {
+                ++decodeCount;
+                return mips;
+            }, GL_RGB);
+            
+            // the texture is encoded once, and not again whenever it is uploaded
+            texture.compress();
+            ASSERT_EQ(1u, decodeCount);
+            ASSERT_FALSE(texture.lazy());
+            ASSERT_EQ(static_cast<GLenum>(GL_COMPRESSED_RGB_S3TC_DXT1_EXT), texture.format());
+            ASSERT_EQ(4u, texture.buffers().size());
+            ASSERT_EQ(compressedImageSize(16, 16, GL_COMPRESSED_RGB_S3TC_DXT1_EXT), texture.buffers()[0].size());
+        }
+    }
+}
@@ -0,0 +1,117 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Logger.h"
+#include "Assets/TextureCollection.h"
+#include "Assets/TextureManager.h"
+#include "EL/VariableStore.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/Path.h"
+#include "IO/TextureLoader.h"
+#include "Model/GameConfig.h"
+
+#include <memory>
+
+namespace TrenchBroom {
+    namespace Assets {
+        class TestLogger : public Logger {
+        public:
+            size_t errorCount;
+
+            TestLogger() :
+            errorCount(0) {}
+        private:
+            void doLog(const LogLevel level, const String& message) override {
+                if (level == LogLevel_Error)
+                    ++errorCount;
+            }
+
+            void doLog(const LogLevel level, const wxString& message) override {}
+        };
+
+        static std::shared_ptr<IO::TextureLoader> createLoader(const IO::FileSystem& fileSystem) {
+            using Model::GameConfig;
+
+            const EL::NullVariableStore variables;
+            const IO::Path::List fileSearchPaths{ IO::Disk::getCurrentWorkingDir() };
+            const GameConfig::TextureConfig textureConfig(GameConfig::TexturePackageConfig(GameConfig::PackageFormatConfig("wad", "idmip")),
+                                                          GameConfig::PackageFormatConfig("D", "idmip"),
+                                                          IO::Path("data/palette.lmp"),
+                                                          "wad");
+            return std::make_shared<IO::TextureLoader>(variables, fileSystem, fileSearchPaths, textureConfig);
+        }
+
+        TEST(TextureManagerTest, placeholdersAreReplacedWhenCollected) {
+            const IO::DiskFileSystem fileSystem(IO::Disk::getCurrentWorkingDir());
+            TestLogger logger;
+            TextureManager manager(&logger, 0, 0);
+
+            manager.setTextureCollections(IO::Path::List{ IO::Path("data/IO/Wad/cr8_czg.wad") }, createLoader(fileSystem));
+
+            ASSERT_EQ(1u, manager.collections().size());
+            TextureCollection* placeholder = manager.collections().front();
+            ASSERT_FALSE(placeholder->loaded());
+            ASSERT_TRUE(manager.texture("coffin1") == nullptr);
+
+            // finished collections are not published before they are collected
+            manager.finishLoading();
+            ASSERT_EQ(placeholder, manager.collections().front());
+
+            ASSERT_TRUE(manager.collectLoadedCollections());
+            ASSERT_EQ(1u, manager.collections().size());
+            ASSERT_TRUE(manager.collections().front()->loaded());
+            ASSERT_TRUE(manager.texture("coffin1") != nullptr);
+            ASSERT_EQ(0u, logger.errorCount);
+
+            ASSERT_FALSE(manager.collectLoadedCollections());
+        }
+
+        TEST(TextureManagerTest, placeholderRemainsIfCollectionFails) {
+            const IO::DiskFileSystem fileSystem(IO::Disk::getCurrentWorkingDir());
+            TestLogger logger;
+            TextureManager manager(&logger, 0, 0);
+
+            const IO::Path::List paths{ IO::Path("data/IO/Wad/missing.wad"), IO::Path("data/IO/Wad/cr8_czg.wad") };
+            manager.setTextureCollections(paths, createLoader(fileSystem));
+            manager.finishLoading();
+
+            ASSERT_TRUE(manager.collectLoadedCollections());
+            ASSERT_EQ(2u, manager.collections().size());
+            ASSERT_EQ(IO::Path("data/IO/Wad/missing.wad"), manager.collections()[0]->path());
+            ASSERT_FALSE(manager.collections()[0]->loaded());
+            ASSERT_TRUE(manager.collections()[1]->loaded());
+            ASSERT_EQ(1u, logger.errorCount);
+        }
+
+        TEST(TextureManagerTest, clearCancelsLoading) {
+            const IO::DiskFileSystem fileSystem(IO::Disk::getCurrentWorkingDir());
+            TestLogger logger;
+            TextureManager manager(&logger, 0, 0);
+
+            manager.setTextureCollections(IO::Path::List{ IO::Path("data/IO/Wad/cr8_czg.wad") }, createLoader(fileSystem));
+            manager.clear();
+
+            ASSERT_TRUE(manager.collections().empty());
+            ASSERT_FALSE(manager.collectLoadedCollections());
+        }
+    }
+}
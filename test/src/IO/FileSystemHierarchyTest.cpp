@@ -0,0 +1,188 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "IO/FileSystemHierarchy.h"
+#include "IO/ImageFileSystem.h"
+#include "IO/MappedFile.h"
+
+#include <algorithm>
+#include <map>
+
+namespace TrenchBroom {
+    namespace IO {
+        typedef std::map<Path, String> FileContents;
+
+        static MappedFile::Ptr createFile(const Path& path, const String& contents) {
+            char* buffer = new char[contents.size()];
+            std::copy(std::begin(contents), std::end(contents), buffer);
+            return MappedFile::Ptr(new MappedFileBuffer(path, buffer, contents.size()));
+        }
+
+        // an archive whose files are indexed by the hierarchy
+        class TestImageFileSystem : public ImageFileSystem {
+        private:
+            FileContents m_contents;
+        public:
+            TestImageFileSystem(const FileContents& contents) :
+            ImageFileSystem(Path("test.pak"), MappedFile::Ptr()),
+            m_contents(contents) {
+                initialize();
+            }
+        private:
+            void doReadDirectory() override {
+                for (const auto& entry : m_contents)
+                    m_index.addFile(entry.first, createFile(entry.first, entry.second));
+            }
+        };
+
+        // a file system that the hierarchy must search on every lookup
+        class TestFileSystem : public FileSystem {
+        private:
+            FileContents m_contents;
+        public:
+            TestFileSystem(const FileContents& contents) :
+            m_contents(contents) {}
+        private:
+            Path doMakeAbsolute(const Path& relPath) const override {
+                return Path("/test") + relPath;
+            }
+
+            bool doDirectoryExists(const Path& path) const override {
+                if (path.isEmpty())
+                    return true;
+                for (const auto& entry : m_contents) {
+                    if (entry.first.length() > path.length() && entry.first.prefix(path.length()) == path)
+                        return true;
+                }
+                return false;
+            }
+
+            bool doFileExists(const Path& path) const override {
+                return m_contents.count(path) > 0;
+            }
+
+            Path::List doGetDirectoryContents(const Path& path) const override {
+                Path::List result;
+                for (const auto& entry : m_contents) {
+                    if (entry.first.length() > path.length() && entry.first.prefix(path.length()) == path)
+                        result.push_back(entry.first.subPath(path.length(), 1));
+                }
+                VectorUtils::sortAndRemoveDuplicates(result);
+                return result;
+            }
+
+            const MappedFile::Ptr doOpenFile(const Path& path) const override {
+                const auto it = m_contents.find(path);
+                return createFile(path, it->second);
+            }
+        };
+
+        static String readFile(const FileSystem& fs, const Path& path) {
+            const MappedFile::Ptr file = fs.openFile(path);
+            return String(file->begin(), file->end());
+        }
+
+        TEST(FileSystemHierarchyTest, laterFileSystemsTakePrecedence) {
+            FileContents pak1;
+            pak1[Path("gfx/palette.lmp")] = "pak1";
+            pak1[Path("progs/player.mdl")] = "pak1";
+
+            FileContents disk;
+            disk[Path("gfx/palette.lmp")] = "disk";
+            disk[Path("maps/start.bsp")] = "disk";
+
+            FileContents pak2;
+            pak2[Path("progs/player.mdl")] = "pak2";
+
+            FileSystemHierarchy fs;
+            fs.addFileSystem(new TestImageFileSystem(pak1));
+            fs.addFileSystem(new TestFileSystem(disk));
+            fs.addFileSystem(new TestImageFileSystem(pak2));
+
+            ASSERT_EQ("disk", readFile(fs, Path("gfx/palette.lmp")));
+            ASSERT_EQ("pak2", readFile(fs, Path("progs/player.mdl")));
+            ASSERT_EQ("pak2", readFile(fs, Path("PROGS/Player.mdl")));
+            ASSERT_EQ("disk", readFile(fs, Path("maps/start.bsp")));
+
+            ASSERT_TRUE(fs.fileExists(Path("Gfx/Palette.lmp")));
+            ASSERT_FALSE(fs.fileExists(Path("gfx/colormap.lmp")));
+            ASSERT_THROW(fs.openFile(Path("gfx/colormap.lmp")), FileSystemException);
+        }
+
+        TEST(FileSystemHierarchyTest, directoryExists) {
+            FileContents pak;
+            pak[Path("textures/e1u1/box1_3.wal")] = "";
+
+            FileContents disk;
+            disk[Path("maps/start.map")] = "";
+
+            FileSystemHierarchy fs;
+            fs.addFileSystem(new TestImageFileSystem(pak));
+            fs.addFileSystem(new TestFileSystem(disk));
+
+            ASSERT_TRUE(fs.directoryExists(Path("")));
+            ASSERT_TRUE(fs.directoryExists(Path("textures")));
+            ASSERT_TRUE(fs.directoryExists(Path("Textures/E1U1")));
+            ASSERT_TRUE(fs.directoryExists(Path("maps")));
+            ASSERT_FALSE(fs.directoryExists(Path("textures/e1u2")));
+            ASSERT_FALSE(fs.directoryExists(Path("textures/e1u1/box1_3.wal")));
+        }
+
+        TEST(FileSystemHierarchyTest, findItems) {
+            FileContents pak1;
+            pak1[Path("textures/e1u1/box1_3.wal")] = "";
+            pak1[Path("textures/e1u1/brlava.wal")] = "";
+
+            FileContents disk;
+            disk[Path("textures/e1u1/brlava.wal")] = "";
+            disk[Path("textures/e1u2/angle1_1.wal")] = "";
+
+            FileSystemHierarchy fs;
+            fs.addFileSystem(new TestImageFileSystem(pak1));
+            fs.addFileSystem(new TestFileSystem(disk));
+
+            Path::List items = fs.findItems(Path("textures"));
+            ASSERT_EQ(2u, items.size());
+            ASSERT_TRUE(std::find(std::begin(items), std::end(items), Path("textures/e1u1")) != std::end(items));
+            ASSERT_TRUE(std::find(std::begin(items), std::end(items), Path("textures/e1u2")) != std::end(items));
+
+            items = fs.findItemsRecursively(Path("textures"), FileTypeMatcher(true, false));
+            ASSERT_EQ(3u, items.size());
+            ASSERT_TRUE(std::find(std::begin(items), std::end(items), Path("textures/e1u1/box1_3.wal")) != std::end(items));
+            ASSERT_TRUE(std::find(std::begin(items), std::end(items), Path("textures/e1u1/brlava.wal")) != std::end(items));
+            ASSERT_TRUE(std::find(std::begin(items), std::end(items), Path("textures/e1u2/angle1_1.wal")) != std::end(items));
+        }
+
+        TEST(FileSystemHierarchyTest, clear) {
+            FileContents pak;
+            pak[Path("gfx/palette.lmp")] = "";
+
+            FileSystemHierarchy fs;
+            fs.addFileSystem(new TestImageFileSystem(pak));
+            ASSERT_TRUE(fs.fileExists(Path("gfx/palette.lmp")));
+
+            fs.clear();
+            ASSERT_FALSE(fs.fileExists(Path("gfx/palette.lmp")));
+            ASSERT_FALSE(fs.directoryExists(Path("gfx")));
+        }
+    }
+}
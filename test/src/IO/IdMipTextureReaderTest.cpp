@@ -28,6 +28,8 @@
 #include "IO/TextureReader.h"
 #include "IO/WadFileSystem.h"
 
+#include <memory>
+
 namespace TrenchBroom {
     namespace IO {
         inline void assertTexture(const String& name, const size_t width, const size_t height, const FileSystem& fs, const TextureReader& loader) {
@@ -72,5 +74,27 @@ namespace TrenchBroom {
             assertTexture("blowjob_machine",   128, 128, wadFS, textureLoader);
             assertTexture("lasthopeofhuman",   128, 128, wadFS, textureLoader);
         }
+        
+        TEST(IdMipTextureReaderTest, testReadTextureLazily) {
+            DiskFileSystem fs(IO::Disk::getCurrentWorkingDir());
+            const Assets::Palette palette = Assets::Palette::loadFile(fs, Path("data/palette.lmp"));
+            
+            TextureReader::TextureNameStrategy nameStrategy;
+            IdMipTextureReader textureLoader(nameStrategy, palette);
+            
+            const Path wadPath = Disk::getCurrentWorkingDir() + Path("data/IO/Wad/cr8_czg.wad");
+            WadFileSystem wadFS(wadPath);
+            
+            const MappedFile::Ptr file = wadFS.openFile(Path("cr8_czg_3.D"));
+            std::unique_ptr<Assets::Texture> lazyTexture(textureLoader.readTexture(file));
+            std::unique_ptr<Assets::Texture> eagerTexture(textureLoader.readTexture(file->begin(), file->end(), file->path()));
+            
+            ASSERT_TRUE(lazyTexture->lazy());
+            ASSERT_FALSE(eagerTexture->lazy());
+            ASSERT_EQ(eagerTexture->name(), lazyTexture->name());
+            ASSERT_EQ(eagerTexture->width(), lazyTexture->width());
+            ASSERT_EQ(eagerTexture->height(), lazyTexture->height());
+            ASSERT_EQ(eagerTexture->averageColor(), lazyTexture->averageColor());
+        }
     }
 }
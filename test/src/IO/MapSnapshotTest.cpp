@@ -0,0 +1,133 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "StringUtils.h"
+#include "Assets/Texture.h"
+#include "IO/MapFileSerializer.h"
+#include "IO/MapSnapshot.h"
+#include "IO/NodeWriter.h"
+#include "IO/OutputBuffer.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/MapFormat.h"
+#include "Model/World.h"
+
+#include <regex>
+
+namespace TrenchBroom {
+    namespace IO {
+        static String writeSnapshot(const MapSnapshot& snapshot) {
+            OutputBuffer buffer;
+            NodeSerializer::Ptr serializer = MapFileSerializer::create(snapshot.format(), buffer);
+            snapshot.write(*serializer);
+            return buffer.str();
+        }
+        
+        static String writeWorld(Model::World* world) {
+            OutputBuffer buffer;
+            NodeWriter(world, buffer).writeMap();
+            return buffer.str();
+        }
+        
+        static String replaceIds(const String& str) {
+            // layer and group ids are generated anew whenever a map is written, only the links between them matter
+            const std::regex ids("(\"_tb_(id|layer|group)\" )\"[0-9]+\"");
+            return std::regex_replace(str, ids, "$1\"*\"");
+        }
+        
+        TEST(MapSnapshotTest, writeSnapshot) {
+            const BBox3 worldBounds(8192.0);
+            
+            Model::World map(Model::MapFormat::Valve, nullptr, worldBounds);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+            map.addOrUpdateAttribute("message", "A World");
+            
+            Model::BrushBuilder builder(&map, worldBounds);
+            map.defaultLayer()->addChild(builder.createCube(64.0, "some"));
+            
+            Model::Entity* entity = map.createEntity();
+            entity->addOrUpdateAttribute("classname", "func_door");
+            entity->addChild(builder.createCube(16.0, "door"));
+            map.defaultLayer()->addChild(entity);
+            
+            Model::Layer* layer = map.createLayer("Custom Layer", worldBounds);
+            map.addChild(layer);
+            
+            Model::Group* group = map.createGroup("Group");
+            layer->addChild(group);
+            group->addChild(builder.createCube(32.0, "none"));
+            
+            const MapSnapshot snapshot(&map);
+            ASSERT_EQ(Model::MapFormat::Valve, snapshot.format());
+            ASSERT_EQ(replaceIds(writeWorld(&map)), replaceIds(writeSnapshot(snapshot)));
+        }
+        
+        TEST(MapSnapshotTest, snapshotIsNotAffectedByChanges) {
+            const BBox3 worldBounds(8192.0);
+            
+            Model::World map(Model::MapFormat::Standard, nullptr, worldBounds);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+            
+            Model::BrushBuilder builder(&map, worldBounds);
+            Model::Brush* brush = builder.createCube(64.0, "some");
+            map.defaultLayer()->addChild(brush);
+            
+            const String expected = writeWorld(&map);
+            const MapSnapshot snapshot(&map);
+            
+            map.addOrUpdateAttribute("message", "Changed");
+            brush->findFace(Vec3::PosZ)->setXOffset(8.0f);
+            map.defaultLayer()->addChild(builder.createCube(32.0, "other"));
+            
+            ASSERT_EQ(expected, writeSnapshot(snapshot));
+        }
+        
+        TEST(MapSnapshotTest, snapshotDoesNotUseTextures) {
+            const BBox3 worldBounds(8192.0);
+            
+            Model::World map(Model::MapFormat::Standard, nullptr, worldBounds);
+            
+            Assets::Texture texture("some", 64, 64);
+            Model::BrushBuilder builder(&map, worldBounds);
+            Model::Brush* brush = builder.createCube(64.0, "some");
+            for (Model::BrushFace* face : brush->faces())
+                face->setTexture(&texture);
+            map.defaultLayer()->addChild(brush);
+            
+            const size_t usageCount = texture.usageCount();
+            ASSERT_EQ(6u, usageCount);
+            
+            {
+                const MapSnapshot snapshot(&map);
+                ASSERT_EQ(usageCount, texture.usageCount());
+                ASSERT_TRUE(StringUtils::containsCaseSensitive(writeSnapshot(snapshot), ") some 0 0 0 1 1\n"));
+            }
+            ASSERT_EQ(usageCount, texture.usageCount());
+            
+            for (Model::BrushFace* face : brush->faces())
+                face->unsetTexture();
+        }
+    }
+}
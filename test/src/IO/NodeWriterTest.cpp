@@ -21,13 +21,19 @@
 
 #include "StringUtils.h"
 #include "IO/NodeWriter.h"
+#include "IO/OutputBuffer.h"
 #include "Model/Brush.h"
 #include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/Entity.h"
 #include "Model/Group.h"
 #include "Model/Layer.h"
 #include "Model/MapFormat.h"
 #include "Model/World.h"
 
+#include <cstdio>
+#include <regex>
+
 namespace TrenchBroom {
     namespace IO {
         TEST(NodeWriterTest, writeEmptyMap) {
@@ -95,6 +101,130 @@ namespace TrenchBroom {
                          "}\n", result.c_str());
         }
         
+        TEST(NodeWriterTest, writeWorldspawnWithBrushToFile) {
+            const BBox3 worldBounds(8192.0);
+            
+            Model::World map(Model::MapFormat::Quake2, nullptr, worldBounds);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+            map.addOrUpdateAttribute("message", "\"holy\" damn");
+            
+            Model::BrushBuilder builder(&map, worldBounds);
+            Model::Brush* brush = builder.createCube(64.0, "none");
+            brush->faces().front()->setXOffset(0.5f);
+            brush->faces().front()->setYScale(0.1f);
+            brush->faces().back()->setSurfaceValue(-12.25f);
+            map.defaultLayer()->addChild(brush);
+            
+            FILE* file = std::tmpfile();
+            ASSERT_TRUE(file != nullptr);
+            
+            NodeWriter writer(&map, file);
+            writer.writeMap();
+            
+            String result(static_cast<size_t>(std::ftell(file)), ' ');
+            std::rewind(file);
+            ASSERT_EQ(result.size(), std::fread(&result[0], 1, result.size(), file));
+            std::fclose(file);
+            
+            ASSERT_STREQ("// entity 0\n"
+                         "{\n"
+                         "\"classname\" \"worldspawn\"\n"
+                         "\"message\" \"\\\"holy\\\" damn\"\n"
+                         "// brush 0\n"
+                         "{\n"
+                         "( -32 -32 -32 ) ( -32 -31 -32 ) ( -32 -32 -31 ) none 0.5 0 0 1 0.1 0 0 0\n"
+                         "( 32 32 32 ) ( 32 32 33 ) ( 32 33 32 ) none 0 0 0 1 1 0 0 0\n"
+                         "( -32 -32 -32 ) ( -32 -32 -31 ) ( -31 -32 -32 ) none 0 0 0 1 1 0 0 0\n"
+                         "( 32 32 32 ) ( 33 32 32 ) ( 32 32 33 ) none 0 0 0 1 1 0 0 0\n"
+                         "( 32 32 32 ) ( 32 33 32 ) ( 33 32 32 ) none 0 0 0 1 1 0 0 0\n"
+                         "( -32 -32 -32 ) ( -31 -32 -32 ) ( -32 -31 -32 ) none 0 0 0 1 1 0 0 -12.25\n"
+                         "}\n"
+                         "}\n", result.c_str());
+        }
+        
+        TEST(NodeWriterTest, writeWorldspawnWithBrushToBuffer) {
+            const BBox3 worldBounds(8192.0);
+            
+            Model::World map(Model::MapFormat::Standard, nullptr, worldBounds);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+            
+            Model::BrushBuilder builder(&map, worldBounds);
+            map.defaultLayer()->addChild(builder.createCube(64.0, "none"));
+            
+            OutputBuffer buffer;
+            buffer.append("// existing contents\n");
+            
+            NodeWriter writer(&map, buffer);
+            writer.writeMap();
+            
+            ASSERT_STREQ("// existing contents\n"
+                         "// entity 0\n"
+                         "{\n"
+                         "\"classname\" \"worldspawn\"\n"
+                         "// brush 0\n"
+                         "{\n"
+                         "( -32 -32 -32 ) ( -32 -31 -32 ) ( -32 -32 -31 ) none 0 0 0 1 1\n"
+                         "( 32 32 32 ) ( 32 32 33 ) ( 32 33 32 ) none 0 0 0 1 1\n"
+                         "( -32 -32 -32 ) ( -32 -32 -31 ) ( -31 -32 -32 ) none 0 0 0 1 1\n"
+                         "( 32 32 32 ) ( 33 32 32 ) ( 32 32 33 ) none 0 0 0 1 1\n"
+                         "( 32 32 32 ) ( 32 33 32 ) ( 33 32 32 ) none 0 0 0 1 1\n"
+                         "( -32 -32 -32 ) ( -31 -32 -32 ) ( -32 -31 -32 ) none 0 0 0 1 1\n"
+                         "}\n"
+                         "}\n", buffer.str().c_str());
+        }
+        
+        TEST(NodeWriterTest, writeManyBrushesToFile) {
+            // enough brushes to be written in several chunks
+            const size_t brushCount = 1000;
+            const BBox3 worldBounds(8192.0);
+            
+            Model::World map(Model::MapFormat::Standard, nullptr, worldBounds);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+            
+            Model::BrushBuilder builder(&map, worldBounds);
+            for (size_t i = 0; i < brushCount; ++i)
+                map.defaultLayer()->addChild(builder.createCube(64.0, "none"));
+            
+            FILE* file = std::tmpfile();
+            ASSERT_TRUE(file != nullptr);
+            
+            NodeWriter writer(&map, file);
+            writer.writeMap();
+            
+            String result(static_cast<size_t>(std::ftell(file)), ' ');
+            std::rewind(file);
+            ASSERT_EQ(result.size(), std::fread(&result[0], 1, result.size(), file));
+            std::fclose(file);
+            
+            StringStream expected;
+            expected << "// entity 0\n"
+                     << "{\n"
+                     << "\"classname\" \"worldspawn\"\n";
+            for (size_t i = 0; i < brushCount; ++i) {
+                expected << "// brush " << i << "\n"
+                         << "{\n"
+                         << "( -32 -32 -32 ) ( -32 -31 -32 ) ( -32 -32 -31 ) none 0 0 0 1 1\n"
+                         << "( 32 32 32 ) ( 32 32 33 ) ( 32 33 32 ) none 0 0 0 1 1\n"
+                         << "( -32 -32 -32 ) ( -32 -32 -31 ) ( -31 -32 -32 ) none 0 0 0 1 1\n"
+                         << "( 32 32 32 ) ( 33 32 32 ) ( 32 32 33 ) none 0 0 0 1 1\n"
+                         << "( 32 32 32 ) ( 32 33 32 ) ( 33 32 32 ) none 0 0 0 1 1\n"
+                         << "( -32 -32 -32 ) ( -31 -32 -32 ) ( -32 -31 -32 ) none 0 0 0 1 1\n"
+                         << "}\n";
+            }
+            expected << "}\n";
+            ASSERT_EQ(expected.str(), result);
+            
+            const Model::NodeList& brushes = map.defaultLayer()->children();
+            for (size_t i = 0; i < brushCount; ++i) {
+                Model::Brush* brush = static_cast<Model::Brush*>(brushes[i]);
+                const size_t startLine = 5 + 9 * i;
+                ASSERT_EQ(startLine, brush->lineNumber());
+                ASSERT_TRUE(brush->containsLine(startLine + 7));
+                ASSERT_FALSE(brush->containsLine(startLine + 8));
+            }
+            ASSERT_TRUE(map.containsLine(1 + 9 * brushCount + 3));
+        }
+        
         TEST(NodeWriterTest, writeWorldspawnWithBrushInCustomLayer) {
             const BBox3 worldBounds(8192.0);
             
@@ -292,6 +422,42 @@ namespace TrenchBroom {
                                                                  ));
         }
         
+        TEST(NodeWriterTest, writeWorldClone) {
+            const BBox3 worldBounds(8192.0);
+            
+            Model::World map(Model::MapFormat::Standard, nullptr, worldBounds);
+            map.addOrUpdateAttribute("classname", "worldspawn");
+            map.addOrUpdateAttribute("message", "A World");
+            
+            Model::BrushBuilder builder(&map, worldBounds);
+            map.defaultLayer()->addChild(builder.createCube(64.0, "none"));
+            
+            Model::Entity* entity = map.createEntity();
+            entity->addOrUpdateAttribute("classname", "light");
+            map.defaultLayer()->addChild(entity);
+            
+            Model::Layer* layer = map.createLayer("Custom Layer", worldBounds);
+            map.addChild(layer);
+            
+            Model::Group* group = map.createGroup("Group");
+            layer->addChild(group);
+            group->addChild(builder.createCube(32.0, "none"));
+            
+            // a clone of the world must be written exactly like the original
+            Model::World* clone = static_cast<Model::World*>(map.cloneRecursively(worldBounds));
+            
+            StringStream expected;
+            NodeWriter(&map, expected).writeMap();
+            
+            StringStream actual;
+            NodeWriter(clone, actual).writeMap();
+            delete clone;
+            
+            // layer and group ids are not preserved, only the links between the nodes
+            const std::regex ids("(\"_tb_(id|layer|group)\" )\"[0-9]+\"");
+            ASSERT_EQ(std::regex_replace(expected.str(), ids, "$1\"*\""), std::regex_replace(actual.str(), ids, "$1\"*\""));
+        }
+        
         TEST(NodeWriterTest, writeNodesWithNestedGroup) {
             const BBox3 worldBounds(8192.0);
             
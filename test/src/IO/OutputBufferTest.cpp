@@ -0,0 +1,87 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "IO/OutputBuffer.h"
+
+#include <cstdio>
+#include <limits>
+#include <random>
+
+namespace TrenchBroom {
+    namespace IO {
+        static String printfDouble(const double value, const int precision) {
+            char str[64];
+            std::snprintf(str, sizeof(str), "%.*g", precision, value);
+            return str;
+        }
+        
+        static void assertFormatsLikePrintf(const double value) {
+            for (const int precision : { 6, 17 }) {
+                OutputBuffer buffer;
+                buffer.appendDouble(value, precision);
+                ASSERT_EQ(printfDouble(value, precision), buffer.str());
+            }
+        }
+        
+        TEST(OutputBufferTest, appendIntegers) {
+            OutputBuffer buffer;
+            buffer.appendUnsigned(0);
+            buffer.append(' ');
+            buffer.appendUnsigned(1234567890123ull);
+            buffer.append(' ');
+            buffer.appendInteger(-42);
+            buffer.append(' ');
+            buffer.appendInteger(std::numeric_limits<long long>::min());
+            ASSERT_EQ(String("0 1234567890123 -42 -9223372036854775808"), buffer.str());
+        }
+        
+        TEST(OutputBufferTest, appendDoubleLikePrintf) {
+            const double values[] = {
+                0.0, -0.0, 1.0, -1.0, 64.0, -16.0, 0.5, -0.25, 0.125, 16.0625, 1.0 / 1024.0, 1.0 / 2048.0,
+                0.1, 0.2, 1.0 / 3.0, 123456.0, 999999.0, 1000000.0, 1234567.0, 123456.5, 99999.75,
+                1e16, 1e17 - 1.0, 1e17, 1e20, 1e-5, 1.5e-7, 8192.0, -8192.0, 4096.001,
+                std::numeric_limits<double>::max(), std::numeric_limits<double>::min(),
+                std::numeric_limits<double>::denorm_min(),
+                std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()
+            };
+            for (const double value : values)
+                assertFormatsLikePrintf(value);
+            
+            // values as they are passed from float members of brush faces
+            assertFormatsLikePrintf(static_cast<double>(0.1f));
+            assertFormatsLikePrintf(static_cast<double>(-3.75f));
+            assertFormatsLikePrintf(static_cast<double>(123.456f));
+        }
+        
+        TEST(OutputBufferTest, appendRandomDoublesLikePrintf) {
+            std::mt19937 random(42);
+            std::uniform_int_distribution<int> integers(-65536, 65536);
+            std::uniform_int_distribution<int> binaryPlaces(0, 12);
+            std::uniform_real_distribution<double> reals(-10000.0, 10000.0);
+            
+            for (size_t i = 0; i < 10000; ++i) {
+                assertFormatsLikePrintf(std::ldexp(static_cast<double>(integers(random)), -binaryPlaces(random)));
+                assertFormatsLikePrintf(reals(random));
+            }
+        }
+    }
+}
@@ -0,0 +1,138 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCompression.h"
+#include "IO/DiskIO.h"
+#include "IO/Path.h"
+#include "IO/TextureCache.h"
+
+#include <wx/filefn.h>
+
+namespace TrenchBroom {
+    namespace IO {
+        static Assets::Texture* createCacheTestTexture(const String& name, const size_t width, const size_t height, const unsigned char value) {
+            Assets::TextureBuffer::List buffers(4);
+            Assets::setMipBufferSize(buffers, width, height);
+            for (Assets::TextureBuffer& buffer : buffers) {
+                for (size_t i = 0; i < buffer.size(); ++i)
+                    buffer[i] = static_cast<unsigned char>(value + i);
+            }
+            return new Assets::Texture(name, width, height, Color(0.25f, 0.5f, 0.75f, 1.0f), buffers, GL_BGR);
+        }
+        
+        static void assertBuffersEqual(const Assets::TextureBuffer::List& expected, const Assets::TextureBuffer::List& actual) {
+            ASSERT_EQ(expected.size(), actual.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                ASSERT_EQ(expected[i].size(), actual[i].size());
+                for (size_t j = 0; j < expected[i].size(); ++j)
+                    ASSERT_EQ(expected[i][j], actual[i][j]);
+            }
+        }
+        
+        TEST(TextureCacheTest, writeAndReadTextures) {
+            const Path cacheDirectory = Disk::getCurrentWorkingDir() + Path("texturecachetest");
+            const Path collectionPath("textures/test.wad");
+            
+            Assets::TextureList textures;
+            textures.push_back(createCacheTestTexture("first", 64, 32, 1));
+            textures.push_back(createCacheTestTexture("second", 16, 16, 7));
+            
+            TextureCache cache(cacheDirectory, 1234);
+            Assets::TextureList cached;
+            ASSERT_FALSE(cache.readTextures(collectionPath, 1, cached));
+            
+            cache.writeTextures(collectionPath, 1, textures);
+            
+            ASSERT_FALSE(cache.readTextures(collectionPath, 2, cached));
+            ASSERT_TRUE(cached.empty());
+            
+            // another reader key maps the collection to another cache file
+            TextureCache otherCache(cacheDirectory, 5678);
+            ASSERT_FALSE(otherCache.readTextures(collectionPath, 1, cached));
+
+            ASSERT_TRUE(cache.readTextures(collectionPath, 1, cached));
+            ASSERT_EQ(textures.size(), cached.size());
+            for (size_t i = 0; i < textures.size(); ++i) {
+                ASSERT_TRUE(cached[i]->lazy());
+                ASSERT_EQ(textures[i]->name(), cached[i]->name());
+                ASSERT_EQ(textures[i]->width(), cached[i]->width());
+                ASSERT_EQ(textures[i]->height(), cached[i]->height());
+                ASSERT_EQ(textures[i]->format(), cached[i]->format());
+                ASSERT_EQ(textures[i]->averageColor(), cached[i]->averageColor());
+                assertBuffersEqual(textures[i]->buffers(), cached[i]->decode());
+            }
+            
+            VectorUtils::clearAndDelete(cached);
+            VectorUtils::clearAndDelete(textures);
+            
+            for (const Path& path : Disk::findItems(cacheDirectory))
+                Disk::deleteFile(path);
+            ASSERT_TRUE(::wxRmdir(cacheDirectory.asString()));
+        }
+        
+        TEST(TextureCacheTest, writeAndReadCompressedTextures) {
+            const Path cacheDirectory = Disk::getCurrentWorkingDir() + Path("texturecachetest");
+            const Path collectionPath("textures/test.wad");
+            
+            Assets::TextureList textures;
+            textures.push_back(createCacheTestTexture("first", 64, 32, 1));
+            textures.push_back(createCacheTestTexture("second", 16, 16, 7));
+            for (Assets::Texture* texture : textures) {
+                texture->compress();
+                ASSERT_TRUE(Assets::isCompressed(texture->format()));
+            }
+            
+            TextureCache cache(cacheDirectory, 1234);
+            cache.writeTextures(collectionPath, 1, textures);
+            
+            // compressed mip buffers are much smaller than uncompressed ones, but they are still valid
+            Assets::TextureList cached;
+            ASSERT_TRUE(cache.readTextures(collectionPath, 1, cached));
+            ASSERT_EQ(textures.size(), cached.size());
+            for (size_t i = 0; i < textures.size(); ++i) {
+                ASSERT_EQ(textures[i]->name(), cached[i]->name());
+                ASSERT_EQ(textures[i]->format(), cached[i]->format());
+                assertBuffersEqual(textures[i]->buffers(), cached[i]->decode());
+            }
+            
+            VectorUtils::clearAndDelete(cached);
+            VectorUtils::clearAndDelete(textures);
+            
+            for (const Path& path : Disk::findItems(cacheDirectory))
+                Disk::deleteFile(path);
+            ASSERT_TRUE(::wxRmdir(cacheDirectory.asString()));
+        }
+        
+        TEST(TextureCacheTest, computeKeyDependsOnReaderKey) {
+            const char contents[] = "texture data";
+            MappedFile::List files;
+            files.push_back(MappedFile::Ptr(new MappedFileView(MappedFile::Ptr(), Path("a.wal"), contents, sizeof(contents))));
+            
+            const TextureCache cache1(Path("cache"), 1);
+            const TextureCache cache2(Path("cache"), 2);
+            ASSERT_EQ(cache1.computeKey(files), cache1.computeKey(files));
+            ASSERT_NE(cache1.computeKey(files), cache2.computeKey(files));
+        }
+    }
+}
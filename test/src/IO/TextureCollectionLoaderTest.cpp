@@ -0,0 +1,67 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureCollection.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/FileMatcher.h"
+#include "IO/IdMipTextureReader.h"
+#include "IO/Path.h"
+#include "IO/TextureCollectionLoader.h"
+#include "IO/TextureReader.h"
+#include "IO/WadFileSystem.h"
+
+#include <memory>
+
+namespace TrenchBroom {
+    namespace IO {
+        TEST(TextureCollectionLoaderTest, loadWadInFileOrder) {
+            DiskFileSystem fs(IO::Disk::getCurrentWorkingDir());
+            const Assets::Palette palette = Assets::Palette::loadFile(fs, Path("data/palette.lmp"));
+            
+            TextureReader::TextureNameStrategy nameStrategy;
+            IdMipTextureReader textureReader(nameStrategy, palette);
+            
+            const Path wadPath = Disk::getCurrentWorkingDir() + Path("data/IO/Wad/cr8_czg.wad");
+            WadFileSystem wadFS(wadPath);
+            const Path::List texturePaths = wadFS.findItems(Path(""), FileExtensionMatcher("D"));
+            
+            Path::List searchPaths;
+            searchPaths.push_back(Disk::getCurrentWorkingDir());
+            FileTextureCollectionLoader collectionLoader(searchPaths);
+            
+            std::unique_ptr<Assets::TextureCollection> collection(collectionLoader.loadTextureCollection(Path("data/IO/Wad/cr8_czg.wad"), "D", textureReader));
+            ASSERT_TRUE(collection->loaded());
+            
+            const Assets::TextureList& textures = collection->textures();
+            ASSERT_EQ(texturePaths.size(), textures.size());
+            
+            for (size_t i = 0; i < textures.size(); ++i) {
+                std::unique_ptr<Assets::Texture> expected(textureReader.readTexture(wadFS.openFile(texturePaths[i])));
+                ASSERT_EQ(expected->name(), textures[i]->name());
+                ASSERT_EQ(expected->width(), textures[i]->width());
+                ASSERT_EQ(expected->height(), textures[i]->height());
+            }
+        }
+    }
+}
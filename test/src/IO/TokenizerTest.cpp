@@ -238,5 +238,32 @@ namespace TrenchBroom {
             ASSERT_EQ(SimpleToken::CBrace, (token = tokenizer.nextToken()).type());
             ASSERT_EQ(SimpleToken::Eof, tokenizer.nextToken().type());
         }
+        
+        TEST(TokenizerTest, tokenToFloatMatchesAtof) {
+            typedef TokenTemplate<SimpleToken::Type> Token;
+            
+            const char* numbers[] = {
+                "0", "-0", "+1", "1", "-1", "0.5", ".5", "-.5", "5.", "1e3", "1E-3", "-2.5e+2", "1e",
+                "128.0625", "-0.000001", "123456789012345", "1234567890123456789", "0.1", "0.2", "0.3",
+                "3.14159265358979323846", "1e22", "1e23", "1e-22", "1e-23", "00000000000000000000012.5"
+            };
+            
+            for (const char* number : numbers) {
+                const Token token(SimpleToken::Decimal, number, number + std::strlen(number), 0, 1, 1);
+                ASSERT_EQ(std::atof(number), token.toFloat<double>()) << number;
+                ASSERT_EQ(static_cast<float>(std::atof(number)), token.toFloat<float>()) << number;
+            }
+        }
+        
+        TEST(TokenizerTest, tokenToIntegerMatchesAtoi) {
+            typedef TokenTemplate<SimpleToken::Type> Token;
+            
+            const char* numbers[] = { "0", "-0", "+1", "1", "-1", "123456", "-2147483647", "12.5", "-3.7", "1e3" };
+            
+            for (const char* number : numbers) {
+                const Token token(SimpleToken::Integer, number, number + std::strlen(number), 0, 1, 1);
+                ASSERT_EQ(std::atoi(number), token.toInteger<int>()) << number;
+            }
+        }
     }
 }
@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 
+#include "Exceptions.h"
 #include "IO/TestParserStatus.h"
 #include "IO/WorldReader.h"
 #include "Model/Brush.h"
@@ -62,6 +63,32 @@ namespace TrenchBroom {
             delete world;
         }
         
+        TEST(WorldReaderTest, parseErrorAfterEntity) {
+            const String data("{\n"
+                              "\"classname\" \"worldspawn\"\n"
+                              "}\n"
+                              "{\n"
+                              "\"classname\" \"func_door\"\n"
+                              "{\n"
+                              "( -16 -16 -16 ) ( -16 -15 -16 ) ( -16 -16 -15 ) none 0 0 0 1 1\n"
+                              "( -16 -16 -16 ) ( -16 -16 -15 ) ( -15 -16 -16 ) none 0 0 0 1 1\n"
+                              "( -16 -16 -16 ) ( -15 -16 -16 ) ( -16 -15 -16 ) none 0 0 0 1 1\n"
+                              "( 16 16 16 ) ( 16 17 16 ) ( 17 16 16 ) none 0 0 0 1 1\n"
+                              "( 16 16 16 ) ( 17 16 16 ) ( 16 16 17 ) none 0 0 0 1 1\n"
+                              "( 16 16 16 ) ( 16 16 17 ) ( 16 17 16 ) none 0 0 0 1 1\n"
+                              "}\n"
+                              "}\n"
+                              "{\n"
+                              "\"classname\"\n");
+            BBox3 worldBounds(8192);
+            
+            IO::TestParserStatus status;
+            WorldReader reader(data, nullptr);
+            
+            // the entity and its brush have not been added to the world when the error occurs and are deleted by the reader
+            ASSERT_THROW(reader.read(Model::MapFormat::Standard, worldBounds, status), ParserException);
+        }
+        
         TEST(WorldReaderTest, parseEmptyMap) {
             const String data("");
             BBox3 worldBounds(8192);
@@ -632,6 +659,162 @@ namespace TrenchBroom {
             delete world;
         }
         
+        TEST(WorldReaderTest, parseBrushesAndEntitiesInFileOrder) {
+            const String data("{\n"
+                              "\"classname\" \"worldspawn\"\n"
+                              "{\n"
+                              "( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1\n"
+                              "( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1\n"
+                              "( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1\n"
+                              "( 64 64  -0 ) ( -0 64  -0 ) ( 64 64 -16 ) none 0 0 0 1 1\n"
+                              "( 64 64  -0 ) ( 64 64 -16 ) ( 64 -0  -0 ) none 0 0 0 1 1\n"
+                              "( 64 64  -0 ) ( 64 -0  -0 ) ( -0 64  -0 ) none 0 0 0 1 1\n"
+                              "}\n"
+                              "{\n"
+                              "( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1\n"
+                              "( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1 1\n"
+                              "}\n"
+                              "}\n"
+                              "{\n"
+                              "\"classname\" \"info_player_start\"\n"
+                              "}\n"
+                              "{\n"
+                              "\"classname\" \"func_door\"\n"
+                              "{\n"
+                              "( -800 288 1024 ) ( -736 288 1024 ) ( -736 224 1024 ) none 0 0 0 1 1\n"
+                              "( -800 288 1024 ) ( -800 224 1024 ) ( -800 224 576 ) none 0 0 0 1 1\n"
+                              "( -736 224 1024 ) ( -736 288 1024 ) ( -736 288 576 ) none 0 0 0 1 1\n"
+                              "( -736 288 1024 ) ( -800 288 1024 ) ( -800 288 576 ) none 0 0 0 1 1\n"
+                              "( -800 224 1024 ) ( -736 224 1024 ) ( -736 224 576 ) none 0 0 0 1 1\n"
+                              "( -800 224 576 ) ( -736 224 576 ) ( -736 288 576 ) none 0 0 0 1 1\n"
+                              "}\n"
+                              "}\n");
+            BBox3 worldBounds(8192);
+            
+            IO::TestParserStatus status;
+            WorldReader reader(data, nullptr);
+            
+            Model::World* world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            
+            // the underspecified brush is skipped
+            Model::Node* defaultLayer = world->children().front();
+            ASSERT_EQ(3u, defaultLayer->childCount());
+            
+            const Model::NodeList& children = defaultLayer->children();
+            ASSERT_TRUE(dynamic_cast<Model::Brush*>(children[0]) != nullptr);
+            ASSERT_EQ(3u, children[0]->lineNumber());
+            ASSERT_TRUE(dynamic_cast<Model::Entity*>(children[1]) != nullptr);
+            ASSERT_TRUE(dynamic_cast<Model::Entity*>(children[2]) != nullptr);
+            
+            Model::Node* door = children[2];
+            ASSERT_EQ(1u, door->childCount());
+            ASSERT_EQ(21u, door->children().front()->lineNumber());
+            
+            delete world;
+        }
+        
+        static String makeBrush(const size_t index, const String& textureName) {
+            const size_t x0 = index * 16;
+            const size_t x1 = x0 + 64;
+            StringStream str;
+            str << "{\n"
+                << "( " << x0 << " 0 -16 ) ( " << x0 << " 0 0 ) ( " << x1 << " 0 -16 ) " << textureName << " 0 0 0 1 1\n"
+                << "( " << x0 << " 0 -16 ) ( " << x0 << " 64 -16 ) ( " << x0 << " 0 0 ) " << textureName << " 0 0 0 1 1\n"
+                << "( " << x0 << " 0 -16 ) ( " << x1 << " 0 -16 ) ( " << x0 << " 64 -16 ) " << textureName << " 0 0 0 1 1\n"
+                << "( " << x1 << " 64 0 ) ( " << x0 << " 64 0 ) ( " << x1 << " 64 -16 ) " << textureName << " 0 0 0 1 1\n"
+                << "( " << x1 << " 64 0 ) ( " << x1 << " 64 -16 ) ( " << x1 << " 0 0 ) " << textureName << " 0 0 0 1 1\n"
+                << "( " << x1 << " 64 0 ) ( " << x1 << " 0 0 ) ( " << x0 << " 64 0 ) " << textureName << " 0 0 0 1 1\n"
+                << "}\n";
+            return str.str();
+        }
+        
+        TEST(WorldReaderTest, parseManyBrushesInFileOrder) {
+            // enough brushes to be split into several chunks, with comments, extra attributes and brace texture names in between
+            const size_t brushCount = 300;
+            
+            StringStream str;
+            str << "{\n"
+                << "\"classname\" \"worldspawn\"\n";
+            for (size_t i = 0; i < brushCount; ++i) {
+                if (i % 50 == 0)
+                    str << "// brush " << i << "\n";
+                if (i % 70 == 0)
+                    str << "\"message\" \"brush " << i << "\"\n";
+                str << makeBrush(i, i % 3 == 0 ? "{fence" : "none");
+            }
+            str << "}\n"
+                << "{\n"
+                << "\"classname\" \"func_wall\"\n"
+                << makeBrush(0, "}none")
+                << "}\n";
+            const String data = str.str();
+            
+            BBox3 worldBounds(8192);
+            
+            IO::TestParserStatus status;
+            WorldReader reader(data, nullptr);
+            
+            Model::World* world = reader.read(Model::MapFormat::Standard, worldBounds, status);
+            
+            Model::Node* defaultLayer = world->children().front();
+            ASSERT_EQ(brushCount + 1, defaultLayer->childCount());
+            
+            // the duplicate message attributes are ignored
+            ASSERT_EQ(String("brush 0"), world->attribute("message"));
+            
+            const Model::NodeList& children = defaultLayer->children();
+            size_t line = 3;
+            for (size_t i = 0; i < brushCount; ++i) {
+                if (i % 50 == 0)
+                    ++line;
+                if (i % 70 == 0)
+                    ++line;
+                
+                Model::Brush* brush = dynamic_cast<Model::Brush*>(children[i]);
+                ASSERT_TRUE(brush != nullptr);
+                ASSERT_EQ(line, brush->lineNumber());
+                ASSERT_TRUE(brush->containsLine(line + 6));
+                ASSERT_FALSE(brush->containsLine(line + 7));
+                ASSERT_EQ(i % 3 == 0 ? "{fence" : "none", brush->faces().front()->textureName());
+                line += 8;
+            }
+            
+            Model::Entity* wall = dynamic_cast<Model::Entity*>(children.back());
+            ASSERT_TRUE(wall != nullptr);
+            ASSERT_EQ(line + 1, wall->lineNumber());
+            ASSERT_EQ(1u, wall->childCount());
+            ASSERT_EQ(line + 3, wall->children().front()->lineNumber());
+            
+            delete world;
+        }
+        
+        TEST(WorldReaderTest, parseErrorInLaterBrush) {
+            StringStream str;
+            str << "{\n"
+                << "\"classname\" \"worldspawn\"\n";
+            for (size_t i = 0; i < 100; ++i)
+                str << makeBrush(i, "none");
+            str << "{\n"
+                << "( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) none 0 0 0 1 1\n"
+                << "( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) none 0 0 0 1\n"
+                << "( -0 -0 -16 ) ( 64 -0 -16 ) ( -0 64 -16 ) none 0 0 0 1 1\n"
+                << "}\n"
+                << "}\n";
+            const String data = str.str();
+            
+            BBox3 worldBounds(8192);
+            
+            IO::TestParserStatus status;
+            WorldReader reader(data, nullptr);
+            
+            try {
+                reader.read(Model::MapFormat::Standard, worldBounds, status);
+                FAIL();
+            } catch (const ParserException& e) {
+                ASSERT_TRUE(StringUtils::containsCaseSensitive(e.what(), "line 806,"));
+            }
+        }
+        
         TEST(WorldReaderTest, parseMultipleClassnames) {
             // See https://github.com/kduske/TrenchBroom/issues/1485
             
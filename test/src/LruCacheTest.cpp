@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "LruCache.h"
+
+#include <string>
+
+namespace {
+    struct CountingCreate {
+        size_t& calls;
+
+        CountingCreate(size_t& i_calls) :
+        calls(i_calls) {}
+
+        std::string* operator()(const int key) const {
+            ++calls;
+            return new std::string(std::to_string(key));
+        }
+    };
+}
+
+TEST(LruCacheTest, getCreatesMissingValues) {
+    size_t calls = 0;
+    LruCache<int, std::string> cache(2);
+
+    ASSERT_EQ("1", *cache.get(1, CountingCreate(calls)));
+    ASSERT_EQ("1", *cache.get(1, CountingCreate(calls)));
+    ASSERT_EQ(1u, calls);
+    ASSERT_EQ(1u, cache.size());
+}
+
+TEST(LruCacheTest, dropLeastRecentlyUsedValue) {
+    size_t calls = 0;
+    LruCache<int, std::string> cache(2);
+
+    cache.get(1, CountingCreate(calls));
+    cache.get(2, CountingCreate(calls));
+
+    // 1 becomes the most recently used value, so 2 is dropped
+    cache.get(1, CountingCreate(calls));
+    cache.get(3, CountingCreate(calls));
+
+    ASSERT_EQ(2u, cache.size());
+    ASSERT_TRUE(cache.contains(1));
+    ASSERT_FALSE(cache.contains(2));
+    ASSERT_TRUE(cache.contains(3));
+    ASSERT_EQ(3u, calls);
+
+    cache.get(2, CountingCreate(calls));
+    ASSERT_EQ(4u, calls);
+    ASSERT_FALSE(cache.contains(1));
+}
+
+TEST(LruCacheTest, droppedValuesStayValid) {
+    size_t calls = 0;
+    LruCache<int, std::string> cache(1);
+
+    const LruCache<int, std::string>::ValuePtr value = cache.get(1, CountingCreate(calls));
+    cache.get(2, CountingCreate(calls));
+
+    ASSERT_FALSE(cache.contains(1));
+    ASSERT_EQ("1", *value);
+}
+
+TEST(LruCacheTest, clear) {
+    size_t calls = 0;
+    LruCache<int, std::string> cache(2);
+
+    cache.get(1, CountingCreate(calls));
+    cache.clear();
+
+    ASSERT_EQ(0u, cache.size());
+    ASSERT_FALSE(cache.contains(1));
+}
@@ -0,0 +1,189 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "Exceptions.h"
+#include "VecMath.h"
+#include "Model/AABBTree.h"
+
+#include <algorithm>
+
+namespace TrenchBroom {
+    namespace Model {
+        typedef AABBTree<float, int> IntTree;
+        
+        TEST(AABBTreeTest, insertObject) {
+            IntTree tree;
+            ASSERT_TRUE(tree.empty());
+            
+            const int a = 1;
+            const BBox3f aBounds(1.0f, 2.0f);
+            tree.addObject(aBounds, a);
+            ASSERT_TRUE(tree.containsObject(a));
+            ASSERT_EQ(1u, tree.size());
+            ASSERT_EQ(aBounds, tree.bounds());
+        }
+        
+        TEST(AABBTreeTest, insertObjectTwice) {
+            IntTree tree;
+            
+            const int a = 1;
+            tree.addObject(BBox3f(1.0f, 2.0f), a);
+            ASSERT_THROW(tree.addObject(BBox3f(3.0f, 4.0f), a), AABBTreeException);
+        }
+        
+        TEST(AABBTreeTest, removeExistingObject) {
+            IntTree tree;
+            
+            const int a = 1;
+            const int b = 2;
+            const int c = 3;
+            tree.addObject(BBox3f(1.0f, 2.0f), a);
+            tree.addObject(BBox3f(3.0f, 4.0f), b);
+            tree.addObject(BBox3f(-4.0f, -3.0f), c);
+            
+            tree.removeObject(b);
+            ASSERT_FALSE(tree.containsObject(b));
+            ASSERT_EQ(2u, tree.size());
+            ASSERT_EQ(BBox3f(-4.0f, 2.0f), tree.bounds());
+            
+            tree.removeObject(a);
+            tree.removeObject(c);
+            ASSERT_TRUE(tree.empty());
+        }
+        
+        TEST(AABBTreeTest, removeNonExistingObject) {
+            IntTree tree;
+            
+            const int a = 1;
+            const int b = 2;
+            tree.addObject(BBox3f(1.0f, 2.0f), a);
+            ASSERT_THROW(tree.removeObject(b), AABBTreeException);
+        }
+        
+        TEST(AABBTreeTest, updateObject) {
+            IntTree tree;
+            for (int i = 0; i < 10; ++i)
+                tree.addObject(BBox3f(Vec3f(static_cast<float>(i * 10), 0.0f, 0.0f), 2.0f), i);
+            
+            // stays within its parent
+            tree.updateObject(BBox3f(Vec3f(41.0f, 0.0f, 0.0f), 2.0f), 4);
+            // moves to a different place in the tree
+            tree.updateObject(BBox3f(Vec3f(0.0f, 0.0f, 200.0f), 2.0f), 9);
+            
+            ASSERT_EQ(BBox3f(Vec3f(-2.0f, -2.0f, -2.0f), Vec3f(82.0f, 2.0f, 202.0f)), tree.bounds());
+            
+            IntTree::List objects = tree.findObjects(Vec3f(41.5f, 0.0f, 0.0f));
+            ASSERT_EQ(1u, objects.size());
+            ASSERT_EQ(4, objects.front());
+            
+            objects = tree.findObjects(Vec3f(90.0f, 0.0f, 0.0f));
+            ASSERT_TRUE(objects.empty());
+            
+            objects = tree.findObjects(Vec3f(0.0f, 0.0f, 200.0f));
+            ASSERT_EQ(1u, objects.size());
+            ASSERT_EQ(9, objects.front());
+        }
+        
+        TEST(AABBTreeTest, updateObjectWithinMargin) {
+            IntTree tree(4.0f);
+            tree.addObject(BBox3f(Vec3f(0.0f, 0.0f, 0.0f), 1.0f), 1);
+            tree.addObject(BBox3f(Vec3f(10.0f, 0.0f, 0.0f), 1.0f), 2);
+            ASSERT_EQ(BBox3f(Vec3f(-5.0f, -5.0f, -5.0f), Vec3f(15.0f, 5.0f, 5.0f)), tree.bounds());
+            
+            // the leaf still contains the object, so the tree does not change
+            tree.updateObject(BBox3f(Vec3f(2.0f, 0.0f, 0.0f), 1.0f), 1);
+            ASSERT_EQ(BBox3f(Vec3f(-5.0f, -5.0f, -5.0f), Vec3f(15.0f, 5.0f, 5.0f)), tree.bounds());
+            
+            // but queries use the exact bounds
+            ASSERT_TRUE(tree.findObjects(Vec3f(0.5f, 0.0f, 0.0f)).empty());
+            ASSERT_EQ(IntTree::List(1, 1), tree.findObjects(Vec3f(2.5f, 0.0f, 0.0f)));
+            ASSERT_TRUE(tree.findObjects(Ray3f(Vec3f(0.5f, 0.0f, -10.0f), Vec3f::PosZ)).empty());
+            
+            // the new leaf is extended in the direction of the movement by at most four times the margin
+            tree.updateObject(BBox3f(Vec3f(-10.0f, 0.0f, 0.0f), 1.0f), 1);
+            ASSERT_EQ(BBox3f(Vec3f(-31.0f, -5.0f, -5.0f), Vec3f(15.0f, 5.0f, 5.0f)), tree.bounds());
+        }
+        
+        TEST(AABBTreeTest, updateObjectPredictsMovement) {
+            IntTree tree(4.0f);
+            tree.addObject(BBox3f(Vec3f(0.0f, 0.0f, 0.0f), 1.0f), 1);
+            tree.addObject(BBox3f(Vec3f(100.0f, 0.0f, 0.0f), 1.0f), 2);
+            
+            // leaves the leaf, which is then extended by four times the displacement towards +x
+            tree.updateObject(BBox3f(Vec3f(6.0f, 0.0f, 0.0f), 1.0f), 1);
+            ASSERT_EQ(BBox3f(Vec3f(1.0f, -5.0f, -5.0f), Vec3f(27.0f, 5.0f, 5.0f)).mergedWith(BBox3f(Vec3f(100.0f, 0.0f, 0.0f), 5.0f)), tree.bounds());
+            
+            // the following steps in the same direction stay within the extended leaf
+            for (int i = 2; i <= 4; ++i) {
+                tree.updateObject(BBox3f(Vec3f(static_cast<float>(6 * i), 0.0f, 0.0f), 1.0f), 1);
+                ASSERT_EQ(BBox3f(Vec3f(1.0f, -5.0f, -5.0f), Vec3f(27.0f, 5.0f, 5.0f)).mergedWith(BBox3f(Vec3f(100.0f, 0.0f, 0.0f), 5.0f)), tree.bounds());
+            }
+            ASSERT_EQ(IntTree::List(1, 1), tree.findObjects(Vec3f(24.5f, 0.0f, 0.0f)));
+        }
+        
+        TEST(AABBTreeTest, findObjectsAlongRay) {
+            IntTree tree;
+            for (int i = 0; i < 100; ++i)
+                tree.addObject(BBox3f(Vec3f(static_cast<float>(i % 10) * 10.0f, static_cast<float>(i / 10) * 10.0f, 0.0f), 2.0f), i);
+            
+            const Ray3f ray(Vec3f(-10.0f, 30.0f, 0.0f), Vec3f::PosX);
+            IntTree::List objects = tree.findObjects(ray);
+            std::sort(std::begin(objects), std::end(objects));
+            
+            ASSERT_EQ(10u, objects.size());
+            for (int i = 0; i < 10; ++i)
+                ASSERT_EQ(30 + i, objects[static_cast<size_t>(i)]);
+        }
+        
+        TEST(AABBTreeTest, findObjectsStartingInside) {
+            IntTree tree;
+            tree.addObject(BBox3f(-2.0f, 2.0f), 1);
+            tree.addObject(BBox3f(Vec3f(0.0f, 0.0f, -10.0f), 1.0f), 2);
+            
+            const IntTree::List objects = tree.findObjects(Ray3f(Vec3f::Null, Vec3f::PosZ));
+            ASSERT_EQ(IntTree::List(1, 1), objects);
+        }
+        
+        TEST(AABBTreeTest, findClosestObjectAlongRay) {
+            IntTree tree;
+            for (int i = 0; i < 100; ++i)
+                tree.addObject(BBox3f(Vec3f(static_cast<float>(i) * 10.0f, 0.0f, 0.0f), 2.0f), i);
+            
+            // looks for the closest object, visiting the objects close to the origin first
+            const Ray3f ray(Vec3f(1000.0f, 0.0f, 0.0f), Vec3f::NegX);
+            int closest = -1;
+            size_t visited = 0;
+            tree.findObjects(ray, [&](const int object, const float maxDistance) {
+                ++visited;
+                const float distance = 1000.0f - static_cast<float>(object) * 10.0f - 2.0f;
+                if (distance < maxDistance) {
+                    closest = object;
+                    return distance;
+                }
+                return maxDistance;
+            });
+            
+            ASSERT_EQ(99, closest);
+            ASSERT_LT(visited, 10u);
+        }
+    }
+}
@@ -0,0 +1,150 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "TrenchBroom.h"
+#include "VecMath.h"
+#include "Polyhedron.h"
+#include "Polyhedron_DefaultPayload.h"
+#include "Model/BrushPlaneTopology.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        static const BBox3 WorldBounds(8192.0);
+
+        static Plane3::List facePlanes(const Polyhedron3& polyhedron) {
+            Plane3::List planes;
+            for (const auto* face : polyhedron.faces()) {
+                planes.push_back(Plane3(face->origin(), face->normal()));
+            }
+            return planes;
+        }
+
+        static void assertTopology(const Polyhedron3& expected, const Plane3::List& planes) {
+            const BrushPlaneTopology topology(planes, WorldBounds);
+            ASSERT_TRUE(topology.success());
+            ASSERT_EQ(planes.size(), topology.faces().size());
+
+            Polyhedron3::Callback callback;
+            const Polyhedron3 actual(topology.vertices(), topology.faces(), callback);
+
+            ASSERT_EQ(expected.vertexCount(), actual.vertexCount());
+            ASSERT_EQ(expected.edgeCount(), actual.edgeCount());
+            ASSERT_EQ(expected.faceCount(), actual.faceCount());
+            ASSERT_TRUE(actual.closed());
+
+            for (const auto* vertex : expected.vertices()) {
+                ASSERT_TRUE(actual.hasVertex(vertex->position(), 0.0001));
+            }
+
+            for (const auto* edge : expected.edges()) {
+                ASSERT_TRUE(actual.hasEdge(edge->firstVertex()->position(), edge->secondVertex()->position(), 0.0001));
+            }
+
+            // each face lies on its plane and has the same orientation
+            size_t index = 0;
+            for (const auto* face : actual.faces()) {
+                const auto& plane = planes[index++];
+                ASSERT_TRUE(face->normal().equals(plane.normal, 0.0001));
+                for (const auto& position : face->vertexPositions()) {
+                    ASSERT_EQ(Math::PointStatus::PSInside, plane.pointStatus(position));
+                }
+            }
+        }
+
+        TEST(BrushPlaneTopologyTest, box) {
+            const Polyhedron3 box(BBox3(Vec3(-16.0, -32.0, 0.0), Vec3(16.0, 32.0, 128.0)));
+            assertTopology(box, facePlanes(box));
+        }
+
+        TEST(BrushPlaneTopologyTest, boxFromUnorderedPlanes) {
+            Plane3::List planes;
+            planes.push_back(Plane3(64.0, Vec3::PosZ));
+            planes.push_back(Plane3(0.0, Vec3::NegX));
+            planes.push_back(Plane3(0.0, Vec3::NegZ));
+            planes.push_back(Plane3(32.0, Vec3::PosY));
+            planes.push_back(Plane3(32.0, Vec3::PosX));
+            planes.push_back(Plane3(0.0, Vec3::NegY));
+
+            const Polyhedron3 box(BBox3(Vec3(0.0, 0.0, 0.0), Vec3(32.0, 32.0, 64.0)));
+            assertTopology(box, planes);
+        }
+
+        TEST(BrushPlaneTopologyTest, tetrahedron) {
+            const Polyhedron3 tetrahedron { Vec3(0.0, 0.0, 0.0), Vec3(64.0, 0.0, 0.0), Vec3(0.0, 64.0, 0.0), Vec3(0.0, 0.0, 64.0) };
+            assertTopology(tetrahedron, facePlanes(tetrahedron));
+        }
+
+        TEST(BrushPlaneTopologyTest, pyramid) {
+            // four planes meet at the apex
+            const Polyhedron3 pyramid { Vec3(-32.0, -32.0, 0.0), Vec3(32.0, -32.0, 0.0), Vec3(32.0, 32.0, 0.0), Vec3(-32.0, 32.0, 0.0), Vec3(0.0, 0.0, 48.0) };
+            assertTopology(pyramid, facePlanes(pyramid));
+        }
+
+        TEST(BrushPlaneTopologyTest, octagonalPrism) {
+            const Polyhedron3 prism {
+                Vec3(-16.0, -40.0, 0.0), Vec3(16.0, -40.0, 0.0), Vec3(40.0, -16.0, 0.0), Vec3(40.0, 16.0, 0.0),
+                Vec3(16.0, 40.0, 0.0), Vec3(-16.0, 40.0, 0.0), Vec3(-40.0, 16.0, 0.0), Vec3(-40.0, -16.0, 0.0),
+                Vec3(-16.0, -40.0, 64.0), Vec3(16.0, -40.0, 64.0), Vec3(40.0, -16.0, 64.0), Vec3(40.0, 16.0, 64.0),
+                Vec3(16.0, 40.0, 64.0), Vec3(-16.0, 40.0, 64.0), Vec3(-40.0, 16.0, 64.0), Vec3(-40.0, -16.0, 64.0)
+            };
+            ASSERT_EQ(10u, prism.faceCount());
+            assertTopology(prism, facePlanes(prism));
+        }
+
+        TEST(BrushPlaneTopologyTest, redundantPlane) {
+            const Polyhedron3 box(BBox3(Vec3(0.0, 0.0, 0.0), Vec3(32.0, 32.0, 32.0)));
+
+            Plane3::List planes = facePlanes(box);
+            planes.push_back(Plane3(64.0, Vec3::PosX));
+            ASSERT_FALSE(BrushPlaneTopology(planes, WorldBounds).success());
+        }
+
+        TEST(BrushPlaneTopologyTest, planeTouchingEdge) {
+            const Polyhedron3 box(BBox3(Vec3(0.0, 0.0, 0.0), Vec3(32.0, 32.0, 32.0)));
+
+            Plane3::List planes = facePlanes(box);
+            planes.push_back(Plane3(Vec3(32.0, 32.0, 0.0), Vec3(1.0, 1.0, 0.0).normalized()));
+            ASSERT_FALSE(BrushPlaneTopology(planes, WorldBounds).success());
+        }
+
+        TEST(BrushPlaneTopologyTest, duplicatePlane) {
+            const Polyhedron3 tetrahedron { Vec3(0.0, 0.0, 0.0), Vec3(64.0, 0.0, 0.0), Vec3(0.0, 64.0, 0.0), Vec3(0.0, 0.0, 64.0) };
+
+            Plane3::List planes = facePlanes(tetrahedron);
+            planes.push_back(planes.front());
+            ASSERT_FALSE(BrushPlaneTopology(planes, WorldBounds).success());
+        }
+
+        TEST(BrushPlaneTopologyTest, unbounded) {
+            Plane3::List planes;
+            planes.push_back(Plane3(0.0, Vec3::PosX));
+            planes.push_back(Plane3(0.0, Vec3::PosY));
+            planes.push_back(Plane3(0.0, Vec3::PosZ));
+            planes.push_back(Plane3(0.0, Vec3(1.0, 1.0, 1.0).normalized()));
+            ASSERT_FALSE(BrushPlaneTopology(planes, WorldBounds).success());
+        }
+
+        TEST(BrushPlaneTopologyTest, outsideWorldBounds) {
+            const Polyhedron3 box(BBox3(Vec3(8000.0, 0.0, 0.0), Vec3(8200.0, 32.0, 32.0)));
+            ASSERT_FALSE(BrushPlaneTopology(facePlanes(box), WorldBounds).success());
+        }
+    }
+}
@@ -37,6 +37,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <random>
 
 namespace TrenchBroom {
     namespace Model {
@@ -574,6 +575,74 @@ namespace TrenchBroom {
             ASSERT_TRUE(hits2.empty());
         }
 
+        TEST(BrushTest, pickFromInside) {
+            const BBox3 worldBounds(4096.0);
+            
+            World world(MapFormat::Standard, nullptr, worldBounds);
+            
+            BrushBuilder builder(&world, worldBounds);
+            std::unique_ptr<Brush> brush(builder.createCube(16.0, "texture"));
+            
+            PickResult hits;
+            brush->pick(Ray3(Vec3::Null, Vec3::PosX), hits);
+            ASSERT_TRUE(hits.empty());
+        }
+        
+        TEST(BrushTest, pickMatchesFacePolygons) {
+            const BBox3 worldBounds(4096.0);
+            
+            BrushFaceList faces;
+            faces.push_back(BrushFace::createParaxial(Vec3(624.0, 688.0, -456.0), Vec3(656.0, 760.0, -480.0), Vec3(624.0, 680.0, -480.0), "face7"));
+            faces.push_back(BrushFace::createParaxial(Vec3(536.0, 792.0, -480.0), Vec3(536.0, 792.0, -432.0), Vec3(488.0, 720.0, -480.0), "face12"));
+            faces.push_back(BrushFace::createParaxial(Vec3(568.0, 656.0, -464.0), Vec3(568.0, 648.0, -480.0), Vec3(520.0, 672.0, -456.0), "face14"));
+            faces.push_back(BrushFace::createParaxial(Vec3(520.0, 672.0, -456.0), Vec3(520.0, 664.0, -480.0), Vec3(488.0, 720.0, -452.0), "face15"));
+            faces.push_back(BrushFace::createParaxial(Vec3(560.0, 728.0, -440.0), Vec3(488.0, 720.0, -452.0), Vec3(536.0, 792.0, -432.0), "face17"));
+            faces.push_back(BrushFace::createParaxial(Vec3(568.0, 656.0, -464.0), Vec3(520.0, 672.0, -456.0), Vec3(624.0, 688.0, -456.0), "face19"));
+            faces.push_back(BrushFace::createParaxial(Vec3(560.0, 728.0, -440.0), Vec3(624.0, 688.0, -456.0), Vec3(520.0, 672.0, -456.0), "face20"));
+            faces.push_back(BrushFace::createParaxial(Vec3(600.0, 840.0, -480.0), Vec3(536.0, 792.0, -480.0), Vec3(636.0, 812.0, -480.0), "face22"));
+            
+            const Brush brush(worldBounds, faces);
+            const BBox3& bounds = brush.bounds();
+            
+            std::mt19937 random(1);
+            std::uniform_real_distribution<FloatType> unit(0.0, 1.0);
+            const auto randomPoint = [&](const BBox3& box) {
+                return Vec3(box.min.x() + unit(random) * (box.max.x() - box.min.x()),
+                            box.min.y() + unit(random) * (box.max.y() - box.min.y()),
+                            box.min.z() + unit(random) * (box.max.z() - box.min.z()));
+            };
+            
+            size_t hitCount = 0;
+            for (size_t i = 0; i < 2000; ++i) {
+                const Vec3 origin = randomPoint(bounds.expanded(64.0));
+                const Vec3 target = randomPoint(bounds);
+                const Ray3 ray(origin, (target - origin).normalized());
+                
+                BrushFace* expectedFace = nullptr;
+                FloatType expectedDistance = Math::nan<FloatType>();
+                for (BrushFace* face : brush.faces()) {
+                    expectedDistance = face->intersectWithRay(ray);
+                    if (!Math::isnan(expectedDistance)) {
+                        expectedFace = face;
+                        break;
+                    }
+                }
+                
+                PickResult hits;
+                brush.pick(ray, hits);
+                if (expectedFace == nullptr) {
+                    ASSERT_TRUE(hits.empty());
+                } else {
+                    ASSERT_EQ(1u, hits.size());
+                    const Hit& hit = hits.all().front();
+                    ASSERT_EQ(expectedFace, hit.target<BrushFace*>());
+                    ASSERT_NEAR(expectedDistance, hit.distance(), 0.0001);
+                    ++hitCount;
+                }
+            }
+            ASSERT_LT(0u, hitCount);
+        }
+        
         TEST(BrushTest, partialSelectionAfterAdd) {
             const BBox3 worldBounds(4096.0);
 
@@ -0,0 +1,145 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/CollectContainedNodesVisitor.h"
+#include "Model/CollectTouchingNodes.h"
+#include "Model/CollectTouchingNodesVisitor.h"
+#include "Model/EditorContext.h"
+#include "Model/EntityAttributes.h"
+#include "Model/Entity.h"
+#include "Model/Group.h"
+#include "Model/Layer.h"
+#include "Model/World.h"
+
+namespace TrenchBroom {
+    namespace Model {
+        class CollectTouchingNodesTest : public ::testing::Test {
+        protected:
+            BBox3 worldBounds;
+            World* world;
+            EditorContext context;
+            
+            void SetUp() override {
+                worldBounds = BBox3(8192.0);
+                world = new World(MapFormat::Standard, nullptr, worldBounds);
+                
+                // a grid of brushes, every third of which is moved into a brush entity or a group
+                Layer* layer = world->defaultLayer();
+                for (size_t x = 0; x < 8; ++x) {
+                    for (size_t y = 0; y < 8; ++y) {
+                        const Vec3 min(32.0 * x, 32.0 * y, 0.0);
+                        Brush* brush = createBrush(BBox3(min, min + Vec3(32.0, 32.0, 32.0)));
+                        switch ((x + y) % 3) {
+                            case 0:
+                                layer->addChild(brush);
+                                break;
+                            case 1: {
+                                Entity* entity = world->createEntity();
+                                entity->addChild(brush);
+                                layer->addChild(entity);
+                                break;
+                            }
+                            default: {
+                                Group* group = world->createGroup("group");
+                                group->addChild(brush);
+                                layer->addChild(group);
+                                break;
+                            }
+                        }
+                    }
+                }
+                
+                Entity* pointEntity = world->createEntity();
+                pointEntity->addOrUpdateAttribute(AttributeNames::Origin, Vec3(100.0, 100.0, 16.0));
+                layer->addChild(pointEntity);
+            }
+            
+            void TearDown() override {
+                delete world;
+                world = nullptr;
+            }
+            
+            Brush* createBrush(const BBox3& bounds) const {
+                BrushBuilder builder(world, worldBounds);
+                return builder.createCuboid(bounds, "texture");
+            }
+            
+            NodeList visitTouchingNodes(const BrushList& brushes) {
+                CollectTouchingNodesVisitor<BrushList::const_iterator> visitor(std::begin(brushes), std::end(brushes), context);
+                world->acceptAndRecurse(visitor);
+                return visitor.nodes();
+            }
+            
+            NodeList visitContainedNodes(const BrushList& brushes) {
+                CollectContainedNodesVisitor<BrushList::const_iterator> visitor(std::begin(brushes), std::end(brushes), context);
+                world->acceptAndRecurse(visitor);
+                return visitor.nodes();
+            }
+        };
+        
+        TEST_F(CollectTouchingNodesTest, collectTouchingNodes) {
+            Brush* brush = createBrush(BBox3(Vec3(40.0, 40.0, 8.0), Vec3(120.0, 90.0, 24.0)));
+            
+            const BrushList brushes(1, brush);
+            const NodeList expected = visitTouchingNodes(brushes);
+            ASSERT_FALSE(expected.empty());
+            ASSERT_EQ(expected, collectTouchingNodes(world, brushes, context));
+            
+            delete brush;
+        }
+        
+        TEST_F(CollectTouchingNodesTest, collectContainedNodes) {
+            Brush* brush = createBrush(BBox3(Vec3(16.0, 16.0, -8.0), Vec3(200.0, 150.0, 120.0)));
+            
+            const BrushList brushes(1, brush);
+            const NodeList expected = visitContainedNodes(brushes);
+            ASSERT_FALSE(expected.empty());
+            ASSERT_EQ(expected, collectContainedNodes(world, brushes, context));
+            
+            delete brush;
+        }
+        
+        TEST_F(CollectTouchingNodesTest, collectNodesWithBrushesInWorld) {
+            Brush* inner = createBrush(BBox3(Vec3(70.0, 70.0, 4.0), Vec3(90.0, 90.0, 28.0)));
+            Brush* outer = createBrush(BBox3(Vec3(0.0, 0.0, -16.0), Vec3(128.0, 128.0, 64.0)));
+            world->defaultLayer()->addChild(inner);
+            world->defaultLayer()->addChild(outer);
+            
+            BrushList brushes;
+            brushes.push_back(inner);
+            brushes.push_back(outer);
+            
+            const NodeList touching = collectTouchingNodes(world, brushes, context);
+            ASSERT_EQ(visitTouchingNodes(brushes), touching);
+            ASSERT_TRUE(VectorUtils::contains(touching, inner));
+            ASSERT_TRUE(VectorUtils::contains(touching, outer));
+            
+            const NodeList contained = collectContainedNodes(world, brushes, context);
+            ASSERT_EQ(visitContainedNodes(brushes), contained);
+            ASSERT_TRUE(VectorUtils::contains(contained, inner));
+            ASSERT_FALSE(VectorUtils::contains(contained, outer));
+        }
+    }
+}
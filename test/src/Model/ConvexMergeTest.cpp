@@ -0,0 +1,119 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/ConvexMerge.h"
+#include "Model/Layer.h"
+#include "Model/World.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Model {
+        class ConvexMergeTest : public ::testing::Test {
+        protected:
+            BBox3 worldBounds;
+            World* world;
+            BrushList brushes;
+            std::vector<double> progress;
+            
+            void SetUp() override {
+                worldBounds = BBox3(8192.0);
+                world = new World(MapFormat::Standard, nullptr, worldBounds);
+            }
+            
+            void TearDown() override {
+                delete world;
+                world = nullptr;
+            }
+            
+            Brush* createBrush(const BBox3& bounds) {
+                BrushBuilder builder(world, worldBounds);
+                Brush* brush = builder.createCuboid(bounds, "texture");
+                world->defaultLayer()->addChild(brush);
+                brushes.push_back(brush);
+                return brush;
+            }
+            
+            ConvexMergeProgress recordProgress() {
+                return [this](const double fraction) { progress.push_back(fraction); };
+            }
+            
+            void assertProgress() const {
+                ASSERT_FALSE(progress.empty());
+                ASSERT_DOUBLE_EQ(1.0, progress.back());
+                for (size_t i = 1; i < progress.size(); ++i)
+                    ASSERT_LE(progress[i - 1], progress[i]);
+            }
+        };
+        
+        TEST_F(ConvexMergeTest, mergeAdjacentBrushes) {
+            createBrush(BBox3(Vec3(0.0, 0.0, 0.0), Vec3(32.0, 32.0, 32.0)));
+            createBrush(BBox3(Vec3(32.0, 0.0, 0.0), Vec3(64.0, 32.0, 32.0)));
+            
+            const Polyhedron3 result = convexMerge(brushes, recordProgress());
+            ASSERT_EQ(Polyhedron3(BBox3(Vec3(0.0, 0.0, 0.0), Vec3(64.0, 32.0, 32.0))), result);
+            assertProgress();
+        }
+        
+        TEST_F(ConvexMergeTest, mergeContainedBrushes) {
+            const Brush* outer = createBrush(BBox3(Vec3(-64.0, -64.0, -64.0), Vec3(64.0, 64.0, 64.0)));
+            createBrush(BBox3(Vec3(-64.0, -64.0, -64.0), Vec3(0.0, 0.0, 0.0)));
+            createBrush(BBox3(Vec3(16.0, 16.0, 16.0), Vec3(32.0, 32.0, 32.0)));
+            
+            const Polyhedron3 result = convexMerge(brushes, recordProgress());
+            ASSERT_EQ(Polyhedron3(outer->vertexPositions()), result);
+            assertProgress();
+        }
+        
+        TEST_F(ConvexMergeTest, mergeManyBrushes) {
+            // enough vertices to compute the hull in chunks
+            Vec3::List points;
+            for (size_t x = 0; x < 16; ++x) {
+                for (size_t y = 0; y < 16; ++y) {
+                    const Vec3 min(32.0 * x, 32.0 * y, 8.0 * ((x * 7 + y * 3) % 5));
+                    const Brush* brush = createBrush(BBox3(min, min + Vec3(32.0, 32.0, 32.0)));
+                    VectorUtils::append(points, brush->vertexPositions());
+                }
+            }
+            
+            const Polyhedron3 result = convexMerge(brushes, recordProgress());
+            ASSERT_EQ(Polyhedron3(points), result);
+            assertProgress();
+        }
+        
+        TEST_F(ConvexMergeTest, mergeFaces) {
+            const Brush* first = createBrush(BBox3(Vec3(0.0, 0.0, 0.0), Vec3(32.0, 32.0, 32.0)));
+            const Brush* second = createBrush(BBox3(Vec3(64.0, 0.0, 0.0), Vec3(96.0, 32.0, 32.0)));
+            
+            BrushFaceList faces;
+            faces.push_back(first->findFace(Vec3::NegX));
+            faces.push_back(second->findFace(Vec3::PosX));
+            
+            const Polyhedron3 result = convexMerge(faces, recordProgress());
+            ASSERT_EQ(Polyhedron3(BBox3(Vec3(0.0, 0.0, 0.0), Vec3(96.0, 32.0, 32.0))), result);
+            assertProgress();
+        }
+    }
+}
@@ -0,0 +1,168 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "CollectionUtils.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/CsgSubtract.h"
+#include "Model/Layer.h"
+#include "Model/World.h"
+
+#include <algorithm>
+
+namespace TrenchBroom {
+    namespace Model {
+        class CsgSubtractTest : public ::testing::Test {
+        protected:
+            BBox3 worldBounds;
+            World* world;
+            
+            void SetUp() override {
+                worldBounds = BBox3(8192.0);
+                world = new World(MapFormat::Standard, nullptr, worldBounds);
+            }
+            
+            void TearDown() override {
+                delete world;
+                world = nullptr;
+            }
+            
+            Brush* createBrush(const BBox3& bounds, const String& textureName) const {
+                BrushBuilder builder(world, worldBounds);
+                Brush* brush = builder.createCuboid(bounds, textureName);
+                world->defaultLayer()->addChild(brush);
+                return brush;
+            }
+            
+            static FloatType volume(const NodeList& nodes) {
+                FloatType result = 0.0;
+                for (const Node* node : nodes) {
+                    const Brush* brush = static_cast<const Brush*>(node);
+                    result += Polyhedron3(brush->vertexPositions()).volume();
+                }
+                return result;
+            }
+        };
+        
+        TEST_F(CsgSubtractTest, mergeFragmentsOfAdjacentBrushes) {
+            /*
+             ___________
+             |   | |   |
+             |   |_|   |
+             |   |     |
+             |___|_____|
+             
+             */
+            
+            Brush* left = createBrush(BBox3(Vec3(-32.0, -32.0, -16.0), Vec3(0.0, 32.0, 16.0)), "texture");
+            Brush* right = createBrush(BBox3(Vec3(0.0, -32.0, -16.0), Vec3(32.0, 32.0, 16.0)), "texture");
+            Brush* subtrahend = createBrush(BBox3(Vec3(-16.0, -64.0, -32.0), Vec3(16.0, 0.0, 32.0)), "subtrahend");
+            
+            const CsgSubtract subtraction(BrushList { left, right }, subtrahend);
+            ASSERT_EQ(BrushList({ left, right }), subtraction.subtractedBrushes());
+            
+            const ParentChildrenMap result = subtraction.createBrushes(*world, worldBounds, "default");
+            ASSERT_EQ(1u, result.size());
+            
+            // the fragments above the subtrahend are merged across both brushes
+            const NodeList& fragments = result.begin()->second;
+            ASSERT_EQ(world->defaultLayer(), result.begin()->first);
+            ASSERT_EQ(3u, fragments.size());
+            ASSERT_DOUBLE_EQ(64.0 * 64.0 * 32.0 - 32.0 * 32.0 * 32.0, volume(fragments));
+            
+            const BBox3 mergedBounds(Vec3(-16.0, 0.0, -16.0), Vec3(16.0, 32.0, 16.0));
+            const Brush* merged = nullptr;
+            for (const Node* node : fragments) {
+                if (node->bounds() == mergedBounds)
+                    merged = static_cast<const Brush*>(node);
+            }
+            
+            ASSERT_TRUE(merged != nullptr);
+            ASSERT_EQ(6u, merged->faceCount());
+            ASSERT_EQ("subtrahend", merged->findFace(Vec3::NegY)->textureName());
+            ASSERT_EQ("texture", merged->findFace(Vec3::PosY)->textureName());
+            ASSERT_EQ("texture", merged->findFace(Vec3::PosZ)->textureName());
+            ASSERT_EQ("texture", merged->findFace(Vec3::NegZ)->textureName());
+            
+            for (const auto& entry : result)
+                VectorUtils::deleteAll(entry.second);
+        }
+        
+        TEST_F(CsgSubtractTest, mergeFragmentsFarFromOrigin) {
+            // same as above, but the volumes are computed with coordinates in the thousands
+            const Vec3 offset(4000.0, -4000.0, 3968.0);
+            
+            Brush* left = createBrush(BBox3(offset + Vec3(-32.0, -32.0, -16.0), offset + Vec3(0.0, 32.0, 16.0)), "texture");
+            Brush* right = createBrush(BBox3(offset + Vec3(0.0, -32.0, -16.0), offset + Vec3(32.0, 32.0, 16.0)), "texture");
+            Brush* subtrahend = createBrush(BBox3(offset + Vec3(-16.0, -64.0, -32.0), offset + Vec3(16.0, 0.0, 32.0)), "subtrahend");
+            
+            const CsgSubtract subtraction(BrushList { left, right }, subtrahend);
+            const ParentChildrenMap result = subtraction.createBrushes(*world, worldBounds, "default");
+            ASSERT_EQ(1u, result.size());
+            
+            const NodeList& fragments = result.begin()->second;
+            ASSERT_EQ(3u, fragments.size());
+            ASSERT_NEAR(64.0 * 64.0 * 32.0 - 32.0 * 32.0 * 32.0, volume(fragments), 0.001);
+            
+            const BBox3 mergedBounds(offset + Vec3(-16.0, 0.0, -16.0), offset + Vec3(16.0, 32.0, 16.0));
+            const bool merged = std::any_of(std::begin(fragments), std::end(fragments), [&mergedBounds](const Node* node) {
+                return node->bounds() == mergedBounds;
+            });
+            ASSERT_TRUE(merged);
+            
+            for (const auto& entry : result)
+                VectorUtils::deleteAll(entry.second);
+        }
+        
+        TEST_F(CsgSubtractTest, keepFragmentsOfBrushesWithDifferentTextures) {
+            Brush* left = createBrush(BBox3(Vec3(-32.0, -32.0, -16.0), Vec3(0.0, 32.0, 16.0)), "left");
+            Brush* right = createBrush(BBox3(Vec3(0.0, -32.0, -16.0), Vec3(32.0, 32.0, 16.0)), "right");
+            Brush* subtrahend = createBrush(BBox3(Vec3(-16.0, -64.0, -32.0), Vec3(16.0, 0.0, 32.0)), "subtrahend");
+            
+            const CsgSubtract subtraction(BrushList { left, right }, subtrahend);
+            const ParentChildrenMap result = subtraction.createBrushes(*world, worldBounds, "default");
+            ASSERT_EQ(1u, result.size());
+            
+            const NodeList& fragments = result.begin()->second;
+            ASSERT_EQ(4u, fragments.size());
+            ASSERT_DOUBLE_EQ(64.0 * 64.0 * 32.0 - 32.0 * 32.0 * 32.0, volume(fragments));
+            
+            for (const auto& entry : result)
+                VectorUtils::deleteAll(entry.second);
+        }
+        
+        TEST_F(CsgSubtractTest, skipDisjointAndContainedBrushes) {
+            Brush* disjoint = createBrush(BBox3(Vec3(64.0, 64.0, 64.0), Vec3(96.0, 96.0, 96.0)), "texture");
+            Brush* contained = createBrush(BBox3(Vec3(-8.0, -8.0, -8.0), Vec3(8.0, 8.0, 8.0)), "texture");
+            Brush* subtrahend = createBrush(BBox3(Vec3(-32.0, -32.0, -32.0), Vec3(32.0, 32.0, 32.0)), "subtrahend");
+            
+            const CsgSubtract subtraction(BrushList { disjoint, contained }, subtrahend);
+            const ParentChildrenMap result = subtraction.createBrushes(*world, worldBounds, "default");
+            
+            ASSERT_TRUE(subtraction.subtractedBrushes().empty());
+            ASSERT_TRUE(result.empty());
+            
+            for (const auto& entry : result)
+                VectorUtils::deleteAll(entry.second);
+        }
+    }
+}
@@ -19,9 +19,12 @@
 
 #include "TestGame.h"
 
+#include "Assets/TextureManager.h"
 #include "EL/VariableStore.h"
 #include "IO/BrushFaceReader.h"
 #include "IO/DiskFileSystem.h"
+#include "IO/MapFileSerializer.h"
+#include "IO/MapSnapshot.h"
 #include "IO/NodeReader.h"
 #include "IO/NodeWriter.h"
 #include "IO/TestParserStatus.h"
@@ -29,9 +32,12 @@
 #include "Model/GameConfig.h"
 #include "Model/World.h"
 
+#include <memory>
+
 namespace TrenchBroom {
     namespace Model {
-        TestGame::TestGame() {}
+        TestGame::TestGame() :
+        m_fileSystem(IO::Disk::getCurrentWorkingDir(), true) {}
 
         const String& TestGame::doGameName() const {
             static const String name("Test");
@@ -64,6 +70,12 @@ namespace TrenchBroom {
         }
         
         void TestGame::doWriteMap(World* world, const IO::Path& path) const {}
+
+        void TestGame::doWriteMap(const IO::MapSnapshot& snapshot, IO::OutputBuffer& buffer) const {
+            IO::NodeSerializer::Ptr serializer = IO::MapFileSerializer::create(snapshot.format(), buffer);
+            snapshot.write(*serializer);
+        }
+        
         void TestGame::doExportMap(World* world, Model::ExportFormat format, const IO::Path& path) const {}
         
         NodeList TestGame::doParseNodes(const String& str, World* world, const BBox3& worldBounds, Logger* logger) const {
@@ -96,17 +108,15 @@ namespace TrenchBroom {
             const EL::NullVariableStore variables;
             const IO::Path::List paths = extractTextureCollections(node);
             
-            const IO::Path root = IO::Disk::getCurrentWorkingDir();
-            const IO::Path::List fileSearchPaths{ root };
-            const IO::DiskFileSystem fileSystem(root, true);
+            const IO::Path::List fileSearchPaths{ IO::Disk::getCurrentWorkingDir() };
             
             const GameConfig::TextureConfig textureConfig(GameConfig::TexturePackageConfig(GameConfig::PackageFormatConfig("wad", "idmip")),
                                                           GameConfig::PackageFormatConfig("D", "idmip"),
                                                           IO::Path("data/palette.lmp"),
                                                           "wad");
             
-            IO::TextureLoader textureLoader(variables, fileSystem, fileSearchPaths, textureConfig);
-            textureLoader.loadTextures(paths, textureManager);
+            auto textureLoader = std::make_shared<IO::TextureLoader>(variables, m_fileSystem, fileSearchPaths, textureConfig);
+            textureManager.setTextureCollections(paths, textureLoader);
         }
         
         bool TestGame::doIsTextureCollection(const IO::Path& path) const {
@@ -20,6 +20,7 @@
 #ifndef TestGame_h
 #define TestGame_h
 
+#include "IO/DiskFileSystem.h"
 #include "Model/Game.h"
 
 namespace TrenchBroom {
@@ -31,6 +32,9 @@ namespace TrenchBroom {
     
     namespace Model {
         class TestGame : public Game {
+        private:
+            // must outlive the texture loaders that load texture collections in the background
+            IO::DiskFileSystem m_fileSystem;
         public:
             TestGame();
         private:
@@ -46,6 +50,7 @@ namespace TrenchBroom {
             World* doNewMap(MapFormat::Type format, const BBox3& worldBounds) const override;
             World* doLoadMap(MapFormat::Type format, const BBox3& worldBounds, const IO::Path& path, Logger* logger) const override;
             void doWriteMap(World* world, const IO::Path& path) const override;
+            void doWriteMap(const IO::MapSnapshot& snapshot, IO::OutputBuffer& buffer) const override;
             void doExportMap(World* world, Model::ExportFormat format, const IO::Path& path) const override;
             
             NodeList doParseNodes(const String& str, World* world, const BBox3& worldBounds, Logger* logger) const override;
@@ -0,0 +1,74 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/Entity.h"
+#include "Model/HitAdapter.h"
+#include "Model/HitFilter.h"
+#include "Model/Layer.h"
+#include "Model/PickResult.h"
+#include "Model/World.h"
+
+#include <limits>
+
+namespace TrenchBroom {
+    namespace Model {
+        TEST(WorldTest, pickClosestEndsAtClosestMatchingHit) {
+            const BBox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+            
+            const BrushBuilder builder(&world, worldBounds);
+            Brush* brush1 = builder.createCuboid(BBox3(Vec3(  0.0, 0.0, 0.0), Vec3( 32.0, 32.0, 32.0)), "texture");
+            Brush* brush2 = builder.createCuboid(BBox3(Vec3( 64.0, 0.0, 0.0), Vec3( 96.0, 32.0, 32.0)), "texture");
+            Brush* brush3 = builder.createCuboid(BBox3(Vec3(128.0, 0.0, 0.0), Vec3(160.0, 32.0, 32.0)), "texture");
+            world.defaultLayer()->addChild(brush3);
+            world.defaultLayer()->addChild(brush1);
+            world.defaultLayer()->addChild(brush2);
+            
+            const Ray3 ray(Vec3(-64.0, 16.0, 16.0), Vec3::PosX);
+            
+            PickResult all;
+            world.pick(ray, all);
+            ASSERT_EQ(3u, all.all().size());
+            
+            PickResult closest;
+            ASSERT_DOUBLE_EQ(64.0, world.pickClosest(ray, TypedHitFilter(Brush::BrushHit), closest));
+            ASSERT_EQ(1u, closest.all().size());
+            ASSERT_EQ(brush1, hitToBrush(closest.all().front()));
+        }
+        
+        TEST(WorldTest, pickClosestWithoutMatchingHit) {
+            const BBox3 worldBounds(8192.0);
+            World world(MapFormat::Standard, nullptr, worldBounds);
+            
+            const BrushBuilder builder(&world, worldBounds);
+            world.defaultLayer()->addChild(builder.createCuboid(BBox3(Vec3( 0.0, 0.0, 0.0), Vec3(32.0, 32.0, 32.0)), "texture"));
+            world.defaultLayer()->addChild(builder.createCuboid(BBox3(Vec3(64.0, 0.0, 0.0), Vec3(96.0, 32.0, 32.0)), "texture"));
+            
+            const Ray3 ray(Vec3(-64.0, 16.0, 16.0), Vec3::PosX);
+            
+            PickResult pickResult;
+            ASSERT_EQ(std::numeric_limits<FloatType>::max(), world.pickClosest(ray, TypedHitFilter(Entity::EntityHit), pickResult));
+            ASSERT_EQ(2u, pickResult.all().size());
+        }
+    }
+}
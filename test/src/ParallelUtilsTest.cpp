@@ -0,0 +1,68 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "ParallelUtils.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST(ParallelUtilsTest, parallelForEmpty) {
+    std::atomic<size_t> calls(0);
+    ParallelUtils::parallelFor(0, [&](const size_t i) { ++calls; });
+    ASSERT_EQ(0u, calls);
+}
+
+TEST(ParallelUtilsTest, parallelForVisitsEveryIndexOnce) {
+    const size_t count = 10000;
+    std::vector<std::atomic<size_t>> visits(count);
+    for (auto& visit : visits)
+        visit = 0;
+
+    ParallelUtils::parallelFor(count, [&](const size_t i) { ++visits[i]; });
+
+    for (size_t i = 0; i < count; ++i)
+        ASSERT_EQ(1u, visits[i]);
+}
+
+TEST(ParallelUtilsTest, parallelForRethrowsException) {
+    ASSERT_THROW(ParallelUtils::parallelFor(100, [](const size_t i) {
+        if (i == 50)
+            throw std::runtime_error("test");
+    }), std::runtime_error);
+}
+
+TEST(ParallelUtilsTest, parallelForReportsProgressOnCallingThread) {
+    const size_t count = 1000;
+    const std::thread::id callingThread = std::this_thread::get_id();
+
+    std::vector<size_t> reports;
+    ParallelUtils::parallelFor(count, [](const size_t i) {}, [&](const size_t processed) {
+        ASSERT_EQ(callingThread, std::this_thread::get_id());
+        reports.push_back(processed);
+    });
+
+    ASSERT_FALSE(reports.empty());
+    ASSERT_EQ(count, reports.back());
+    for (size_t i = 1; i < reports.size(); ++i)
+        ASSERT_LE(reports[i - 1], reports[i]);
+}
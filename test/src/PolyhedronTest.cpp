@@ -2234,6 +2234,58 @@ TEST(PolyhedronTest, subtractTetrahedronFromCubeWithOverlappingFragments) {
     ASSERT_EQ(3u, result.size());
 }
 
+TEST(PolyhedronTest, volume) {
+    ASSERT_DOUBLE_EQ(0.0, Polyhedron3d().volume());
+    ASSERT_DOUBLE_EQ(0.0, Polyhedron3d({ Vec3d(0.0, 0.0, 0.0), Vec3d(1.0, 0.0, 0.0), Vec3d(0.0, 1.0, 0.0) }).volume());
+    
+    const Polyhedron3d cuboid(BBox3d(Vec3d(-8.0, -16.0, 0.0), Vec3d(8.0, 16.0, 64.0)));
+    ASSERT_DOUBLE_EQ(16.0 * 32.0 * 64.0, cuboid.volume());
+    
+    const Polyhedron3d tetrahedron { Vec3d(0.0, 0.0, 0.0), Vec3d(6.0, 0.0, 0.0), Vec3d(0.0, 6.0, 0.0), Vec3d(0.0, 0.0, 6.0) };
+    ASSERT_DOUBLE_EQ(36.0, tetrahedron.volume());
+}
+
+TEST(PolyhedronTest, mergeConvexUnionOfAdjacentCuboids) {
+    Polyhedron3d left(BBox3d(Vec3d(-32.0, -16.0, -16.0), Vec3d(0.0, 16.0, 16.0)));
+    const Polyhedron3d right(BBox3d(Vec3d(0.0, -16.0, -16.0), Vec3d(32.0, 16.0, 16.0)));
+    
+    ASSERT_TRUE(left.mergeConvexUnion(right));
+    ASSERT_EQ(Polyhedron3d(BBox3d(Vec3d(-32.0, -16.0, -16.0), Vec3d(32.0, 16.0, 16.0))), left);
+}
+
+TEST(PolyhedronTest, mergeConvexUnionOfLShape) {
+    /*
+     ____
+     |  |
+     |  |____
+     |______|
+     
+     */
+    
+    const Polyhedron3d original(BBox3d(Vec3d(-32.0, -16.0, -16.0), Vec3d(0.0, 16.0, 48.0)));
+    const Polyhedron3d right(BBox3d(Vec3d(0.0, -16.0, -16.0), Vec3d(32.0, 16.0, 16.0)));
+    
+    Polyhedron3d left(original);
+    ASSERT_FALSE(left.mergeConvexUnion(right));
+    ASSERT_EQ(original, left);
+}
+
+TEST(PolyhedronTest, mergeConvexUnionOfDisjointCuboids) {
+    Polyhedron3d left(BBox3d(Vec3d(-32.0, -16.0, -16.0), Vec3d(-8.0, 16.0, 16.0)));
+    const Polyhedron3d right(BBox3d(Vec3d(0.0, -16.0, -16.0), Vec3d(32.0, 16.0, 16.0)));
+    
+    ASSERT_FALSE(left.mergeConvexUnion(right));
+}
+
+TEST(PolyhedronTest, mergeConvexUnionOfWedges) {
+    // two wedges that together form a cuboid
+    Polyhedron3d lower { Vec3d(0.0, 0.0, 0.0), Vec3d(32.0, 0.0, 0.0), Vec3d(0.0, 32.0, 0.0), Vec3d(0.0, 0.0, 16.0), Vec3d(32.0, 0.0, 16.0), Vec3d(0.0, 32.0, 16.0) };
+    const Polyhedron3d upper { Vec3d(32.0, 32.0, 0.0), Vec3d(32.0, 0.0, 0.0), Vec3d(0.0, 32.0, 0.0), Vec3d(32.0, 32.0, 16.0), Vec3d(32.0, 0.0, 16.0), Vec3d(0.0, 32.0, 16.0) };
+    
+    ASSERT_TRUE(lower.mergeConvexUnion(upper));
+    ASSERT_EQ(Polyhedron3d(BBox3d(Vec3d(0.0, 0.0, 0.0), Vec3d(32.0, 32.0, 16.0))), lower);
+}
+
 TEST(PolyhedronTest, intersection_empty_polyhedron) {
     const Polyhedron3d empty;
     const Polyhedron3d point      { Vec3d(1.0, 0.0, 0.0) };
@@ -0,0 +1,55 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Renderer/EntityModelVertexArray.h"
+
+namespace TrenchBroom {
+    namespace Renderer {
+        using Vertex = EntityModelVertexArray::Vertex;
+
+        TEST(EntityModelVertexArrayTest, insertVertices) {
+            EntityModelVertexArray vertexArray;
+            ASSERT_TRUE(vertexArray.empty());
+
+            const AllocationTracker::Block* b1 = vertexArray.insertVertices(Vertex::List(3));
+            const AllocationTracker::Block* b2 = vertexArray.insertVertices(Vertex::List(5));
+
+            ASSERT_FALSE(vertexArray.empty());
+            ASSERT_FALSE(vertexArray.prepared());
+            ASSERT_EQ(0u, b1->pos);
+            ASSERT_EQ(3u, b1->size);
+            ASSERT_EQ(3u, b2->pos);
+            ASSERT_EQ(5u, b2->size);
+        }
+
+        TEST(EntityModelVertexArrayTest, reuseDeletedVertices) {
+            EntityModelVertexArray vertexArray;
+
+            AllocationTracker::Block* b1 = vertexArray.insertVertices(Vertex::List(4));
+            vertexArray.insertVertices(Vertex::List(4));
+            vertexArray.deleteVertices(b1);
+
+            const AllocationTracker::Block* b3 = vertexArray.insertVertices(Vertex::List(2));
+            ASSERT_EQ(0u, b3->pos);
+            ASSERT_EQ(2u, b3->size);
+        }
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include "Assets/Texture.h"
+#include "Renderer/TextureArrayBatcher.h"
+
+#include <vector>
+
+namespace TrenchBroom {
+    namespace Renderer {
+        TEST(TextureArrayBatcherTest, slotsAreGroupedBySize) {
+            const Assets::Texture t1("t1", 64, 64);
+            const Assets::Texture t2("t2", 32, 64);
+            const Assets::Texture t3("t3", 64, 64);
+
+            TextureArrayBatcher batcher(16);
+            const TextureArrayBatcher::Slot s1 = batcher.slot(&t1);
+            const TextureArrayBatcher::Slot s2 = batcher.slot(&t2);
+            const TextureArrayBatcher::Slot s3 = batcher.slot(&t3);
+
+            ASSERT_EQ(2u, batcher.arrayCount());
+            ASSERT_EQ(0u, s1.array);
+            ASSERT_EQ(0u, s1.layer);
+            ASSERT_EQ(1u, s2.array);
+            ASSERT_EQ(0u, s2.layer);
+            ASSERT_EQ(0u, s3.array);
+            ASSERT_EQ(1u, s3.layer);
+
+            const TextureArrayBatcher::Array& array = batcher.array(0);
+            ASSERT_EQ(64u, array.width);
+            ASSERT_EQ(64u, array.height);
+            ASSERT_EQ((std::vector<const Assets::Texture*>{ &t1, &t3 }), array.layers);
+        }
+
+        TEST(TextureArrayBatcherTest, slotsAreStable) {
+            const Assets::Texture t1("t1", 16, 16);
+            const Assets::Texture t2("t2", 16, 16);
+
+            TextureArrayBatcher batcher(16);
+            batcher.slot(&t1);
+            batcher.slot(&t2);
+
+            ASSERT_EQ(1u, batcher.slot(&t2).layer);
+            ASSERT_EQ(0u, batcher.slot(&t1).layer);
+            ASSERT_EQ(2u, batcher.array(0).layers.size());
+        }
+
+        TEST(TextureArrayBatcherTest, fullArraysAreNotReused) {
+            const Assets::Texture t1("t1", 16, 16);
+            const Assets::Texture t2("t2", 16, 16);
+            const Assets::Texture t3("t3", 16, 16);
+
+            TextureArrayBatcher batcher(2);
+            batcher.slot(&t1);
+            batcher.slot(&t2);
+            const TextureArrayBatcher::Slot s3 = batcher.slot(&t3);
+
+            ASSERT_EQ(2u, batcher.arrayCount());
+            ASSERT_EQ(1u, s3.array);
+            ASSERT_EQ(0u, s3.layer);
+        }
+
+        TEST(TextureArrayBatcherTest, batch) {
+            const Assets::Texture t1("t1", 16, 16);
+            const Assets::Texture t2("t2", 32, 32);
+            const Assets::Texture t3("t3", 16, 16);
+            const Assets::Texture t4("t4", 16, 16);
+
+            TextureArrayBatcher batcher(2);
+            const std::vector<const Assets::Texture*> textures { &t1, &t2, nullptr, &t3, &t4 };
+            const TextureArrayBatcher::Batch::List batches = batcher.batch(textures);
+
+            // t1 and t3 share the first array, t4 goes into a second array of the same size
+            ASSERT_EQ(3u, batches.size());
+            ASSERT_EQ(batcher.slot(&t1).array, batches[0].array);
+            ASSERT_EQ((std::vector<size_t>{ 0, 3 }), batches[0].indices);
+            ASSERT_EQ(batcher.slot(&t2).array, batches[1].array);
+            ASSERT_EQ((std::vector<size_t>{ 1 }), batches[1].indices);
+            ASSERT_EQ(batcher.slot(&t4).array, batches[2].array);
+            ASSERT_EQ((std::vector<size_t>{ 4 }), batches[2].indices);
+        }
+
+        TEST(TextureArrayBatcherTest, clear) {
+            const Assets::Texture t1("t1", 16, 16);
+            const Assets::Texture t2("t2", 16, 16);
+
+            TextureArrayBatcher batcher(16);
+            batcher.slot(&t1);
+            batcher.clear();
+
+            ASSERT_EQ(0u, batcher.arrayCount());
+            ASSERT_EQ(0u, batcher.slot(&t2).layer);
+            ASSERT_EQ(0u, batcher.slot(&t1).array);
+            ASSERT_EQ(1u, batcher.slot(&t1).layer);
+        }
+    }
+}
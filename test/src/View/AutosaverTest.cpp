@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "StringUtils.h"
+#include "IO/DiskFileSystem.h"
+#include "IO/DiskIO.h"
+#include "IO/MappedFile.h"
+#include "IO/Path.h"
+#include "Model/Brush.h"
+#include "View/Autosaver.h"
+#include "View/MapDocumentTest.h"
+#include "View/MapDocument.h"
+
+#include <wx/filefn.h>
+
+namespace TrenchBroom {
+    namespace View {
+        class AutosaverTest : public MapDocumentTest {
+        protected:
+            IO::Path dir;
+        protected:
+            void SetUp() override {
+                MapDocumentTest::SetUp();
+                
+                dir = IO::Disk::getCurrentWorkingDir() + IO::Path("autosavertest");
+                deleteTestEnvironment();
+                IO::WritableDiskFileSystem fs(dir, true);
+                fs.createFile(IO::Path("test.map"), "");
+                
+                document->loadDocument(Model::MapFormat::Standard, document->worldBounds(), document->game(), dir + IO::Path("test.map"));
+            }
+            
+            void TearDown() override {
+                deleteTestEnvironment();
+            }
+            
+            String readBackup(const size_t no) const {
+                StringStream name;
+                name << "test." << no << ".map";
+                
+                const IO::MappedFile::Ptr file = IO::Disk::openFile(dir + IO::Path("autosave") + IO::Path(name.str()));
+                return String(file->begin(), file->end());
+            }
+        private:
+            void deleteTestEnvironment() {
+                const IO::Path autosaveDir = dir + IO::Path("autosave");
+                if (::wxDirExists(autosaveDir.asString())) {
+                    for (size_t i = 1; i <= 2; ++i) {
+                        StringStream name;
+                        name << "test." << i << ".map";
+                        ::wxRemoveFile((autosaveDir + IO::Path(name.str())).asString());
+                    }
+                    ::wxRmdir(autosaveDir.asString());
+                }
+                if (::wxDirExists(dir.asString())) {
+                    ::wxRemoveFile((dir + IO::Path("test.map")).asString());
+                    ::wxRmdir(dir.asString());
+                }
+            }
+        };
+        
+        TEST_F(AutosaverTest, writeBackupInBackground) {
+            {
+                Autosaver autosaver(document, 0, 0);
+                
+                Model::Brush* brush = createBrush("some_texture");
+                document->addNode(brush, document->currentParent());
+                autosaver.triggerAutosave(document.get());
+                
+                // the backup is written from a snapshot, so the document can be changed while it is being written
+                document->select(brush);
+                document->deleteObjects();
+                
+                // the destructor waits for the pending backup and writes another one for the deletion
+            }
+            
+            const String first = readBackup(1);
+            ASSERT_TRUE(StringUtils::containsCaseSensitive(first, "// brush 0\n"));
+            ASSERT_TRUE(StringUtils::containsCaseSensitive(first, ") some_texture 0 0 0 1 1\n"));
+            
+            const String second = readBackup(2);
+            ASSERT_TRUE(StringUtils::containsCaseSensitive(second, "// entity 0\n"));
+            ASSERT_FALSE(StringUtils::containsCaseSensitive(second, "// brush 0\n"));
+        }
+    }
+}
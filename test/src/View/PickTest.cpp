@@ -0,0 +1,109 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/EditorContext.h"
+#include "Model/HitAdapter.h"
+#include "Model/PickResult.h"
+#include "Model/World.h"
+#include "View/MapDocumentTest.h"
+#include "View/MapDocument.h"
+
+namespace TrenchBroom {
+    namespace View {
+        class PickTest : public MapDocumentTest {
+        protected:
+            Model::Brush* brush1;
+            Model::Brush* brush2;
+            Model::Brush* brush3;
+            Ray3 ray;
+        protected:
+            void SetUp() override {
+                MapDocumentTest::SetUp();
+                
+                const Model::BrushBuilder builder(document->world(), document->worldBounds());
+                brush1 = builder.createCuboid(BBox3(Vec3(  0.0, 0.0, 0.0), Vec3( 32.0, 32.0, 32.0)), "texture");
+                brush2 = builder.createCuboid(BBox3(Vec3( 64.0, 0.0, 0.0), Vec3( 96.0, 32.0, 32.0)), "texture");
+                brush3 = builder.createCuboid(BBox3(Vec3(128.0, 0.0, 0.0), Vec3(160.0, 32.0, 32.0)), "texture");
+                document->addNode(brush1, document->currentParent());
+                document->addNode(brush2, document->currentParent());
+                document->addNode(brush3, document->currentParent());
+                
+                ray = Ray3(Vec3(-64.0, 16.0, 16.0), Vec3::PosX);
+            }
+            
+            Model::BrushList pickBrushes(const bool closest) const {
+                Model::PickResult pickResult = Model::PickResult::byDistance(document->editorContext());
+                if (closest)
+                    document->pickClosest(ray, pickResult);
+                else
+                    document->pick(ray, pickResult);
+                
+                Model::BrushList result;
+                for (const Model::Hit& hit : pickResult.query().type(Model::Brush::BrushHit).all())
+                    result.push_back(Model::hitToBrush(hit));
+                return result;
+            }
+        };
+        
+        TEST_F(PickTest, pickFindsAllBrushes) {
+            const Model::BrushList brushes = pickBrushes(false);
+            ASSERT_EQ(3u, brushes.size());
+            ASSERT_EQ(brush1, brushes[0]);
+            ASSERT_EQ(brush2, brushes[1]);
+            ASSERT_EQ(brush3, brushes[2]);
+        }
+        
+        TEST_F(PickTest, pickClosestEndsAtClosestBrush) {
+            const Model::BrushList brushes = pickBrushes(true);
+            ASSERT_EQ(1u, brushes.size());
+            ASSERT_EQ(brush1, brushes[0]);
+        }
+        
+        TEST_F(PickTest, pickClosestSkipsHiddenBrushes) {
+            document->hide(Model::NodeList(1, brush1));
+            
+            const Model::BrushList brushes = pickBrushes(true);
+            ASSERT_EQ(1u, brushes.size());
+            ASSERT_EQ(brush2, brushes[0]);
+        }
+        
+        TEST_F(PickTest, pickClosestFindsSelectedBrushBehindClosestBrush) {
+            document->select(brush3);
+            
+            const Model::BrushList brushes = pickBrushes(true);
+            ASSERT_EQ(2u, brushes.size());
+            ASSERT_EQ(brush1, brushes[0]);
+            ASSERT_EQ(brush3, brushes[1]);
+        }
+        
+        TEST_F(PickTest, pickClosestFindsSelectedFaceBehindClosestBrush) {
+            document->select(brush2->findFace(Vec3::NegX));
+            
+            const Model::BrushList brushes = pickBrushes(true);
+            ASSERT_EQ(2u, brushes.size());
+            ASSERT_EQ(brush1, brushes[0]);
+            ASSERT_EQ(brush2, brushes[1]);
+        }
+    }
+}
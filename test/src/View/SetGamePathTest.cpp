@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2010-2017 Kristian Duske
+ 
+ This file is part of TrenchBroom.
+ 
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+ 
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "Assets/EntityModelManager.h"
+#include "IO/Path.h"
+#include "Model/MapFormat.h"
+#include "Model/TestGame.h"
+#include "View/MapDocument.h"
+#include "View/MapDocumentCommandFacade.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+namespace TrenchBroom {
+    namespace View {
+        class SlowModelGame : public Model::TestGame {
+        private:
+            std::shared_future<void> m_gate;
+            mutable std::atomic<size_t> m_loading;
+        public:
+            std::promise<void> loadStarted;
+            std::atomic<bool> gamePathSetWhileLoading;
+            
+            SlowModelGame(std::shared_future<void> gate) :
+            m_gate(gate),
+            m_loading(0),
+            gamePathSetWhileLoading(false) {}
+        private:
+            void doSetGamePath(const IO::Path& gamePath, Logger* logger) override {
+                if (m_loading > 0)
+                    gamePathSetWhileLoading = true;
+            }
+            
+            Assets::EntityModel* doLoadEntityModel(const IO::Path& path) const override {
+                ++m_loading;
+                const_cast<SlowModelGame*>(this)->loadStarted.set_value();
+                m_gate.wait();
+                --m_loading;
+                return nullptr;
+            }
+        };
+        
+        TEST(SetGamePathTest, setGamePathWhileLoadingModels) {
+            std::promise<void> gate;
+            SlowModelGame* game = new SlowModelGame(gate.get_future().share());
+            
+            MapDocumentSPtr document = MapDocumentCommandFacade::newMapDocument();
+            document->newDocument(Model::MapFormat::Standard, BBox3(8192.0), Model::GameSPtr(game));
+            
+            document->entityModelManager().loadModels(IO::Path::List(1, IO::Path("progs/player.mdl")));
+            game->loadStarted.get_future().wait();
+            
+            // the pending load must be finished before the game file system is replaced
+            std::thread release([&gate]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                gate.set_value();
+            });
+            document->setGamePath(IO::Path("other"));
+            release.join();
+            
+            ASSERT_FALSE(game->gamePathSetWhileLoading);
+        }
+    }
+}
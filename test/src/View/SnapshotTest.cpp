@@ -40,6 +40,10 @@ namespace TrenchBroom {
         TEST_F(SnapshotTest, setTexturesAfterRestore) {
             document->setEnabledTextureCollections(IO::Path::List{ IO::Path("data/IO/Wad/cr8_czg.wad") });
             
+            // the collection is loaded in the background
+            document->textureManager().finishLoading();
+            document->collectTextureCollections();
+            
             Model::Brush* brush = createBrush("coffin1");
             document->addNode(brush, document->currentParent());
             